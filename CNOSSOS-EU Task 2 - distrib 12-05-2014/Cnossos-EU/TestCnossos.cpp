@@ -23,6 +23,22 @@
  *
  *  25/11/2013	version 1.002 ready for distribution
  *
+ *	18/10/2026	added option -s (statically dispatched calculation pipeline)
+ *
+ *	18/10/2026	added option -v (trace level, see Trace.h)
+ *
+ *	18/10/2026	added options -pack= and -unpack= (conversion between XML files and binary batch 
+ *				files, see PathBatch.h)
+ *
+ *	18/10/2026	added option -stream (calculation of all paths in a file containing multiple paths)
+ *
+ *	18/10/2026	in stream mode, results are written to the output file (CSV or binary, see 
+ *				ResultSink.h)
+ *
+ *	18/10/2026	the checks and benchmarks of the library move to TestCnossosBench
+ *
+ *	18/10/2026	in stream mode, paths before the first <method> element are reported as errors
+ *
  * ------------------------------------------------------------------------------------------------- 
  */
 #ifndef __GNUC__
@@ -35,6 +51,8 @@
 #include "PathParseXML.h"
 #include "PathResult.h"
 #include "Material.h"
+#include "PathBatch.h"
+#include "ResultSink.h"
 #ifdef __GNUC__
 #ifndef WIN32
 #include <curses.h>
@@ -53,11 +71,33 @@ static const char* usage =
 "\n"
 "Usage:\n"
 "\n"
-"  TestCnossos [-w] [-m=<method>] [-i=<input file>] [-c] [-o] [-o=<output file>]\n"
+"  TestCnossos [-w] [-s] [-v=<level>] [-m=<method>] [-i=<input file>] [-c] [-o] [-o=<output file>]\n"
+"  TestCnossos [-s] [-m=<method>] -stream -i=<input file> [-o] [-o=<output file>]\n"
+"  TestCnossos -pack=<batch file> <input file> ...\n"
+"  TestCnossos -unpack=<batch file>\n"
 "\n" 
 "  .if -w is specified, the program will halt and wait for some user input \n"
 "   before exiting, otherwise exit is automatic at the end of the calculations \n"
 "\n"
+"  .if -s is specified, the calculation method uses the statically dispatched\n"
+"   pipeline (same results)\n"
+"\n"
+"  .if -v=<level> is specified, diagnostic messages up to the given level\n"
+"   (1=errors, 2=warnings, 3=info, 4=debug) are recorded and listed at the\n"
+"   end of the program\n"
+"\n"
+"  .if -stream is specified, the input file may contain any number of paths ;\n"
+"   the paths are read and calculated one by one and the levels of each path\n"
+"   are printed on a single line. If an output file is specified, the results\n"
+"   are written to this file instead, as comma-separated values if the name\n"
+"   of the file ends with .csv and in a compact binary format otherwise\n"
+"\n"
+"  .if -pack=<batch file> is specified, all subsequent arguments are names of\n"
+"   XML input files ; the propagation paths are converted to a binary batch file\n"
+"\n"
+"  .if -unpack=<batch file> is specified, each propagation path in the batch file\n"
+"   is converted to an XML file named <batch file>.<index>.xml\n"
+"\n"
 "  .if -c is specified, the program will copy the results to the clipboard in a\n"
 "   tabular format ready for pasting in spreadsheet applications or text editors\n"
 "\n"
@@ -83,6 +123,8 @@ static const char* usage =
 
 static bool interactive_mode = false ;
 static bool copy_to_clipboard = false ;
+static bool stream_mode = false ;
+static bool dump_trace = false ;
 
 static char* getcwd (void)
 {
@@ -113,6 +155,167 @@ static void show_libraries(unsigned int processID = -1) { }
 extern bool CopyToClipboard (CnossosEU::PathResult& result) ;
 #endif
 
+/*
+ * parse a propagation path from an XML file, file names in the input file being relative to the
+ * folder containing the file
+ */
+static bool parse_xml_path (const char* fileName, PropagationPath& path, PropagationPathOptions& options)
+{
+	XMLFileLoader xmlFile ;
+	if (!xmlFile.ParseFile (fileName))
+	{
+		printf ("Syntax error in file %s \n", fileName) ;
+		return false ;
+	}
+	char* old_dir = getcwd() ;
+	char* new_dir = getcwd (fileName) ;
+	_chdir (new_dir) ;
+	bool ok = false ;
+	try
+	{
+		ok = ParsePathFromFile (xmlFile.GetRoot(), path, options) ;
+	}
+	catch (ErrorMessage& err)
+	{
+		err.print() ;
+	}
+	_chdir (old_dir) ;
+	free (old_dir) ;
+	free (new_dir) ;
+	return ok ;
+}
+/*
+ * convert XML files to a batch file ; the materials defined in an input file only apply to the path
+ * in this file. Returns false in case of a write error.
+ */
+static bool pack_xml_files (const char* batchFile, int nbFiles, char* fileNames[])
+{
+	PathBatchWriter writer ;
+	if (!writer.open (batchFile))
+	{
+		printf ("Cannot create file %s \n", batchFile) ;
+		return false ;
+	}
+	bool ok = true ;
+	for (int i = 0 ; i < nbFiles && ok ; ++i)
+	{
+		MaterialSnapshot materials ;
+		PropagationPath path ;
+		PropagationPathOptions options ;
+		if (!parse_xml_path (fileNames[i], path, options))
+		{
+			printf ("Skipping file %s \n", fileNames[i]) ;
+			continue ;
+		}
+		ref_ptr<CalculationMethod> method = options.method ;
+		ok = writer.write (path, options) ;
+	}
+	unsigned int nb_paths = writer.getNbPaths() ;
+	ok = writer.close() && ok ;
+	printf ("%d paths written to %s %s\n", nb_paths, batchFile, ok ? "" : "(write error)") ;
+	return ok ;
+}
+/*
+ * convert a batch file to XML files, returns false if the batch file is invalid or if an XML file
+ * cannot be created
+ */
+static bool unpack_batch_file (const char* batchFile)
+{
+	PathBatchReader reader ;
+	if (!reader.open (batchFile))
+	{
+		printf ("Invalid batch file %s \n", batchFile) ;
+		return false ;
+	}
+	bool ok = true ;
+	std::vector<char> fileName (strlen (batchFile) + 32) ;
+	for (unsigned int k = 0 ; k < reader.getNbPaths() ; ++k)
+	{
+		sprintf (&fileName[0], "%s.%d.xml", batchFile, k) ;
+		if (reader.exportXML (k, &fileName[0])) continue ;
+		printf ("Cannot create file %s \n", &fileName[0]) ;
+		ok = false ;
+	}
+	printf ("%d paths read from %s \n", reader.getNbPaths(), batchFile) ;
+	return ok ;
+}
+
+/*
+ * calculate the paths in a file containing multiple paths, one by one as they are read. The 
+ * results are either printed or written to the output file, with one result per path (paths 
+ * without results have all levels set to NaN).
+ */
+static void calculate_path_stream (const char* inputFile, CalculationMethod* method, const char* outputFile)
+{
+	char* old_dir = getcwd() ;
+	char* new_dir = getcwd (inputFile) ;
+	XMLPathStream stream ;
+	ResultSink sink ;
+	PropagationPath path ;
+	PropagationPathOptions options ;
+	PathResult result ;
+	try
+	{
+		printf ("Parse file: %s \n", inputFile) ;
+		stream.Open (inputFile) ;
+		_chdir (new_dir) ;
+		if (outputFile != 0)
+		{
+			ResultSinkOptions sinkOptions ;
+			size_t len = strlen (outputFile) ;
+			sinkOptions.CSV = (len >= 4 && strcmp (outputFile + len - 4, ".csv") == 0) ;
+			if (!sink.open (outputFile, sinkOptions)) signal_error (ErrorMessage ("cannot create output file")) ;
+		}
+		else
+		{
+			printf ("  path   Leq dB(A)   LpH dB(A)   LpF dB(A)\n") ;
+		}
+		while (stream.ReadPath (path, options))
+		{
+			CalculationMethod* pathMethod = (method != 0) ? method : options.method ;
+			bool ok = true ;
+			try
+			{
+				if (pathMethod == 0) signal_error (ErrorMessage ("no calculation method, expecting tag <method> before the path")) ;
+				pathMethod->setOptions (options) ;
+				pathMethod->doCalculation (path, result) ;
+			}
+			catch (ErrorMessage& err)
+			{
+				printf ("%6d no results available\n", stream.GetNbPaths()) ;
+				err.print() ;
+				ok = false ;
+			}
+			if (outputFile == 0)
+			{
+				if (ok) printf ("%6d %11.2f %11.2f %11.2f\n", stream.GetNbPaths(), result.Leq_dBA, result.LpH_dBA, result.LpF_dBA) ;
+				continue ;
+			}
+			PathResult invalid ;
+			if (!ok)
+			{
+				double nan = sqrt (-1.0) ;
+				invalid.Leq_dBA = invalid.LpF_dBA = invalid.LpH_dBA = nan ;
+				invalid.Leq = invalid.LpF = invalid.LpH = Spectrum (nan) ;
+			}
+			if (!sink.add (ok ? result : invalid)) signal_error (ErrorMessage ("error writing output file")) ;
+		}
+		if (outputFile != 0)
+		{
+			if (!sink.close()) signal_error (ErrorMessage ("error writing output file")) ;
+			printf ("Results written to %s \n", outputFile) ;
+		}
+	}
+	catch (ErrorMessage& err)
+	{
+		err.print () ;
+	}
+	printf ("%d paths calculated \n", stream.GetNbPaths()) ;
+	_chdir (old_dir) ;
+	free (old_dir) ;
+	free (new_dir) ;
+}
+
 #ifdef __GNUC__
 int  main (int argc, char* argv[])
 #else
@@ -125,6 +328,7 @@ int _tmain (int argc, _TCHAR* argv[])
 	char* outputFile = 0 ;
 	char* old_dir = 0 ;
 	char* new_dir = 0 ;
+	char* methodName = 0 ;
 	ref_ptr<CalculationMethod> method = 0 ;
 
 	XMLFileLoader xmlFile ;
@@ -159,11 +363,23 @@ int _tmain (int argc, _TCHAR* argv[])
 			 */
 			else if (strncmp (argv[i], "-m=",3) == 0)
 			{
-				method = getCalculationMethod (argv[i]+3) ;
-				if (method == 0)
-				{
-					printf ("WARNING: invalid method specified on command line, using input file instead\n") ;
-				}
+				methodName = argv[i] + 3 ;
+			}
+			/*
+			 * option "-s" : use the statically dispatched calculation pipeline
+			 */
+			else if (strcmp (argv[i], "-s") == 0)
+			{
+				SetStaticPipeline (true) ;
+			}
+			/*
+			 * option "-v=" : record diagnostic messages up to the specified level
+			 */
+			else if (strncmp (argv[i], "-v=", 3) == 0)
+			{
+				SetTraceLevel (atoi (argv[i] + 3)) ;
+				SetTraceEcho (false) ;
+				dump_trace = true ;
 			}
 			/*
 			 * option "-w=" : specify interactive mode, i.e. wait for user confirmation before exiting the program
@@ -193,6 +409,39 @@ int _tmain (int argc, _TCHAR* argv[])
 			{
 				copy_to_clipboard = true ;
 			}
+			/*
+			 * option "-stream" : calculate all paths in the input file one by one
+			 */
+			else if (strcmp (argv[i], "-stream") == 0)
+			{
+				stream_mode = true ;
+			}
+			/*
+			 * option "-pack=" : convert the XML files given as subsequent arguments to a batch file
+			 */
+			else if (strncmp (argv[i], "-pack=", 6) == 0)
+			{
+				exit (pack_xml_files (argv[i] + 6, argc - i - 1, argv + i + 1) ? 0 : 1) ;
+			}
+			/*
+			 * option "-unpack=" : convert the paths in a batch file to XML files
+			 */
+			else if (strncmp (argv[i], "-unpack=", 8) == 0)
+			{
+				exit (unpack_batch_file (argv[i] + 8) ? 0 : 1) ;
+			}
+		}
+	}
+	/*
+	 * create the calculation method specified on the command line (after all other 
+	 * options, as -s changes the type of method that is created)
+	 */
+	if (methodName != 0)
+	{
+		method = getCalculationMethod (methodName) ;
+		if (method == 0)
+		{
+			printf ("WARNING: invalid method specified on command line, using input file instead\n") ;
 		}
 	}
 	/*
@@ -210,10 +459,19 @@ int _tmain (int argc, _TCHAR* argv[])
 			{
 				if (outputFile[--pos] == '.') break ;
 			}
-			strcpy (outputFile+pos, ".out.xml") ;
+			strcpy (outputFile+pos, stream_mode ? ".out.csv" : ".out.xml") ;
 			print_debug ("Generated output file name = %s \n", outputFile) ;
 		}
 	}
+	/*
+	 * read and process input files containing multiple paths
+	 */
+	if (stream_mode)
+	{
+		calculate_path_stream (inputFile, method, outputFile) ;
+		if (dump_trace) DumpTrace (stdout) ;
+		return 0 ;
+	}
 	/*
 	 * try reading and processing the input file
 	 */
@@ -344,6 +602,14 @@ int _tmain (int argc, _TCHAR* argv[])
 		printf ("No results available...\n") ;
 		printf ("No output file generated\n") ;
 	}
+	/*
+	 * list the diagnostic messages recorded during the calculation
+	 */
+	if (dump_trace)
+	{
+		printf ("Trace\n") ;
+		DumpTrace (stdout) ;
+	}
 	/*
 	 * reset current working directory to initial value
 	 */
@@ -11,6 +11,10 @@
  *
  *	03/12/2013	initial version
  *
+ *	18/10/2026	added CNOSSOS_P2P_SetStaticPipeline
+ *
+ *	18/10/2026	added CNOSSOS_P2P_SetTraceLevel and CNOSSOS_P2P_DumpTrace
+ *
  * ------------------------------------------------------------------------------------------------- 
  */
 #include "CnossosPropagation.h"
@@ -581,4 +585,25 @@ bool CNOSSOS_P2P_GetPerformanceCounters (CNOSSOS_P2P_ENGINE* p2p, unsigned int &
 void CNOSSOS_P2P_SetInfinityMode (bool on_off)
 {
 	SetInfinityMode (on_off) ;
+}
+
+void CNOSSOS_P2P_SetStaticPipeline (bool on_off)
+{
+	SetStaticPipeline (on_off) ;
+}
+
+void CNOSSOS_P2P_SetTraceLevel (int level)
+{
+	SetTraceLevel (level) ;
+	SetTraceEcho (false) ;
+}
+
+int CNOSSOS_P2P_DumpTrace (const char* fileName)
+{
+	if (fileName == 0) return DumpTrace (stdout) ;
+	FILE* fp = fopen (fileName, "a") ;
+	if (fp == 0) return -1 ;
+	int nb_records = DumpTrace (fp) ;
+	fclose (fp) ;
+	return nb_records ;
 }
\ No newline at end of file
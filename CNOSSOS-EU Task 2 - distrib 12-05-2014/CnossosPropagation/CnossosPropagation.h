@@ -43,6 +43,9 @@
  * - \ref CNOSSOS_P2P_GetErrorMessage
  * - \ref CNOSSOS_P2P_ProcessPathFile
  * - \ref CNOSSOS_P2P_SetInfinityMode
+ * - \ref CNOSSOS_P2P_SetStaticPipeline
+ * - \ref CNOSSOS_P2P_SetTraceLevel
+ * - \ref CNOSSOS_P2P_DumpTrace
  */
 #ifndef _CNOSSOS_PROPAGATION_INCLUDED_
 #define _CNOSSOS_PROPAGATION_INCLUDED_
@@ -477,5 +480,25 @@ _CNOSSOS_DLL_DECL_ bool CNOSSOS_P2P_GetPerformanceCounters (
  * If disabled, the library will use an arbitrary large value to represent infinity
  */
 _CNOSSOS_DLL_DECL_ void CNOSSOS_P2P_SetInfinityMode (bool on_off) ;
+/**
+ * \brief Enables or disables the statically dispatched calculation pipeline.
+ * If enabled, calculation engines created afterwards call all calculation steps directly
+ * instead of through virtual functions. The results are identical.
+ */
+_CNOSSOS_DLL_DECL_ void CNOSSOS_P2P_SetStaticPipeline (bool on_off) ;
+/**
+ * \brief Selects the level of the diagnostic messages recorded by the library.
+ * 0 = none (default), 1 = errors, 2 = warnings, 3 = information, 4 = debug messages.
+ * Messages are recorded in a ring buffer per thread, holding the most recent messages.
+ * Debug messages are only available if the library was compiled in debug mode.
+ */
+_CNOSSOS_DLL_DECL_ void CNOSSOS_P2P_SetTraceLevel (int level) ;
+/**
+ * \brief Writes the recorded diagnostic messages to a file and clears the ring buffers.
+ * \param fileName the name of the output file, the messages are appended to the file. 
+ * If NULL, the messages are written to the standard output.
+ * \return the number of messages written, or -1 if the file cannot be opened.
+ */
+_CNOSSOS_DLL_DECL_ int CNOSSOS_P2P_DumpTrace (const char* fileName) ;
 
 #endif
\ No newline at end of file
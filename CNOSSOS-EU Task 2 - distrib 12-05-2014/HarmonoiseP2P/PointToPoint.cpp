@@ -8,6 +8,31 @@
  * changes:
  *
  *	14/01/2014	this header added, all other copyright and licensing notices removed
+ *
+ *	18/10/2026	partial results are only recorded when the enableDetails option is set
+ *
+ *	18/10/2026	GroundEffect and GetCoherence process all frequency bands in vectorizable loops, 
+ *				exact-match test against the original calculation with -D_TEST_GROUND_EFFECT_
+ *
+ *	18/10/2026	faster Fref, Qref and HaddenPierce, accuracy and speed test against the original 
+ *				implementations with -D_TEST_SPECIAL_FUNCTIONS_
+ *
+ *	18/10/2026	Delany & Bazley impedance spectra cached and shared between all engines
+ *
+ *	18/10/2026	per-stage timers (option enableProfiling, P2P_GetStageTimer)
+ *
+ *	18/10/2026	long-term results over a wind rose (P2P_GetWindRoseResults), conditions that lead to the 
+ *				same curved geometry are calculated only once
+ *
+ *	18/10/2026	P2P_GetWindRoseResults resets the details and debug parameters like DoPointToPoint
+ *
+ *	18/10/2026	the exact-match test of the ground effect is switched on and read with P2P_CheckGroundEffect
+ *
+ *	18/10/2026	P2P_TestSpecialFunctions takes the number of repetitions and the tolerance, returns the 
+ *				number of functions that fail
+ *
+ *	18/10/2026	P2P_GetWindRoseResults creates the segments once per subdivision of the profile and shares 
+ *				the distinct geometries between threads (P2P_SetNbThreads)
  * ------------------------------------------------------------------------------------------------- 
  */
 // ----------------------------------------------------------------------------------------------------- 
@@ -38,6 +63,14 @@
 #include <assert.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
 
 #include "PointToPointEx.hpp"
 
@@ -51,6 +84,54 @@ const double HSR_MIN = 0 ;
 
 const double DIST_MIN = 0.01 ;
 
+// ---------------------------------------------------------------------------------------------------------
+// Per-stage timers
+//
+// A StageClock measures the time between its construction and its destruction and adds it to the timer of 
+// the given stage, if the option enableProfiling is set. Recursive calls are counted but only the outermost 
+// call is timed, so that the total time of a stage includes each call only once.
+// ---------------------------------------------------------------------------------------------------------
+
+static double HighResolutionTime (void)
+{
+#ifdef WIN32
+    LARGE_INTEGER frequency, counter ;
+    QueryPerformanceFrequency (&frequency) ;
+    QueryPerformanceCounter (&counter) ;
+    return (double) counter.QuadPart / (double) frequency.QuadPart ;
+#else
+    struct timespec t ;
+    clock_gettime (CLOCK_MONOTONIC, &t) ;
+    return t.tv_sec + 1.E-9 * t.tv_nsec ;
+#endif
+}
+
+class StageClock
+{
+public:
+
+    StageClock (PropagationPath *path, int stage) : timer (0), start (0)
+    {
+        if ((path->options & enableProfiling) == 0) return ;
+        timer = &path->stage_timer[stage] ;
+        timer->nbCalls++ ;
+        if (timer->depth++ == 0) start = HighResolutionTime() ;
+    }
+
+    ~StageClock (void)
+    {
+        if (timer == 0 || --timer->depth > 0) return ;
+        double t = HighResolutionTime() - start ;
+        timer->total += t ;
+        if (t > timer->max) timer->max = t ;
+    }
+
+private:
+
+    StageTimer* timer ;
+    double      start ;
+} ;
+
 // ---------------------------------------------------------------------------------------------------------
 // 
 // Calculate parameters of Fresnel ellipse in 2D
@@ -225,11 +306,27 @@ Complex FresnelAux (double x)
     return Complex (FresnelAuxF(x), -FresnelAuxG(x)) ;
 }
 
+// ----------------------------------------------------------------------------------------------------
+// 1/z for arguments well inside the range of floating point numbers (avoids the scaling and the special
+// cases of the general complex division, the result differs by a few units in the last place at most)
+// ----------------------------------------------------------------------------------------------------
+
+inline Complex Reciprocal (Complex z)
+{
+   double d = z.real() * z.real() + z.imag() * z.imag() ;
+   return Complex (z.real() / d, -z.imag() / d) ;
+}
+
 // ----------------------------------------------------------------------------------------------------
 // Fref : correction factor for spherical reflection coefficient 
 //
 // Reference : Chien & Soroko, JSV, 1980
 //
+// modif 18/10/2026 : the factors exp(-n*n*h*h) of the series are constants, the common factor of p2 and
+//                    q2 is evaluated once and the rational approximations for large arguments use 
+//                    Reciprocal instead of complex divisions. See P2P_TestSpecialFunctions for the 
+//                    deviation from the original implementation. 
+//
 // Copyright CSTB, 2002-2007, all rights reserved. Special conditions apply to members of the Harmonoise
 // and Imagine consortium as stated in the Consortium's Agreements.
 // ----------------------------------------------------------------------------------------------------
@@ -253,13 +350,13 @@ Complex Fref (Complex z)
       
       if ( fabs(x) > 6. || fabs(y) > 6. )
       {
-          erf = j * z1 * (0.5124242 / (z2 - 0.2752551) + 0.05176536 / (z2 - 2.724745)) ;
+          erf = j * z1 * (0.5124242 * Reciprocal (z2 - 0.2752551) + 0.05176536 * Reciprocal (z2 - 2.724745)) ;
       } 
       else   
       {
-          erf = j * z1 * (0.461313500 / (z2 - 0.1901635) 
-                        + 0.099992160 / (z2 - 1.7844927) 
-                        + 0.002883894 / (z2 - 5.5253437)) ;
+          erf = j * z1 * (0.461313500 * Reciprocal (z2 - 0.1901635) 
+                        + 0.099992160 * Reciprocal (z2 - 1.7844927) 
+                        + 0.002883894 * Reciprocal (z2 - 5.5253437)) ;
       }
       
    // careful about the signs here !   
@@ -286,10 +383,18 @@ Complex Fref (Complex z)
       }
       else
       {
-         p2 = 2 * exp (-1*(x*x+2*y*PI/h-y*y))*(a1*c1-b1*d1) / cd;
-         q2 = 2 * exp (-1*(x*x+2*y*PI/h-y*y))*(a1*d1+b1*c1) / cd;
+         double e2 = 2 * exp (-1*(x*x+2*y*PI/h-y*y)) ;
+         p2 = e2*(a1*c1-b1*d1) / cd;
+         q2 = e2*(a1*d1+b1*c1) / cd;
       }
 
+   // exp(-1*(n*n)*h*h) for n = 1..5 and h = 0.8
+
+      static const double exp_nh[5] = 
+      { 
+         0.5272924240430485, 0.07730474044329971, 0.0031511115984444384, 3.5712849641635144e-05, 1.1253517471925912e-07 
+      } ;
+
       double eh = 0.000001 ;
       double h1 = 0 ;
       double h2 = 0 ;
@@ -298,8 +403,9 @@ Complex Fref (Complex z)
          double x1 = (y*y+x*x+n*n*h*h);
          double x2 = (y*y-x*x+n*n*h*h);
          double x3 = (y*y+x*x-n*n*h*h);
-         h1 += exp(-1*(n*n)*h*h)*x1/(x2*x2+4*y*y*x*x);
-         h2 += exp(-1*(n*n)*h*h)*x3/(x2*x2+4*y*y*x*x);
+         double dn = x2*x2+4*y*y*x*x ;
+         h1 += exp_nh[n-1]*x1/dn;
+         h2 += exp_nh[n-1]*x3/dn;
       }
 
       double hyx = h*y / (PI*(x*x+y*y)) + 2*y*h*h1/PI - y*eh/PI;
@@ -350,21 +456,36 @@ Complex Fref (Complex z)
 
 Complex Qref (Complex Z, double cos_teta, double kr, double N)
 {
-   Complex  j(0,1) ;
+// modif 18/10/2026 : complex divisions and the complex power are written out in real arithmetic and 
+// pow(F,N) is skipped for N = 1. See P2P_TestSpecialFunctions for the deviation from the original 
+// implementation.
 
-// plane wave reflection coefficient   
+   double zr = Z.real() * cos_teta ;
+   double zi = Z.imag() * cos_teta ;
+   
+// plane wave reflection coefficient Rp = (Z * cos_teta - 1.) / (Z * cos_teta + 1.)
 
-   Complex Rp = (Z * cos_teta - 1.) / (Z * cos_teta + 1.) ;
+   double d2 = (zr + 1) * (zr + 1) + zi * zi ;
+   double rr = ((zr - 1) * (zr + 1) + zi * zi) / d2 ;
+   double ri = 2 * zi / d2 ;
    
 // correction for spherical reflection, parameter w = (1+j)/2 * sqrt(kr) * (cos(teta)+1./z)
 
-   Complex w = (j+1.)/2. * sqrt(kr) * (cos_teta + 1./Z) ;
+   Complex u = cos_teta + Reciprocal (Z) ;
+   double  a = 0.5 * sqrt(kr) ;
+   Complex w (a * (u.real() - u.imag()), a * (u.real() + u.imag())) ;
    
-// spherical reflection coefficient
+// spherical reflection coefficient Qc = Rp + (1. - Rp) * pow (Fref(w), N) 
 
-   Complex Qc = Rp + (1. - Rp) * pow (Fref(w), N) ;
+   Complex F = Fref (w) ;
+   if (N != 1)
+   {
+      double m = exp (0.5 * N * log (norm (F))) ;
+      double t = N * arg (F) ;
+      F = Complex (m * cos (t), m * sin (t)) ;
+   }
 
-   return Qc ;
+   return Complex (rr + (1 - rr) * F.real() + ri * F.imag(), ri + (1 - rr) * F.imag() - ri * F.real()) ;
 }
 
 // --------------------------------------------------------------------------------------------------------
@@ -427,6 +548,8 @@ inline double LowpassFilter (double X)
 // -----------------------------------------------------------------------------------------------------
 // Hadden & Pierce : calculation of diffracted field components
 //
+// modif 18/10/2026 : constant factor exp(j.PI/4) no longer evaluated on each call
+//
 // Copyright CSTB, 2002-2007, all rights reserved. Special conditions apply to members of the Harmonoise
 // and Imagine consortium as stated in the Consortium's Agreements.
 // -----------------------------------------------------------------------------------------------------
@@ -445,7 +568,7 @@ Complex HaddenPierce (double beta, double teta, double Rs, double Rr, double k,
 
     Complex ad = FresnelAux (b) ;
 
-    Complex ep = exp (Complex (0, PI/4)) ;
+    static const Complex ep (0.7071067811865476, 0.7071067811865475) ; // exp (Complex (0, PI/4))
 
  // modif DVM 14.04.2003 : special case sin(x)/x as x tends to 0
 
@@ -646,7 +769,7 @@ void PropagationPath::SingleDiffraction (double xs, double ys, double xd, double
 // and Imagine consortium as stated in the Consortium's Agreements.
 // --------------------------------------------------------------------------------------------------------
 
-void PropagationPath::CumulDiffraction (int is, int id, int ir) 
+void PropagationPath::CumulDiffraction (int is, int id, int ir, double *att_dif, int model) 
 {
     Complex p_free [MAX_FREQ] ;
     Complex p_diff [MAX_FREQ] ;
@@ -664,7 +787,6 @@ void PropagationPath::CumulDiffraction (int is, int id, int ir)
 
  // calculate insertion loss by diffraction 
  
-    double att_dif [MAX_FREQ] ;
     for (int j = 0 ; j < nbFreq ; j++)
     {
        att_dif[j] = 10 * log10 (norm(p_diff[j] / p_free[j])) ;
@@ -672,11 +794,25 @@ void PropagationPath::CumulDiffraction (int is, int id, int ir)
 
  // save details
  
+    SaveDetail (model, is, id, ir, att_dif) ;
+}
+
+// --------------------------------------------------------------------------------------------------------
+// SaveDetail
+//
+// Record a partial result in the detail buffer. Partial results are only needed for P2P_GetDetails, they 
+// are not recorded unless the enableDetails option has been set.
+// --------------------------------------------------------------------------------------------------------
+
+void PropagationPath::SaveDetail (int model, int is, int id, int ir, const double *att) 
+{
+    if ((options & enableDetails) == 0) return ;
+    
     detail[nbDetails].pos_src = is ;
     detail[nbDetails].pos_rec = ir ;
     detail[nbDetails].pos_dif = id ;
-    detail[nbDetails].model    = ATT_DIFFRACTION ;
-    for (int j = 0 ; j < nbFreq ; j++) detail[nbDetails].att[j] = att_dif[j] ;
+    detail[nbDetails].model   = model ;
+    for (int j = 0 ; j < nbFreq ; j++) detail[nbDetails].att[j] = att[j] ;
     nbDetails++ ;
 }
 
@@ -708,15 +844,19 @@ void PropagationPath::CumulDiffraction (int is, int id, int ir)
 // and Imagine consortium as stated in the Consortium's Agreements.
 // --------------------------------------------------------------------------------------------------------
 
-void PropagationPath::FindConvexHull (int is, int ir)
+void PropagationPath::FindConvexHull (int is, int ir, double *att)
 {
-    int i ;
+    StageClock timer (this, STAGE_CONVEX_HULL) ;
+
+    int i, j ;
     
  // a single segment contains no diffraction points...
  
     if ((ir - is) == 1)
     {
-        GroundEffect (is, ir) ;
+        double att_seg[MAX_FREQ] ;
+        GroundEffect (is, ir, att_seg) ;
+        for (j = 0 ; j < nbFreq ; j++) att[j] += att_seg[j] ;
         return ;
     }
  
@@ -753,7 +893,7 @@ void PropagationPath::FindConvexHull (int is, int ir)
  
     if (ipos_dif == 0)
     {
-       FindSecondHull (is, ir) ; 
+       FindSecondHull (is, ir, att) ; 
        return ;
     }
 
@@ -763,15 +903,17 @@ void PropagationPath::FindConvexHull (int is, int ir)
 
  // calculate attenuation due to diffraction by this edge
  
-    CumulDiffraction (is, ipos_dif, ir) ;      
+    double att_dif[MAX_FREQ] ;
+    CumulDiffraction (is, ipos_dif, ir, att_dif) ;      
+    for (j = 0 ; j < nbFreq ; j++) att[j] += att_dif[j] ;
 
     for (i = is ; i < ipos_dif ; i++) seg[i].index_r = ipos_dif ;
     for (i = ipos_dif ; i < ir ; i++) seg[i].index_s = ipos_dif ;
 
  // and continue search process recursively on both sides of this edge
  
-    FindConvexHull (is, ipos_dif) ;
-    FindConvexHull (ipos_dif, ir) ;
+    FindConvexHull (is, ipos_dif, att) ;
+    FindConvexHull (ipos_dif, ir, att) ;
 }
 
 
@@ -789,17 +931,24 @@ void PropagationPath::FindConvexHull (int is, int ir)
 // and Imagine consortium as stated in the Consortium's Agreements.
 // --------------------------------------------------------------------------------------------------------
 
-void PropagationPath::FindSecondHull (int is, int ir)
+void PropagationPath::FindSecondHull (int is, int ir, double *att_total)
 {
+    StageClock timer (this, STAGE_CONVEX_HULL) ;
+
     int i,j ;
 
  // calculate ground effect using flat ground model
 
-    GroundEffect (is, ir) ;
+    double att_flat[MAX_FREQ] ;
+    GroundEffect (is, ir, att_flat) ;
         
  // a single segment contains certainly no diffraction points...
  
-    if ((ir - is) == 1) return ;
+    if ((ir - is) == 1) 
+    {
+        for (j = 0 ; j < nbFreq ; j++) att_total[j] += att_flat[j] ;
+        return ;
+    }
     
  // look for secondary diffraction only at the end points of convex segments
  // that is to say : ignore points common to two succesive convex segments
@@ -832,16 +981,15 @@ void PropagationPath::FindSecondHull (int is, int ir)
 
  // no second diffraction point, just keep the ground effect previously calculated
 
-    if (ipos_dif == 0) return ;
+    if (ipos_dif == 0) 
+    {
+        for (j = 0 ; j < nbFreq ; j++) att_total[j] += att_flat[j] ;
+        return ;
+    }
 
- // get result from detail buffer, mark result as intermediate GROUND_FLAT model 
+ // mark the detail saved by GroundEffect as intermediate GROUND_FLAT model 
  
-    double att_flat[MAX_FREQ] ;
-    int    npos = nbDetails-1 ;
-
-    detail[npos].model = ATT_GROUND_FLAT ;
-    
-    for (j = 0 ; j < nbFreq ; j++) att_flat[j] = detail[npos].att[j] ;
+    if (options & enableDetails) detail[nbDetails-1].model = ATT_GROUND_FLAT ;
     
  // prepare for transition : find most important reflexion point (if it exists)
  // only count "real" reflexion points, ignore any convex segments here
@@ -926,47 +1074,31 @@ void PropagationPath::FindSecondHull (int is, int ir)
  // source and receiver side. 
  // Do not further resursions in order to find other secondary diffracting edges.
  
-    CumulDiffraction (is, ipos_dif, ir) ;
+    double att_dif[MAX_FREQ] ;
+    double att_gs[MAX_FREQ] ;
+    double att_gr[MAX_FREQ] ;
+
+    CumulDiffraction (is, ipos_dif, ir, att_dif, ATT_DIFFRACTION_BLOS) ;
     
     for (i = is ; i < ipos_dif ; i++) seg[i].index_r = ipos_dif ;
     for (i = ipos_dif ; i < ir ; i++) seg[i].index_s = ipos_dif ;
 
-    GroundEffect (is, ipos_dif) ;
-    GroundEffect (ipos_dif, ir) ;
+    GroundEffect (is, ipos_dif, att_gs, ATT_GROUND_BLOS) ;
+    GroundEffect (ipos_dif, ir, att_gr, ATT_GROUND_BLOS) ;
 
  // remove primary diffraction
  
     seg[ipos_dif].convex_hull = false ;
 
- // get results from detail buffer, mark results as intermediate DIFFACTION_BLOS and GROUND_BLOS
  // cumulate diffraction + ground effect on both sides of the diffraction point 
  
     double att_blos[MAX_FREQ] ;
 
-    for (j = 0 ; j < nbFreq ; j++) att_blos[j] = 0 ;
-    
-    for (i = npos ; i < nbDetails ; i++)
-    {
-       if (detail[i].model == ATT_DIFFRACTION)
-       {
-           detail[i].model = ATT_DIFFRACTION_BLOS ;
-           for (j = 0 ; j < nbFreq ; j++) att_blos[j] += detail[i].att[j] ;
-       }
-       else if (detail[i].model == ATT_GROUND)
-       {
-           detail[i].model = ATT_GROUND_BLOS ;
-           for (j = 0 ; j < nbFreq ; j++) att_blos[j] += detail[i].att[j] ;
-       }
-    }
+    for (j = 0 ; j < nbFreq ; j++) att_blos[j] = att_dif[j] + att_gs[j] + att_gr[j] ;
 
  // save details for diffraction below line of sight model
  
-    npos = nbDetails++ ;
-    detail[npos].model = ATT_DIFF_GROUND_BLOS ;
-    detail[npos].pos_src = is ;
-    detail[npos].pos_rec = ir ;
-    detail[npos].pos_dif = -1 ;
-    for (j = 0 ; j < nbFreq ; j++) detail[npos].att[j] = att_blos[j] ;
+    SaveDetail (ATT_DIFF_GROUND_BLOS, is, -1, ir, att_blos) ;
 
  // transition between diffraction and ground model
  //
@@ -1027,21 +1159,13 @@ void PropagationPath::FindSecondHull (int is, int ir)
  
  // save details about transition function
  
-    npos = nbDetails++ ;
-    detail[npos].model = ATT_TRANS_BLOS_FLAT ;
-    detail[npos].pos_src = is ;
-    detail[npos].pos_rec = ir ;
-    detail[npos].pos_dif = -1 ;
-    for (j = 0 ; j < nbFreq ; j++) detail[npos].att[j] = trans[j] ;
+    SaveDetail (ATT_TRANS_BLOS_FLAT, is, -1, ir, trans) ;
 
- // save combined ground attenuation
+ // save and cumulate combined ground attenuation
  
-    npos = nbDetails++ ;
-    detail[npos].model = ATT_GROUND ;
-    detail[npos].pos_src = is ;
-    detail[npos].pos_rec = ir ;
-    detail[npos].pos_dif = -1 ;
-    for (j = 0 ; j < nbFreq ; j++) detail[npos].att[j] = att[j] ;
+    SaveDetail (ATT_GROUND, is, -1, ir, att) ;
+
+    for (j = 0 ; j < nbFreq ; j++) att_total[j] += att[j] ;
 }
 
 
@@ -1069,6 +1193,8 @@ void PropagationPath::FindSecondHull (int is, int ir)
 
 void PropagationPath::LocalCoordinates (int i1, int i2)
 {
+    StageClock timer (this, STAGE_LOCAL_COORDINATES) ;
+
     for (int i = i1 ; i < i2  ; i++)
     {
         int is = seg[i].index_s ;
@@ -1331,6 +1457,8 @@ void PropagationPath::FresnelWeights (int i1, int i2, double freqCenter)
 
 void PropagationPath::InitialFresnelWeights (int is, int ir)
 {
+    StageClock timer (this, STAGE_FRESNEL_WEIGHTS) ;
+
     centerFreq = 0 ;
     
     LocalCoordinates (is, ir) ;
@@ -1364,6 +1492,8 @@ void PropagationPath::InitialFresnelWeights (int is, int ir)
 
 void PropagationPath::ModifiedFresnelWeights (int is, int ir) 
 {
+    StageClock timer (this, STAGE_FRESNEL_WEIGHTS) ;
+
     double phi_max[MAX_FREQ] ;
 
  // determine maximum total phase difference (includes path difference + phase due to finite impedance)
@@ -1511,6 +1641,8 @@ void PropagationPath::MakeImage (double xo, double yo, int i, double &xi, double
 
 void PropagationPath::GetDiffraction (int i1, int i2)
 {
+    StageClock timer (this, STAGE_DIFFRACTION) ;
+
     int i,j ;
     
     double xs, ys ;     // source position
@@ -1686,68 +1818,81 @@ void PropagationPath::GetDiffraction (int i1, int i2)
 
 void PropagationPath::GetCoherence (int i1, int i2)
 {
+    StageClock timer (this, STAGE_COHERENCE) ;
+
     int i,j ;
     
     if (options & enableAveraging)
     {
+     // modif 18/10/2026 : the frequency dependent terms are calculated once for all segments, the 
+     // segment dependent terms once per segment. The exponents are evaluated for all frequency bands 
+     // in a single loop without branches (which the compiler vectorizes), the exponentials are then 
+     // only taken in bands with a non-zero Fresnel weight. The results are bit-identical to the 
+     // original per-band calculation (see ScalarCoherence).
+
+        double kc  [MAX_FREQ] ;
+        double Xf2 [MAX_FREQ] ;
+        double e1  [MAX_FREQ] ;
+        double e2  [MAX_FREQ] ;
+
+        double xf = pow (2. , band_width/2) ;
+
+        for (j = 0 ; j < nbFreq ; j++)
+        {
+            double stddev_f = freq[j] * (xf - 1/xf) / 3. ;
+            double Xf = stddev_f / freq[j] ;
+            Xf2[j] = Xf * Xf ;
+            kc[j]  = 2 * PI * freq[j] / c_sound  ;
+        }
+
         for (i = i1 ; i < i2 ; i++)
         {      
-            for (j = 0 ; j < nbFreq ; j++)
-            {
-                if (seg[i].w_fresnel[j] == 0)
-                {
-                    seg[i].C[j] = 0 ;
-                    continue ;
-                }  
-
-             // include loss of coherency due to the following effects :
-             // - finite frequency band width
-             // - incertainties on sound speed
-             // - incertainties on source and receiver height
- 
-                double hs = seg[i].hs ;
-                double hr = seg[i].hr ;
-                double dh = fabs (seg[i].dr - seg[i].ds) ;
-
-                double xf = pow (2. , band_width/2) ;
-                
-                double stddev_f = freq[j] * (xf - 1/xf) / 3. ;
-             
-             // modif DVM 28.11.2008 version 2.019
-             // no variation of sound speed with time (this might become an input parameter)
+         // include loss of coherency due to the following effects :
+         // - finite frequency band width
+         // - incertainties on sound speed
+         // - incertainties on source and receiver height
+ 
+            double hs = seg[i].hs ;
+            double hr = seg[i].hr ;
+            double dh = fabs (seg[i].dr - seg[i].ds) ;
+
+         // modif DVM 28.11.2008 version 2.019
+         // no variation of sound speed with time (this might become an input parameter)
              
-                double stddev_c = 0 ;
-                double stddev_s = ((seg[i].index_s == 0)     ? delta_hSource   : 0.00) ;
-                double stddev_r = ((seg[i].index_r == nbSeg) ? delta_hReceiver : 0.00) ;
+            double stddev_c = 0 ;
+            double stddev_s = ((seg[i].index_s == 0)     ? delta_hSource   : 0.00) ;
+            double stddev_r = ((seg[i].index_r == nbSeg) ? delta_hReceiver : 0.00) ;
          
-                double dr = DIST (dh, hs+hr) - DIST(dh, hs-hr) ;
-                double kc  = 2 * PI * freq[j] / c_sound  ;
-                double phi = kc * dr ;
-          
-                double Xf = stddev_f / freq[j] ;
-                double Xc = stddev_c / c_sound ;
-                double Xs = 0 ;
-                double Xr = 0 ;
+            double dr = DIST (dh, hs+hr) - DIST(dh, hs-hr) ;
           
-                if (hs != 0) Xs = stddev_s / hs ;
-                if (Xs >  1) Xs = 1 ;
-                if (hr != 0) Xr = stddev_r / hr ;
-                if (Xr >  1) Xr = 1 ;
-
-                double X = phi * sqrt (Xf * Xf + Xc * Xc + Xs * Xs + Xr * Xr) ;
+            double Xc = stddev_c / c_sound ;
+            double Xs = 0 ;
+            double Xr = 0 ;
           
-                double C1 = exp (-0.5 * X * X) ;
+            if (hs != 0) Xs = stddev_s / hs ;
+            if (Xs >  1) Xs = 1 ;
+            if (hr != 0) Xr = stddev_r / hr ;
+            if (Xr >  1) Xr = 1 ;
 
-             // add loss of coherence due to turbulence (Kolmogorov model)
+         // add loss of coherence due to turbulence (Kolmogorov model)
 
-             // modif DVM 28.11.2008, version 2.019
-             // handle special case hS = hR = 0
+         // modif DVM 28.11.2008, version 2.019
+         // handle special case hS = hR = 0
              
-                double dt = ((hs + hr) == 0) ? 0.0 : (hs * hr / (hs + hr)) ;
-                double C2 = exp (- 0.1365 * c_meteo * kc * kc * pow(fabs(dt),5./3.) * dh) ;
-          
-                seg[i].C[j] = C1 * C2 ;
+            double dt  = ((hs + hr) == 0) ? 0.0 : (hs * hr / (hs + hr)) ;
+            double dt3 = pow(fabs(dt),5./3.) ;
 
+            for (j = 0 ; j < nbFreq ; j++)
+            {
+                double phi = kc[j] * dr ;
+                double X   = phi * sqrt (Xf2[j] + Xc * Xc + Xs * Xs + Xr * Xr) ;
+                e1[j] = -0.5 * X * X ;
+                e2[j] = - 0.1365 * c_meteo * kc[j] * kc[j] * dt3 * dh ;
+            }
+
+            for (j = 0 ; j < nbFreq ; j++)
+            {
+                seg[i].C[j] = (seg[i].w_fresnel[j] == 0) ? 0 : exp (e1[j]) * exp (e2[j]) ;
             }
         }
     }
@@ -1772,6 +1917,8 @@ void PropagationPath::GetCoherence (int i1, int i2)
 
 void PropagationPath::GetReflexion (int is, int ir)
 {
+    StageClock timer (this, STAGE_REFLEXION) ;
+
     int i,j ;
 
  // calculate spherical reflection coefficients for each segment 
@@ -1825,18 +1972,21 @@ void PropagationPath::GetReflexion (int is, int ir)
 // and Imagine consortium as stated in the Consortium's Agreements.
 // --------------------------------------------------------------------------------------------------------
 
-void PropagationPath::GroundEffect (int is, int ir)
+void PropagationPath::GroundEffect (int is, int ir, double *attSEG, int model)
 {
+    StageClock timer (this, STAGE_GROUND_EFFECT) ;
+
     int i, j ;
    
-    Complex attCOH [MAX_FREQ] ;
+    double  attCOHr [MAX_FREQ] ;
+    double  attCOHi [MAX_FREQ] ;
     double  attLIN [MAX_FREQ] ;
     double  attLOG [MAX_FREQ] ;
     double  sumW   [MAX_FREQ] ;
-    double  attSEG [MAX_FREQ] ;
        
     for (j = 0 ; j < nbFreq ; j++) attLIN[j] = 0 ;
-    for (j = 0 ; j < nbFreq ; j++) attCOH[j] = 0 ;
+    for (j = 0 ; j < nbFreq ; j++) attCOHr[j] = 0 ;
+    for (j = 0 ; j < nbFreq ; j++) attCOHi[j] = 0 ;
     for (j = 0 ; j < nbFreq ; j++) attLOG[j] = 0 ;
     for (j = 0 ; j < nbFreq ; j++) sumW[j]   = 0 ;
     
@@ -1862,28 +2012,51 @@ void PropagationPath::GroundEffect (int is, int ir)
     
  // calculate LIN and LOG ground effects; sum contributions using fresnel weighting
 
+
+ // modif 18/10/2026 : the complex quantities are handled as separate real and imaginary parts and 
+ // the contributions of a segment are accumulated for all frequency bands in a loop without branches 
+ // (segments with a zero Fresnel weight add exactly zero), which the compiler vectorizes. Only the 
+ // logarithms of the LOG model are taken in a separate loop. The order of all operations is the same 
+ // as in the original complex arithmetic, so that the results are bit-identical to it (see 
+ // CheckGroundEffect).
+
     for (i = is ; i < ir ; i++)
     {
+        const double *Q = reinterpret_cast<const double*> (seg[i].Q) ;
+        const double *D = reinterpret_cast<const double*> (seg[i].D) ;
+        const double *W = seg[i].w_fresnel ;
+        const double *C = seg[i].C ;
+        double arg [MAX_FREQ] ;
+
         for (j = 0 ; j < nbFreq ; j++)
         {          
-           Complex Q = seg[i].Q[j] * seg[i].D[j] ;
-           double  w = seg[i].w_fresnel[j] ; 
-           double  C = seg[i].C[j] ;
-           if (w > 0)
-           {
-               attLOG[j] += w * LOG10 (norm (1. + C*Q) + (1. - C*C) * norm(Q)) ;
-               attCOH[j] += w * Q * C ;
-               attLIN[j] += w * (1. - C*C) * norm(Q) ;
-               sumW[j]   += w ;
-           }
-       }
+           double re = Q[2*j] * D[2*j]   - Q[2*j+1] * D[2*j+1] ;
+           double im = Q[2*j] * D[2*j+1] + Q[2*j+1] * D[2*j] ;
+           double w  = (W[j] > 0) ? W[j] : 0 ;
+           double q2 = re * re + im * im ;
+           double x  = 1. + C[j] * re ;
+           double y  = C[j] * im ;
+
+           arg[j]     = (x * x + y * y) + (1. - C[j]*C[j]) * q2 ;
+           attCOHr[j] += w * re * C[j] ;
+           attCOHi[j] += w * im * C[j] ;
+           attLIN[j]  += w * (1. - C[j]*C[j]) * q2 ;
+           sumW[j]    += w ;
+        }
+
+        for (j = 0 ; j < nbFreq ; j++)
+        {
+           if (W[j] > 0) attLOG[j] += W[j] * LOG10 (arg[j]) ;
+        }
     }
  
  // LIN model: add coherent + incoherent parts and transform to log values 
 
     for (j = 0 ; j < nbFreq ; j++)
     {
-        attLIN[j] = LOG10 (attLIN[j] + norm (1. + attCOH[j])) ;
+        double x = 1. + attCOHr[j] ;
+        double y = attCOHi[j] ;
+        attLIN[j] = LOG10 (attLIN[j] + (x * x + y * y)) ;
     }
     
  // --------------------------------------------------------------------------------------------
@@ -1897,43 +2070,177 @@ void PropagationPath::GroundEffect (int is, int ir)
     for (j = 0 ; j < nbFreq ; j++)
     {    
          double F = freq[j] / centerFreq ;
-         double X = sumW[j] / sqrt (1 + F * F); 
-         double T = LowpassFilter(X) ;
-         
+         trans[j] = sumW[j] / sqrt (1 + F * F); 
+    }
+
+    for (j = 0 ; j < nbFreq ; j++) trans[j] = LowpassFilter (trans[j]) ;
+
+    for (j = 0 ; j < nbFreq ; j++)
+    {    
+         double T = trans[j] ;
          attSEG[j] = T * attLOG[j] + (1 - T) * attLIN[j] ;            
-         trans[j]  = T ;
     }
 
+#ifdef _TEST_GROUND_EFFECT_
+    CheckGroundEffect (is, ir, attLIN, attLOG, attSEG) ;
+#endif
+
  // save details
  
-    detail[nbDetails].pos_src = is ;
-    detail[nbDetails].pos_rec = ir ;
-    detail[nbDetails].pos_dif = -1 ;
-    detail[nbDetails].model    = ATT_GROUND_LIN ;
-    for (j = 0 ; j < nbFreq ; j++) detail[nbDetails].att[j] = attLIN[j] ;
-    nbDetails++ ;
+    if (options & enableDetails)
+    {
+        SaveDetail (ATT_GROUND_LIN, is, -1, ir, attLIN) ;
+        SaveDetail (ATT_GROUND_LOG, is, -1, ir, attLOG) ;
+        SaveDetail (ATT_TRANS_LIN_LOG, is, -1, ir, trans) ;
+        SaveDetail (model, is, -1, ir, attSEG) ;
+    }
+} ;
 
-    detail[nbDetails].pos_src = is ;
-    detail[nbDetails].pos_rec = ir ;
-    detail[nbDetails].pos_dif = -1 ;
-    detail[nbDetails].model    = ATT_GROUND_LOG ;
-    for (j = 0 ; j < nbFreq ; j++) detail[nbDetails].att[j] = attLOG[j] ;
-    nbDetails++ ;
+#ifdef _TEST_GROUND_EFFECT_
 
-    detail[nbDetails].pos_src = is ;
-    detail[nbDetails].pos_rec = ir ;
-    detail[nbDetails].pos_dif = -1 ;
-    detail[nbDetails].model    = ATT_TRANS_LIN_LOG ;
-    for (j = 0 ; j < nbFreq ; j++) detail[nbDetails].att[j] = trans[j] ;
-    nbDetails++ ;
+// --------------------------------------------------------------------------------------------------------
+// Exact-match test of the ground effect kernels (build with -D_TEST_GROUND_EFFECT_)
+//
+// GroundEffect and GetCoherence accumulate over all frequency bands at once. CheckGroundEffect repeats 
+// the calculation of each GroundEffect call band by band with the original complex arithmetic and counts 
+// the results that are not bit-identical. The check is enabled and the counters are read with 
+// P2P_CheckGroundEffect (single-threaded use only, the counters are shared by all engines).
+// --------------------------------------------------------------------------------------------------------
 
-    detail[nbDetails].pos_src = is ;
-    detail[nbDetails].pos_rec = ir ;
-    detail[nbDetails].pos_dif = -1 ;
-    detail[nbDetails].model    = ATT_GROUND ;
-    for (j = 0 ; j < nbFreq ; j++) detail[nbDetails].att[j] = attSEG[j] ;
-    nbDetails++ ;
-} ;
+static bool groundCheckEnabled = false ;
+static int  nbGroundChecks = 0 ;
+static int  nbGroundValues = 0 ;
+static int  nbGroundDiffs  = 0 ;
+
+int P2P_CheckGroundEffect (bool enable, int *nb_calls, int *nb_values)
+{
+    if (nb_calls)  *nb_calls  = nbGroundChecks ;
+    if (nb_values) *nb_values = nbGroundValues ;
+    int nb_diffs = nbGroundDiffs ;
+
+    groundCheckEnabled = enable ;
+    nbGroundChecks = nbGroundValues = nbGroundDiffs = 0 ;
+    return nb_diffs ;
+}
+
+static void CompareGroundEffect (const char *name, int is, int ir, int j, double x, double ref)
+{
+    nbGroundValues++ ;
+    if (memcmp (&x, &ref, sizeof(double)) == 0) return ;
+    if (x != x && ref != ref) return ;
+    if (nbGroundDiffs++ < 10)
+    {
+        fprintf (stderr, "ground effect check: %s [%d-%d] band %d : %.17g <> %.17g\n", name, is, ir, j, x, ref) ;
+    }
+}
+
+// original calculation of the coherence factor of segment i in band j
+
+double PropagationPath::ScalarCoherence (int i, int j)
+{
+    if (!(options & enableAveraging)) return 1 ;
+    if (seg[i].w_fresnel[j] == 0) return 0 ;
+
+ // include loss of coherency due to the following effects :
+ // - finite frequency band width
+ // - incertainties on sound speed
+ // - incertainties on source and receiver height
+ 
+    double hs = seg[i].hs ;
+    double hr = seg[i].hr ;
+    double dh = fabs (seg[i].dr - seg[i].ds) ;
+
+    double xf = pow (2. , band_width/2) ;
+    
+    double stddev_f = freq[j] * (xf - 1/xf) / 3. ;
+ 
+ // modif DVM 28.11.2008 version 2.019
+ // no variation of sound speed with time (this might become an input parameter)
+ 
+    double stddev_c = 0 ;
+    double stddev_s = ((seg[i].index_s == 0)     ? delta_hSource   : 0.00) ;
+    double stddev_r = ((seg[i].index_r == nbSeg) ? delta_hReceiver : 0.00) ;
+         
+    double dr = DIST (dh, hs+hr) - DIST(dh, hs-hr) ;
+    double kc  = 2 * PI * freq[j] / c_sound  ;
+    double phi = kc * dr ;
+          
+    double Xf = stddev_f / freq[j] ;
+    double Xc = stddev_c / c_sound ;
+    double Xs = 0 ;
+    double Xr = 0 ;
+          
+    if (hs != 0) Xs = stddev_s / hs ;
+    if (Xs >  1) Xs = 1 ;
+    if (hr != 0) Xr = stddev_r / hr ;
+    if (Xr >  1) Xr = 1 ;
+
+    double X = phi * sqrt (Xf * Xf + Xc * Xc + Xs * Xs + Xr * Xr) ;
+          
+    double C1 = exp (-0.5 * X * X) ;
+
+ // add loss of coherence due to turbulence (Kolmogorov model)
+
+ // modif DVM 28.11.2008, version 2.019
+ // handle special case hS = hR = 0
+ 
+    double dt = ((hs + hr) == 0) ? 0.0 : (hs * hr / (hs + hr)) ;
+    double C2 = exp (- 0.1365 * c_meteo * kc * kc * pow(fabs(dt),5./3.) * dh) ;
+          
+    return C1 * C2 ;
+}
+
+void PropagationPath::CheckGroundEffect (int is, int ir, const double *attLIN, const double *attLOG, const double *attSEG)
+{
+    int i, j ;
+
+    if (!groundCheckEnabled) return ;
+    nbGroundChecks++ ;
+
+    Complex refCOH [MAX_FREQ] ;
+    double  refLIN [MAX_FREQ] ;
+    double  refLOG [MAX_FREQ] ;
+    double  refW   [MAX_FREQ] ;
+
+    for (j = 0 ; j < nbFreq ; j++) refLIN[j] = 0 ;
+    for (j = 0 ; j < nbFreq ; j++) refCOH[j] = 0 ;
+    for (j = 0 ; j < nbFreq ; j++) refLOG[j] = 0 ;
+    for (j = 0 ; j < nbFreq ; j++) refW[j]   = 0 ;
+
+    for (i = is ; i < ir ; i++)
+    {
+        for (j = 0 ; j < nbFreq ; j++)
+        {          
+           CompareGroundEffect ("coherence", is, ir, j, seg[i].C[j], ScalarCoherence (i, j)) ;
+
+           Complex Q = seg[i].Q[j] * seg[i].D[j] ;
+           double  w = seg[i].w_fresnel[j] ; 
+           double  C = ScalarCoherence (i, j) ;
+           if (w > 0)
+           {
+               refLOG[j] += w * LOG10 (norm (1. + C*Q) + (1. - C*C) * norm(Q)) ;
+               refCOH[j] += w * Q * C ;
+               refLIN[j] += w * (1. - C*C) * norm(Q) ;
+               refW[j]   += w ;
+           }
+       }
+    }
+ 
+    for (j = 0 ; j < nbFreq ; j++)
+    {
+        refLIN[j] = LOG10 (refLIN[j] + norm (1. + refCOH[j])) ;
+
+        double F = freq[j] / centerFreq ;
+        double X = refW[j] / sqrt (1 + F * F); 
+        double T = LowpassFilter(X) ;
+         
+        CompareGroundEffect ("LIN", is, ir, j, attLIN[j], refLIN[j]) ;
+        CompareGroundEffect ("LOG", is, ir, j, attLOG[j], refLOG[j]) ;
+        CompareGroundEffect ("ground", is, ir, j, attSEG[j], T * refLOG[j] + (1 - T) * refLIN[j]) ;
+    }
+}
+
+#endif
 
 // --------------------------------------------------------------------------------------------------------
 // ExcessAttenuation
@@ -1946,6 +2253,8 @@ void PropagationPath::GroundEffect (int is, int ir)
 
 void PropagationPath::ExcessAttenuation (void)
 {
+    StageClock timer (this, STAGE_EXCESS_ATTENUATION) ;
+
 // initialize segment data
 
     for (int i = 0 ; i <= nbSeg ; i++)
@@ -1959,29 +2268,11 @@ void PropagationPath::ExcessAttenuation (void)
     
  // decompose problem and recursively calculate diffraction and ground effects
 
-    FindConvexHull (0, nbSeg) ;
-
- // cumulate ground & diffraction effects to obtain total excess attenuation
+ // ground & diffraction effects are cumulated in the result to obtain total excess attenuation
 
-    int npos = nbDetails++ ;
+    for (int j = 0 ; j < nbFreq ; j++) result[j] = 0 ;
 
-    detail[npos].model = ATT_EXCESS_GLOBAL ;
-    detail[npos].pos_src = 0 ;
-    detail[npos].pos_rec = nbSeg ;
-    detail[npos].pos_dif = -1 ;
-   
-    for (int j = 0 ; j < nbFreq ; j++) 
-    {
-        detail[npos].att[j] = 0 ;
-   
-        for (int i = 0 ; i < nbDetails-1 ; i++)
-        {
-            if (detail[i].model == ATT_DIFFRACTION || detail[i].model == ATT_GROUND)
-            {
-                detail[npos].att[j] += detail[i].att[j] ;
-            }
-        }
-    }
+    FindConvexHull (0, nbSeg, result) ;
 
 // add scattering 
 
@@ -1993,10 +2284,10 @@ void PropagationPath::ExcessAttenuation (void)
        
        for (int j = 0 ; j < nbFreq ; j++)
        {
-            double A1 = detail[npos].att[j] ;
+            double A1 = result[j] ;
             double A2 = 25 + 10 * log10 (c_meteo) + 3 * log10 (freq[j]/1000) + 10 * log10 (d/100) ;
             double A3 = 10 * log10 (pow(10.,A1/10) + pow(10.,A2/10)) ;
-            detail[npos].att[j] = A3 ;
+            result[j] = A3 ;
         }
     }
     
@@ -2013,9 +2304,13 @@ void PropagationPath::ExcessAttenuation (void)
        
        for (int j = 0 ; j < nbFreq ; j++)
        {
-            detail[npos].att[j] -= abs_air[j] * d ;
+            result[j] -= abs_air[j] * d ;
        }
     }
+
+// save total excess attenuation
+    
+    SaveDetail (ATT_EXCESS_GLOBAL, 0, -1, nbSeg, result) ;
 }
 
 // ---------------------------------------------------------------------------------------------------------
@@ -2073,6 +2368,15 @@ PropagationPath::PropagationPath (void)
     InitAirAbsorption() ;
     
     cpu_timer = 0 ;
+    nbThreads = 1 ;
+    
+    for (int i = 0 ; i < NB_STAGES ; i++)
+    {
+        stage_timer[i].nbCalls = 0 ;
+        stage_timer[i].depth   = 0 ;
+        stage_timer[i].total   = 0 ;
+        stage_timer[i].max     = 0 ;
+    }
 }
 
 // --------------------------------------------------------------------------------------------------------
@@ -2093,7 +2397,7 @@ PropagationPath::~PropagationPath (void)
 // and Imagine consortium as stated in the Consortium's Agreements.
 // --------------------------------------------------------------------------------------------------------
 
-int PropagationPath::DoPointToPoint (void)
+void PropagationPath::ResetResults (void)
 {
 // reset results
 
@@ -2107,6 +2411,13 @@ int PropagationPath::DoPointToPoint (void)
     p4.name = "" ; p4.value = 0.0 ;
     p5.name = "" ; p5.value = 0.0 ;
     p6.name = "" ; p6.value = 0.0 ;
+}
+
+int PropagationPath::DoPointToPoint (void)
+{
+// reset results and debug
+
+    ResetResults() ;
  
  // error checking
  
@@ -2130,41 +2441,128 @@ int PropagationPath::DoPointToPoint (void)
 } ;
 
 // --------------------------------------------------------------------------------------------------------
-// default impedances models
+// Cache of Delany & Bazley impedance spectra
+//
+// The impedance spectra only depend on the flow resistivity, the layer thickness, the sound speed and the
+// frequency array. They are calculated once per process and shared (read-only) between all engines, so 
+// that creating an engine, changing its frequency array or (re)defining the same ground classes costs a
+// lookup and a copy of the spectrum. The cache is protected by a lock and limited in size ; if full, the 
+// spectra are calculated without being stored.
 // --------------------------------------------------------------------------------------------------------
 
-static const int nbDefaultSigma = 9 ;
-static double defaultSigma[nbDefaultSigma] =
+struct ImpedanceSpectrum
 {
-    500, 12.5, 32, 80, 200, 500, 2000, 20000, 200000
+    double  sigma ;
+    double  thickness ;
+    double  c_sound ;
+    int     nbFreq ;
+    double  freq [MAX_FREQ] ;
+    Complex Z [MAX_FREQ] ;
+    ImpedanceSpectrum* next ;
 } ;
 
-// --------------------------------------------------------------------------------------------------------
-// Fill in default impedances 
-//
-// See also : constants defined in PointToPoint.hpp
-// 
-// Copyright CSTB, 2002-2007, all rights reserved. Special conditions apply to members of the Harmonoise
-// and Imagine consortium as stated in the Consortium's Agreements.
-// --------------------------------------------------------------------------------------------------------
+static const int nbImpedanceBuckets = 256 ;
+static const int maxImpedanceSpectra = 1024 ;
 
-void PropagationPath::InitImpedances (void)
-{
- // fill in default sigma class values
- 
+static ImpedanceSpectrum* impedanceCache [nbImpedanceBuckets] ;
+static int nbImpedanceSpectra = 0 ;
+
+#ifdef WIN32
+static SRWLOCK impedanceLock = SRWLOCK_INIT ;
+#define LockImpedanceCache()   AcquireSRWLockExclusive (&impedanceLock)
+#define UnlockImpedanceCache() ReleaseSRWLockExclusive (&impedanceLock)
+#else
+static pthread_mutex_t impedanceLock = PTHREAD_MUTEX_INITIALIZER ;
+#define LockImpedanceCache()   pthread_mutex_lock (&impedanceLock)
+#define UnlockImpedanceCache() pthread_mutex_unlock (&impedanceLock)
+#endif
+
+static unsigned int HashImpedance (double sigma, double thickness, double c, int nbFreq, const double *freq)
+{
+    double key[3] = { sigma, thickness, c } ;
+    const unsigned char *b = (const unsigned char *) key ;
+
+    unsigned int h = 2166136261u + nbFreq ;
+    for (unsigned int i = 0 ; i < sizeof(key) ; i++) h = (h ^ b[i]) * 16777619u ;
+    b = (const unsigned char *) freq ;
+    for (unsigned int i = 0 ; i < nbFreq * sizeof(double) ; i++) h = (h ^ b[i]) * 16777619u ;
+    return h % nbImpedanceBuckets ;
+}
+
+static void GetImpedanceSpectrum (double sigma, double thickness, double c, int nbFreq, const double *freq, Complex *Z)
+{
+    unsigned int h = HashImpedance (sigma, thickness, c, nbFreq, freq) ;
+
+    LockImpedanceCache() ;
+    for (ImpedanceSpectrum *s = impedanceCache[h] ; s != 0 ; s = s->next)
+    {
+        if (s->sigma == sigma && s->thickness == thickness && s->c_sound == c && s->nbFreq == nbFreq
+            && memcmp (s->freq, freq, nbFreq * sizeof(double)) == 0)
+        {
+            memcpy (Z, s->Z, nbFreq * sizeof(Complex)) ;
+            UnlockImpedanceCache() ;
+            return ;
+        }
+    }
+    UnlockImpedanceCache() ;
+
+    for (int j = 0 ; j < nbFreq ; j++) Z[j] = impedance_D_and_B (sigma, thickness, freq[j], c) ;
+
+ // store the new spectrum, unless another engine did so in the mean time
+
+    LockImpedanceCache() ;
+    bool found = false ;
+    for (ImpedanceSpectrum *s = impedanceCache[h] ; s != 0 && !found ; s = s->next)
+    {
+        found = (s->sigma == sigma && s->thickness == thickness && s->c_sound == c && s->nbFreq == nbFreq
+                 && memcmp (s->freq, freq, nbFreq * sizeof(double)) == 0) ;
+    }
+    if (!found && nbImpedanceSpectra < maxImpedanceSpectra)
+    {
+        ImpedanceSpectrum *s = new ImpedanceSpectrum ;
+        s->sigma = sigma ;
+        s->thickness = thickness ;
+        s->c_sound = c ;
+        s->nbFreq = nbFreq ;
+        memcpy (s->freq, freq, nbFreq * sizeof(double)) ;
+        memcpy (s->Z, Z, nbFreq * sizeof(Complex)) ;
+        s->next = impedanceCache[h] ;
+        impedanceCache[h] = s ;
+        nbImpedanceSpectra++ ;
+    }
+    UnlockImpedanceCache() ;
+}
+
+// --------------------------------------------------------------------------------------------------------
+// default impedances models
+// --------------------------------------------------------------------------------------------------------
+
+static const int nbDefaultSigma = 9 ;
+static double defaultSigma[nbDefaultSigma] =
+{
+    500, 12.5, 32, 80, 200, 500, 2000, 20000, 200000
+} ;
+
+// --------------------------------------------------------------------------------------------------------
+// Fill in default impedances 
+//
+// See also : constants defined in PointToPoint.hpp
+// 
+// Copyright CSTB, 2002-2007, all rights reserved. Special conditions apply to members of the Harmonoise
+// and Imagine consortium as stated in the Consortium's Agreements.
+// --------------------------------------------------------------------------------------------------------
+
+void PropagationPath::InitImpedances (void)
+{
+ // fill in default sigma class values
+ 
     for (int i = 0 ; i < nbDefaultSigma ; i++)
     {
         impedance[i].model = true ;
         impedance[i].sigma = defaultSigma[i] ;
         impedance[i].thickness = 0 ;
         
-        for (int j = 0 ; j < nbFreq ; j++) 
-        {
-           impedance[i].Z[j] = impedance_D_and_B (impedance[i].sigma, 
-                                                  impedance[i].thickness, 
-                                                  freq[j], 
-                                                  c_sound) ;
-        }
+        GetImpedanceSpectrum (impedance[i].sigma, impedance[i].thickness, c_sound, nbFreq, freq, impedance[i].Z) ;
     }
     
     for (int i = groundUserDefined ; i < maxImpedance ; i++)
@@ -2211,6 +2609,8 @@ void AUX_RandomGauss (int n, double *val)
 
 void PropagationPath::CreateSegments (void)
 {
+    StageClock timer (this, STAGE_CREATE_SEGMENTS) ;
+
    double dsr = userSegment[nbUserSegment-1].x ;
 /*   
    double maxLen = 50 ;
@@ -2344,6 +2744,8 @@ void PropagationPath::GetVertex (int i, double &x, double &y)
 
 void PropagationPath::DoCurvature (void)
 {
+    StageClock timer (this, STAGE_CURVATURE) ;
+
     R_meteo = 0 ;
   
     double dSR = seg[nbSeg-1].x2 - seg[0].x1 ;
@@ -2845,13 +3247,7 @@ int P2P_SetImpedanceDB (void* p2p_struct, int index, double sigma, double thickn
     path->impedance[i].sigma = sigma ;
     path->impedance[i].thickness = thickness ;
         
-    for (int j = 0 ; j < path->nbFreq ; j++) 
-    {
-       path->impedance[i].Z[j] = impedance_D_and_B (path->impedance[i].sigma, 
-                                                   path->impedance[i].thickness, 
-                                                   path->freq[j], 
-                                                   path->c_sound) ;
-    }
+    GetImpedanceSpectrum (sigma, thickness, path->c_sound, path->nbFreq, path->freq, path->impedance[i].Z) ;
     
     return index ;
 }
@@ -2967,16 +3363,15 @@ int P2P_GetResults (void* p2p_struct, double *att)
         for (int i = 0 ; i < path->nbFreq ; i++) att[i] = 0 ;
     }
     
-    path->DoPointToPoint() ;
+    int ok = path->DoPointToPoint() ;
     
     if (att != NULL)
     {
-        int npos = path->nbDetails-1 ;
-        if (npos < 0) return 0 ;
+        if (!ok) return 0 ;
        
         for (int i = 0 ; i < path->nbFreq ; i++)
         {
-            att[i] = path->detail[npos].att[i] ;
+            att[i] = path->result[i] ;
         }
     }
     
@@ -3053,6 +3448,43 @@ double P2P_GetTimerCPU (void* p2p_struct, bool reset)
     return ret_val ;
 }
 
+// info: get per-stage timers (only if options & enableProfiling)
+
+int P2P_GetStageTimer (void* p2p_struct, int stage, int *nb_calls, double *total, double *max, bool reset)
+{
+    if (p2p_struct == 0) return 0 ;
+    PropagationPath* path = (PropagationPath *) p2p_struct ;
+
+    if (stage < 0 || stage >= NB_STAGES) return 0 ;
+    
+    StageTimer &timer = path->stage_timer[stage] ;
+    
+    if (nb_calls) *nb_calls = timer.nbCalls ;
+    if (total)    *total    = timer.total ;
+    if (max)      *max      = timer.max ;
+    
+    if (reset)
+    {
+        timer.nbCalls = 0 ;
+        timer.total   = 0 ;
+        timer.max     = 0 ;
+    }
+    
+    return 1 ;
+}
+
+const char* P2P_GetStageName (int stage)
+{
+    static const char* names[NB_STAGES] = 
+    {
+        "CreateSegments", "DoCurvature", "FindConvexHull", "LocalCoordinates", "FresnelWeights",
+        "GetReflexion", "GetDiffraction", "GetCoherence", "GroundEffect", "ExcessAttenuation"
+    } ;
+    
+    if (stage < 0 || stage >= NB_STAGES) return 0 ;
+    return names[stage] ;
+}
+
 // ---------------------------------------------------------------------------------------------------------
 // utility function: get averaged results over N meteorological conditions
 //
@@ -3112,10 +3544,7 @@ int P2P_GetAveragedResults (void* p2p_struct, int nb_cond, double *rd, double *w
         path->a_meteo = path->c_sound * rd[i] / dist ;
         path->b_meteo = 0 ;
     
-        path->DoPointToPoint() ;
-        
-        int npos = path->nbDetails-1 ;
-        if (npos < 0)
+        if (!path->DoPointToPoint())
         {
             free (res) ;
             return 0 ;
@@ -3123,7 +3552,7 @@ int P2P_GetAveragedResults (void* p2p_struct, int nb_cond, double *rd, double *w
         
         for (j = 0 ; j < path->nbFreq ; j++)
         {
-            res[k++] = path->detail[npos].att[j] ;
+            res[k++] = path->result[j] ;
         }
     }        
  
@@ -3188,11 +3617,8 @@ static double invMO[5][5] =
    {  0.00,  0.00, 0.00, 0.00, 0.00 }
 } ;
 
-int P2P_SetupMeteoParameters (void* p2p_struct, double windSpeed, double cosWind, int stabilityClass) 
+static void MeteoProfile (double windSpeed, double cosWind, int stabilityClass, double &A, double &B) 
 {
-    if (p2p_struct == 0) return 0 ;
-    PropagationPath* path = (PropagationPath *) p2p_struct ;
-
     int iWind = 0 ;
     int iStab = stabilityClass ;
     
@@ -3220,9 +3646,761 @@ int P2P_SetupMeteoParameters (void* p2p_struct, double windSpeed, double cosWind
     double AT = CC * (CT * T * L / k - g/Cp) ;
     double BT = CC * 0.74 * T / k ;
 
-    path->a_meteo = AW + AT ;
-    path->b_meteo = BW + BT ;
+    A = AW + AT ;
+    B = BW + BT ;
+}
+
+int P2P_SetupMeteoParameters (void* p2p_struct, double windSpeed, double cosWind, int stabilityClass) 
+{
+    if (p2p_struct == 0) return 0 ;
+    PropagationPath* path = (PropagationPath *) p2p_struct ;
+
+    MeteoProfile (windSpeed, cosWind, stabilityClass, path->a_meteo, path->b_meteo) ;
     
     return 1 ;
 }
 
+// ---------------------------------------------------------------------------------------------------------
+// utility function: get long-term results over a wind rose
+//
+// input :
+//
+//      nb_cond        : number of conditions
+//      windSpeed      : wind speed for each condition
+//      cosWind        : cosine of the angle between the wind and the propagation direction
+//      stabilityClass : stability class (0...4) for each condition
+//      weight         : probability of occurrence of each condition (only needed if att != NULL)
+//      
+// output: 
+//
+//      att_cond       : excess attenuation for each condition, nb_cond x nbFreq values (may be NULL)
+//      att            : weighted long-term excess attenuation (may be NULL)
+//
+// note: the ground profile is only subdivided in the presence of meteorological refraction. The segments 
+// before curvature are therefore created once for the homogeneous and once for the refracting conditions 
+// and copied into the engine before DoCurvature. All further steps (Fresnel weights, reflexion, 
+// diffraction, coherence and ground effect) depend on the curved geometry. The conditions of a wind rose 
+// however largely map onto the same equivalent ray curvature, e.g. all conditions with cross wind and 
+// neutral stability, or all strongly downward refracting conditions for which the curvature is clipped 
+// to the limit of the conformal mapping. Each distinct geometry (key: subdivision of the profile and ray 
+// curvature after DoCurvature) is calculated once and its results copied to the other conditions. 
+//
+// The distinct geometries are shared between nbThreads threads (see P2P_SetNbThreads), each of which 
+// works on its own engine with a copy of the input data. The results are identical to those of calling 
+// P2P_SetupMeteoParameters and P2P_GetResults per condition, whatever the number of threads. Likewise, 
+// the debug parameters and the details are those of the last condition, which is always handled by the 
+// engine of the caller ; if the option enableDetails is set, the last condition is always calculated so 
+// that its details are available. With the randomTerrain option, the segments are created again for each 
+// condition and the conditions are calculated one after the other without any reuse of results.
+// ---------------------------------------------------------------------------------------------------------
+
+const int MAX_THREADS = 64 ;
+
+static int ProcessorCount (void)
+{
+#ifdef WIN32
+    SYSTEM_INFO info ;
+    GetSystemInfo (&info) ;
+    return MAX ((int) info.dwNumberOfProcessors, 1) ;
+#else
+    long n = sysconf (_SC_NPROCESSORS_ONLN) ;
+    return (n > 0) ? (int) n : 1 ;
+#endif
+}
+
+// segments before curvature, without (0) and with (1) subdivision of the profile
+
+struct WindRoseSegments
+{
+    int      nbSeg[2] ;
+    Segment *seg[2] ;
+} ;
+
+// curved geometry of a condition ; without stored segments, they are created as in DoPointToPoint
+
+static void WindRoseGeometry (PropagationPath *path, const WindRoseSegments *flat, double a, double b)
+{
+    path->a_meteo = a ;
+    path->b_meteo = b ;
+    path->ResetResults() ;
+
+    int split = (a != 0 || b != 0) ;
+    const Segment *s = flat->seg[split] ;
+    
+    if (s == NULL)
+    {
+        path->CreateSegments() ;
+    }
+    else
+    {
+        int nbSeg = flat->nbSeg[split] ;
+        
+        for (int i = 0 ; i < nbSeg ; i++)
+        {
+            path->seg[i].x1 = s[i].x1 ;
+            path->seg[i].y1 = s[i].y1 ;
+            path->seg[i].x2 = s[i].x2 ;
+            path->seg[i].y2 = s[i].y2 ;
+            path->seg[i].ground = s[i].ground ;
+        }
+        path->seg[nbSeg].x1 = s[nbSeg].x1 ;
+        path->seg[nbSeg].y1 = s[nbSeg].y1 ;
+        path->nbSeg = nbSeg ;
+    }
+    
+    path->DoCurvature() ;
+}
+
+// engine of a worker thread : copy of the input data of the caller's engine, without details
+
+static PropagationPath* WindRoseEngine (const PropagationPath *path)
+{
+    PropagationPath *copy = new PropagationPath() ;
+    
+    copy->nbFreq = path->nbFreq ;
+    memcpy (copy->freq, path->freq, sizeof(path->freq)) ;
+    copy->band_width = path->band_width ;
+    copy->options = path->options & ~enableDetails ;
+    
+    copy->hSource = path->hSource ;
+    copy->hReceiver = path->hReceiver ;
+    copy->delta_hSource = path->delta_hSource ;
+    copy->delta_hReceiver = path->delta_hReceiver ;
+    
+    copy->c_sound = path->c_sound ;
+    copy->c_meteo = path->c_meteo ;
+    copy->d_meteo = path->d_meteo ;
+    memcpy (copy->abs_air, path->abs_air, sizeof(path->abs_air)) ;
+    
+    copy->nbImpedance = path->nbImpedance ;
+    memcpy (copy->impedance, path->impedance, path->nbImpedance * sizeof(Impedance)) ;
+    
+    return copy ;
+}
+
+// work of a thread : conditions todo[first], todo[first+step]... each thread writes its own rows of res
+
+struct WindRoseWorker
+{
+    PropagationPath        *path ;
+    const WindRoseSegments *flat ;
+    const double           *a ;
+    const double           *b ;
+    const int              *todo ;
+    int                     nb_todo ;
+    int                     first ;
+    int                     step ;
+    double                 *res ;
+} ;
+
+static void WindRoseWork (WindRoseWorker *work)
+{
+    PropagationPath *path = work->path ;
+    int nbFreq = path->nbFreq ;
+    
+    for (int k = work->first ; k < work->nb_todo ; k += work->step)
+    {
+        int i = work->todo[k] ;
+        WindRoseGeometry (path, work->flat, work->a[i], work->b[i]) ;
+        path->ExcessAttenuation() ;
+        memcpy (work->res + i * nbFreq, path->result, nbFreq * sizeof(double)) ;
+    }
+}
+
+#ifdef WIN32
+static DWORD WINAPI WindRoseThread (LPVOID arg)
+{
+    WindRoseWork ((WindRoseWorker *) arg) ;
+    return 0 ;
+}
+#else
+static void* WindRoseThread (void* arg)
+{
+    WindRoseWork ((WindRoseWorker *) arg) ;
+    return 0 ;
+}
+#endif
+
+// run the workers, the first one in the calling thread ; if a thread cannot be started, its work is done
+// in the calling thread
+
+static void WindRoseParallel (int nb_threads, WindRoseWorker *work)
+{
+    int k ;
+    
+#ifdef WIN32
+    HANDLE    thread[MAX_THREADS] ;
+#else
+    pthread_t thread[MAX_THREADS] ;
+#endif
+    bool      started[MAX_THREADS] ;
+
+    for (k = 1 ; k < nb_threads ; k++)
+    {
+#ifdef WIN32
+        thread[k] = CreateThread (NULL, 0, WindRoseThread, &work[k], 0, NULL) ;
+        started[k] = (thread[k] != 0) ;
+#else
+        started[k] = (pthread_create (&thread[k], NULL, WindRoseThread, &work[k]) == 0) ;
+#endif
+        if (!started[k]) WindRoseWork (&work[k]) ;
+    }
+    
+    WindRoseWork (&work[0]) ;
+    
+    for (k = 1 ; k < nb_threads ; k++)
+    {
+        if (!started[k]) continue ;
+#ifdef WIN32
+        WaitForSingleObject (thread[k], INFINITE) ;
+        CloseHandle (thread[k]) ;
+#else
+        pthread_join (thread[k], NULL) ;
+#endif
+    }
+}
+
+int P2P_GetWindRoseResults (void* p2p_struct, int nb_cond, const double *windSpeed, const double *cosWind, 
+                            const int *stabilityClass, const double *weight, double *att_cond, double *att)
+{
+    int i,j,k ;
+
+    if (p2p_struct == 0) return 0 ;
+    PropagationPath* path = (PropagationPath *) p2p_struct ;
+
+    time_t start = clock() ;
+    
+ // default return value, no details or debug parameters left over from earlier calls
+ 
+    path->ResetResults() ;
+    int nbFreq = path->nbFreq ;
+    if (att != NULL)
+    {
+        for (j = 0 ; j < nbFreq ; j++) att[j] = 0 ;
+    }
+    
+ // check arguments
+ 
+    if (nb_cond < 1 || windSpeed == NULL || cosWind == NULL || stabilityClass == NULL) return 0 ;
+    if (att != NULL && weight == NULL) return 0 ;
+    if (nbFreq < 1 || path->nbUserSegment < 1) return 0 ;
+    
+    for (i = 0 ; i < nb_cond ; i++)
+    {
+        if (stabilityClass[i] < 0 || stabilityClass[i] > 4) return 0 ;
+    }
+
+    double sum_w = 0 ;
+    if (att != NULL)
+    {
+        for (i = 0 ; i < nb_cond ; i++) sum_w += weight[i] ;
+        if (sum_w <= 0) return 0 ;
+    }
+    
+ // allocate buffers : results (unless provided by the caller), sound speed profile, geometry key and 
+ // origin of the results for each condition, conditions to be calculated by the worker threads
+ 
+    double *res = (att_cond != NULL) ? att_cond : (double *) malloc (nb_cond * nbFreq * sizeof(double)) ;
+    double *cond_a = (double *) malloc (nb_cond * sizeof(double)) ;
+    double *cond_b = (double *) malloc (nb_cond * sizeof(double)) ;
+    double *key_R = (double *) malloc (nb_cond * sizeof(double)) ;
+    int *key_split = (int *) malloc (nb_cond * sizeof(int)) ;
+    int *origin = (int *) malloc (nb_cond * sizeof(int)) ;
+    int *todo = (int *) malloc (nb_cond * sizeof(int)) ;
+    
+    WindRoseSegments flat ;
+    flat.seg[0] = flat.seg[1] = NULL ;
+    flat.nbSeg[0] = flat.nbSeg[1] = 0 ;
+    
+    bool ok = (res != NULL && cond_a != NULL && cond_b != NULL && key_R != NULL && key_split != NULL && 
+               origin != NULL && todo != NULL) ;
+
+    double a_save = path->a_meteo ;
+    double b_save = path->b_meteo ;
+    bool reuse = (path->options & randomTerrain) == 0 ;
+    bool details = (path->options & enableDetails) != 0 ;
+    int nb_todo = 0 ;
+
+ // segments before curvature (unless the random terrain option is set) and geometry key of each 
+ // condition ; the results of a condition are calculated unless an earlier condition has the same key
+    
+    for (i = 0 ; i < nb_cond && ok ; i++)
+    {
+        MeteoProfile (windSpeed[i], cosWind[i], stabilityClass[i], cond_a[i], cond_b[i]) ;
+        
+        int split = (cond_a[i] != 0 || cond_b[i] != 0) ;
+        if (reuse && flat.seg[split] == NULL)
+        {
+            path->a_meteo = cond_a[i] ;
+            path->b_meteo = cond_b[i] ;
+            path->CreateSegments() ;
+            
+            size_t size = (path->nbSeg + 1) * sizeof(Segment) ;
+            flat.seg[split] = (Segment *) malloc (size) ;
+            if (flat.seg[split] == NULL) 
+            {
+                ok = false ;
+                break ;
+            }
+            memcpy (flat.seg[split], path->seg, size) ;
+            flat.nbSeg[split] = path->nbSeg ;
+        }
+        
+        k = i ;
+        if (reuse)
+        {
+            WindRoseGeometry (path, &flat, cond_a[i], cond_b[i]) ;
+            key_split[i] = split ;
+            key_R[i] = path->R_meteo ;
+            
+            for (k = 0 ; k < i ; k++)
+            {
+                if (key_split[k] == key_split[i] && key_R[k] == key_R[i]) break ;
+            }
+        }
+        
+        origin[i] = (k < i && !(details && i == nb_cond - 1)) ? k : i ;
+        if (origin[i] == i && i < nb_cond - 1) todo[nb_todo++] = i ;
+    }
+    
+ // calculate the distinct geometries, except the last condition : in the calling thread if there is 
+ // only one thread or with the random terrain option, otherwise by the worker threads
+ 
+    if (ok)
+    {
+        int nb_threads = (path->nbThreads > 0) ? path->nbThreads : ProcessorCount() ;
+        nb_threads = MIN (MIN (nb_threads, nb_todo), MAX_THREADS) ;
+        if (!reuse) nb_threads = 1 ;
+
+        WindRoseWorker work[MAX_THREADS] ;
+        for (k = 0 ; k < MAX (nb_threads, 1) ; k++)
+        {
+            work[k].path = (k == 0) ? path : WindRoseEngine (path) ;
+            work[k].flat = &flat ;
+            work[k].a = cond_a ;
+            work[k].b = cond_b ;
+            work[k].todo = todo ;
+            work[k].nb_todo = nb_todo ;
+            work[k].first = k ;
+            work[k].step = MAX (nb_threads, 1) ;
+            work[k].res = res ;
+        }
+        
+        if (nb_threads > 1)
+        {
+            WindRoseParallel (nb_threads, work) ;
+        }
+        else
+        {
+            WindRoseWork (&work[0]) ;
+        }
+
+     // the worker threads add their stage timers to those of the caller's engine
+     
+        for (k = 1 ; k < nb_threads ; k++)
+        {
+            if (path->options & enableProfiling)
+            {
+                for (j = 0 ; j < NB_STAGES ; j++)
+                {
+                    StageTimer &timer = path->stage_timer[j] ;
+                    StageTimer &other = work[k].path->stage_timer[j] ;
+                    timer.nbCalls += other.nbCalls ;
+                    timer.total   += other.total ;
+                    timer.max      = MAX (timer.max, other.max) ;
+                }
+            }
+            delete work[k].path ;
+        }
+        
+     // the last condition leaves its details and debug parameters in the caller's engine
+
+        i = nb_cond - 1 ;
+        WindRoseGeometry (path, &flat, cond_a[i], cond_b[i]) ;
+        if (origin[i] == i)
+        {
+            path->ExcessAttenuation() ;
+            memcpy (res + i * nbFreq, path->result, nbFreq * sizeof(double)) ;
+        }
+        
+     // copy the results of the conditions with the same geometry as an earlier one
+        
+        for (i = 0 ; i < nb_cond ; i++)
+        {
+            if (origin[i] != i) memcpy (res + i * nbFreq, res + origin[i] * nbFreq, nbFreq * sizeof(double)) ;
+        }
+    }
+    
+    path->a_meteo = a_save ;
+    path->b_meteo = b_save ;
+ 
+ // calculate long-term result
+ 
+    if (ok && att != NULL)
+    {
+        for (i = 0 ; i < nb_cond ; i++)
+        for (j = 0 ; j < nbFreq ; j++) 
+        {
+            att[j] += weight[i] * pow (10, 0.1 * res[i * nbFreq + j]) ;
+        }
+        for (j = 0 ; j < nbFreq ; j++) 
+        {
+            att[j] = 10 * log10 (att[j] / sum_w) ;
+        }
+    }
+
+    if (res != att_cond) free (res) ;
+    free (cond_a) ;
+    free (cond_b) ;
+    free (key_R) ;
+    free (key_split) ;
+    free (origin) ;
+    free (todo) ;
+    free (flat.seg[0]) ;
+    free (flat.seg[1]) ;
+
+    path->cpu_timer += (clock() - start) ;
+    
+    return ok ? 1 : 0 ;
+}
+
+// number of threads of P2P_GetWindRoseResults (0 : one thread per processor)
+
+int P2P_SetNbThreads (void* p2p_struct, int nb_threads)
+{
+    if (p2p_struct == 0) return 0 ;
+    PropagationPath* path = (PropagationPath *) p2p_struct ;
+    
+    if (nb_threads < 0) return 0 ;
+    
+    path->nbThreads = nb_threads ;
+    return 1 ;
+}
+
+int P2P_GetNbThreads (void* p2p_struct)
+{
+    if (p2p_struct == 0) return 0 ;
+    PropagationPath* path = (PropagationPath *) p2p_struct ;
+    return path->nbThreads ;
+}
+
+#ifdef _TEST_SPECIAL_FUNCTIONS_
+
+// --------------------------------------------------------------------------------------------------------
+// Accuracy and speed of the special functions (build with -D_TEST_SPECIAL_FUNCTIONS_)
+//
+// The original implementations of Fref, Qref and HaddenPierce are kept below as a reference. For each
+// function, P2P_TestSpecialFunctions evaluates both versions over a grid of arguments covering the range 
+// used by the engine, prints the maximum absolute and relative deviation and the CPU time per call, and 
+// counts the functions that exceed the given relative deviation or return NaN where the original does not.
+// --------------------------------------------------------------------------------------------------------
+
+static Complex FrefReference (Complex z)
+{
+   Complex  j(0,1) ;
+   Complex  erf ;
+
+// first we calculate w(z) = exp(-z^2) * erfc(-j*z) for (x > 0, y > 0)
+
+   double  x  = z.real() ;
+   double  y  = z.imag() ;
+
+// approximations for large values of the arguments 
+
+   if (fabs(x) > 3.9 || fabs(y) > 3)
+   {
+      Complex z1 = Complex (fabs(x), fabs(y));
+      Complex z2 = z1 * z1 ; 
+      
+      if ( fabs(x) > 6. || fabs(y) > 6. )
+      {
+          erf = j * z1 * (0.5124242 / (z2 - 0.2752551) + 0.05176536 / (z2 - 2.724745)) ;
+      } 
+      else   
+      {
+          erf = j * z1 * (0.461313500 / (z2 - 0.1901635) 
+                        + 0.099992160 / (z2 - 1.7844927) 
+                        + 0.002883894 / (z2 - 5.5253437)) ;
+      }
+      
+   // careful about the signs here !   
+
+      if (x < 0) erf = conj(erf) ;
+      if (y < 0) erf = 2 * exp(y*y-x*x) * Complex(cos(2*x*y), -sin(2*x*y)) - conj(erf) ;
+   }
+   
+// series development for small values of x and y
+
+   else
+   {
+      double h  = 0.8;
+      double a1 = cos (2*x*y);
+      double b1 = sin (2*x*y);
+      double c1 = exp (-2*y*PI/h) - cos(2*x*PI/h);
+      double d1 = sin (2*x*PI/h);
+      double cd = c1*c1 + d1*d1;
+      double p2,q2 ;
+
+      if (cd == 0)
+      {
+         p2 = q2 = 1;
+      }
+      else
+      {
+         p2 = 2 * exp (-1*(x*x+2*y*PI/h-y*y))*(a1*c1-b1*d1) / cd;
+         q2 = 2 * exp (-1*(x*x+2*y*PI/h-y*y))*(a1*d1+b1*c1) / cd;
+      }
+
+      double eh = 0.000001 ;
+      double h1 = 0 ;
+      double h2 = 0 ;
+      for (int n = 1 ; n <= 5 ; n++)
+      {
+         double x1 = (y*y+x*x+n*n*h*h);
+         double x2 = (y*y-x*x+n*n*h*h);
+         double x3 = (y*y+x*x-n*n*h*h);
+         h1 += exp(-1*(n*n)*h*h)*x1/(x2*x2+4*y*y*x*x);
+         h2 += exp(-1*(n*n)*h*h)*x3/(x2*x2+4*y*y*x*x);
+      }
+
+      double hyx = h*y / (PI*(x*x+y*y)) + 2*y*h*h1/PI - y*eh/PI;
+      double kyx = h*x / (PI*(x*x+y*y)) + 2*x*h*h2/PI + x*eh/PI;
+
+      if (y < PI/h)
+      {
+         hyx = hyx + p2;
+         kyx = kyx - q2;
+      }
+
+      if (y == PI/h)
+      {
+         hyx = hyx + 0.5 * p2;
+         kyx = kyx - 0.5 * q2;
+      }
+
+      erf = Complex (hyx, kyx) ;
+   }
+
+// now return Fref(w) = 1 + j * sqrt(PI) * z * [exp(-z^2) * erfc(-j*z)]
+
+   Complex ret_val = 1. + j * sqrt(PI) * z * erf ;
+
+   return ret_val ;
+}
+
+static Complex QrefReference (Complex Z, double cos_teta, double kr, double N)
+{
+   Complex  j(0,1) ;
+
+// plane wave reflection coefficient   
+
+   Complex Rp = (Z * cos_teta - 1.) / (Z * cos_teta + 1.) ;
+   
+// correction for spherical reflection, parameter w = (1+j)/2 * sqrt(kr) * (cos(teta)+1./z)
+
+   Complex w = (j+1.)/2. * sqrt(kr) * (cos_teta + 1./Z) ;
+   
+// spherical reflection coefficient
+
+   Complex Qc = Rp + (1. - Rp) * pow (FrefReference(w), N) ;
+
+   return Qc ;
+}
+
+static Complex HaddenPierceReference (double beta, double teta, double Rs, double Rr, double k, bool include_direct)
+{
+    double r  = Rs + Rr ;
+    double nu = PI / beta ;
+    double at = (teta - beta - PI) * nu / 2 ;
+    if (teta < PI) at += PI ;
+
+    double aa = fabs(at) ;
+    double ct = cos (aa) ;
+    double cn = sqrt (nu * nu + (2 * Rs * Rr / (r * r) + 0.5) * ct * ct) ; 
+    double b  = sqrt (4 * k * Rs * Rr / (PI * r)) * ct / cn;
+
+    Complex ad = FresnelAux (b) ;
+
+    Complex ep = exp (Complex (0, PI/4)) ;
+
+ // modif DVM 14.04.2003 : special case sin(x)/x as x tends to 0
+
+    double sin_aa = sin(aa) ;
+    if (sin_aa < 1.E-5) sin_aa = 1 ; else sin_aa /= aa ;
+
+    Complex en = (PI/sqrt(2.)) * (sin_aa) * ep * ad / (cn / nu) ;
+
+    Complex pd = -1/(PI * r) * at * en * exp(Complex(0,k*r)) ;
+
+ // modif DVM 18.10.2003 : add optical field if requested
+ 
+    if (include_direct && (teta < PI))
+    {
+       double rd = sqrt (Rs * Rs + Rr * Rr - 2 * Rs * Rr * cos(teta)) ;
+       pd += (1/rd) * exp (Complex (0, k * rd)) ;
+    }
+    
+    return pd ;
+}
+
+struct SpecialFunctionStat
+{
+    const char* name ;
+    int         nbCalls ;
+    double      maxAbsError ;
+    double      maxRelError ;
+    int         nbNaN ;
+    double      timeRef ;
+    double      timeFast ;
+} ;
+
+static void CompareSpecialFunction (SpecialFunctionStat &stat, Complex fast, Complex ref)
+{
+    double err = abs (fast - ref) ;
+    if (err != err)
+    {
+        if (abs (fast) == abs (fast) || abs (ref) == abs (ref)) stat.nbNaN++ ;
+        return ;
+    }
+    if (err > stat.maxAbsError) stat.maxAbsError = err ;
+    if (abs (ref) > 0 && err / abs(ref) > stat.maxRelError) stat.maxRelError = err / abs(ref) ;
+}
+
+static int PrintSpecialFunction (const SpecialFunctionStat &stat, double tolerance)
+{
+    printf ("%-14s %8d %10.1f %10.1f %12.3g %12.3g %6d\n", stat.name, stat.nbCalls, 
+            1.E9 * stat.timeRef / stat.nbCalls, 1.E9 * stat.timeFast / stat.nbCalls, 
+            stat.maxAbsError, stat.maxRelError, stat.nbNaN) ;
+    return (stat.maxRelError > tolerance || stat.nbNaN > 0) ? 1 : 0 ;
+}
+
+int P2P_TestSpecialFunctions (int nbRepeat, double tolerance)
+{
+    double sum = 0 ;
+    int nbFailed = 0 ;
+
+    printf ("function          calls   ref (ns)  fast (ns)      max abs      max rel    NaN\n") ;
+
+ // Fref : -10 < x,y < 10 (both branches of the approximation, z = 0 excluded)
+ 
+    {
+        SpecialFunctionStat stat = { "Fref", 0, 0, 0, 0, 0, 0 } ;
+        const int n = 200 ;
+        for (int i = 0 ; i < n ; i++)
+        {
+            for (int j = 0 ; j < n ; j++)
+            {
+                Complex z (-10 + 20. * (i + 0.5) / n, -10 + 20. * (j + 0.5) / n) ;
+                CompareSpecialFunction (stat, Fref (z), FrefReference (z)) ;
+            }
+        }
+        clock_t t0 = clock() ;
+        for (int r = 0 ; r < nbRepeat ; r++)
+            for (int i = 0 ; i < n ; i++)
+                for (int j = 0 ; j < n ; j++) sum += FrefReference (Complex (-10 + 20. * (i + 0.5) / n, -10 + 20. * (j + 0.5) / n)).real() ;
+        clock_t t1 = clock() ;
+        for (int r = 0 ; r < nbRepeat ; r++)
+            for (int i = 0 ; i < n ; i++)
+                for (int j = 0 ; j < n ; j++) sum += Fref (Complex (-10 + 20. * (i + 0.5) / n, -10 + 20. * (j + 0.5) / n)).real() ;
+        clock_t t2 = clock() ;
+        stat.nbCalls  = nbRepeat * n * n ;
+        stat.timeRef  = (double) (t1 - t0) / CLOCKS_PER_SEC ;
+        stat.timeFast = (double) (t2 - t1) / CLOCKS_PER_SEC ;
+        nbFailed += PrintSpecialFunction (stat, tolerance) ;
+    }
+
+ // Qref : Delany & Bazley impedances of the default ground classes, all default frequencies,
+ //        0 <= cos(teta) <= 1, 0.01 < kr < 10000 and N = 0.3, 0.65 and 1
+ 
+    {
+        SpecialFunctionStat stat = { "Qref", 0, 0, 0, 0, 0, 0 } ;
+        const int nbCos = 11 ;
+        const int nbKr  = 13 ;
+        const int nbN   = 3 ;
+        int nbFreq = sizeof(defaultFreq) / sizeof(double) ;
+        static Complex Z [nbDefaultSigma * 2][sizeof(defaultFreq) / sizeof(double)] ;
+        for (int i = 0 ; i < 2 * nbDefaultSigma ; i++)
+            for (int j = 0 ; j < nbFreq ; j++) 
+                Z[i][j] = impedance_D_and_B (defaultSigma[i/2], (i % 2) * 0.01, defaultFreq[j]) ;
+
+        for (int r = -1 ; r < nbRepeat ; r++)
+        {
+            for (int fast = 0 ; fast < 2 ; fast++)
+            {
+                clock_t t0 = clock() ;
+                for (int i = 0 ; i < 2 * nbDefaultSigma ; i++)
+                for (int j = 0 ; j < nbFreq ; j++)
+                for (int c = 0 ; c < nbCos ; c++)
+                for (int k = 0 ; k < nbKr ; k++)
+                for (int n = 0 ; n < nbN ; n++)
+                {
+                    double cos_teta = (double) c / (nbCos - 1) ;
+                    double kr = pow (10., -2 + 6. * k / (nbKr - 1)) ;
+                    double N  = 0.3 + 0.35 * n ;
+                    if (r < 0)
+                    {
+                        if (fast) CompareSpecialFunction (stat, Qref (Z[i][j], cos_teta, kr, N), QrefReference (Z[i][j], cos_teta, kr, N)) ;
+                    }
+                    else
+                    {
+                        sum += (fast ? Qref (Z[i][j], cos_teta, kr, N) : QrefReference (Z[i][j], cos_teta, kr, N)).real() ;
+                    }
+                }
+                double t = (double) (clock() - t0) / CLOCKS_PER_SEC ;
+                if (r >= 0) 
+                {
+                    if (fast) stat.timeFast += t ; else stat.timeRef += t ;
+                }
+            }
+        }
+        stat.nbCalls = nbRepeat * 2 * nbDefaultSigma * nbFreq * nbCos * nbKr * nbN ;
+        nbFailed += PrintSpecialFunction (stat, tolerance) ;
+    }
+
+ // HaddenPierce : thin screen, 0 < teta < 2.PI, Rs, Rr = 1, 10 and 100 m, 0.3 < k < 300
+ 
+    {
+        SpecialFunctionStat stat = { "HaddenPierce", 0, 0, 0, 0, 0, 0 } ;
+        const int nbTeta = 200 ;
+        const int nbK    = 31 ;
+        double R[3] = { 1, 10, 100 } ;
+
+        for (int r = -1 ; r < nbRepeat ; r++)
+        {
+            for (int fast = 0 ; fast < 2 ; fast++)
+            {
+                clock_t t0 = clock() ;
+                for (int i = 0 ; i < nbTeta ; i++)
+                for (int s = 0 ; s < 3 ; s++)
+                for (int q = 0 ; q < 3 ; q++)
+                for (int k = 0 ; k < nbK ; k++)
+                {
+                    double teta = 2 * PI * (i + 0.5) / nbTeta ;
+                    double kk = 0.3 * pow (10., 3. * k / (nbK - 1)) ;
+                    if (r < 0)
+                    {
+                        if (fast) CompareSpecialFunction (stat, HaddenPierce (2*PI, teta, R[s], R[q], kk, true), 
+                                                                HaddenPierceReference (2*PI, teta, R[s], R[q], kk, true)) ;
+                    }
+                    else
+                    {
+                        sum += (fast ? HaddenPierce (2*PI, teta, R[s], R[q], kk, true) 
+                                     : HaddenPierceReference (2*PI, teta, R[s], R[q], kk, true)).real() ;
+                    }
+                }
+                double t = (double) (clock() - t0) / CLOCKS_PER_SEC ;
+                if (r >= 0) 
+                {
+                    if (fast) stat.timeFast += t ; else stat.timeRef += t ;
+                }
+            }
+        }
+        stat.nbCalls = nbRepeat * nbTeta * 3 * 3 * nbK ;
+        nbFailed += PrintSpecialFunction (stat, tolerance) ;
+    }
+
+    printf ("(checksum %g)\n", sum) ;
+    return nbFailed ;
+}
+
+#endif
@@ -8,6 +8,17 @@
  * changes:
  *
  *	14/01/2014	this header added, all other copyright and licensing notices removed
+ *
+ *	18/10/2026	partial results are only recorded when the enableDetails option is set
+ *
+ *	18/10/2026	per-stage timers (option enableProfiling, P2P_GetStageTimer)
+ *
+ *	18/10/2026	long-term results over a wind rose (P2P_GetWindRoseResults)
+ *
+ *	18/10/2026	number of threads of P2P_GetWindRoseResults (P2P_SetNbThreads, P2P_GetNbThreads)
+ *
+ *	18/10/2026	P2P_CheckGroundEffect (test builds only), P2P_TestSpecialFunctions returns the number of 
+ *				failed functions
  * ------------------------------------------------------------------------------------------------- 
  */
 #ifndef _PointToPoint_Included
@@ -92,6 +103,11 @@
 #define  enableScattering       0x00000008   // enbale scattered energy
 #define  difHaddenPierce        0x00000010   // use the Hadden-Pierce diffraction model
 #define  randomTerrain          0x00000020   // randomize terrain profile (for fine-tuning only)
+#define  enableDetails          0x00000040   // record partial results for P2P_GetNbDetails / P2P_GetDetails
+#define  enableProfiling        0x00000080   // collect per-stage timers for P2P_GetStageTimer
+
+// note : partial results are only recorded if enableDetails is set explicitly ; without this option the 
+//        calculation engine only keeps the total excess attenuation as returned by P2P_GetResults
 
 // index values for impedances models (classification as indicated in report HAR32TR-030715-DGMR.DOC)
 
@@ -140,6 +156,23 @@
 #define ATT_GROUND_FLAT           9
 #define ATT_TRANS_BLOS_FLAT      10
 
+// calculation stages for P2P_GetStageTimer 
+//
+// note : times are inclusive, e.g. the time of STAGE_CONVEX_HULL includes the time of all other stages except 
+//        STAGE_CREATE_SEGMENTS and STAGE_CURVATURE. Recursive calls of a stage are counted but timed only once.
+
+#define STAGE_CREATE_SEGMENTS     0          // CreateSegments
+#define STAGE_CURVATURE           1          // DoCurvature
+#define STAGE_CONVEX_HULL         2          // FindConvexHull, FindSecondHull
+#define STAGE_LOCAL_COORDINATES   3          // LocalCoordinates
+#define STAGE_FRESNEL_WEIGHTS     4          // InitialFresnelWeights, ModifiedFresnelWeights
+#define STAGE_REFLEXION           5          // GetReflexion
+#define STAGE_DIFFRACTION         6          // GetDiffraction
+#define STAGE_COHERENCE           7          // GetCoherence
+#define STAGE_GROUND_EFFECT       8          // GroundEffect
+#define STAGE_EXCESS_ATTENUATION  9          // ExcessAttenuation
+#define NB_STAGES                10
+
 // modifiers required in order to generate standard windows calling conventions
 
 #ifdef WIN32
@@ -240,6 +273,21 @@ __EXPORTTYPE int      __CALLTYPE  P2P_GetResults (void* p2p_struct, double *att)
 
 __EXPORTTYPE int      __CALLTYPE  P2P_GetAveragedResults (void* p2p_struct, int nb_cond, double *rd, double *wd, double *att) ;
 
+// get long-term results over a wind rose, i.e. N combinations of wind speed, direction and stability class
+// (see P2P_SetupMeteoParameters) with their probability of occurrence. 
+// note : att_cond (may be NULL) receives the results for each condition (nb_cond x nbFreq values), att (may
+//        be NULL) the weighted long-term average. The sound speed profile of the engine is not modified.
+//        The details and debug parameters are those of the last condition, as after P2P_GetResults.
+
+__EXPORTTYPE int      __CALLTYPE  P2P_GetWindRoseResults (void* p2p_struct, int nb_cond, const double *windSpeed, const double *cosWind, 
+                                                          const int *stabilityClass, const double *weight, double *att_cond, double *att) ;
+
+// number of threads of P2P_GetWindRoseResults (1 by default, 0 : one thread per processor) ; the results do 
+// not depend on the number of threads
+
+__EXPORTTYPE int      __CALLTYPE  P2P_SetNbThreads (void* p2p_struct, int nb_threads) ;
+__EXPORTTYPE int      __CALLTYPE  P2P_GetNbThreads (void* p2p_struct) ;
+
 // access to calculation details
 
 __EXPORTTYPE int      __CALLTYPE P2P_GetNbDetails (void *p2P_struct) ;
@@ -251,6 +299,26 @@ __EXPORTTYPE void     __CALLTYPE  AUX_RandomGauss (int n, double *val) ;
 
 __EXPORTTYPE double   __CALLTYPE  P2P_GetTimerCPU (void* p2p_struct, bool reset_clock) ;
 
+// per-stage timers, only if the option enableProfiling is set (times in seconds, measured with a high 
+// resolution clock, see STAGE_xxx for the list of stages)
+
+__EXPORTTYPE int      __CALLTYPE  P2P_GetStageTimer (void* p2p_struct, int stage, int *nb_calls, double *total, double *max, bool reset) ;
+__EXPORTTYPE const char* __CALLTYPE P2P_GetStageName (int stage) ;
+
+// accuracy and speed of the special functions against their original implementation (test builds only) : 
+// returns the number of functions whose maximum relative deviation exceeds the tolerance or that return NaN
+
+#ifdef _TEST_SPECIAL_FUNCTIONS_
+__EXPORTTYPE int      __CALLTYPE  P2P_TestSpecialFunctions (int nb_repeat, double tolerance) ;
+#endif
+
+// exact-match test of the ground effect against the original band by band calculation (test builds only) :
+// enables or disables the test, returns the number of differences found and resets the counters
+
+#ifdef _TEST_GROUND_EFFECT_
+__EXPORTTYPE int      __CALLTYPE  P2P_CheckGroundEffect (bool enable, int *nb_calls, int *nb_values) ;
+#endif
+
 #endif
 
 
@@ -8,6 +8,10 @@
  * changes:
  *
  *	14/01/2014	this header added, all other copyright and licensing notices removed
+ *
+ *	18/10/2026	partial results are only recorded when the enableDetails option is set
+ *
+ *	18/10/2026	number of threads of P2P_GetWindRoseResults
  * ------------------------------------------------------------------------------------------------- 
  */
 // ----------------------------------------------------------------------------------------------------- 
@@ -165,6 +169,16 @@ struct Segment
     double  C [MAX_FREQ] ;           // coherence coefficient
 } ;
 
+// per-stage timers (only if options & enableProfiling)
+
+struct StageTimer
+{
+    int     nbCalls ;                // number of calls 
+    int     depth ;                  // internal : recursion depth
+    double  total ;                  // total time (s)
+    double  max ;                    // longest single call (s)
+} ;
+
 // debug details
 
 struct DebugParam 
@@ -220,7 +234,11 @@ struct PropagationPath
     int         maxSeg ;                  // internal, memory management
     Segment     seg[MAX_SEG] ;            // output 
 
- // save calculation details
+ // total excess attenuation 
+ 
+    double      result[MAX_FREQ] ;        // output : total excess attenuation
+
+ // save calculation details (only if options & enableDetails)
     
     int         nbDetails ;               // output : number of segments
     int         maxDetails ;              // internal memory management
@@ -239,6 +257,14 @@ struct PropagationPath
  
     time_t  cpu_timer ;          
 
+ // per-stage timers 
+ 
+    StageTimer stage_timer[NB_STAGES] ;
+
+ // threads of P2P_GetWindRoseResults
+ 
+    int         nbThreads ;               // input : number of threads (1 by default, 0 : one per processor)
+
  // constructor & destructor
  
     PropagationPath() ;
@@ -250,6 +276,7 @@ struct PropagationPath
  
  // internal utilities
  
+    void ResetResults (void) ;
     void InitImpedances (void) ;
     void InitAirAbsorption (void) ;
     void SetupAirAbsorption (double temp, double hum) ;
@@ -258,10 +285,11 @@ struct PropagationPath
     void DoCurvature (void) ;
 
     void GetVertex (int i, double &x, double &y) ;
-    void FindConvexHull (int i1, int i2) ;
-    void FindSecondHull (int i1, int i2) ;
+    void FindConvexHull (int i1, int i2, double *att) ;
+    void FindSecondHull (int i1, int i2, double *att) ;
     
-    void CumulDiffraction (int is, int id, int ir) ;
+    void CumulDiffraction (int is, int id, int ir, double *att, int model = ATT_DIFFRACTION) ;
+    void SaveDetail (int model, int is, int id, int ir, const double *att) ;
     
     void LocalCoordinates (int is, int ir) ;    
     void FresnelParameters (int is, int ir, double centerFreq) ;
@@ -269,10 +297,14 @@ struct PropagationPath
     void InitialFresnelWeights (int is, int ir) ;
     void ModifiedFresnelWeights (int is, int ir) ;
     
-    void GroundEffect (int is, int ir) ;
+    void GroundEffect (int is, int ir, double *att, int model = ATT_GROUND) ;
     void PartialGroundEffect (int is, int ir) ;
     
     void GetCoherence (int is, int ir) ;
+#ifdef _TEST_GROUND_EFFECT_
+    double ScalarCoherence (int i, int j) ;
+    void CheckGroundEffect (int is, int ir, const double *attLIN, const double *attLOG, const double *attSEG) ;
+#endif
     void GetReflexion (int is, int ir) ;
     void GetDiffraction (int is, int ir) ;
     
@@ -13,10 +13,13 @@
  *
  *  12/07/2018	simplified model for AttGround implemented and tested
  *
+ *	18/10/2026	diagnostic output of the reflection coefficient only in debug mode
+ *
  * ------------------------------------------------------------------------------------------------- 
  */
 #include <algorithm>
 #include "CNOSSOS-2018.h"
+#include "StaticPipeline.h"
 #include "PropagationPath.h"
 #include "Material.h"
 #include "VerticalExt.h"
@@ -269,7 +272,7 @@ static Spectrum getAttGround_sigma (double dp, double zs, double zr, double Gm)
 	 * approximate value of the specular reflexion coefficient 
 	 */
 	double R = 2 * exp (-3.0 * pow (Gm, 0.33)) - 1 ;
-	printf ("R = %.3f \n", R) ;
+	print_debug ("R = %.3f \n", R) ;
 	/*
 	 * path length difference
 	 */
@@ -923,3 +926,7 @@ Spectrum CNOSSOS_2018::getFiniteSizeCorrection (PropagationPath& path)
 	}
 	return -att ;
 }
+/*
+ * statically dispatched pipeline, see StaticPipeline.h
+ */
+template class CnossosEU::StaticPipeline<CNOSSOS_2018> ;
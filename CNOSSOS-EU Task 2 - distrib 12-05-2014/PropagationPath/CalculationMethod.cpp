@@ -14,6 +14,13 @@
  *
  *	24/10/2013	implemented meteorological weighting models 
  *
+ *	18/10/2026	message about fixed angular resolution moved from printf to the trace mechanism
+ *
+ *	18/10/2026	upper bound of the noise levels for a source/receiver pair
+ *
+ *	18/10/2026	the sequence of calculation steps moves to StaticPipeline.h, where it is shared with the
+ *				statically dispatched pipeline
+ *
  * ------------------------------------------------------------------------------------------------- 
  */
 #include "CalculationMethod.h"
@@ -23,6 +30,7 @@
 #include "PathResult.h"
 #include "ErrorMessage.h"
 #include "SystemClock.h"
+#include "StaticPipeline.h"
 #include <algorithm>
 
 static const double PI = 3.1415926 ;
@@ -32,91 +40,50 @@ using namespace Geometry ;
 /*
  * calculate the partial noise level associated with a propagation path
  *
- * this is implemented as a three step process:
- *
- *	1) geometrical analysis of the path and construction of the Fermat ray path
- *
- *	2) calculate the different components of the noise model
- *
- *  3) calculate noise levels
- *
  * Note that the calculation of each of the different components is implemented in 
  * a distinct virtual function. Some functions are shared amongst all derived methods,
- * some have specific implementations in each of the derived methods.
+ * some have specific implementations in each of the derived methods. The sequence of
+ * calculation steps is implemented in StaticPipeline.h
  */
 bool CalculationMethod::doCalculation (PropagationPath& path, PathResult& result)
 {
-	SystemClock clock ;
-	/*
-	 * setup local variables
-	 */
-	initCalculation() ;
-	/*
-	 * geometrical analysis of the path
-	 */
-	if (!path.analyze_path(options)) return false ;
-	/*
-	 * evaluate the sound power of the source
-	 */
-	result.Lw = options.ExcludeSoundPower ? Spectrum(0.0) : getSoundPower (path) ;
-	/*
-	 * convert sound power to dB(A) values if needed
-	 */
-	result.dBA = getFrequencyWeighting (path) ;
-	/*
-	 * evaluate the sound power adaptation of the source
-	 */
-	result.delta_Lw = getSoundPowerAdaptation (path) ;
-	/*
-	 * evaluate the geometrical spread
-	 */
-	result.AttGeo = options.ExcludeGeometricalSpread ? 0.0 : getGeometricalSpread (path) ;
-	/*
-	 * evaluate air absorption
-	 */
-	result.AttAir = options.ExcludeGeometricalSpread ? Spectrum (0.0) : getAirAbsorption (path) ;
-	/*
-	 * evaluate attenuation due to absorption by reflecting obstacles
-	 */
-	result.AttAbsMat = getAbsorption (path) ;
-	/*
-	 * evaluate attenuation due to lateral diffraction
-	 */
-	result.AttLatDif = getLateralDiffraction (path) ;
-	/*
-	 * evaluate attenuation due to finite size of obstacles
-	 */
-	result.AttSize = getFiniteSizeCorrection (path) ;
-	/*
-	 * evaluate excess attenuation
-	 */
-	result.AttF = getExcessAttenuation (path, true) ;
-	result.AttH = getExcessAttenuation (path, false) ;
-	/*
-	 * calculate levels 
-	 */
-	result.LpF = getNoiseLevel (result, true) ;
-	result.LpH = getNoiseLevel (result, false) ;
-	/*
-	 * estimate long-time averaged noise level
-	 */
-	result.Leq = getNoiseLevel (path, result) ;
-	/*
-	 * convert values to dB(A) values
-	 */
-	result.LpF_dBA = getNoiseLevel (result.LpF) ;
-	result.LpH_dBA = getNoiseLevel (result.LpH) ;
-	result.Leq_dBA = getNoiseLevel (result.Leq) ;
-	/*
-	 * cleanup local variables
-	 */
-	exitCalculation() ;
-	/*
-	 * update performance counters
-	 */
-	nbCalls++ ;
-	totalCPUTime += clock.get() ;
+	return runCalculationSteps (*this, path, result) ;
+}
+/*
+ * upper bound of the noise levels for a source/receiver pair
+ *
+ * the bound is evaluated on a straight path where the receiver is moved vertically to the height 
+ * of the source, so that the propagation distance equals the horizontal distance. Any other path 
+ * between the same positions (over the terrain, diffracted by obstacles or reflected by vertical 
+ * walls) is at least as long and is therefore more attenuated by the geometrical spread and the air 
+ * absorption. The conversion of the sound power depends on the ground below the source and is 
+ * bounded by zero where it would be negative. The remaining terms (absorption by obstacles, lateral 
+ * diffraction, finite size corrections) are attenuations. The long-time averaged level is bounded 
+ * by the highest of the levels in homogeneous and favorable conditions.
+ */
+bool CalculationMethod::getUpperBound (SourceExt* source, Point3D const& src, ReceiverExt* receiver, 
+									   Point3D const& rec, Spectrum& Lmax)
+{
+	PropagationPath path ;
+	path.resize (2) ;
+	path[0].pos = src ;
+	path[0].mat = getMaterial ("H") ;
+	path[0].ext = source ;
+	path[1].pos = Point3D (rec.x, rec.y, src.z + source->h - receiver->h) ;
+	path[1].mat = path[0].mat ;
+	path[1].ext = receiver ;
+	if (!path.analyze_path (options)) return false ;
 
+	Lmax = options.ExcludeSoundPower ? Spectrum(0.0) : getSoundPower (path) ;
+	Lmax += getFrequencyWeighting (path) ;
+	Spectrum delta_Lw = getSoundPowerAdaptation (path) ;
+	for (unsigned int i = 0 ; i < Lmax.size() ; ++i) Lmax[i] += std::max (delta_Lw[i], 0.0) ;
+	if (!options.ExcludeGeometricalSpread)
+	{
+		Lmax += getGeometricalSpread (path) ;
+		Lmax += getAirAbsorption (path) ;
+	}
+	Lmax += getMaxExcessGain() ;
 	return true ;
 }
 /* 
@@ -580,7 +547,7 @@ double CalculationMethod::getGeometricalSpreadLineSource (PropagationPath& path,
 	double aa ;
 	if (fixed_angle != 0)
 	{
-		printf (".using fixed angular resolution of %.3f degrees \n", fixed_angle) ;
+		CNOSSOS_TRACE (TRACE_INFO, ".using fixed angular resolution of %.3f degrees \n", fixed_angle) ;
 		aa = fixed_angle * PI / 180 ;
 	}
 	else
@@ -23,6 +23,15 @@
  *				propagation model can use either of these meteorological models and therefore
  *				the model is implemented in the common base class.
  *
+ *	18/10/2026	statically dispatched pipeline for the concrete methods (see StaticPipeline.h), 
+ *				enabled by SetStaticPipeline
+ *
+ *	18/10/2026	upper bound of the noise levels for a source/receiver pair (getUpperBound) ; the
+ *				maximum gain of the excess attenuation is infinite unless the method overrides it
+ *
+ *	18/10/2026	the virtual and the static pipeline share the same sequence of calculation steps
+ *				(runCalculationSteps)
+ *
  * ------------------------------------------------------------------------------------------------- 
  */
 #include "Spectrum.h"
@@ -30,6 +39,7 @@
 #include "PathResult.h"
 #include "VerticalExt.h"
 #include "ReferenceObject.h"
+#include <math.h>
 
 namespace CnossosEU
 {
@@ -74,6 +84,16 @@ namespace CnossosEU
 		 * calculate noise levels associated with propagation path
 		 */
 		virtual bool doCalculation (PropagationPath& path, PathResult& result) ;
+		/*
+		 * upper bound of the long-time averaged noise levels (Leq) for any propagation path between
+		 * the source and the receiver, i.e. the sound power of the source attenuated by the geometrical
+		 * spread and the air absorption over the horizontal distance, plus the maximum gain due to the
+		 * excess attenuation (see getMaxExcessGain). The bound only holds if the maximum gain does.
+		 * Positions are given at ground level. The bound is much cheaper to evaluate than the 
+		 * propagation path.
+		 */
+		bool getUpperBound (SourceExt* source, Geometry::Point3D const& src,
+							ReceiverExt* receiver, Geometry::Point3D const& rec, Spectrum& Lmax) ;
 		/*
 		 * get performance counters
 		 */
@@ -95,6 +115,13 @@ namespace CnossosEU
 
 		virtual MeasurementType expectedMeasurementType (void) { return MeasurementType::Undefined ; }
 		virtual MeteoCondition::MeteoModel getDefaultMeteoModel (void) { return MeteoCondition::DEFAULT ; }
+		/*
+		 * maximum gain (i.e. minus the minimum value) of the excess attenuation due to ground and
+		 * diffraction, in any frequency band and for any meteorological condition. The default value
+		 * (infinite) makes the upper bounds useless but safe ; derived methods return an analytical
+		 * bound where one is known, or an empirical value otherwise.
+		 */
+		virtual double getMaxExcessGain (void) { return HUGE_VAL ; }
 
 		static double     getPropagationDistance (PropagationPath& path) ;
 		static Spectrum   getAbsorption (Material* mat) ;
@@ -122,6 +149,19 @@ namespace CnossosEU
 														Geometry::Point3D& p1,
 														Geometry::Point3D& p2,	
 														double fixed_angle) ;
+		/*
+		 * sequence of calculation steps, shared by doCalculation and StaticPipeline (see
+		 * StaticPipeline.h)
+		 */
+		template <class Method> friend bool runCalculationSteps (Method& method, PropagationPath& path, PathResult& result) ;
+		/*
+		 * update performance counters after a calculation
+		 */
+		void countCalculation (double cpuTime)
+		{
+			nbCalls++ ;
+			totalCPUTime += cpuTime ;
+		}
 
 	private:
 		/*
@@ -135,8 +175,27 @@ namespace CnossosEU
 		unsigned int nbCalls ;
 		double  totalCPUTime ;
 	};
+	/*
+	 * statically dispatched calculation pipeline for a concrete calculation method: the same sequence
+	 * of calculation steps as in the virtual pipeline, but the class is final, so that all calculation
+	 * steps are called directly and the method specific steps can be inlined. Classes derived from a 
+	 * concrete method in order to override some of the calculation steps (e.g. TestCnossosEXT) must 
+	 * use the virtual pipeline. The pipeline is instantiated with each calculation method.
+	 */
+	template <class Method> class StaticPipeline final : public Method
+	{
+	public:
+		virtual bool doCalculation (PropagationPath& path, PathResult& result) ;
+
+		template <class M> friend bool runCalculationSteps (M& method, PropagationPath& path, PathResult& result) ;
+	};
 	/*
 	 * instantiate the appropriate calculation method
 	 */
 	CalculationMethod* getCalculationMethod (const char* id) ;
+	/*
+	 * enable or disable the statically dispatched pipeline for all calculation methods created 
+	 * by getCalculationMethod (default = disabled)
+	 */
+	void SetStaticPipeline (bool on_off = true) ;
 }
\ No newline at end of file
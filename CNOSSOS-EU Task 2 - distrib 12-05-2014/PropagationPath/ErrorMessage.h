@@ -10,6 +10,8 @@
  *
  *	18/10/2013  initial version 1.001
  * 
+ *	18/10/2026	print_debug records its messages by means of the trace mechanism (see Trace.h)
+ *
  * ------------------------------------------------------------------------------------------------- 
  */
 #include <stdio.h>
@@ -44,11 +46,10 @@ namespace CnossosEU
 #define signal_error(msg) throw(msg) 
 /*
  * abstract interface for warning / trace mechanism
+ *
+ * debug messages are removed at compile time unless CNOSSOS_TRACE_LEVEL >= TRACE_DEBUG (default
+ * in debug builds), in which case they are recorded if the actual trace level allows it
  */
-#
-#ifdef _DEBUG
-#define print_debug printf
-#else
-inline void print_debug (...) { }
-#endif
+#include "Trace.h"
+#define print_debug(...) CNOSSOS_TRACE (CnossosEU::TRACE_DEBUG, __VA_ARGS__)
 
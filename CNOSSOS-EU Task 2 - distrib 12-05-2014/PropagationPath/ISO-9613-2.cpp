@@ -20,9 +20,12 @@
  *
  *  06/12/2013	bug fixed in the calculation and use of Gr, Gm and Gs
  *
+ *	18/10/2026	octave band tables applied to any band set by means of Spectrum::octave
+ *
  * ------------------------------------------------------------------------------------------------- 
  */
 #include "ISO-9613-2.h"
+#include "StaticPipeline.h"
 #include "VerticalExt.h"
 #include "Material.h"
 #include <algorithm>
@@ -135,34 +138,24 @@ Spectrum ISO_9613_2::getExcessAttenuation (PropagationPath& path, bool favorable
  */
 Spectrum getAground (double G, double h, double dp)
 {
-	Spectrum att ;
-	assert (att.size() == 8) ;
-
-	assert (att.freq(0) == 63) ;
-	att[0] = -1.5 ; 
-
-	assert (att.freq(1) == 125) ;
-	att[1] = -1.5 + G * (1.5 + 3.0 * exp (-.12 * (h-5.) * (h-5.)) * (1. - exp (-dp/50.))
-		   + 5.7 * exp (-.09 * h * h) * (1. - exp (-2.8E-6 * dp * dp))) ;
-	
-	assert (att.freq(2) == 250) ;
-	att[2] = -1.5 + G * (1.5 + 8.6 * exp (-.09 * h * h) * (1. - exp (-dp/50.))) ;
-
-	assert (att.freq(3) == 500) ;
-	att[3] = -1.5 + G * (1.5 + 14. * exp (-.46 * h * h) * (1. - exp (-dp/50.))) ;
-
-	assert (att.freq(4) == 1000) ;
-	att[4] = -1.5 + G * (1.5 + 5.0 * exp (-.90 * h * h) * (1. - exp (-dp/50.))) ;
+	/*
+	 * the standard defines the ground effect in octave bands, each frequency band takes 
+	 * the value of the octave band it belongs to
+	 */
+	double oct[8] ;
 	
-	assert (att.freq(5) == 2000) ;
-	att[5] = -1.5 + 1.5 * G ;
-
-	assert (att.freq(6) == 4000) ;
-	att[6] = -1.5 + 1.5 * G ;
-
-	assert (att.freq(7) == 8000) ;
-	att[7] = -1.5 + 1.5 * G ;
+	oct[0] = -1.5 ; 
+	oct[1] = -1.5 + G * (1.5 + 3.0 * exp (-.12 * (h-5.) * (h-5.)) * (1. - exp (-dp/50.))
+		   + 5.7 * exp (-.09 * h * h) * (1. - exp (-2.8E-6 * dp * dp))) ;
+	oct[2] = -1.5 + G * (1.5 + 8.6 * exp (-.09 * h * h) * (1. - exp (-dp/50.))) ;
+	oct[3] = -1.5 + G * (1.5 + 14. * exp (-.46 * h * h) * (1. - exp (-dp/50.))) ;
+	oct[4] = -1.5 + G * (1.5 + 5.0 * exp (-.90 * h * h) * (1. - exp (-dp/50.))) ;
+	oct[5] = -1.5 + 1.5 * G ;
+	oct[6] = -1.5 + 1.5 * G ;
+	oct[7] = -1.5 + 1.5 * G ;
 
+	Spectrum att ;
+	for (unsigned int i = 0 ; i < att.size() ; ++i) att[i] = oct[Spectrum::octave(i)] ;
 	return att ;
 }
 /*
@@ -314,7 +307,7 @@ Spectrum ISO_9613_2::getGroundEffect (PropagationPath& path)
 	{
 		double A0 = Am[0] = -3*q ;
 		double A1 = -3*q* (1 - Gm) ;
-		for (unsigned int i = 0 ; i < Am.size() ; ++i) Am[i] = (i == 0) ? A0 : A1 ;
+		for (unsigned int i = 0 ; i < Am.size() ; ++i) Am[i] = (Spectrum::octave(i) == 0) ? A0 : A1 ;
 	}
 	/*
 	 * return sum of three components
@@ -782,5 +775,7 @@ Spectrum  ISO_9613_2::getHeightCorrection2D (PropagationPath& path)
 	}
 	return att ;
 }
-
-
+/*
+ * statically dispatched pipeline, see StaticPipeline.h
+ */
+template class CnossosEU::StaticPipeline<ISO_9613_2> ;
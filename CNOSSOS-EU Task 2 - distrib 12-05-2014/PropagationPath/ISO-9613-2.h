@@ -35,6 +35,7 @@ namespace CnossosEU
 		virtual MeasurementType expectedMeasurementType (void) { return MeasurementType::HemiSpherical ; }
 		virtual MeteoCondition::MeteoModel getDefaultMeteoModel (void) { return MeteoCondition::ISO9613 ; }
 
+		virtual double getMaxExcessGain (void) { return 6.0 ; }		// As, Ar >= -1.5 dB, Am >= -3 dB, Dz >= 0 dB
 		virtual Spectrum getExcessAttenuation (PropagationPath& path, bool favorable_condition) ;
 		virtual Spectrum getFiniteSizeCorrection (PropagationPath& path) ;
 		virtual Spectrum getLateralDiffraction (PropagationPath& path) ;
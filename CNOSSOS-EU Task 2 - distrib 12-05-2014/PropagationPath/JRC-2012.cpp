@@ -18,6 +18,7 @@
  * ------------------------------------------------------------------------------------------------- 
  */
 #include "JRC-2012.h"
+#include "StaticPipeline.h"
 #include "PropagationPath.h"
 #include "Material.h"
 #include "VerticalExt.h"
@@ -770,3 +771,7 @@ Spectrum JRC2012::getFiniteSizeCorrection (PropagationPath& path)
 	}
 	return -att ;
 }
+/*
+ * statically dispatched pipeline, see StaticPipeline.h
+ */
+template class CnossosEU::StaticPipeline<JRC2012> ;
@@ -38,6 +38,7 @@ namespace CnossosEU
 		virtual MeasurementType expectedMeasurementType (void) { return MeasurementType::HemiSpherical ; }
 		virtual MeteoCondition::MeteoModel getDefaultMeteoModel (void) { return MeteoCondition::JRC2012 ; }
 
+		virtual double getMaxExcessGain (void) { return 18.0 ; }		// Aground,F >= -9 dB, on both sides of the diffraction edges
 		virtual Spectrum getExcessAttenuation (PropagationPath& path, bool favorable_condition) ;
 		virtual Spectrum getFiniteSizeCorrection (PropagationPath& path) ;
 		virtual Spectrum getLateralDiffraction (PropagationPath& path) ;
@@ -15,9 +15,16 @@
  *  25/10/2013	implemented correction for finite height of reflecting obstacles based on
  *				Fresnel weighting
  *
+ *	18/10/2026	materials with a user-defined impedance are registered only once per path
+ *				and fall back to the nearest predefined category if no more impedance 
+ *				classes are available
+ *
+ *	18/10/2026	frequency bands of the Harmonoise engine taken from the Spectrum class
+ *
  * ------------------------------------------------------------------------------------------------- 
  */
 #include "JRC-draft-2010.h"
+#include "StaticPipeline.h"
 #include "PropagationPath.h"
 #include "Material.h"
 #include "VerticalExt.h"
@@ -30,17 +37,20 @@ using namespace Geometry ;
 #ifdef _DEBUG
 	static void show_p2p_details (void* p2p_struct) ;
 	#define show_details(x) show_p2p_details(x)
+	#define P2P_DETAILS enableDetails
 #else
 	#define show_details(x)
+	#define P2P_DETAILS 0
 #endif
 
 JRCdraft2010::JRCdraft2010 (void)
 {
 	p2p_struct = P2P_Create() ;
 
-	double freq[] = { 63, 125, 250, 500, 1000, 2000, 4000, 8000 } ;
-	P2P_SetFreqArray (p2p_struct, 8, freq) ;
-	P2P_SetBandwidth (p2p_struct, 1.) ;
+	double freq[Spectrum::nbFreq] ;
+	for (unsigned int i = 0 ; i < Spectrum::nbFreq ; ++i) freq[i] = Spectrum::freq(i) ;
+	P2P_SetFreqArray (p2p_struct, Spectrum::nbFreq, freq) ;
+	P2P_SetBandwidth (p2p_struct, Spectrum::bandWidth()) ;
 }
 
 JRCdraft2010::~JRCdraft2010 (void)
@@ -65,6 +75,7 @@ bool JRCdraft2010::initCalculation (void)
 {
 	path_defined = false ;
 	user_defined = groundUserDefined ;
+	user_materials.clear() ;
 	/*
 	 * fix mandatory options for the JRC-draft-2010 method
 	 */
@@ -102,10 +113,17 @@ int JRCdraft2010::getMaterial (Material* mat)
 	Impedance const* imp = mat->getImpedance() ;
 	if (imp)
 	{
+		std::map<Material*, int>::const_iterator it = user_materials.find (mat) ;
+		if (it != user_materials.end()) return it->second ;
+
 		Impedance impVal = *imp ;
-		int index = user_defined++ ;
-		P2P_SetImpedance (p2p_struct, index, &impVal[0]) ;
-		return index ;
+		int index = user_defined ;
+		if (P2P_SetImpedance (p2p_struct, index, &impVal[0]) == index)
+		{
+			user_defined++ ;
+			user_materials[mat] = index ;
+			return index ;
+		}
 	}
 	/*
 	 * use "nearest" predefined material category
@@ -172,7 +190,7 @@ Spectrum JRCdraft2010::getExcessAttenuation (PropagationPath& path, bool favorab
 	/*
 	 * set options and sound speed profile
 	 */
-	P2P_SetOptions (p2p_struct, enableAveraging | enableScattering) ;
+	P2P_SetOptions (p2p_struct, enableAveraging | enableScattering | P2P_DETAILS) ;
 	double C_sound = options.meteo.getSoundSpeed() ;
 	P2P_SetSoundSpeed (p2p_struct, C_sound) ;
 	double A_meteo = favorable_condition ? 0.07 : 0.00 ;
@@ -257,7 +275,7 @@ static void show_p2p_details (void* p2p)
 		" MIX_DIF_FLAT  "
 	} ;
 
-	assert (P2P_GetNbFreq (p2p) == 8) ;
+	assert (P2P_GetNbFreq (p2p) == Spectrum::nbFreq) ;
 
 	printf ("---------------------------------------------------------------------------\n") ;
 	printf ("Using HarmonoiseP2P.DLL V%.3f \n", P2P_GetVersionDLL (p2p)) ;
@@ -269,7 +287,7 @@ static void show_p2p_details (void* p2p)
 	printf ("---------------------------------------------------------------------------\n") ;
 	printf ("Component       POS SRC REC") ;
 	Spectrum att ;
-	for (unsigned int k = 0 ; k < 8 ; k++) 
+	for (unsigned int k = 0 ; k < att.size() ; k++) 
 		if (att.freq(k) < 1000) 
 			printf ("%4.0fHz", att.freq(k)) ;
 		else
@@ -283,7 +301,7 @@ static void show_p2p_details (void* p2p)
 		int pos_rec ;
 		int pos_src ;
 		int model ;
-		double att[8] ;
+		double att[Spectrum::nbFreq] ;
 
 		P2P_GetDetails (p2p,i, &model, &pos_rec,&pos_dif, &pos_src, att) ;
 	
@@ -293,11 +311,14 @@ static void show_p2p_details (void* p2p)
 		else
 			printf ("    ") ;
 		printf (" %3d %3d", pos_src, pos_rec) ;
-		for (unsigned int k = 0 ; k < 8 ; k++) printf (" %5.1f", att[k]) ;
+		for (unsigned int k = 0 ; k < Spectrum::nbFreq ; k++) printf (" %5.1f", att[k]) ;
 		
 		printf ("\n") ;
 	}
 
 	printf ("---------------------------------------------------------------------------\n") ;
 }
-
+/*
+ * statically dispatched pipeline, see StaticPipeline.h
+ */
+template class CnossosEU::StaticPipeline<JRCdraft2010> ;
@@ -12,11 +12,16 @@
  * changes:
  *
  *	18/01/2013	initial version
+ *
+ *	18/10/2026	user-defined impedances registered once per material
+ *
+ *	18/10/2026	maximum gain of the excess attenuation (empirical value)
  * ------------------------------------------------------------------------------------------------- 
  */
 #include "./CalculationMethod.h"
 #include "../HarmonoiseP2P/PointToPoint.hpp"
 #include "VerticalExt.h"
+#include <map>
 
 namespace CnossosEU 
 {
@@ -25,6 +30,7 @@ namespace CnossosEU
 		void*	p2p_struct ;
 		bool	path_defined ;
 		int		user_defined ;
+		std::map<Material*, int> user_materials ;
 
 	public:
 
@@ -42,6 +48,12 @@ namespace CnossosEU
 		virtual MeasurementType expectedMeasurementType (void) { return MeasurementType::FreeField ; }
 		virtual MeteoCondition::MeteoModel getDefaultMeteoModel (void) { return MeteoCondition::JRC2012 ; }
 
+		/*
+		 * empirical value: there is no analytical bound on the coherent ground reflections of the
+		 * Harmonoise model ; the maximum gain observed on random scenes is 15 dB, the margin is a
+		 * heuristic
+		 */
+		virtual double getMaxExcessGain (void) { return 20.0 ; }
 		virtual Spectrum getExcessAttenuation (PropagationPath& path, bool favorable_condition) ;
 		virtual Spectrum getFiniteSizeCorrection (PropagationPath& path) ;
 
@@ -0,0 +1,100 @@
+/*
+ * ------------------------------------------------------------------------------------------------
+ * file:		LineSplitter.cpp
+ * version:		1.0
+ * author:		dirk.van-maercke@cstb.fr
+ * copyright:	see file licence.EU.txt
+ * description: adaptive subdivision of line sources into elementary sources
+ * changes:
+ *
+ *	18/10/2026	initial version
+ * -------------------------------------------------------------------------------------------------
+ */
+#include "LineSplitter.h"
+#include <math.h>
+#include <algorithm>
+
+using namespace CnossosEU ;
+using namespace Geometry ;
+
+static const double PI = 3.1415926 ;
+/*
+ * receivers closer than this distance to the line are moved away from the line, as in the
+ * calculation of the geometrical spread (see CalculationMethod::getGeometricalSpreadLineSource)
+ */
+static const double MIN_DISTANCE = 1.0 ;
+/*
+ * angle of view and point source error of a straight piece
+ *
+ * with R the distance from the receiver to the supporting line and t1, t2 the positions of the
+ * end-points along the line relative to the projection of the receiver, the integral of 1/(4.pi.r²)
+ * along the piece equals (atan(t2/R) - atan(t1/R)) / (4.pi.R) whereas the equivalent point source
+ * gives L / (4.pi.(R² + tm²)) with tm the position of the middle of the piece.
+ */
+static void get_piece_properties (Point3D const& p1, Point3D const& p2, Point3D const& rec,
+								  double& angle, double& error)
+{
+	double L = dist (p1, p2) ;
+	angle = 0 ;
+	error = 0 ;
+	if (L <= 0) return ;
+
+	Vector3D n = (p2 - p1) / L ;
+	double t1 = (p1 - rec) * n ;
+	double t2 = t1 + L ;
+	Point3D x = p1 + (-t1) * n ;
+	double R = std::max (dist (rec, x), MIN_DISTANCE) ;
+	double tm = 0.5 * (t1 + t2) ;
+
+	angle = atan (t2 / R) - atan (t1 / R) ;
+	error = 10 * log10 (L * R / ((R * R + tm * tm) * angle)) ;
+}
+
+double CnossosEU::getLineElementError (Point3D const& p1, Point3D const& p2, Point3D const& rec)
+{
+	double angle, error ;
+	get_piece_properties (p1, p2, rec, angle, error) ;
+	return error ;
+}
+/*
+ * bisect the piece (p1,p2) recursively until all criteria are met
+ */
+static unsigned int split_piece (Point3D const& p1, Point3D const& p2, Point3D const& rec, Vector3D const& n,
+								 std::vector<LineElement>& elements, LineSplitOptions const& options)
+{
+	double L = dist (p1, p2) ;
+	if (L > 2 * options.MinLength)
+	{
+		double angle, error ;
+		get_piece_properties (p1, p2, rec, angle, error) ;
+		bool split = (options.MaxLength > 0 && L > options.MaxLength)
+				  || (options.MaxAngle > 0 && angle * 180 / PI > options.MaxAngle)
+				  || (options.Tolerance > 0 && fabs (error) > options.Tolerance) ;
+		if (split)
+		{
+			Point3D pm = p1 + 0.5 * (p2 - p1) ;
+			return split_piece (p1, pm, rec, n, elements, options) + split_piece (pm, p2, rec, n, elements, options) ;
+		}
+	}
+	LineElement e ;
+	e.pos = p1 + 0.5 * (p2 - p1) ;
+	e.length = L ;
+	e.orientation = n ;
+	elements.push_back (e) ;
+	return 1 ;
+}
+
+unsigned int CnossosEU::splitLineSource (std::vector<Point3D> const& polyline, Point3D const& rec,
+										 std::vector<LineElement>& elements, LineSplitOptions const& options)
+{
+	unsigned int count = 0 ;
+	for (unsigned int i = 1 ; i < polyline.size() ; ++i)
+	{
+		Point3D const& p1 = polyline[i-1] ;
+		Point3D const& p2 = polyline[i] ;
+		double L = dist (p1, p2) ;
+		if (L <= 0) continue ;
+		count += split_piece (p1, p2, rec, (p2 - p1) / L, elements, options) ;
+	}
+	return count ;
+}
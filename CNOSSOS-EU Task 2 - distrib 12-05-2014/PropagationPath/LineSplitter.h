@@ -0,0 +1,63 @@
+#pragma once
+/*
+ * ------------------------------------------------------------------------------------------------
+ * file:		LineSplitter.h
+ * version:		1.0
+ * author:		dirk.van-maercke@cstb.fr
+ * copyright:	see file licence.EU.txt
+ * description: adaptive subdivision of line sources (roads, railways) into elementary sources
+ * note:		each elementary source is an equivalent point source at the middle of a piece of the
+ *				line, with the sound power of the piece (see LineSource). Compared to the incoherent
+ *				integration along the piece, the point source approximation of the geometrical
+ *				spread introduces an error that depends on the distance from the receiver and on
+ *				the angle of view of the piece. The pieces are bisected until this error is below
+ *				a given tolerance, so that distant parts of the line are represented by a few long
+ *				pieces and parts close to the receiver by many short pieces.
+ * changes:
+ *
+ *	18/10/2026	initial version
+ * -------------------------------------------------------------------------------------------------
+ */
+#include "Geometry3D.h"
+#include <vector>
+
+namespace CnossosEU
+{
+	/*
+	 * subdivision criteria ; a piece is split in two halves if any of the criteria is not met,
+	 * unless it is already shorter than twice the minimum length
+	 */
+	struct LineSplitOptions
+	{
+		double Tolerance ;		// maximum error (dB) of the point source approximation, 0 = not used
+		double MaxAngle ;		// maximum angle of view (degrees) of a piece, 0 = not used
+		double MaxLength ;		// maximum length (m) of a piece, 0 = not used
+		double MinLength ;		// minimum length (m) of a piece
+
+		LineSplitOptions (void) : Tolerance (0.1), MaxAngle (0.0), MaxLength (0.0), MinLength (1.0) { }
+	} ;
+	/*
+	 * elementary source representing a piece of the line
+	 */
+	struct LineElement
+	{
+		Geometry::Point3D	pos ;			// middle of the piece
+		double				length ;		// length of the piece
+		Geometry::Vector3D	orientation ;	// direction of the line (normalized)
+	} ;
+	/*
+	 * subdivide the polyline as seen from the receiver and append the elementary sources to the
+	 * list. Source and receiver positions must be given at the same reference height (e.g. both at
+	 * the height of the source and the receiver above the ground). Returns the number of elements
+	 * added.
+	 */
+	unsigned int splitLineSource (std::vector<Geometry::Point3D> const& polyline, Geometry::Point3D const& rec,
+								  std::vector<LineElement>& elements,
+								  LineSplitOptions const& options = LineSplitOptions()) ;
+	/*
+	 * error (dB) of the geometrical spread of the equivalent point source in the middle of the
+	 * segment (p1,p2) with respect to the integration along the segment. The error is positive if
+	 * the point source over-estimates the level at the receiver.
+	 */
+	double getLineElementError (Geometry::Point3D const& p1, Geometry::Point3D const& p2, Geometry::Point3D const& rec) ;
+}
@@ -8,6 +8,10 @@
  * changes:
  *
  *	18/01/2013	initial version
+ *
+ *	18/10/2026	added reverse lookup of material identifiers
+ *
+ *	18/10/2026	added snapshots of the material table
  * ------------------------------------------------------------------------------------------------- 
  */
 #include "Material.h"
@@ -71,6 +75,55 @@ Material* CnossosEU::getMaterial (const char* id, bool create_if_needed)
 	if (matList.empty()) initMaterialList() ;
 	return findMaterial (id, create_if_needed) ;
 }
+/*
+ * public function: reverse lookup of the material table
+ */
+const char* CnossosEU::getMaterialID (Material* mat)
+{
+	if (mat == 0) return 0 ;
+	for (MaterialList::const_iterator it = matList.begin() ; it != matList.end() ; ++it)
+	{
+		if (it->second == mat) return it->first.c_str() ;
+	}
+	return 0 ;
+}
+/*
+ * public class: snapshot of the material table
+ */
+MaterialSnapshot::MaterialSnapshot (void)
+{
+	if (matList.empty()) initMaterialList() ;
+	for (MaterialList::const_iterator it = matList.begin() ; it != matList.end() ; ++it)
+	{
+		if (it->second) saved.insert (std::make_pair (it->first, Material (*it->second))) ;
+	}
+}
+
+MaterialSnapshot::~MaterialSnapshot (void)
+{
+	restore() ;
+}
+
+void MaterialSnapshot::restore (void)
+{
+	MaterialList::iterator it = matList.begin() ;
+	while (it != matList.end())
+	{
+		std::map<std::string, Material>::const_iterator old = saved.find (it->first) ;
+		if (old == saved.end() || !it->second)
+		{
+			matList.erase (it++) ;
+			continue ;
+		}
+		*it->second = old->second ;
+		++it ;
+	}
+	for (std::map<std::string, Material>::const_iterator old = saved.begin() ; old != saved.end() ; ++old)
+	{
+		ref_ptr<Material>& mat = matList[old->first] ;
+		if (!mat) mat = new Material (old->second) ;
+	}
+}
 /*
  * utility function for converting G values into equivalent sigma values
  *
@@ -172,6 +225,27 @@ Impedance Material::getImpedanceValue (void)
 	return convert_sigma_to_impedance (sigma, 0.0) ;
 }
 
+Material::Material (Material const& other) 
+: ReferenceObject(), G_value (other.G_value), sigma (0), alpha (0), impedance (0)
+{
+	if (other.sigma) sigma = new double (*other.sigma) ;
+	if (other.alpha) alpha = new Spectrum (*other.alpha) ;
+	if (other.impedance) impedance = new Impedance (*other.impedance) ;
+}
+
+Material& Material::operator= (Material const& other)
+{
+	if (this == &other) return *this ;
+	G_value = other.G_value ;
+	delete sigma ;
+	delete alpha ;
+	delete impedance ;
+	sigma = other.sigma ? new double (*other.sigma) : 0 ;
+	alpha = other.alpha ? new Spectrum (*other.alpha) : 0 ;
+	impedance = other.impedance ? new Impedance (*other.impedance) : 0 ;
+	return *this ;
+}
+
 void Material::setSigma (double _sigma)
 { 
 	if (sigma) 
@@ -13,10 +13,16 @@
  *  23/10/2013	added impedance as material property
  *
  *  23/10/2013	added support for evaluating default impedances and absorption coefficients
+ *
+ *	18/10/2026	added reverse lookup of material identifiers (getMaterialID)
+ *
+ *	18/10/2026	added snapshots of the common database (MaterialSnapshot)
  * ------------------------------------------------------------------------------------------------- 
  */
 #include "Spectrum.h"
 #include "ReferenceObject.h"
+#include <string>
+#include <map>
 
 namespace CnossosEU
 {
@@ -66,6 +72,11 @@ namespace CnossosEU
 		Impedance  getImpedanceValue (void) ;
 		
 		Material (double G = 0) : G_value (G), sigma (0), alpha(0), impedance(0) { }
+		/*
+		 * copy the properties of another material
+		 */
+		Material (Material const& other) ;
+		Material& operator= (Material const& other) ;
 		~Material (void)
 		{
 			if (sigma) delete sigma ;
@@ -87,4 +98,24 @@ namespace CnossosEU
 	 * absorbing materials, as defined in the CNOSSOS-EU documentation. 
 	 */
 	Material* getMaterial (const char* id, bool create_if_needed = false) ;
+	/*
+	 * identifier of a material in the common database, or null if the material is not registered
+	 */
+	const char* getMaterialID (Material* mat) ;
+	/*
+	 * snapshot of the properties of the materials in the common database. When the snapshot goes out
+	 * of scope, the properties of the materials are reset to their saved values and the materials
+	 * registered since the snapshot are removed from the database, e.g. to confine the definitions of
+	 * materials in an input file to the calculation of the paths in this file. Paths that refer to
+	 * the materials remain valid, but see the restored properties.
+	 */
+	class MaterialSnapshot
+	{
+	public:
+		MaterialSnapshot (void) ;
+		~MaterialSnapshot (void) ;
+		void restore (void) ;
+	private:
+		std::map<std::string, Material> saved ;
+	} ;
 }
\ No newline at end of file
@@ -0,0 +1,685 @@
+/*
+ * ------------------------------------------------------------------------------------------------
+ * file:		NoiseMap.cpp
+ * version:		1.0
+ * author:		dirk.van-maercke@cstb.fr
+ * copyright:	see file licence.EU.txt
+ * description: calculation of noise maps on a regular grid of receivers
+ * changes:
+ *
+ *	18/10/2026	initial version
+ *
+ *	18/10/2026	optional culling of weak contributions based on upper bounds of the levels
+ *
+ *	18/10/2026	optional clustering of distant point sources
+ *
+ *	18/10/2026	optional adaptive subdivision of line segments
+ * -------------------------------------------------------------------------------------------------
+ */
+#include "NoiseMap.h"
+#include "CalculationMethod.h"
+#include "ErrorMessage.h"
+#include <math.h>
+#include <stdio.h>
+#include <algorithm>
+#include <functional>
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#include <time.h>
+#endif
+
+using namespace CnossosEU ;
+using namespace System ;
+using namespace Geometry ;
+
+#define POW2(x) ((x)*(x))
+/*
+ * value written for receivers without any contribution
+ */
+static const double NODATA_VALUE = -99.0 ;
+/*
+ * portable threads and locks
+ */
+#ifdef WIN32
+typedef SRWLOCK MapLock ;
+#define InitLock(x)		InitializeSRWLock (&x)
+#define DeleteLock(x)
+#define AcquireLock(x)	AcquireSRWLockExclusive (&x)
+#define ReleaseLock(x)	ReleaseSRWLockExclusive (&x)
+#else
+typedef pthread_mutex_t MapLock ;
+#define InitLock(x)		pthread_mutex_init (&x, 0)
+#define DeleteLock(x)	pthread_mutex_destroy (&x)
+#define AcquireLock(x)	pthread_mutex_lock (&x)
+#define ReleaseLock(x)	pthread_mutex_unlock (&x)
+#endif
+
+struct ThreadStart
+{
+	void (*func) (void*) ;
+	void* arg ;
+} ;
+
+#ifdef WIN32
+static DWORD WINAPI thread_entry (LPVOID arg)
+{
+	ThreadStart* start = (ThreadStart*) arg ;
+	start->func (start->arg) ;
+	return 0 ;
+}
+#else
+static void* thread_entry (void* arg)
+{
+	ThreadStart* start = (ThreadStart*) arg ;
+	start->func (start->arg) ;
+	return 0 ;
+}
+#endif
+/*
+ * run func(args[k]) in n threads, the first one in the calling thread, and wait for all of them
+ */
+static void run_parallel (unsigned int n, void (*func) (void*), void* args[])
+{
+	std::vector<ThreadStart> start (n) ;
+#ifdef WIN32
+	std::vector<HANDLE> threads (n, (HANDLE) 0) ;
+#else
+	std::vector<pthread_t> threads (n) ;
+	std::vector<bool> started (n, false) ;
+#endif
+	for (unsigned int k = 1 ; k < n ; ++k)
+	{
+		start[k].func = func ;
+		start[k].arg = args[k] ;
+#ifdef WIN32
+		threads[k] = CreateThread (NULL, 0, thread_entry, &start[k], 0, NULL) ;
+		if (threads[k] == 0) func (args[k]) ;
+#else
+		started[k] = (pthread_create (&threads[k], NULL, thread_entry, &start[k]) == 0) ;
+		if (!started[k]) func (args[k]) ;
+#endif
+	}
+	if (n > 0) func (args[0]) ;
+	for (unsigned int k = 1 ; k < n ; ++k)
+	{
+#ifdef WIN32
+		if (threads[k] == 0) continue ;
+		WaitForSingleObject (threads[k], INFINITE) ;
+		CloseHandle (threads[k]) ;
+#else
+		if (started[k]) pthread_join (threads[k], NULL) ;
+#endif
+	}
+}
+
+/*
+ * elapsed time in seconds (SystemClock measures the CPU time of the process on POSIX systems,
+ * i.e. the sum over all threads)
+ */
+static double wall_time (void)
+{
+#ifdef WIN32
+	LARGE_INTEGER counter, frequency ;
+	QueryPerformanceCounter (&counter) ;
+	QueryPerformanceFrequency (&frequency) ;
+	return (double) counter.QuadPart / (double) frequency.QuadPart ;
+#else
+	timespec t ;
+	clock_gettime (CLOCK_MONOTONIC, &t) ;
+	return t.tv_sec + 1.E-9 * t.tv_nsec ;
+#endif
+}
+
+static unsigned int processor_count (void)
+{
+#ifdef WIN32
+	SYSTEM_INFO info ;
+	GetSystemInfo (&info) ;
+	return std::max ((unsigned int) info.dwNumberOfProcessors, 1u) ;
+#else
+	long n = sysconf (_SC_NPROCESSORS_ONLN) ;
+	return (n > 0) ? (unsigned int) n : 1 ;
+#endif
+}
+/*
+ * progress of the calculation, shared by all threads
+ */
+struct ProgressState
+{
+	MapLock				lock ;
+	unsigned int		done ;
+	unsigned int		total ;
+	NoiseMapProgress	callback ;
+	void*				userData ;
+} ;
+/*
+ * horizontal strip of tiles
+ */
+struct NoiseMap::Strip
+{
+	unsigned int		j0 ;			// first (southern most) row of receivers
+	unsigned int		nbRows ;		// number of rows of receivers
+	unsigned int		ntx ;			// number of tiles per row of tiles
+	unsigned int		nbTiles ;
+	volatile long		nextTile ;		// number of tiles taken by the threads
+	std::vector<float>	levels ;		// nbRows x nx levels, starting at row j0
+} ;
+/*
+ * private data of each thread ; workers are reused for all strips
+ */
+struct NoiseMap::Worker
+{
+	NoiseMap*					map ;
+	Strip*						strip ;
+	NoiseMapOptions const*		options ;
+	ProgressState*				progress ;
+	ref_ptr<CalculationMethod>	method ;
+	ref_ptr<ReceiverExt>		receiver ;
+	PropagationPath				path ;
+	std::vector<Spectrum>		energy ;		// energies at the receivers of the current tile
+	double						nbPaths ;
+	double						nbFailures ;
+	double						nbSkipped ;
+	/*
+	 * sources in range of the current tile, their upper bounds at the current receiver in decreasing 
+	 * order and the sums of the remaining bounds (only used with a tolerance)
+	 */
+	struct Candidate
+	{
+		MapSource*				src ;
+		ref_ptr<SourceExt>		ext ;
+	} ;
+	std::vector<Candidate>		candidates ;
+	std::vector<std::pair<double,unsigned int> > bounds ;
+	std::vector<double>			remaining ;
+	/*
+	 * sources and equivalent sources of clusters selected for the current tile
+	 */
+	std::vector<MapSource*>		selected ;
+	std::vector<unsigned int>	selectedClusters ;
+	std::vector<unsigned int>	selectedMembers ;
+	/*
+	 * elementary sources of the line segment being calculated
+	 */
+	std::vector<LineElement>	elements ;
+} ;
+
+NoiseMap::NoiseMap (NoiseMapGrid const& _grid)
+: grid (_grid), terrain (0), obstacles (0), ground (0), sources(), tree (0), clusters(), treeSources(), 
+  otherSources(), nbPaths (0), nbFailures (0), nbSkipped (0), 
+  elapsedTime (0)
+{
+	ground = getMaterial ("H") ;
+}
+
+NoiseMap::~NoiseMap (void)
+{
+}
+
+unsigned int NoiseMap::addSource (Point3D const& pos, ElementarySource const& source, SourceGeometry* geo)
+{
+	MapSource src ;
+	src.pos = pos ;
+	src.source = source ;
+	/*
+	 * during the calculation, the threads only read the original geometry and work on clones
+	 */
+	src.geo = (geo != 0) ? geo->clone() : new PointSource() ;
+	sources.push_back (src) ;
+	return sources.size() - 1 ;
+}
+/*
+ * position of the equivalent point source: for line segments, the projection of the receiver on the
+ * segment, kept slightly inside the segment so that the path passes the alignment checks
+ */
+static Point3D equivalent_source (SourceExt* ext, Point3D const& pos, Point2D const& rec, bool* on_segment = 0)
+{
+	LineSegment* seg = ext->geo.cast_to_ptr<LineSegment>() ;
+	if (on_segment) *on_segment = (seg != 0) ;
+	if (seg == 0) return pos ;
+
+	Vector2D d = (Point2D) seg->p2 - (Point2D) seg->p1 ;
+	double d2 = d * d ;
+	double t = (d2 > 0) ? (((Point2D) rec - (Point2D) seg->p1) * d) / d2 : 0.5 ;
+	t = std::max (0.01, std::min (t, 0.99)) ;
+	return seg->p1 + t * (seg->p2 - seg->p1) ;
+}
+/*
+ * construct the propagation path from the source to a receiver, calculate it and add the energy
+ * of the long-term level to the receiver. Returns false if the receiver is out of range or if the
+ * calculation fails ; failures are counted.
+ */
+bool NoiseMap::calculatePath (Worker& worker, MapSource const& src, SourceExt* ext, Point2D const& rec, Spectrum& energy)
+{
+	NoiseMapOptions const& options = *worker.options ;
+	if (options.SplitLines)
+	{
+		LineSegment* seg = ext->geo.cast_to_ptr<LineSegment>() ;
+		if (seg != 0) return calculateLine (worker, src, *seg, rec, energy) ;
+	}
+	PropagationPath& path = worker.path ;
+	bool on_segment ;
+	Point3D pos = equivalent_source (ext, src.pos, rec, &on_segment) ;
+	if (POW2(pos.x - rec.x) + POW2(pos.y - rec.y) > POW2(options.MaxDistance)) return false ;
+	/*
+	 * vertical profile
+	 */
+	try
+	{
+		if (terrain != 0)
+		{
+			if (!terrain->isInside (pos.x, pos.y) || !terrain->isInside (rec.x, rec.y))
+			{
+				worker.nbFailures++ ;
+				return false ;
+			}
+			terrain->getProfile (pos.x, pos.y, rec.x, rec.y, path, options.ProfileOptions) ;
+			if (on_segment) path[0].pos.z = pos.z ;
+		}
+		else
+		{
+			path.clear() ;
+			path.resize (2) ;
+			path[0].pos = pos ;
+			path[0].mat = ground ;
+			path[1].pos = Position (rec.x, rec.y, 0.0) ;
+			path[1].mat = ground ;
+		}
+		if (obstacles != 0) obstacles->insertObstacles (path) ;
+
+		unsigned int n = path.size() ;
+		path[0].ext = ext ;
+		path[n-1].ext = worker.receiver ;
+		/*
+		 * calculate the path and add the energies of the long-term levels in each frequency band
+		 */
+		PathResult result ;
+		if (!worker.method->doCalculation (path, result))
+		{
+			worker.nbFailures++ ;
+			return false ;
+		}
+		energy += POW10 (result.Leq) ;
+	}
+	catch (std::exception&)
+	{
+		worker.nbFailures++ ;
+		return false ;
+	}
+	worker.nbPaths++ ;
+	return true ;
+}
+/*
+ * split the line segment as seen from the receiver, at the height of the source and the receiver
+ * above the ground, and calculate the path from each elementary source to the receiver. The
+ * elementary sources share a single extension, updated before each path. Returns false if no path
+ * could be calculated.
+ */
+bool NoiseMap::calculateLine (Worker& worker, MapSource const& src, LineSegment const& seg, Point2D const& rec, Spectrum& energy)
+{
+	NoiseMapOptions const& options = *worker.options ;
+	double hs = src.source.sourceHeight ;
+	std::vector<Point3D> polyline (2) ;
+	polyline[0] = Point3D (seg.p1.x, seg.p1.y, hs) ;
+	polyline[1] = Point3D (seg.p2.x, seg.p2.y, hs) ;
+	std::vector<LineElement>& elements = worker.elements ;
+	elements.clear() ;
+	splitLineSource (polyline, Point3D (rec.x, rec.y, grid.height), elements, options.LineSplit) ;
+
+	LineSource* geo = new LineSource() ;
+	ref_ptr<SourceExt> ext = new SourceExt (src.source, geo) ;
+	ext->h = hs ;
+	MapSource element ;
+	Vector2D d = (Point2D) seg.p2 - (Point2D) seg.p1 ;
+	double d2 = d * d ;
+	bool calculated = false ;
+	for (unsigned int k = 0 ; k < elements.size() ; ++k)
+	{
+		LineElement const& e = elements[k] ;
+		geo->length = e.length ;
+		geo->orientation = e.orientation ;
+		/*
+		 * ground position of the element, interpolated along the segment
+		 */
+		double t = (d2 > 0) ? (((Point2D) e.pos - (Point2D) seg.p1) * d) / d2 : 0.5 ;
+		element.pos = seg.p1 + t * (seg.p2 - seg.p1) ;
+		if (calculatePath (worker, element, ext, rec, energy)) calculated = true ;
+	}
+	return calculated ;
+}
+/*
+ * calculate the paths from the candidate sources to a receiver in decreasing order of their upper
+ * bounds, until the sum of the bounds of the remaining sources cannot raise the total energy at 
+ * the receiver by more than the tolerance (see CalculationMethod::getMaxExcessGain for the validity
+ * of the bounds).
+ */
+void NoiseMap::calculateBounded (Worker& worker, Point2D const& rec, Spectrum& energy)
+{
+	NoiseMapOptions const& options = *worker.options ;
+	std::vector<Worker::Candidate>& candidates = worker.candidates ;
+	std::vector<std::pair<double,unsigned int> >& bounds = worker.bounds ;
+	std::vector<double>& remaining = worker.remaining ;
+
+	bounds.clear() ;
+	for (unsigned int k = 0 ; k < candidates.size() ; ++k)
+	{
+		SourceExt* ext = candidates[k].ext ;
+		Point3D pos = equivalent_source (ext, candidates[k].src->pos, rec) ;
+		if (POW2(pos.x - rec.x) + POW2(pos.y - rec.y) > POW2(options.MaxDistance)) continue ;
+		/*
+		 * if the bound cannot be evaluated, the path is always calculated
+		 */
+		Spectrum Lmax ;
+		double bound = HUGE_VAL ;
+		if (worker.method->getUpperBound (ext, pos, worker.receiver, Position (rec.x, rec.y, pos.z), Lmax))
+		{
+			bound = 0 ;
+			for (unsigned int f = 0 ; f < Lmax.size() ; ++f) bound += POW10 (Lmax[f]) ;
+		}
+		bounds.push_back (std::make_pair (bound, k)) ;
+	}
+	std::sort (bounds.begin(), bounds.end(), std::greater<std::pair<double,unsigned int> >()) ;
+
+	unsigned int n = bounds.size() ;
+	remaining.resize (n + 1) ;
+	remaining[n] = 0 ;
+	for (unsigned int k = n ; k > 0 ; --k) remaining[k-1] = remaining[k] + bounds[k-1].first ;
+
+	double factor = pow (10.0, options.Tolerance / 10) - 1 ;
+	double sum = 0 ;
+	for (unsigned int k = 0 ; k < n ; ++k)
+	{
+		if (remaining[k] <= sum * factor)
+		{
+			worker.nbSkipped += n - k ;
+			break ;
+		}
+		Worker::Candidate& c = candidates[bounds[k].second] ;
+		if (!calculatePath (worker, *c.src, c.ext, rec, energy)) continue ;
+		sum = 0 ;
+		for (unsigned int f = 0 ; f < energy.size() ; ++f) sum += energy[f] ;
+	}
+}
+/*
+ * add the point sources to the tree and construct the equivalent sources of the clusters
+ */
+void NoiseMap::buildClusters (SourceTree& tree)
+{
+	treeSources.clear() ;
+	otherSources.clear() ;
+	for (unsigned int k = 0 ; k < sources.size() ; ++k)
+	{
+		MapSource& src = sources[k] ;
+		if (src.geo->GetSpectrumType() == SpectrumType::PointSource)
+		{
+			tree.addSource (src.pos, src.source) ;
+			treeSources.push_back (k) ;
+		}
+		else
+		{
+			otherSources.push_back (k) ;
+		}
+	}
+	tree.build() ;
+
+	clusters.resize (tree.getNbClusters()) ;
+	for (unsigned int k = 0 ; k < clusters.size() ; ++k)
+	{
+		SourceCluster const& node = tree.getCluster (k) ;
+		clusters[k].pos = node.pos ;
+		clusters[k].source = node.source ;
+		clusters[k].geo = new PointSource() ;
+	}
+}
+/*
+ * sources to be calculated for the receivers of a tile
+ */
+void NoiseMap::selectSources (Worker& worker, double xmin, double ymin, double xmax, double ymax)
+{
+	std::vector<MapSource*>& selected = worker.selected ;
+	selected.clear() ;
+	if (tree == 0)
+	{
+		for (unsigned int k = 0 ; k < sources.size() ; ++k) selected.push_back (&sources[k]) ;
+		return ;
+	}
+	NoiseMapOptions const& options = *worker.options ;
+	worker.selectedClusters.clear() ;
+	worker.selectedMembers.clear() ;
+	tree->select (xmin, ymin, xmax, ymax, options.ClusterAngle, options.MaxDistance, 
+				  worker.selectedClusters, worker.selectedMembers) ;
+	for (unsigned int k = 0 ; k < worker.selectedClusters.size() ; ++k)
+	{
+		selected.push_back (&clusters[worker.selectedClusters[k]]) ;
+	}
+	for (unsigned int k = 0 ; k < worker.selectedMembers.size() ; ++k)
+	{
+		selected.push_back (&sources[treeSources[worker.selectedMembers[k]]]) ;
+	}
+	for (unsigned int k = 0 ; k < otherSources.size() ; ++k)
+	{
+		selected.push_back (&sources[otherSources[k]]) ;
+	}
+}
+/*
+ * calculate all paths between the sources and the receivers of a tile
+ */
+void NoiseMap::calculateTile (Worker& worker, Strip& strip, unsigned int tile)
+{
+	NoiseMapOptions const& options = *worker.options ;
+	unsigned int size = std::max (options.TileSize, 1u) ;
+	unsigned int i0 = (tile % strip.ntx) * size ;
+	unsigned int i1 = std::min (i0 + size, grid.nx) ;
+	unsigned int j0 = strip.j0 + (tile / strip.ntx) * size ;
+	unsigned int j1 = std::min (j0 + size, strip.j0 + strip.nbRows) ;
+	unsigned int nb_cols = i1 - i0 ;
+	unsigned int nb_rec = nb_cols * (j1 - j0) ;
+
+	std::vector<Spectrum>& energy = worker.energy ;
+	energy.assign (nb_rec, Spectrum (0.0)) ;
+	/*
+	 * extent of the tile
+	 */
+	double xmin = grid.x0 + i0 * grid.step ;
+	double xmax = grid.x0 + (i1 - 1) * grid.step ;
+	double ymin = grid.y0 + j0 * grid.step ;
+	double ymax = grid.y0 + (j1 - 1) * grid.step ;
+
+	selectSources (worker, xmin, ymin, xmax, ymax) ;
+	for (unsigned int k = 0 ; k < worker.selected.size() ; ++k)
+	{
+		MapSource& src = *worker.selected[k] ;
+		/*
+		 * ignore sources that are too far away from all receivers in the tile
+		 */
+		double sxmin = src.pos.x, sxmax = src.pos.x ;
+		double symin = src.pos.y, symax = src.pos.y ;
+		LineSegment* seg = src.geo.cast_to_ptr<LineSegment>() ;
+		if (seg != 0)
+		{
+			sxmin = std::min (seg->p1.x, seg->p2.x) ; sxmax = std::max (seg->p1.x, seg->p2.x) ;
+			symin = std::min (seg->p1.y, seg->p2.y) ; symax = std::max (seg->p1.y, seg->p2.y) ;
+		}
+		double dx = std::max (0.0, std::max (sxmin - xmax, xmin - sxmax)) ;
+		double dy = std::max (0.0, std::max (symin - ymax, ymin - symax)) ;
+		if (POW2(dx) + POW2(dy) > POW2(options.MaxDistance)) continue ;
+		/*
+		 * source extension, owned by this thread and shared by the paths to all receivers in the tile
+		 */
+		ref_ptr<SourceExt> ext = new SourceExt (src.source, src.geo->clone()) ;
+		ext->h = src.source.sourceHeight ;
+
+		if (options.Tolerance > 0)
+		{
+			Worker::Candidate c ;
+			c.src = &src ;
+			c.ext = ext ;
+			worker.candidates.push_back (c) ;
+			continue ;
+		}
+		for (unsigned int j = j0 ; j < j1 ; ++j)
+		{
+			for (unsigned int i = i0 ; i < i1 ; ++i)
+			{
+				Point2D rec (grid.x0 + i * grid.step, grid.y0 + j * grid.step) ;
+				calculatePath (worker, src, ext, rec, energy[(j - j0) * nb_cols + (i - i0)]) ;
+			}
+		}
+	}
+	/*
+	 * with a tolerance, the sources are processed receiver by receiver
+	 */
+	if (options.Tolerance > 0)
+	{
+		for (unsigned int j = j0 ; j < j1 ; ++j)
+		{
+			for (unsigned int i = i0 ; i < i1 ; ++i)
+			{
+				Point2D rec (grid.x0 + i * grid.step, grid.y0 + j * grid.step) ;
+				calculateBounded (worker, rec, energy[(j - j0) * nb_cols + (i - i0)]) ;
+			}
+		}
+		worker.candidates.clear() ;
+	}
+	/*
+	 * convert the energies to A-weighted levels (the long-term levels are already A-weighted)
+	 */
+	for (unsigned int j = j0 ; j < j1 ; ++j)
+	{
+		for (unsigned int i = i0 ; i < i1 ; ++i)
+		{
+			Spectrum& e = energy[(j - j0) * nb_cols + (i - i0)] ;
+			double sum = 0 ;
+			for (unsigned int f = 0 ; f < e.size() ; ++f) sum += e[f] ;
+			strip.levels[(j - strip.j0) * grid.nx + i] = (float) ((sum > 0) ? 10 * log10 (sum) : NODATA_VALUE) ;
+		}
+	}
+}
+/*
+ * calculation thread: take tiles from the current strip until all tiles have been taken
+ */
+void NoiseMap::threadMain (void* arg)
+{
+	Worker& worker = *(Worker*) arg ;
+	Strip& strip = *worker.strip ;
+	while (true)
+	{
+		long tile = atomic_increment (&strip.nextTile) - 1 ;
+		if (tile >= (long) strip.nbTiles) break ;
+		worker.map->calculateTile (worker, strip, (unsigned int) tile) ;
+
+		ProgressState& progress = *worker.progress ;
+		AcquireLock (progress.lock) ;
+		progress.done++ ;
+		if (progress.callback) progress.callback (progress.done, progress.total, progress.userData) ;
+		ReleaseLock (progress.lock) ;
+	}
+}
+
+bool NoiseMap::calculate (NoiseMapOptions const& options, const char* fileName)
+{
+	double start_time = wall_time() ;
+	nbPaths = 0 ;
+	nbFailures = 0 ;
+	nbSkipped = 0 ;
+	elapsedTime = 0 ;
+	if (grid.nx == 0 || grid.ny == 0) return false ;
+
+	unsigned int nb_threads = (options.NbThreads > 0) ? options.NbThreads : processor_count() ;
+	unsigned int size = std::max (options.TileSize, 1u) ;
+	unsigned int ntx = (grid.nx + size - 1) / size ;
+	unsigned int nty = (grid.ny + size - 1) / size ;
+	/*
+	 * each strip contains enough tiles to keep all threads busy until (almost) the end of the strip
+	 */
+	unsigned int strip_size = std::max ((4 * nb_threads + ntx - 1) / ntx, 1u) ;
+	/*
+	 * each thread uses its own instance of the calculation method
+	 */
+	Strip strip ;
+	ProgressState progress ;
+	std::vector<Worker> workers (nb_threads) ;
+	std::vector<void*> args (nb_threads) ;
+	for (unsigned int k = 0 ; k < nb_threads ; ++k)
+	{
+		Worker& worker = workers[k] ;
+		worker.map = this ;
+		worker.strip = &strip ;
+		worker.options = &options ;
+		worker.progress = &progress ;
+		worker.method = getCalculationMethod (options.Method) ;
+		if (worker.method == 0) return false ;
+		worker.method->setOptions (options.PathOptions) ;
+		worker.receiver = new ReceiverExt (grid.height) ;
+		worker.nbPaths = 0 ;
+		worker.nbFailures = 0 ;
+		worker.nbSkipped = 0 ;
+		args[k] = &worker ;
+	}
+	/*
+	 * header of the ESRI ASCII grid
+	 */
+	FILE* fp = 0 ;
+	if (fileName != 0)
+	{
+		fp = fopen (fileName, "wt") ;
+		if (fp == 0) return false ;
+		fprintf (fp, "ncols %d\nnrows %d\n", grid.nx, grid.ny) ;
+		fprintf (fp, "xllcenter %.3f\nyllcenter %.3f\ncellsize %.3f\n", grid.x0, grid.y0, grid.step) ;
+		fprintf (fp, "NODATA_value %.0f\n", NODATA_VALUE) ;
+	}
+	InitLock (progress.lock) ;
+	progress.done = 0 ;
+	progress.total = ntx * nty ;
+	progress.callback = options.Progress ;
+	progress.userData = options.ProgressData ;
+	/*
+	 * clusters of point sources, the tree is only used during the calculation
+	 */
+	SourceTree source_tree ;
+	tree = 0 ;
+	if (options.ClusterAngle > 0)
+	{
+		buildClusters (source_tree) ;
+		tree = &source_tree ;
+	}
+	/*
+	 * calculate the strips from north to south, i.e. in the order of the rows in the output file
+	 */
+	for (int r1 = (int) nty ; r1 > 0 ; r1 -= strip_size)
+	{
+		int r0 = std::max (r1 - (int) strip_size, 0) ;
+		strip.j0 = r0 * size ;
+		strip.nbRows = std::min (r1 * size, grid.ny) - strip.j0 ;
+		strip.ntx = ntx ;
+		strip.nbTiles = ntx * (r1 - r0) ;
+		strip.nextTile = 0 ;
+		strip.levels.assign (strip.nbRows * grid.nx, (float) NODATA_VALUE) ;
+
+		run_parallel (nb_threads, threadMain, &args[0]) ;
+
+		if (fp == 0) continue ;
+		for (int j = strip.nbRows - 1 ; j >= 0 ; --j)
+		{
+			float* row = &strip.levels[j * grid.nx] ;
+			for (unsigned int i = 0 ; i < grid.nx ; ++i) fprintf (fp, (i > 0) ? " %.2f" : "%.2f", row[i]) ;
+			fprintf (fp, "\n") ;
+		}
+	}
+	DeleteLock (progress.lock) ;
+	if (fp != 0) fclose (fp) ;
+	tree = 0 ;
+	clusters.clear() ;
+
+	for (unsigned int k = 0 ; k < nb_threads ; ++k)
+	{
+		nbPaths += workers[k].nbPaths ;
+		nbFailures += workers[k].nbFailures ;
+		nbSkipped += workers[k].nbSkipped ;
+	}
+	elapsedTime = wall_time() - start_time ;
+	return true ;
+}
@@ -0,0 +1,168 @@
+#pragma once
+/*
+ * ------------------------------------------------------------------------------------------------
+ * file:		NoiseMap.h
+ * version:		1.0
+ * author:		dirk.van-maercke@cstb.fr
+ * copyright:	see file licence.EU.txt
+ * description: calculation of noise maps on a regular grid of receivers
+ * note:		the receivers are grouped in square tiles. A tile is calculated by a single thread,
+ *				which constructs the propagation paths from all sources to all receivers in the tile
+ *				and accumulates the energies per frequency band in a buffer small enough to stay in
+ *				cache. Tiles are calculated in horizontal strips, from north to south; each strip is
+ *				written to the output raster as soon as it is complete, so that the memory used does
+ *				not depend on the number of rows of the grid.
+ * changes:
+ *
+ *	18/10/2026	initial version
+ *
+ *	18/10/2026	optional culling of weak contributions, based on upper bounds of the levels
+ *
+ *	18/10/2026	optional clustering of distant point sources (see SourceTree)
+ *
+ *	18/10/2026	optional adaptive subdivision of line segments (see LineSplitter)
+ * -------------------------------------------------------------------------------------------------
+ */
+#include "PropagationPath.h"
+#include "TerrainModel.h"
+#include "ObstacleIndex.h"
+#include "SourceTree.h"
+#include "LineSplitter.h"
+#include <vector>
+
+namespace CnossosEU
+{
+	/*
+	 * regular grid of receivers at positions (x0 + i * step, y0 + j * step), all at the same height
+	 * above the local ground
+	 */
+	struct NoiseMapGrid
+	{
+		double		 x0 ;
+		double		 y0 ;
+		double		 step ;
+		unsigned int nx ;
+		unsigned int ny ;
+		double		 height ;
+
+		NoiseMapGrid (void) : x0 (0), y0 (0), step (10.0), nx (0), ny (0), height (4.0) { }
+	} ;
+	/*
+	 * progress callback, called after each tile with the number of tiles done and the total number
+	 * of tiles. Calls are serialized but may come from any of the calculation threads.
+	 */
+	typedef void (*NoiseMapProgress) (unsigned int done, unsigned int total, void* userData) ;
+	/*
+	 * calculation options
+	 */
+	struct NoiseMapOptions
+	{
+		const char*				Method ;			// name of the calculation method (see getCalculationMethod)
+		PropagationPathOptions	PathOptions ;		// options of the calculation method
+		TerrainProfileOptions	ProfileOptions ;	// options of the extraction of terrain profiles
+		double					MaxDistance ;		// sources further away from a receiver are ignored
+		double					Tolerance ;			// target error (dB) of the culling of weak contributions, 0 = no culling
+		double					ClusterAngle ;		// maximum angle (degrees) under which clusters of point sources are replaced by an equivalent source, 0 = no clustering
+		bool					SplitLines ;		// line segments are split into elementary sources as seen from each receiver
+		LineSplitOptions		LineSplit ;			// subdivision criteria of the line segments
+		unsigned int			NbThreads ;			// number of threads, 0 = number of processors
+		unsigned int			TileSize ;			// number of receivers along the side of a tile
+		NoiseMapProgress		Progress ;			// optional progress callback
+		void*					ProgressData ;		// user data passed to the progress callback
+
+		NoiseMapOptions (void)
+		: Method ("CNOSSOS-2018"), PathOptions(), ProfileOptions(), MaxDistance (2000.0), Tolerance (0.0),
+		  ClusterAngle (0.0), SplitLines (false), LineSplit(), NbThreads (0), TileSize (16), Progress (0), ProgressData (0) { }
+	} ;
+	/*
+	 * noise map calculation
+	 *
+	 * the terrain, the obstacles and the sources must not be modified while the calculation is
+	 * running. Without a terrain model, the ground is flat (z = 0) and made of a single material.
+	 */
+	class NoiseMap
+	{
+	public:
+		NoiseMap (NoiseMapGrid const& grid) ;
+		~NoiseMap (void) ;
+		/*
+		 * environment
+		 */
+		void setTerrain (TerrainModel const* terrain) { this->terrain = terrain ; }
+		void setObstacles (ObstacleIndex const* obstacles) { this->obstacles = obstacles ; }
+		void setGroundMaterial (Material* mat) { ground = mat ; }
+		/*
+		 * add a source and return its index. The geometry of the source is cloned and defaults to
+		 * a point source. For line segments, the position is ignored: each receiver uses its
+		 * projection on the segment as the position of the equivalent point source or, if the
+		 * option SplitLines is set, the elementary sources of the adaptive subdivision of the
+		 * segment as seen from the receiver (see splitLineSource). Positions are given at ground
+		 * level, the source height is taken from the elementary source.
+		 */
+		unsigned int addSource (Geometry::Point3D const& pos, ElementarySource const& source, SourceGeometry* geo = 0) ;
+		unsigned int getNbSources (void) const { return sources.size() ; }
+		/*
+		 * calculate the long-term averaged A-weighted levels (Leq) at all receivers and write them to
+		 * an ESRI ASCII grid file. If fileName is null, the results are calculated but not stored.
+		 * Returns false if the calculation method or the output file is invalid.
+		 *
+		 * If a tolerance is specified, the paths to each receiver are calculated in decreasing order
+		 * of their upper bounds (see CalculationMethod::getUpperBound) and the remaining paths are
+		 * skipped as soon as the sum of their bounds cannot raise the level by more than the tolerance.
+		 * The error only stays below the tolerance if the bounds hold, which is not guaranteed for the
+		 * methods with an empirical maximum gain of the excess attenuation (CNOSSOS-2018, JRC-draft-2010).
+		 *
+		 * If a cluster angle is specified, the point sources are grouped in a quadtree and, for each
+		 * tile, the clusters seen from the tile under a smaller angle are replaced by their equivalent
+		 * source. Line segments and sources with other geometries are never clustered.
+		 */
+		bool calculate (NoiseMapOptions const& options, const char* fileName = 0) ;
+		/*
+		 * statistics of the last calculation (number of paths calculated, failed or skipped, elapsed time
+		 * in seconds)
+		 */
+		double getNbPaths (void) const { return nbPaths ; }
+		double getNbFailures (void) const { return nbFailures ; }
+		double getNbSkipped (void) const { return nbSkipped ; }
+		double getElapsedTime (void) const { return elapsedTime ; }
+
+	private:
+
+		struct MapSource
+		{
+			Geometry::Point3D				pos ;
+			ElementarySource				source ;
+			System::ref_ptr<SourceGeometry>	geo ;
+		} ;
+
+		struct Worker ;
+		struct Strip ;
+
+		NoiseMapGrid					grid ;
+		TerrainModel const*				terrain ;
+		ObstacleIndex const*			obstacles ;
+		System::ref_ptr<Material>		ground ;
+		std::vector<MapSource>			sources ;
+		SourceTree const*				tree ;				// clusters of point sources, during the calculation
+		std::vector<MapSource>			clusters ;			// equivalent sources of the nodes of the tree
+		std::vector<unsigned int>		treeSources ;		// index of the sources in the tree
+		std::vector<unsigned int>		otherSources ;		// index of the sources that are not clustered
+		double							nbPaths ;
+		double							nbFailures ;
+		double							nbSkipped ;
+		double							elapsedTime ;
+
+		void buildClusters (SourceTree& tree) ;
+		void selectSources (Worker& worker, double xmin, double ymin, double xmax, double ymax) ;
+		void calculateTile (Worker& worker, Strip& strip, unsigned int tile) ;
+		void calculateBounded (Worker& worker, Geometry::Point2D const& rec, Spectrum& energy) ;
+		bool calculatePath (Worker& worker, MapSource const& src, SourceExt* ext,
+							Geometry::Point2D const& rec, Spectrum& energy) ;
+		bool calculateLine (Worker& worker, MapSource const& src, LineSegment const& seg,
+							Geometry::Point2D const& rec, Spectrum& energy) ;
+		static void threadMain (void* arg) ;
+
+		NoiseMap (NoiseMap const&) ;
+		NoiseMap& operator= (NoiseMap const&) ;
+	} ;
+}
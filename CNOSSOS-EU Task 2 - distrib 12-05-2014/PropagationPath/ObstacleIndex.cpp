@@ -0,0 +1,315 @@
+/*
+ * ------------------------------------------------------------------------------------------------
+ * file:		ObstacleIndex.cpp
+ * version:		1.0
+ * author:		dirk.van-maercke@cstb.fr
+ * copyright:	see file licence.EU.txt
+ * description: spatial index of barriers and buildings
+ * changes:
+ *
+ *	18/10/2026	initial version
+ * -------------------------------------------------------------------------------------------------
+ */
+#include "ObstacleIndex.h"
+#include "ErrorMessage.h"
+#include <math.h>
+#include <algorithm>
+
+using namespace CnossosEU ;
+using namespace System ;
+using namespace Geometry ;
+
+#define POW2(x) ((x)*(x))
+
+ObstacleIndex::ObstacleIndex (double _cellSize)
+: cellSize (_cellSize), x0 (0), y0 (0), nx (0), ny (0), built (false)
+{
+}
+
+ObstacleIndex::~ObstacleIndex (void)
+{
+}
+
+unsigned int ObstacleIndex::addBarrier (std::vector<Point2D> const& polyline, double h, Material* mat)
+{
+	return addObstacle (polyline, h, mat, ObstacleCrossing::Barrier) ;
+}
+
+unsigned int ObstacleIndex::addBuilding (std::vector<Point2D> const& footprint, double h, Material* mat)
+{
+	return addObstacle (footprint, h, mat, ObstacleCrossing::Building) ;
+}
+
+unsigned int ObstacleIndex::addObstacle (std::vector<Point2D> const& pos, double h, Material* mat,
+										 ObstacleCrossing::ObstacleType type)
+{
+	if (pos.size() < 2) signal_error (ErrorMessage ("Obstacle must have at least two vertices")) ;
+
+	unsigned int id = obstacles.size() ;
+	Obstacle obstacle ;
+	obstacle.h = h ;
+	obstacle.mat = (mat != 0) ? mat : getMaterial ("A0") ;
+	obstacle.type = type ;
+	obstacles.push_back (obstacle) ;
+	/*
+	 * the footprint of a building is closed by an additional edge from the last to the first vertex
+	 */
+	unsigned int n = pos.size() ;
+	unsigned int nb_edges = (type == ObstacleCrossing::Building) ? n : n - 1 ;
+	for (unsigned int i = 0 ; i < nb_edges ; ++i)
+	{
+		Edge edge ;
+		edge.a = pos[i] ;
+		edge.b = pos[(i + 1) % n] ;
+		edge.obstacle = id ;
+		edge.last = (type == ObstacleCrossing::Barrier && i == nb_edges - 1) ;
+		edges.push_back (edge) ;
+	}
+	built = false ;
+	return id ;
+}
+/*
+ * register each edge in all the cells overlapping its bounding box, slightly enlarged so that
+ * crossings close to the boundary of a cell are found in the cells on both sides
+ */
+void ObstacleIndex::build (void)
+{
+	cellStart.clear() ;
+	cellEdges.clear() ;
+	nx = ny = 0 ;
+	built = true ;
+	if (edges.empty()) return ;
+
+	double xmin = edges[0].a.x, xmax = xmin ;
+	double ymin = edges[0].a.y, ymax = ymin ;
+	double total_length = 0 ;
+	for (unsigned int k = 0 ; k < edges.size() ; ++k)
+	{
+		Edge const& e = edges[k] ;
+		xmin = std::min (xmin, std::min (e.a.x, e.b.x)) ;
+		xmax = std::max (xmax, std::max (e.a.x, e.b.x)) ;
+		ymin = std::min (ymin, std::min (e.a.y, e.b.y)) ;
+		ymax = std::max (ymax, std::max (e.a.y, e.b.y)) ;
+		total_length += dist (e.a, e.b) ;
+	}
+	/*
+	 * default cell size: about two edges per cell, but not smaller than the average length of
+	 * the edges
+	 */
+	double size = cellSize ;
+	if (size <= 0)
+	{
+		double area = std::max ((xmax - xmin) * (ymax - ymin), 1.0) ;
+		size = std::max (sqrt (2 * area / edges.size()), total_length / edges.size()) ;
+	}
+	size = std::max (size, 1.E-3 * std::max (xmax - xmin, ymax - ymin)) ;
+	size = std::max (size, 1.E-3) ;
+	x0 = xmin ;
+	y0 = ymin ;
+	nx = (unsigned int) floor ((xmax - xmin) / size) + 1 ;
+	ny = (unsigned int) floor ((ymax - ymin) / size) + 1 ;
+	cellSize = size ;
+	/*
+	 * count the edges in each cell, then store them in a single array
+	 */
+	double eps = 1.E-6 * cellSize ;
+	cellStart.assign (nx * ny + 1, 0) ;
+	for (int pass = 0 ; pass < 2 ; ++pass)
+	{
+		if (pass == 1)
+		{
+			for (unsigned int k = 0 ; k < nx * ny ; ++k) cellStart[k+1] += cellStart[k] ;
+			cellEdges.resize (cellStart[nx * ny]) ;
+		}
+		for (unsigned int k = 0 ; k < edges.size() ; ++k)
+		{
+			Edge const& e = edges[k] ;
+			int i0 = (int) floor ((std::min (e.a.x, e.b.x) - eps - x0) / cellSize) ;
+			int i1 = (int) floor ((std::max (e.a.x, e.b.x) + eps - x0) / cellSize) ;
+			int j0 = (int) floor ((std::min (e.a.y, e.b.y) - eps - y0) / cellSize) ;
+			int j1 = (int) floor ((std::max (e.a.y, e.b.y) + eps - y0) / cellSize) ;
+			i0 = std::max (i0, 0) ; i1 = std::min (i1, (int) nx - 1) ;
+			j0 = std::max (j0, 0) ; j1 = std::min (j1, (int) ny - 1) ;
+			for (int j = j0 ; j <= j1 ; ++j)
+			{
+				for (int i = i0 ; i <= i1 ; ++i)
+				{
+					unsigned int cell = j * nx + i ;
+					if (pass == 0)
+						cellStart[cell+1]++ ;
+					else
+						cellEdges[cellStart[cell]++] = k ;
+				}
+			}
+		}
+	}
+	/*
+	 * the second pass moved the start of each cell to the start of the next one
+	 */
+	for (unsigned int k = nx * ny ; k > 0 ; --k) cellStart[k] = cellStart[k-1] ;
+	cellStart[0] = 0 ;
+}
+
+static bool sort_by_position (ObstacleCrossing const& c1, ObstacleCrossing const& c2)
+{
+	return c1.t < c2.t ;
+}
+/*
+ * traverse the cells crossed by the line, from source to receiver. Each crossing is only accepted
+ * in the cell where it is located along the line, so that edges registered in multiple cells are
+ * never reported twice.
+ */
+unsigned int ObstacleIndex::getCrossings (Point2D const& src, Point2D const& rec,
+										  std::vector<ObstacleCrossing>& crossings) const
+{
+	assert (built) ;
+	crossings.clear() ;
+	if (!built || nx == 0) return 0 ;
+
+	Vector2D d = rec - src ;
+	if (d.x == 0 && d.y == 0) return 0 ;
+	/*
+	 * clip the line to the extent of the grid
+	 */
+	double t0 = 0 ;
+	double t1 = 1 ;
+	double lo[2] = { x0, y0 } ;
+	double hi[2] = { x0 + nx * cellSize, y0 + ny * cellSize } ;
+	for (int k = 0 ; k < 2 ; ++k)
+	{
+		if (d.coord[k] == 0)
+		{
+			if (src.coord[k] < lo[k] || src.coord[k] > hi[k]) return 0 ;
+			continue ;
+		}
+		double ta = (lo[k] - src.coord[k]) / d.coord[k] ;
+		double tb = (hi[k] - src.coord[k]) / d.coord[k] ;
+		t0 = std::max (t0, std::min (ta, tb)) ;
+		t1 = std::min (t1, std::max (ta, tb)) ;
+	}
+	if (t0 > t1) return 0 ;
+	/*
+	 * first cell and parameters of the traversal
+	 */
+	double u = (src.x + t0 * d.x - x0) / cellSize ;
+	double v = (src.y + t0 * d.y - y0) / cellSize ;
+	int i = std::max (0, std::min ((int) floor (u), (int) nx - 1)) ;
+	int j = std::max (0, std::min ((int) floor (v), (int) ny - 1)) ;
+	int si = (d.x > 0) ? 1 : -1 ;
+	int sj = (d.y > 0) ? 1 : -1 ;
+	double du = d.x / cellSize ;
+	double dv = d.y / cellSize ;
+	double tu = (du != 0) ? t0 + ((du > 0 ? i + 1 : i) - u) / du : HUGE_VAL ;
+	double tv = (dv != 0) ? t0 + ((dv > 0 ? j + 1 : j) - v) / dv : HUGE_VAL ;
+	double dtu = (du != 0) ? fabs (1 / du) : 0 ;
+	double dtv = (dv != 0) ? fabs (1 / dv) : 0 ;
+
+	double t_enter = t0 ;
+	while (true)
+	{
+		double t_exit = std::min (std::min (tu, tv), t1) ;
+		bool last_cell = (t_exit >= t1) ;
+		unsigned int cell = j * nx + i ;
+		for (unsigned int k = cellStart[cell] ; k < cellStart[cell+1] ; ++k)
+		{
+			Edge const& e = edges[cellEdges[k]] ;
+			Vector2D de = e.b - e.a ;
+			double det = d ^ de ;
+			if (det == 0) continue ;
+			Vector2D w = e.a - src ;
+			double t = (w ^ de) / det ;
+			if (t <= 0 || t >= 1 || t < t_enter || t > t_exit || (t == t_exit && !last_cell)) continue ;
+			double s = (w ^ d) / det ;
+			if (s < 0 || s > 1 || (s == 1 && !e.last)) continue ;
+
+			Obstacle const& obstacle = obstacles[e.obstacle] ;
+			ObstacleCrossing crossing ;
+			crossing.t = t ;
+			crossing.pos = Point2D (src.x + t * d.x, src.y + t * d.y) ;
+			crossing.h = obstacle.h ;
+			crossing.mat = obstacle.mat ;
+			crossing.id = e.obstacle ;
+			crossing.type = obstacle.type ;
+			crossings.push_back (crossing) ;
+		}
+		if (last_cell) break ;
+		/*
+		 * next cell
+		 */
+		t_enter = t_exit ;
+		if (tu <= tv)
+		{
+			i += si ; tu += dtu ;
+		}
+		else
+		{
+			j += sj ; tv += dtv ;
+		}
+		if (i < 0 || j < 0 || i >= (int) nx || j >= (int) ny) break ;
+	}
+	std::sort (crossings.begin(), crossings.end(), sort_by_position) ;
+	return crossings.size() ;
+}
+/*
+ * insert barrier control points in the path, ordered from source to receiver
+ */
+unsigned int ObstacleIndex::insertObstacles (PropagationPath& path) const
+{
+	unsigned int n = path.size() ;
+	if (n < 2) return 0 ;
+
+	Point2D src = path[0].pos ;
+	Point2D rec = path[n-1].pos ;
+	std::vector<ObstacleCrossing> crossings ;
+	unsigned int m = getCrossings (src, rec, crossings) ;
+	if (m == 0) return 0 ;
+	/*
+	 * relative position and elevation of the existing control points along the line
+	 */
+	Vector2D d = rec - src ;
+	double d2 = d * d ;
+	std::vector<double> t (n) ;
+	std::vector<double> z (n) ;
+	for (unsigned int k = 0 ; k < n ; ++k)
+	{
+		t[k] = (((Point2D) path[k].pos - src) * d) / d2 ;
+		z[k] = path[k].pos.z ;
+	}
+	/*
+	 * merge the existing control points and the crossings, moving the existing control points to
+	 * the new path without cloning their extensions
+	 */
+	PropagationPath new_path ;
+	new_path.resize (n + m) ;
+	unsigned int k = 0 ;
+	unsigned int pos = 0 ;
+	for (unsigned int c = 0 ; c < m ; ++c)
+	{
+		ObstacleCrossing const& crossing = crossings[c] ;
+		while (k < n - 1 && t[k] <= crossing.t) new_path[pos++].swap (path[k++]) ;
+		assert (k > 0) ;
+		/*
+		 * crossings at the position of an intermediate terrain point become extensions of this point
+		 */
+		if (t[k-1] == crossing.t && k > 1 && !new_path[pos-1].ext)
+		{
+			new_path[pos-1].ext = new BarrierExt (crossing.h, crossing.mat) ;
+			continue ;
+		}
+		double f = (crossing.t - t[k-1]) / (t[k] - t[k-1]) ;
+		ControlPoint& cp = new_path[pos++] ;
+		cp.pos = Position (crossing.pos.x, crossing.pos.y, z[k-1] + f * (z[k] - z[k-1])) ;
+		cp.mat = path[k].mat ;
+		cp.ext = new BarrierExt (crossing.h, crossing.mat) ;
+	}
+	while (k < n) new_path[pos++].swap (path[k++]) ;
+	new_path.resize (pos) ;
+	path.cp.swap (new_path.cp) ;
+	return m ;
+}
+
+size_t ObstacleIndex::getMemoryUsage (void) const
+{
+	return sizeof (ObstacleIndex) + obstacles.size() * sizeof (Obstacle) + edges.size() * sizeof (Edge)
+		 + cellStart.size() * sizeof (unsigned int) + cellEdges.size() * sizeof (unsigned int) ;
+}
@@ -0,0 +1,121 @@
+#pragma once
+/*
+ * ------------------------------------------------------------------------------------------------
+ * file:		ObstacleIndex.h
+ * version:		1.0
+ * author:		dirk.van-maercke@cstb.fr
+ * copyright:	see file licence.EU.txt
+ * description: spatial index of barriers and buildings, for the automatic construction of the
+ *				diffraction points of propagation paths
+ * note:		the edges of all obstacles are stored in a uniform grid of square cells. Queries
+ *				traverse the cells crossed by the line from source to receiver and only test the
+ *				edges registered in these cells. Once built, the index is read-only and can be
+ *				shared by multiple threads.
+ * changes:
+ *
+ *	18/10/2026	initial version
+ * -------------------------------------------------------------------------------------------------
+ */
+#include "PropagationPath.h"
+#include "Material.h"
+#include <vector>
+
+namespace CnossosEU
+{
+	/*
+	 * intersection of the line between source and receiver with the edge of an obstacle
+	 */
+	struct ObstacleCrossing
+	{
+		enum ObstacleType
+		{
+			Barrier  = 0,
+			Building = 1
+		} ;
+		double				t ;			// relative position along the line (0 = source, 1 = receiver)
+		Geometry::Point2D	pos ;		// position in the horizontal plane
+		double				h ;			// height of the obstacle above the local ground
+		Material*			mat ;		// material of the obstacle
+		unsigned int		id ;		// index of the obstacle, in order of insertion
+		ObstacleType		type ;
+	} ;
+	/*
+	 * spatial index of barriers (polylines) and buildings (closed footprints), both with a constant
+	 * height above the local ground
+	 */
+	class ObstacleIndex
+	{
+	public:
+		/*
+		 * construct an empty index; if cellSize is zero, the size of the cells is selected
+		 * automatically from the number and the size of the edges
+		 */
+		ObstacleIndex (double cellSize = 0.0) ;
+		~ObstacleIndex (void) ;
+		/*
+		 * add an obstacle and return its index. The footprint of buildings is closed automatically.
+		 * If no material is specified, obstacles are reflecting (A0).
+		 */
+		unsigned int addBarrier (std::vector<Geometry::Point2D> const& polyline, double h, Material* mat = 0) ;
+		unsigned int addBuilding (std::vector<Geometry::Point2D> const& footprint, double h, Material* mat = 0) ;
+		/*
+		 * construct the grid, must be called after adding the obstacles and before any query
+		 */
+		void build (void) ;
+		/*
+		 * get all crossings strictly between source and receiver, ordered from source to receiver.
+		 * A building crossed by the line produces (at least) two crossings, where the line enters
+		 * and leaves the footprint. Returns the number of crossings.
+		 */
+		unsigned int getCrossings (Geometry::Point2D const& src, Geometry::Point2D const& rec,
+								   std::vector<ObstacleCrossing>& crossings) const ;
+		/*
+		 * insert the crossings with the line between the first and the last control point of the
+		 * path as barrier control points. The elevation of the new control points is interpolated
+		 * from the neighbouring control points, which must be ordered from source to receiver (e.g.
+		 * as produced by TerrainModel::getProfile). Returns the number of crossings.
+		 */
+		unsigned int insertObstacles (PropagationPath& path) const ;
+		/*
+		 * statistics
+		 */
+		unsigned int getNbObstacles (void) const { return obstacles.size() ; }
+		unsigned int getNbEdges (void) const { return edges.size() ; }
+		unsigned int getNbCells (void) const { return nx * ny ; }
+		size_t getMemoryUsage (void) const ;
+
+	private:
+
+		struct Obstacle
+		{
+			double						 h ;
+			System::ref_ptr<Material>	 mat ;
+			ObstacleCrossing::ObstacleType type ;
+		} ;
+
+		struct Edge
+		{
+			Geometry::Point2D a ;
+			Geometry::Point2D b ;
+			unsigned int	  obstacle ;
+			bool			  last ;		// last edge of a barrier, includes its end point
+		} ;
+
+		double cellSize ;
+		double x0 ;
+		double y0 ;
+		unsigned int nx ;
+		unsigned int ny ;
+		bool built ;
+		std::vector<Obstacle> obstacles ;
+		std::vector<Edge> edges ;
+		std::vector<unsigned int> cellStart ;		// edges in cell k are cellEdges[cellStart[k]...cellStart[k+1]-1]
+		std::vector<unsigned int> cellEdges ;
+
+		unsigned int addObstacle (std::vector<Geometry::Point2D> const& pos, double h, Material* mat,
+								  ObstacleCrossing::ObstacleType type) ;
+
+		ObstacleIndex (ObstacleIndex const&) ;
+		ObstacleIndex& operator= (ObstacleIndex const&) ;
+	} ;
+}
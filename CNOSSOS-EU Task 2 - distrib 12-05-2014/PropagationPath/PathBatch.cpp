@@ -0,0 +1,911 @@
+/*
+ * ------------------------------------------------------------------------------------------------
+ * file:		PathBatch.cpp
+ * version:		1.0
+ * author:		dirk.van-maercke@cstb.fr
+ * copyright:	see file licence.EU.txt
+ * description: compact binary container for large numbers of propagation paths
+ * changes:
+ *
+ *	18/10/2026	initial version
+ * -------------------------------------------------------------------------------------------------
+ */
+#include "PathBatch.h"
+#include "SourceGeometry.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace CnossosEU ;
+using namespace System ;
+using namespace Geometry ;
+
+static const char MAGIC[8] = { 'C', 'N', 'O', 'S', 'B', 'T', 'C', 'H' } ;
+static const uint32_t VERSION = 1 ;
+static const unsigned int HEADER_SIZE = 48 ;
+static const uint16_t NO_MATERIAL = 0xFFFF ;
+/*
+ * geometry of sources
+ */
+enum GeometryType
+{
+	NoGeometry = 0,
+	PointGeometry = 1,
+	LineGeometry = 2,
+	AreaGeometry = 3,
+	SegmentGeometry = 4
+} ;
+/*
+ * boolean options, stored as bits (in this order) in the options table
+ */
+struct OptionFlag
+{
+	const char* name ;
+	bool PropagationPathOptions::* member ;
+} ;
+
+static const OptionFlag option_flags[] =
+{
+	{ "ForceSourceToReceiver",		&PropagationPathOptions::ForceSourceToReceiver },
+	{ "CheckHorizontalAlignment",	&PropagationPathOptions::CheckHorizontalAlignment },
+	{ "CheckLateralDiffraction",	&PropagationPathOptions::CheckLateralDiffraction },
+	{ "DisableReflections",			&PropagationPathOptions::DisableReflections },
+	{ "DisableLateralDiffractions",	&PropagationPathOptions::DisableLateralDiffractions },
+	{ "CheckHeightLowerBound",		&PropagationPathOptions::CheckHeightLowerBound },
+	{ "CheckHeightUpperBound",		&PropagationPathOptions::CheckHeightUpperBound },
+	{ "CheckSourceSegment",			&PropagationPathOptions::CheckSourceSegment },
+	{ "CheckSoundPowerUnits",		&PropagationPathOptions::CheckSoundPowerUnits },
+	{ "SimplifyPathGeometry",		&PropagationPathOptions::SimplifyPathGeometry },
+	{ "IgnoreComplexPaths",			&PropagationPathOptions::IgnoreComplexPaths },
+	{ "ExcludeGeometricalSpread",	&PropagationPathOptions::ExcludeGeometricalSpread },
+	{ "ExcludeAirAbsorption",		&PropagationPathOptions::ExcludeAirAbsorption },
+	{ "ExcludeSoundPower",			&PropagationPathOptions::ExcludeSoundPower }
+} ;
+
+static const unsigned int NB_FLAGS = sizeof(option_flags) / sizeof(option_flags[0]) ;
+/*
+ * identifier of a calculation method, as accepted by getCalculationMethod
+ */
+struct MethodName
+{
+	const char* name ;
+	const char* id ;
+} ;
+
+static const MethodName method_names[] =
+{
+	{ "CNOSSOS-2018",		"CNOSSOS-2018" },
+	{ "ISO-9613-2:1996",	"ISO-9613-2" },
+	{ "JRC_final_2012",		"JRC-2012" },
+	{ "JRC_draft_2010",		"JRC-draft-2010" }
+} ;
+
+static std::string get_method_id (CalculationMethod* method)
+{
+	if (method == 0) return std::string() ;
+	for (unsigned int k = 0 ; k < sizeof(method_names) / sizeof(method_names[0]) ; ++k)
+	{
+		if (strcmp (method->name(), method_names[k].name) == 0) return method_names[k].id ;
+	}
+	return std::string() ;
+}
+/*
+ * encoding of scalar values in little-endian byte order, whatever the byte order of the host
+ */
+static bool host_is_little_endian (void)
+{
+	uint16_t x = 1 ;
+	return *(unsigned char*) &x == 1 ;
+}
+
+static const bool little_endian = host_is_little_endian() ;
+
+template <class T> static void put (std::vector<unsigned char>& buffer, T value)
+{
+	unsigned char b[sizeof(T)] ;
+	memcpy (b, &value, sizeof(T)) ;
+	if (!little_endian) std::reverse (b, b + sizeof(T)) ;
+	buffer.insert (buffer.end(), b, b + sizeof(T)) ;
+}
+
+static void put_string (std::vector<unsigned char>& buffer, std::string const& s)
+{
+	put<uint16_t> (buffer, (uint16_t) s.size()) ;
+	buffer.insert (buffer.end(), s.begin(), s.end()) ;
+}
+
+static void put_point (std::vector<unsigned char>& buffer, Point3D const& p)
+{
+	put<double> (buffer, p.x) ;
+	put<double> (buffer, p.y) ;
+	put<double> (buffer, p.z) ;
+}
+
+static void put_spectrum (std::vector<unsigned char>& buffer, Spectrum const& s)
+{
+	for (unsigned int i = 0 ; i < s.size() ; ++i) put<double> (buffer, s[i]) ;
+}
+/*
+ * decoding, with bounds checking: reading beyond the end of the record invalidates the cursor
+ */
+struct Cursor
+{
+	const unsigned char* p ;
+	const unsigned char* end ;
+	bool ok ;
+
+	Cursor (const unsigned char* _p, const unsigned char* _end) : p (_p), end (_end), ok (_p <= _end) { }
+
+	template <class T> T get (void)
+	{
+		T value = T() ;
+		if (!ok || end - p < (ptrdiff_t) sizeof(T))
+		{
+			ok = false ;
+			return value ;
+		}
+		unsigned char b[sizeof(T)] ;
+		memcpy (b, p, sizeof(T)) ;
+		if (!little_endian) std::reverse (b, b + sizeof(T)) ;
+		memcpy (&value, b, sizeof(T)) ;
+		p += sizeof(T) ;
+		return value ;
+	}
+
+	std::string get_string (void)
+	{
+		unsigned int n = get<uint16_t>() ;
+		if (!ok || end - p < (ptrdiff_t) n)
+		{
+			ok = false ;
+			return std::string() ;
+		}
+		std::string s ((const char*) p, n) ;
+		p += n ;
+		return s ;
+	}
+
+	void get_point (Point3D& pos)
+	{
+		pos.x = get<double>() ;
+		pos.y = get<double>() ;
+		pos.z = get<double>() ;
+	}
+
+	void get_spectrum (Spectrum& s)
+	{
+		for (unsigned int i = 0 ; i < s.size() ; ++i) s[i] = get<double>() ;
+	}
+} ;
+
+/* ------------------------------------------------------------------------------------------------
+ * writer
+ * ------------------------------------------------------------------------------------------------ */
+
+PathBatchWriter::PathBatchWriter (void)
+: fp (0), offset (0), failed (false), buffer(), index(), materials(), options()
+{
+}
+
+PathBatchWriter::~PathBatchWriter (void)
+{
+	if (fp != 0) close() ;
+}
+
+bool PathBatchWriter::open (const char* fileName)
+{
+	if (fp != 0) close() ;
+	fp = fopen (fileName, "wb") ;
+	if (fp == 0) return false ;
+	/*
+	 * the header is written again, with the actual counts and offsets, when the file is closed
+	 */
+	buffer.assign (HEADER_SIZE, 0) ;
+	offset = 0 ;
+	failed = false ;
+	index.clear() ;
+	materials.clear() ;
+	options.clear() ;
+	writeBuffer() ;
+	return !failed ;
+}
+
+void PathBatchWriter::writeBuffer (void)
+{
+	if (buffer.empty()) return ;
+	if (fwrite (&buffer[0], 1, buffer.size(), fp) != buffer.size()) failed = true ;
+	offset += buffer.size() ;
+	buffer.clear() ;
+}
+/*
+ * index of a material in the table ; the properties of a material are captured when the material
+ * is first used, a registered material whose properties have been modified since then gets a new
+ * entry with the same identifier. The table holds a reference to the materials, so that a material
+ * removed from the global table (see MaterialSnapshot) cannot be confused with a new material at the
+ * same address.
+ */
+unsigned int PathBatchWriter::getMaterialIndex (Material* mat)
+{
+	if (mat == 0) return NO_MATERIAL ;
+	double const* sigma = mat->getSigma() ;
+	Spectrum const* alpha = mat->getAlpha() ;
+	for (unsigned int k = materials.size() ; k > 0 ; --k)
+	{
+		MaterialEntry const& e = materials[k-1] ;
+		if (e.mat != mat || e.G != mat->getGValue()) continue ;
+		if (e.hasSigma != (sigma != 0) || (sigma != 0 && e.sigma != *sigma)) continue ;
+		if (e.hasAlpha != (alpha != 0)) continue ;
+		bool same = true ;
+		for (unsigned int i = 0 ; alpha != 0 && i < alpha->size() ; ++i) same = same && (e.alpha[i] == (*alpha)[i]) ;
+		if (same) return k - 1 ;
+	}
+	MaterialEntry e ;
+	const char* id = getMaterialID (mat) ;
+	e.mat = mat ;
+	e.id = (id != 0) ? id : "" ;
+	e.G = mat->getGValue() ;
+	e.hasSigma = (sigma != 0) ;
+	e.sigma = sigma ? *sigma : 0.0 ;
+	e.hasAlpha = (alpha != 0) ;
+	e.alpha = alpha ? *alpha : Spectrum (0.0) ;
+	materials.push_back (e) ;
+	return materials.size() - 1 ;
+}
+
+unsigned int PathBatchWriter::getOptionsIndex (PropagationPathOptions const& opt)
+{
+	uint32_t flags = 0 ;
+	for (unsigned int i = 0 ; i < NB_FLAGS ; ++i)
+	{
+		if (opt.*option_flags[i].member) flags |= (1u << i) ;
+	}
+	std::string method = get_method_id (opt.method) ;
+	for (unsigned int k = options.size() ; k > 0 ; --k)
+	{
+		OptionsEntry const& e = options[k-1] ;
+		if (e.flags == flags && e.method == method && e.meteo.model == opt.meteo.model &&
+			e.meteo.C0 == opt.meteo.C0 && e.meteo.pFav == opt.meteo.pFav &&
+			e.meteo.temperature == opt.meteo.temperature && e.meteo.humidity == opt.meteo.humidity)
+		{
+			return k - 1 ;
+		}
+	}
+	OptionsEntry e ;
+	e.method = method ;
+	e.flags = flags ;
+	e.meteo = opt.meteo ;
+	options.push_back (e) ;
+	return options.size() - 1 ;
+}
+
+bool PathBatchWriter::write (PropagationPath& path, PropagationPathOptions const& opt)
+{
+	if (fp == 0) return false ;
+	if (options.size() >= 0xFFFF || materials.size() >= NO_MATERIAL - 2) return false ;
+
+	index.push_back (offset) ;
+	put<uint32_t> (buffer, (uint32_t) path.size()) ;
+	put<uint16_t> (buffer, (uint16_t) getOptionsIndex (opt)) ;
+	for (unsigned int k = 0 ; k < path.size() ; ++k)
+	{
+		ControlPoint& cp = path[k] ;
+		put_point (buffer, cp.pos) ;
+		put<uint16_t> (buffer, (uint16_t) getMaterialIndex (cp.mat)) ;
+
+		VerticalExt* ext = cp.ext ;
+		if (ext == 0)
+		{
+			put<uint8_t> (buffer, VerticalExt::Undefined) ;
+		}
+		else if (ext->isSource())
+		{
+			SourceExt* source = (SourceExt*) ext ;
+			ElementarySource const& src = source->source ;
+			put<uint8_t> (buffer, VerticalExt::Source) ;
+			put<double> (buffer, source->h) ;
+			put<double> (buffer, src.sourceHeight) ;
+			put<uint8_t> (buffer, (uint8_t) src.spectrumType.type) ;
+			put<uint8_t> (buffer, (uint8_t) src.measurementType.type) ;
+			put<uint8_t> (buffer, (uint8_t) src.frequencyWeighting.type) ;
+			put_spectrum (buffer, src.soundPower) ;
+
+			SourceGeometry* geo = source->geo ;
+			if (LineSegment* seg = dynamic_cast<LineSegment*> (geo))
+			{
+				put<uint8_t> (buffer, SegmentGeometry) ;
+				put_point (buffer, seg->p1) ;
+				put_point (buffer, seg->p2) ;
+				put<double> (buffer, seg->fixed_angle) ;
+			}
+			else if (LineSource* line = dynamic_cast<LineSource*> (geo))
+			{
+				put<uint8_t> (buffer, LineGeometry) ;
+				put<double> (buffer, line->length) ;
+				put_point (buffer, line->orientation) ;
+			}
+			else if (AreaSource* area = dynamic_cast<AreaSource*> (geo))
+			{
+				put<uint8_t> (buffer, AreaGeometry) ;
+				put<double> (buffer, area->area) ;
+				put_point (buffer, area->orientation) ;
+			}
+			else if (PointSource* point = dynamic_cast<PointSource*> (geo))
+			{
+				put<uint8_t> (buffer, PointGeometry) ;
+				put_point (buffer, point->orientation) ;
+			}
+			else
+			{
+				put<uint8_t> (buffer, NoGeometry) ;
+			}
+		}
+		else if (ext->isBarrier())
+		{
+			put<uint8_t> (buffer, VerticalExt::Barrier) ;
+			put<double> (buffer, ext->h) ;
+			put<uint16_t> (buffer, (uint16_t) getMaterialIndex (((BarrierExt*) ext)->mat)) ;
+		}
+		else if (ext->isVerticalWall())
+		{
+			put<uint8_t> (buffer, VerticalExt::VerticalWall) ;
+			put<double> (buffer, ext->h) ;
+			put<uint16_t> (buffer, (uint16_t) getMaterialIndex (((VerticalWallExt*) ext)->mat)) ;
+		}
+		else
+		{
+			put<uint8_t> (buffer, ext->isReceiver() ? VerticalExt::Receiver : VerticalExt::VerticalEdge) ;
+			put<double> (buffer, ext->h) ;
+		}
+	}
+	writeBuffer() ;
+	return !failed ;
+}
+
+bool PathBatchWriter::close (void)
+{
+	if (fp == 0) return false ;
+	/*
+	 * tables of materials and options
+	 */
+	uint64_t tables_offset = offset ;
+	for (unsigned int k = 0 ; k < materials.size() ; ++k)
+	{
+		MaterialEntry const& e = materials[k] ;
+		put_string (buffer, e.id) ;
+		put<double> (buffer, e.G) ;
+		put<uint8_t> (buffer, (uint8_t) ((e.hasSigma ? 1 : 0) + (e.hasAlpha ? 2 : 0))) ;
+		if (e.hasSigma) put<double> (buffer, e.sigma) ;
+		if (e.hasAlpha) put_spectrum (buffer, e.alpha) ;
+	}
+	for (unsigned int k = 0 ; k < options.size() ; ++k)
+	{
+		OptionsEntry const& e = options[k] ;
+		put_string (buffer, e.method) ;
+		put<uint32_t> (buffer, e.flags) ;
+		put<uint32_t> (buffer, (uint32_t) e.meteo.model) ;
+		put<double> (buffer, e.meteo.C0) ;
+		put<double> (buffer, e.meteo.pFav) ;
+		put<double> (buffer, e.meteo.temperature) ;
+		put<double> (buffer, e.meteo.humidity) ;
+	}
+	writeBuffer() ;
+	/*
+	 * index of the paths
+	 */
+	uint64_t index_offset = offset ;
+	for (unsigned int k = 0 ; k < index.size() ; ++k) put<uint64_t> (buffer, index[k]) ;
+	writeBuffer() ;
+	/*
+	 * header
+	 */
+	buffer.insert (buffer.end(), MAGIC, MAGIC + 8) ;
+	put<uint32_t> (buffer, VERSION) ;
+	put<uint32_t> (buffer, (uint32_t) Spectrum::nbFreq) ;
+	put<uint32_t> (buffer, (uint32_t) index.size()) ;
+	put<uint32_t> (buffer, (uint32_t) materials.size()) ;
+	put<uint32_t> (buffer, (uint32_t) options.size()) ;
+	put<uint32_t> (buffer, 0) ;
+	put<uint64_t> (buffer, tables_offset) ;
+	put<uint64_t> (buffer, index_offset) ;
+	if (fseek (fp, 0, SEEK_SET) != 0) failed = true ;
+	writeBuffer() ;
+	if (fclose (fp) != 0) failed = true ;
+	fp = 0 ;
+	return !failed ;
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * reader
+ * ------------------------------------------------------------------------------------------------ */
+
+PathBatchReader::PathBatchReader (void)
+: data (0), size (0), nbPaths (0), indexOffset (0), materials(), options(), methodIds(), methods()
+#ifdef WIN32
+, file (INVALID_HANDLE_VALUE), mapping (0)
+#endif
+{
+}
+
+PathBatchReader::~PathBatchReader (void)
+{
+	close() ;
+}
+
+void PathBatchReader::close (void)
+{
+#ifdef WIN32
+	if (data != 0) UnmapViewOfFile (data) ;
+	if (mapping != 0) CloseHandle ((HANDLE) mapping) ;
+	if (file != INVALID_HANDLE_VALUE) CloseHandle ((HANDLE) file) ;
+	file = INVALID_HANDLE_VALUE ;
+	mapping = 0 ;
+#else
+	if (data != 0) munmap ((void*) data, (size_t) size) ;
+#endif
+	data = 0 ;
+	size = 0 ;
+	nbPaths = 0 ;
+	materials.clear() ;
+	options.clear() ;
+	methodIds.clear() ;
+	methods.clear() ;
+}
+
+bool PathBatchReader::open (const char* fileName)
+{
+	close() ;
+	/*
+	 * map the whole file into memory
+	 */
+#ifdef WIN32
+	file = CreateFileA (fileName, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL) ;
+	if (file == INVALID_HANDLE_VALUE) return false ;
+	LARGE_INTEGER file_size ;
+	if (!GetFileSizeEx ((HANDLE) file, &file_size) || file_size.QuadPart < HEADER_SIZE)
+	{
+		close() ;
+		return false ;
+	}
+	mapping = CreateFileMappingA ((HANDLE) file, NULL, PAGE_READONLY, 0, 0, NULL) ;
+	if (mapping != 0) data = (const unsigned char*) MapViewOfFile ((HANDLE) mapping, FILE_MAP_READ, 0, 0, 0) ;
+	if (data == 0)
+	{
+		close() ;
+		return false ;
+	}
+	size = file_size.QuadPart ;
+#else
+	int fd = ::open (fileName, O_RDONLY) ;
+	if (fd < 0) return false ;
+	struct stat st ;
+	if (fstat (fd, &st) != 0 || st.st_size < (off_t) HEADER_SIZE)
+	{
+		::close (fd) ;
+		return false ;
+	}
+	void* p = mmap (0, (size_t) st.st_size, PROT_READ, MAP_SHARED, fd, 0) ;
+	::close (fd) ;
+	if (p == MAP_FAILED) return false ;
+	data = (const unsigned char*) p ;
+	size = st.st_size ;
+#endif
+	/*
+	 * header
+	 */
+	Cursor c (data, data + size) ;
+	bool ok = (memcmp (data, MAGIC, 8) == 0) ;
+	c.p += 8 ;
+	uint32_t version = c.get<uint32_t>() ;
+	uint32_t nb_freq = c.get<uint32_t>() ;
+	uint32_t nb_paths = c.get<uint32_t>() ;
+	uint32_t nb_materials = c.get<uint32_t>() ;
+	uint32_t nb_options = c.get<uint32_t>() ;
+	c.get<uint32_t>() ;
+	uint64_t tables_offset = c.get<uint64_t>() ;
+	indexOffset = c.get<uint64_t>() ;
+	ok = ok && c.ok && version == VERSION && nb_freq == Spectrum::nbFreq ;
+	ok = ok && tables_offset <= size && indexOffset <= size && (size - indexOffset) / 8 >= nb_paths ;
+	/*
+	 * materials, not registered in the global table
+	 */
+	if (ok) c = Cursor (data + tables_offset, data + size) ;
+	for (unsigned int k = 0 ; ok && k < nb_materials ; ++k)
+	{
+		MaterialEntry e ;
+		e.id = c.get_string() ;
+		e.mat = new Material (c.get<double>()) ;
+		uint8_t flags = c.get<uint8_t>() ;
+		if (flags & 1) e.mat->setSigma (c.get<double>()) ;
+		if (flags & 2)
+		{
+			Spectrum alpha ;
+			c.get_spectrum (alpha) ;
+			e.mat->setAlpha (alpha) ;
+		}
+		materials.push_back (e) ;
+		ok = c.ok ;
+	}
+	/*
+	 * options
+	 */
+	for (unsigned int k = 0 ; ok && k < nb_options ; ++k)
+	{
+		PropagationPathOptions opt ;
+		std::string id = c.get_string() ;
+		uint32_t flags = c.get<uint32_t>() ;
+		for (unsigned int i = 0 ; i < NB_FLAGS ; ++i) opt.*option_flags[i].member = ((flags >> i) & 1) != 0 ;
+		opt.meteo.model = (MeteoCondition::MeteoModel) c.get<uint32_t>() ;
+		opt.meteo.C0 = c.get<double>() ;
+		opt.meteo.pFav = c.get<double>() ;
+		opt.meteo.temperature = c.get<double>() ;
+		opt.meteo.humidity = c.get<double>() ;
+		methods.push_back (getCalculationMethod (id.c_str())) ;
+		opt.method = methods.back() ;
+		options.push_back (opt) ;
+		methodIds.push_back (id) ;
+		ok = c.ok ;
+	}
+	if (!ok)
+	{
+		close() ;
+		return false ;
+	}
+	nbPaths = nb_paths ;
+	return true ;
+}
+/*
+ * decode into the existing control point, reusing its extension if it has the right type
+ */
+template <class T> static T* reuse_ext (ControlPoint& cp, bool same_type)
+{
+	T* ext = same_type ? cp.ext.cast_to_ptr<T>() : 0 ;
+	if (ext == 0)
+	{
+		ext = new T() ;
+		cp.ext = ext ;
+	}
+	return ext ;
+}
+
+template <class T> static T* reuse_geo (SourceExt* source, SpectrumType type)
+{
+	T* geo = (source->geo != 0) ? source->geo.cast_to_ptr<T>() : 0 ;
+	if (geo == 0 || geo->GetSpectrumType() != type)
+	{
+		geo = new T() ;
+		source->geo = geo ;
+	}
+	return geo ;
+}
+
+bool PathBatchReader::read (unsigned int k, PropagationPath& path, PropagationPathOptions* opt)
+{
+	if (data == 0 || k >= nbPaths) return false ;
+	Cursor c (data + indexOffset + 8 * (uint64_t) k, data + size) ;
+	uint64_t offset = c.get<uint64_t>() ;
+	if (!c.ok || offset >= size) return false ;
+
+	c = Cursor (data + offset, data + size) ;
+	uint32_t n = c.get<uint32_t>() ;
+	uint16_t options_index = c.get<uint16_t>() ;
+	if (!c.ok || options_index >= options.size() || n > (size - offset) / 27) return false ;
+	if (opt != 0) *opt = options[options_index] ;
+
+	path.resize (n) ;
+	path.info = PathInfo() ;
+	for (unsigned int i = 0 ; i < n && c.ok ; ++i)
+	{
+		ControlPoint& cp = path[i] ;
+		c.get_point (cp.pos) ;
+		uint16_t m = c.get<uint16_t>() ;
+		cp.mat = (m < materials.size()) ? (Material*) materials[m].mat : 0 ;
+		cp.mode2D = Action2D() ;
+		cp.mode3D = Action3D() ;
+		cp.d_path = 0 ;
+		cp.z_path = 0 ;
+
+		uint8_t type = c.get<uint8_t>() ;
+		if (type == VerticalExt::Undefined)
+		{
+			cp.ext = 0 ;
+		}
+		else if (type == VerticalExt::Source)
+		{
+			SourceExt* source = reuse_ext<SourceExt> (cp, cp.ext != 0 && cp.ext->isSource()) ;
+			ElementarySource& src = source->source ;
+			source->h = c.get<double>() ;
+			src.sourceHeight = c.get<double>() ;
+			src.spectrumType = (SpectrumType::Type) c.get<uint8_t>() ;
+			src.measurementType = (MeasurementType::Type) c.get<uint8_t>() ;
+			src.frequencyWeighting = (FrequencyWeighting::Type) c.get<uint8_t>() ;
+			c.get_spectrum (src.soundPower) ;
+
+			uint8_t geo = c.get<uint8_t>() ;
+			if (geo == SegmentGeometry)
+			{
+				LineSegment* seg = reuse_geo<LineSegment> (source, SpectrumType::LineSource) ;
+				c.get_point (seg->p1) ;
+				c.get_point (seg->p2) ;
+				seg->fixed_angle = c.get<double>() ;
+			}
+			else if (geo == LineGeometry)
+			{
+				LineSource* line = reuse_geo<LineSource> (source, SpectrumType::LineSource) ;
+				line->length = c.get<double>() ;
+				c.get_point (line->orientation) ;
+			}
+			else if (geo == AreaGeometry)
+			{
+				AreaSource* area = reuse_geo<AreaSource> (source, SpectrumType::AreaSource) ;
+				area->area = c.get<double>() ;
+				c.get_point (area->orientation) ;
+			}
+			else if (geo == PointGeometry)
+			{
+				PointSource* point = reuse_geo<PointSource> (source, SpectrumType::PointSource) ;
+				c.get_point (point->orientation) ;
+			}
+			else
+			{
+				source->geo = 0 ;
+			}
+		}
+		else if (type == VerticalExt::Barrier || type == VerticalExt::VerticalWall)
+		{
+			double h = c.get<double>() ;
+			uint16_t m = c.get<uint16_t>() ;
+			Material* mat = (m < materials.size()) ? (Material*) materials[m].mat : getMaterial ("A0") ;
+			if (type == VerticalExt::Barrier)
+			{
+				BarrierExt* barrier = reuse_ext<BarrierExt> (cp, cp.ext != 0 && cp.ext->isBarrier()) ;
+				barrier->h = h ;
+				barrier->mat = mat ;
+			}
+			else
+			{
+				VerticalWallExt* wall = reuse_ext<VerticalWallExt> (cp, cp.ext != 0 && cp.ext->isVerticalWall()) ;
+				wall->h = h ;
+				wall->mat = mat ;
+			}
+		}
+		else if (type == VerticalExt::Receiver)
+		{
+			reuse_ext<ReceiverExt> (cp, cp.ext != 0 && cp.ext->isReceiver())->h = c.get<double>() ;
+		}
+		else if (type == VerticalExt::VerticalEdge)
+		{
+			reuse_ext<VerticalEdgeExt> (cp, cp.ext != 0 && cp.ext->isVerticalEdge())->h = c.get<double>() ;
+		}
+		else
+		{
+			return false ;
+		}
+	}
+	return c.ok ;
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * conversion to XML
+ * ------------------------------------------------------------------------------------------------ */
+
+/*
+ * shortest representation of a value that is read back without loss
+ */
+static std::string xml_value (double value)
+{
+	char s[32] ;
+	for (int digits = 15 ; digits <= 17 ; ++digits)
+	{
+		sprintf (s, "%.*g", digits, value) ;
+		if (strtod (s, 0) == value) break ;
+	}
+	return s ;
+}
+
+static void print_xml_spectrum (FILE* fp, Spectrum const& s)
+{
+	for (unsigned int i = 0 ; i < s.size() ; ++i) fprintf (fp, " %s", xml_value (s[i]).c_str()) ;
+}
+
+static void print_xml_point (FILE* fp, const char* tag, Point3D const& p, const char* indent)
+{
+	fprintf (fp, "%s<%s>\n", indent, tag) ;
+	fprintf (fp, "%s\t<x> %s </x>\n", indent, xml_value (p.x).c_str()) ;
+	fprintf (fp, "%s\t<y> %s </y>\n", indent, xml_value (p.y).c_str()) ;
+	fprintf (fp, "%s\t<z> %s </z>\n", indent, xml_value (p.z).c_str()) ;
+	fprintf (fp, "%s</%s>\n", indent, tag) ;
+}
+
+bool PathBatchReader::exportXML (unsigned int k, const char* fileName)
+{
+	PropagationPath path ;
+	PropagationPathOptions opt ;
+	if (!read (k, path, &opt)) return false ;
+	/*
+	 * identifiers of the materials used by the path ; anonymous materials get a generated name
+	 */
+	std::vector<unsigned int> used ;
+	std::vector<std::string> ids (materials.size()) ;
+	for (unsigned int m = 0 ; m < materials.size() ; ++m)
+	{
+		char name[32] ;
+		sprintf (name, "BatchMaterial%u", m) ;
+		ids[m] = materials[m].id.empty() ? std::string (name) : materials[m].id ;
+	}
+	std::vector<Material*> mats ;
+	for (unsigned int i = 0 ; i < path.size() ; ++i)
+	{
+		mats.push_back (path[i].mat) ;
+		if (path[i].ext != 0 && path[i].ext->isBarrier()) mats.push_back (path[i].ext.cast_to_ptr<BarrierExt>()->mat) ;
+		if (path[i].ext != 0 && path[i].ext->isVerticalWall()) mats.push_back (path[i].ext.cast_to_ptr<VerticalWallExt>()->mat) ;
+	}
+	for (unsigned int m = 0 ; m < materials.size() ; ++m)
+	{
+		if (std::find (mats.begin(), mats.end(), (Material*) materials[m].mat) != mats.end()) used.push_back (m) ;
+	}
+
+	FILE* fp = fopen (fileName, "wt") ;
+	if (fp == 0) return false ;
+	fprintf (fp, "<?xml version=\"1.0\" encoding=\"UTF-8\" ?>\n\n") ;
+	fprintf (fp, "<CNOSSOS-EU version=\"1.001\">\n") ;
+	/*
+	 * calculation method, options and meteorological conditions
+	 */
+	unsigned int options_index = 0 ;
+	for (unsigned int m = 0 ; m < options.size() ; ++m)
+	{
+		if (options[m].method == opt.method) options_index = m ;
+	}
+	fprintf (fp, "\t<method>\n") ;
+	fprintf (fp, "\t\t<select id=\"%s\" />\n", methodIds.empty() ? "" : methodIds[options_index].c_str()) ;
+	fprintf (fp, "\t\t<options>\n") ;
+	for (unsigned int i = 0 ; i < NB_FLAGS ; ++i)
+	{
+		fprintf (fp, "\t\t\t<option id=\"%s\" value=\"%s\" />\n", option_flags[i].name,
+				 (opt.*option_flags[i].member) ? "true" : "false") ;
+	}
+	fprintf (fp, "\t\t</options>\n") ;
+	if (opt.meteo.model == MeteoCondition::ISO9613)
+	{
+		fprintf (fp, "\t\t<meteo model=\"ISO-9613-2\">\n") ;
+	}
+	else if (opt.meteo.model == MeteoCondition::JRC2012)
+	{
+		fprintf (fp, "\t\t<meteo model=\"JRC-2012\">\n") ;
+	}
+	else
+	{
+		fprintf (fp, "\t\t<meteo>\n") ;
+	}
+	fprintf (fp, "\t\t\t<temperature> %s </temperature>\n", xml_value (opt.meteo.temperature).c_str()) ;
+	fprintf (fp, "\t\t\t<humidity> %s </humidity>\n", xml_value (opt.meteo.humidity).c_str()) ;
+	fprintf (fp, "\t\t\t<pFav> %s </pFav>\n", xml_value (opt.meteo.pFav).c_str()) ;
+	fprintf (fp, "\t\t\t<C0> %s </C0>\n", xml_value (opt.meteo.C0).c_str()) ;
+	fprintf (fp, "\t\t</meteo>\n") ;
+	fprintf (fp, "\t</method>\n") ;
+	/*
+	 * materials
+	 */
+	if (!used.empty())
+	{
+		fprintf (fp, "\t<materials>\n") ;
+		for (unsigned int u = 0 ; u < used.size() ; ++u)
+		{
+			Material* mat = materials[used[u]].mat ;
+			fprintf (fp, "\t\t<mat id=\"%s\">\n", ids[used[u]].c_str()) ;
+			fprintf (fp, "\t\t\t<G> %s </G>\n", xml_value (mat->getGValue()).c_str()) ;
+			if (mat->getSigma() != 0) fprintf (fp, "\t\t\t<sigma> %s </sigma>\n", xml_value (*mat->getSigma()).c_str()) ;
+			if (mat->getAlpha() != 0)
+			{
+				fprintf (fp, "\t\t\t<alpha>") ;
+				print_xml_spectrum (fp, *mat->getAlpha()) ;
+				fprintf (fp, " </alpha>\n") ;
+			}
+			fprintf (fp, "\t\t</mat>\n") ;
+		}
+		fprintf (fp, "\t</materials>\n") ;
+	}
+	/*
+	 * control points
+	 */
+	fprintf (fp, "\t<path>\n") ;
+	for (unsigned int i = 0 ; i < path.size() ; ++i)
+	{
+		ControlPoint& cp = path[i] ;
+		fprintf (fp, "\t\t<cp>\n") ;
+		print_xml_point (fp, "pos", cp.pos, "\t\t\t") ;
+		for (unsigned int m = 0 ; m < materials.size() ; ++m)
+		{
+			if (materials[m].mat == cp.mat) fprintf (fp, "\t\t\t<mat id=\"%s\" />\n", ids[m].c_str()) ;
+		}
+		VerticalExt* ext = cp.ext ;
+		if (ext != 0)
+		{
+			fprintf (fp, "\t\t\t<ext>\n") ;
+			if (ext->isSource())
+			{
+				SourceExt* source = (SourceExt*) ext ;
+				ElementarySource const& src = source->source ;
+				fprintf (fp, "\t\t\t\t<source>\n") ;
+				fprintf (fp, "\t\t\t\t\t<h> %s </h>\n", xml_value (source->h).c_str()) ;
+				fprintf (fp, "\t\t\t\t\t<Lw") ;
+				if (src.measurementType == MeasurementType::FreeField) fprintf (fp, " measurementType=\"FreeField\"") ;
+				if (src.measurementType == MeasurementType::HemiSpherical) fprintf (fp, " measurementType=\"HemiSpherical\"") ;
+				if (src.spectrumType == SpectrumType::PointSource) fprintf (fp, " sourceType=\"PointSource\"") ;
+				if (src.spectrumType == SpectrumType::LineSource) fprintf (fp, " sourceType=\"LineSource\"") ;
+				if (src.spectrumType == SpectrumType::AreaSource) fprintf (fp, " sourceType=\"AreaSource\"") ;
+				if (src.frequencyWeighting == FrequencyWeighting::dBLIN) fprintf (fp, " frequencyWeighting=\"LIN\"") ;
+				if (src.frequencyWeighting == FrequencyWeighting::dBA) fprintf (fp, " frequencyWeighting=\"dBA\"") ;
+				fprintf (fp, ">") ;
+				print_xml_spectrum (fp, src.soundPower) ;
+				fprintf (fp, " </Lw>\n") ;
+
+				SourceGeometry* geo = source->geo ;
+				if (geo != 0) fprintf (fp, "\t\t\t\t\t<extGeometry>\n") ;
+				if (LineSegment* seg = dynamic_cast<LineSegment*> (geo))
+				{
+					fprintf (fp, "\t\t\t\t\t\t<lineSegment>\n") ;
+					print_xml_point (fp, "posStart", seg->p1, "\t\t\t\t\t\t\t") ;
+					print_xml_point (fp, "posEnd", seg->p2, "\t\t\t\t\t\t\t") ;
+					fprintf (fp, "\t\t\t\t\t\t\t<fixedAngle> %s </fixedAngle>\n", xml_value (seg->fixed_angle).c_str()) ;
+					fprintf (fp, "\t\t\t\t\t\t</lineSegment>\n") ;
+				}
+				else if (LineSource* line = dynamic_cast<LineSource*> (geo))
+				{
+					fprintf (fp, "\t\t\t\t\t\t<lineSource>\n") ;
+					fprintf (fp, "\t\t\t\t\t\t\t<length> %s </length>\n", xml_value (line->length).c_str()) ;
+					print_xml_point (fp, "orientation", line->orientation, "\t\t\t\t\t\t\t") ;
+					fprintf (fp, "\t\t\t\t\t\t</lineSource>\n") ;
+				}
+				else if (AreaSource* area = dynamic_cast<AreaSource*> (geo))
+				{
+					fprintf (fp, "\t\t\t\t\t\t<areaSource>\n") ;
+					fprintf (fp, "\t\t\t\t\t\t\t<area> %s </area>\n", xml_value (area->area).c_str()) ;
+					print_xml_point (fp, "orientation", area->orientation, "\t\t\t\t\t\t\t") ;
+					fprintf (fp, "\t\t\t\t\t\t</areaSource>\n") ;
+				}
+				else if (PointSource* point = dynamic_cast<PointSource*> (geo))
+				{
+					fprintf (fp, "\t\t\t\t\t\t<pointSource>\n") ;
+					print_xml_point (fp, "orientation", point->orientation, "\t\t\t\t\t\t\t") ;
+					fprintf (fp, "\t\t\t\t\t\t</pointSource>\n") ;
+				}
+				if (geo != 0) fprintf (fp, "\t\t\t\t\t</extGeometry>\n") ;
+				fprintf (fp, "\t\t\t\t</source>\n") ;
+			}
+			else if (ext->isReceiver())
+			{
+				fprintf (fp, "\t\t\t\t<receiver>\n\t\t\t\t\t<h> %s </h>\n\t\t\t\t</receiver>\n", xml_value (ext->h).c_str()) ;
+			}
+			else if (ext->isVerticalEdge())
+			{
+				fprintf (fp, "\t\t\t\t<edge>\n\t\t\t\t\t<h> %s </h>\n\t\t\t\t</edge>\n", xml_value (ext->h).c_str()) ;
+			}
+			else
+			{
+				const char* tag = ext->isBarrier() ? "barrier" : "wall" ;
+				Material* mat = ext->isBarrier() ? (Material*) ((BarrierExt*) ext)->mat : (Material*) ((VerticalWallExt*) ext)->mat ;
+				fprintf (fp, "\t\t\t\t<%s>\n\t\t\t\t\t<h> %s </h>\n", tag, xml_value (ext->h).c_str()) ;
+				for (unsigned int m = 0 ; m < materials.size() ; ++m)
+				{
+					if (materials[m].mat == mat) fprintf (fp, "\t\t\t\t\t<mat id=\"%s\" />\n", ids[m].c_str()) ;
+				}
+				fprintf (fp, "\t\t\t\t</%s>\n", tag) ;
+			}
+			fprintf (fp, "\t\t\t</ext>\n") ;
+		}
+		fprintf (fp, "\t\t</cp>\n") ;
+	}
+	fprintf (fp, "\t</path>\n") ;
+	fprintf (fp, "</CNOSSOS-EU>\n") ;
+	return fclose (fp) == 0 ;
+}
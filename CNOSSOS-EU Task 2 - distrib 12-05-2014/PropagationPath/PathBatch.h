@@ -0,0 +1,151 @@
+#pragma once
+/*
+ * ------------------------------------------------------------------------------------------------
+ * file:		PathBatch.h
+ * version:		1.0
+ * author:		dirk.van-maercke@cstb.fr
+ * copyright:	see file licence.EU.txt
+ * description: compact binary container for large numbers of propagation paths
+ * note:		a batch file holds any number of paths together with the tables of materials and
+ *				calculation options they refer to. All values are stored in little-endian byte
+ *				order ; the layout of the file is
+ *
+ *					header		magic "CNOSBTCH", version, number of frequency bands, number of
+ *								paths, materials and options, offsets of the tables and the index
+ *					paths		one record per path: number of control points, index of the
+ *								options, then for each control point its position, the index of
+ *								its material and its vertical extension (if any)
+ *					materials	identifier, G and optional sigma and absorption spectrum
+ *					options		method identifier, flags and meteorological conditions
+ *					index		offset of each path record in the file
+ *
+ *				The reader maps the file into memory and decodes the records directly into an
+ *				existing path, reusing its control points and their extensions whenever possible,
+ *				so that reading paths of similar structure does not allocate memory.
+ * changes:
+ *
+ *	18/10/2026	initial version
+ * -------------------------------------------------------------------------------------------------
+ */
+#include "PropagationPath.h"
+#include "CalculationMethod.h"
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace CnossosEU
+{
+	/*
+	 * write propagation paths to a batch file. The materials and options are collected while the
+	 * paths are written and are stored, together with the index, when the file is closed.
+	 */
+	class PathBatchWriter
+	{
+	public:
+		PathBatchWriter (void) ;
+		~PathBatchWriter (void) ;
+		/*
+		 * create the file, returns false if the file cannot be created
+		 */
+		bool open (const char* fileName) ;
+		/*
+		 * append a path and the options used for its calculation, returns false in case of a write
+		 * error
+		 */
+		bool write (PropagationPath& path, PropagationPathOptions const& options) ;
+		/*
+		 * write the tables and the index, returns false in case of a write error
+		 */
+		bool close (void) ;
+
+		unsigned int getNbPaths (void) const { return index.size() ; }
+
+	private:
+
+		struct MaterialEntry
+		{
+			System::ref_ptr<Material>	mat ;
+			std::string					id ;
+			double						G ;
+			bool						hasSigma ;
+			double						sigma ;
+			bool						hasAlpha ;
+			Spectrum					alpha ;
+		} ;
+
+		struct OptionsEntry
+		{
+			std::string			method ;
+			uint32_t			flags ;
+			MeteoCondition		meteo ;
+		} ;
+
+		FILE*						fp ;
+		uint64_t					offset ;
+		bool						failed ;
+		std::vector<unsigned char>	buffer ;
+		std::vector<uint64_t>		index ;
+		std::vector<MaterialEntry>	materials ;
+		std::vector<OptionsEntry>	options ;
+
+		unsigned int getMaterialIndex (Material* mat) ;
+		unsigned int getOptionsIndex (PropagationPathOptions const& options) ;
+		void writeBuffer (void) ;
+
+		PathBatchWriter (PathBatchWriter const&) ;
+		PathBatchWriter& operator= (PathBatchWriter const&) ;
+	} ;
+	/*
+	 * read propagation paths from a batch file. The materials of the file are private to the reader
+	 * (i.e. they are not registered in the global table of materials) and remain valid as long as
+	 * the paths refer to them, even after the reader has been closed.
+	 */
+	class PathBatchReader
+	{
+	public:
+		PathBatchReader (void) ;
+		~PathBatchReader (void) ;
+		/*
+		 * map the file into memory and read the tables, returns false if the file cannot be opened
+		 * or is not a valid batch file for the current number of frequency bands
+		 */
+		bool open (const char* fileName) ;
+		void close (void) ;
+
+		unsigned int getNbPaths (void) const { return nbPaths ; }
+		/*
+		 * decode a path and (optionally) the options used for its calculation. Returns false if the
+		 * index is out of range or the record is invalid.
+		 */
+		bool read (unsigned int k, PropagationPath& path, PropagationPathOptions* options = 0) ;
+		/*
+		 * write a path to a file in the CNOSSOS-EU XML format (see PathParseXML.h), including the
+		 * definition of the materials it refers to
+		 */
+		bool exportXML (unsigned int k, const char* fileName) ;
+
+	private:
+
+		struct MaterialEntry
+		{
+			System::ref_ptr<Material>	mat ;
+			std::string					id ;
+		} ;
+
+		const unsigned char*		data ;
+		uint64_t					size ;
+		unsigned int				nbPaths ;
+		uint64_t					indexOffset ;
+		std::vector<MaterialEntry>	materials ;
+		std::vector<PropagationPathOptions> options ;
+		std::vector<std::string>	methodIds ;
+		std::vector< System::ref_ptr<CalculationMethod> > methods ;
+#ifdef WIN32
+		void*						file ;
+		void*						mapping ;
+#endif
+
+		PathBatchReader (PathBatchReader const&) ;
+		PathBatchReader& operator= (PathBatchReader const&) ;
+	} ;
+}
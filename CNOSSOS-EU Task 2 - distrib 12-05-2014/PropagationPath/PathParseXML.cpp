@@ -19,6 +19,14 @@
  *
  *	05/12/2013	bug fixed: order of evaluation of internal/external source height fixed
  *
+ *	18/10/2026	octave band spectra are accepted by one-third octave band builds (see Spectrum.h)
+ *
+ *	18/10/2026	added streaming of files containing multiple paths (XMLPathStream)
+ *
+ *	18/10/2026	imported files are released on all paths, including errors
+ *
+ *	18/10/2026	XMLPathStream releases the calculation method of the previous <method> element
+ *
  * ------------------------------------------------------------------------------------------------- 
  */
 #include "./PathParseXML.h"
@@ -79,20 +87,29 @@ static bool ParseValue (XMLNode* node, const char* name, double& value)
 /*
  * parse a tag containing a spectrum, note that spectra are stored as arrays of 
  * floating-point values where the size of the array is a constant defined in the
- * Spectrum class.
+ * Spectrum class. If the Spectrum class does not use octave bands, spectra in 8 octave 
+ * bands are accepted as well (see ExpandOctaveBands).
  */
-static bool ParseSpectrum (XMLNode* node, const char* name, Spectrum& spec)
+static bool ParseSpectrum (XMLNode* node, const char* name, Spectrum& spec, bool power = false)
 {
 	if (!checkTagName (node, name)) return false ;
 
 	const char*s = node->GetText() ;
-	for (unsigned int i = 0 ; i < Spectrum::nbFreq ; i++)
+	double values[Spectrum::nbFreq] ;
+	unsigned int n = 0 ;
+	while (n < Spectrum::nbFreq && DecodeValue (s, values[n])) n++ ;
+	if (n == 8 && Spectrum::nbFreq != 8)
 	{
-		if (!DecodeValue (s, spec[i]))
-		{
-			signal_error (XMLParseError ("missing value", node)) ;
-			return false ;
-		}
+		ExpandOctaveBands (values, spec, power) ;
+	}
+	else if (n < Spectrum::nbFreq)
+	{
+		signal_error (XMLParseError ("missing value", node)) ;
+		return false ;
+	}
+	else
+	{
+		for (unsigned int i = 0 ; i < Spectrum::nbFreq ; i++) spec[i] = values[i] ;
 	}
 	if (SkipWhiteSpace (s))
 	{
@@ -152,7 +169,7 @@ static bool ParseMaterialRef (XMLNode* node, System::ref_ptr<Material>& mat)
  */
 static bool ParseElementarySource (XMLNode* node, ElementarySource &source)
 {
-	if (!ParseSpectrum (node, "Lw", source.soundPower)) return false ;
+	if (!ParseSpectrum (node, "Lw", source.soundPower, true)) return false ;
 
 	const char* attrib = node->GetAttribute ("measurementType") ;
 	if (attrib)
@@ -193,16 +210,16 @@ static bool ImportSourceDescription (XMLNode* node, SourceExt &source)
 	/*
 	 * create a new file parser and load the file
 	 */
-	XMLFileLoader* externalFile = new XMLFileLoader() ;
-	if (!externalFile->ParseFile (filename))
+	XMLFileLoader externalFile ;
+	if (!externalFile.ParseFile (filename))
 	{
-		signal_error (XMLSyntaxError (*externalFile)) ;
+		signal_error (XMLSyntaxError (externalFile)) ;
 		return false ;
 	}
 	/*
 	 * root node must be "CNOSSOS_SourcePower"
 	 */
-	node = externalFile->GetRoot() ;
+	node = externalFile.GetRoot() ;
 	if (!checkTagName (node, "CNOSSOS_SourcePower"))
 	{
 		signal_error (XMLUnexpectedTag(node)) ;
@@ -217,10 +234,6 @@ static bool ImportSourceDescription (XMLNode* node, SourceExt &source)
 		signal_error (XMLUnexpectedTag(node)) ;
 		return false ;
 	}
-	/*
-	 * cleanup and return
-	 */
-	delete externalFile ;
 	print_debug ("import external file OK\n") ;
 	return true ;
 }
@@ -936,4 +949,71 @@ namespace CnossosEU
 		}
 		return true ;
 	}
+	/*
+	 * public API : parse files containing multiple paths
+	 */
+	XMLPathStream::XMLPathStream (void) : loader(), options(), method(), nbPaths (0)
+	{
+	}
+
+	bool XMLPathStream::Open (const char* fileName)
+	{
+		options = PropagationPathOptions() ;
+		method = 0 ;
+		nbPaths = 0 ;
+		if (!loader.Open (fileName))
+		{
+			signal_error (XMLSyntaxError (loader)) ;
+			return false ;
+		}
+		static const char* root = "CNOSSOS-EU" ;
+		if (!checkTagName (loader.GetRoot(), root)) 
+		{
+			signal_error (XMLMissingTag (root, loader.GetRoot())) ;
+			return false ;
+		}
+		return true ;
+	}
+
+	bool XMLPathStream::ReadPath (PropagationPath& path, PropagationPathOptions& _options)
+	{
+		XMLNode* node = loader.GetNextEntity() ;
+		while (node != 0)
+		{
+			if (checkTagName (node, "method"))
+			{
+				/*
+				 * the method of the previous <method> element is released
+				 */
+				bool ok = ParseParameters (node, options) ;
+				method = options.method ;
+				if (!ok) return false ;
+			}
+			else if (checkTagName (node, "materials"))
+			{
+				if (!ParseMaterials (node)) return false ;
+			}
+			else if (ParsePropagationPath (node, path))
+			{
+				_options = options ;
+				nbPaths++ ;
+				return true ;
+			}
+			else
+			{
+				return false ;
+			}
+			node = loader.GetNextEntity() ;
+		}
+		if (loader.last_error != 0)
+		{
+			signal_error (XMLSyntaxError (loader)) ;
+		}
+		return false ;
+	}
+
+	void XMLPathStream::Close (void)
+	{
+		loader.Close() ;
+	}
 }
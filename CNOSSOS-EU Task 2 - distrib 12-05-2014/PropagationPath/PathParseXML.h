@@ -9,6 +9,11 @@
  * changes:
  *
  *	18/01/2013	initial version
+ *
+ *	18/10/2026	added class XMLPathStream (files containing multiple paths)
+ *
+ *	18/10/2026	the context of parse errors is recorded when the error is raised, so that the 
+ *				document may be released before the error is reported
  * ------------------------------------------------------------------------------------------------- 
  */
 #include "../SimpleXML/SimpleXML.h"
@@ -72,27 +77,35 @@ namespace CnossosEU
 	class XMLParseError : public ErrorMessage
 	{
 		XMLNode* _node ;
+		std::string _context ;
 	
 	protected:
 
 		void print_context (void)
+		{
+			printf ("%s", _context.c_str()) ;
+		}
+
+	public:
+
+		XMLParseError (const char* what, XMLNode* node) : ErrorMessage (what), _node(node), _context()
 		{
 			if (!_node) return ;
-			printf (".while parsing tag <%s> \n", _node->GetName()) ;
+			_context = std::string (".while parsing tag <") + _node->GetName() + "> \n" ;
 			XMLNode* parent = _node->GetParent() ;
 			while (parent != 0)
 			{				
-				printf (".from parent <%s", parent->GetName()) ;
+				_context += std::string (".from parent <") + parent->GetName() ;
 				const char* id = parent->GetAttribute ("id") ;
-				if (id != 0) printf (" id=\"%s\"", id) ;
-				printf (">\n") ;
+				if (id != 0) _context += std::string (" id=\"") + id + "\"" ;
+				_context += ">\n" ;
 				parent = parent->GetParent() ;
 			}
 		}
-
-	public:
-
-		XMLParseError (const char* what, XMLNode* node) : ErrorMessage (what), _node(node) { }
+		~XMLParseError (void) throw() {} 
+		/*
+		 * the node is only valid as long as the document it belongs to
+		 */
 		XMLNode* node (void) const { return _node ; }
 		
 		virtual void print (void)
@@ -132,7 +145,59 @@ namespace CnossosEU
 		}
 	};
 	/*
-	 * load and parse file 
+	 * load and parse file ; the calculation method selected in the file (options.method) is 
+	 * created by the parser and owned by the caller
 	 */
 	bool ParsePathFromFile (XMLNode* root, PropagationPath& path, PropagationPathOptions& options) ;
+	/*
+	 * read the propagation paths from a file containing any number of <path> elements, e.g.
+	 *
+	 *		<CNOSSOS-EU>
+	 *			<method> ... </method>
+	 *			<materials> ... </materials>
+	 *			<path> ... </path>
+	 *			<path> ... </path>
+	 *			...
+	 *		</CNOSSOS-EU>
+	 *
+	 * The <method> and <materials> elements apply to all subsequent paths and may be repeated
+	 * between paths. Paths are parsed one by one as the file is read, only the current path is
+	 * held in memory. Files containing a single path are read as by ParsePathFromFile.
+	 *
+	 * Errors are signalled in the same way as in ParsePathFromFile.
+	 */
+	class XMLPathStream
+	{
+	public:
+
+		XMLPathStream (void) ;
+		/*
+		 * open the file and check the root element
+		 */
+		bool Open (const char* fileName) ;
+		/*
+		 * parse the next path and return the options that apply to it, returns false at the end
+		 * of the file. The calculation method in the options is owned by the stream and remains
+		 * valid until the next <method> element is read or the stream is destroyed.
+		 */
+		bool ReadPath (PropagationPath& path, PropagationPathOptions& options) ;
+		/*
+		 * close the file
+		 */
+		void Close (void) ;
+		/*
+		 * number of paths read so far
+		 */
+		unsigned int GetNbPaths (void) const { return nbPaths ; }
+
+	private:
+
+		XMLStreamLoader			loader ;
+		PropagationPathOptions	options ;
+		System::ref_ptr<CalculationMethod> method ;		// owns options.method
+		unsigned int			nbPaths ;
+
+		XMLPathStream (XMLPathStream const&) ;
+		XMLPathStream& operator= (XMLPathStream const&) ;
+	} ;
 }
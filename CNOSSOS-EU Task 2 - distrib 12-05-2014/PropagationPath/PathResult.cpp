@@ -9,6 +9,8 @@
  *
  *	23/10/2013	initial version
  *
+ *	18/10/2026	output_results_to_XML accepts an open file
+ *
  * ------------------------------------------------------------------------------------------------- 
  */
 #include "PathResult.h"
@@ -88,6 +90,13 @@ namespace CnossosEU
 		FILE* fp = fopen (filename, "wt") ;
 		if (!fp) return false ;
 
+		output_results_to_XML (fp, result) ;
+	
+		return fclose (fp) == 0 ;
+	}
+
+	bool output_results_to_XML (FILE* fp, PathResult& result)
+	{
 		fprintf (fp, "<?xml version=\"1.0\" encoding=\"UTF-8\" ?>\n") ;
 		fprintf (fp, "<CNOSSOS-EU>\n") ;
 		fprintf (fp, "  <pathResult>\n") ;
@@ -111,8 +120,6 @@ namespace CnossosEU
 		fprintf (fp, "    </details>\n") ;
 		fprintf (fp, "  </pathResult>\n") ;
 		fprintf (fp, "</CNOSSOS-EU>\n") ;
-	
-		fclose (fp) ;
-		return true ;
+		return !ferror (fp) ;
 	}
 }
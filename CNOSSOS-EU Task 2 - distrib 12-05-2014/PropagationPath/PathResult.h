@@ -10,11 +10,15 @@
  *
  *	23/10/2013	initial version
  *
+ *	18/10/2026	output_results_to_XML accepts an open file (see also ResultSink.h for large numbers
+ *				of results)
+ *
  * ------------------------------------------------------------------------------------------------- 
  */
 
 #include "Spectrum.h"
 #include <string.h> 
+#include <stdio.h>
 
 namespace CnossosEU
 {
@@ -43,4 +47,8 @@ namespace CnossosEU
 	void print_results_to_stdout (PathResult& path) ;
 
 	bool output_results_to_XML (const char* filename, PathResult& path) ;
+	/*
+	 * write the results to an open file, in the same format
+	 */
+	bool output_results_to_XML (FILE* fp, PathResult& path) ;
 }
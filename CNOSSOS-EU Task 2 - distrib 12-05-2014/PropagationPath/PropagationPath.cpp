@@ -10,6 +10,12 @@
  * changes:
  *
  *	18/01/2013	initial version
+ *
+ *	18/10/2026	control points are moved by swapping instead of copying when inserting barrier
+ *				points and reversing the path
+ *
+ *	18/10/2026	control points on the line of sight accepted as diffraction points despite rounding
+ *				errors (flat parts of terrain profiles)
   * ------------------------------------------------------------------------------------------------- 
  */
 #include "PropagationPath.h"
@@ -82,11 +88,12 @@ bool PropagationPath::remove_barriers (void)
 			assert (barrier != 0) ;
 			cp[i].ext = 0 ;
 			/*
-			 * insert two extra control points
+			 * insert two extra control points ; the following points are moved by swapping them
+			 * with the new (empty) points, which end up at positions i+1 and i+2
 			 */
 			int n = cp.size() ;
 			cp.resize (n+2) ;
-			for (unsigned int j = n+1 ; j > i+1 ; --j) cp[j] = cp[j-2] ; 
+			for (unsigned int j = n+1 ; j > i+2 ; --j) cp[j].swap (cp[j-2]) ; 
 			/*
 			 * insert top of barrier 
 			 */
@@ -117,7 +124,7 @@ bool PropagationPath::reverse_path (void)
 	{
 		unsigned int i1 = i ;
 		unsigned int i2 = size()-1-i ;
-		std::swap (cp[i1], cp[i2]) ;
+		cp[i1].swap (cp[i2]) ;
 	}
 
 	for (unsigned int i = size()-1 ; i > 0 ; --i)
@@ -438,7 +445,11 @@ void PropagationPath::construct_convex_hull (unsigned int n1, unsigned int n2, u
 	{
 		if (dif_max >= 0)
 		{
-			assert (cp[pos_max].z_path <= cp[pos_max].pos.z) ;
+			/*
+			 * control points on the line of sight (e.g. on flat ground between two diffraction edges)
+			 * have a zero path difference, up to rounding errors on the intersection
+			 */
+			assert (cp[pos_max].z_path <= cp[pos_max].pos.z + 1.E-6) ;
 			cp[pos_max].z_path = cp[pos_max].pos.z ;
 			cp[pos_max].mode3D = Action3D::Diffraction ;
 			construct_convex_hull (n1, pos_max, level+1) ;
@@ -9,9 +9,12 @@
  * changes:
  *
  *	18/01/2013	initial version
+ *
+ *	18/10/2026	ControlPoint::swap exchanges control points without cloning the extensions
  * ------------------------------------------------------------------------------------------------- 
  */
 #include <vector>
+#include <algorithm>
 #include "Geometry3D.h"
 #include "ErrorMessage.h"
 #include "MeteoCondition.h"
@@ -112,6 +115,20 @@ namespace CnossosEU
 			z_path = other.z_path ; 
 			return *this ;
 		}
+		/*
+		 * exchange two control points ; unlike copying, this doesn't clone the extensions 
+		 * nor update any reference counters
+		 */
+		void swap (ControlPoint& other)
+		{
+			std::swap (pos, other.pos) ;
+			mat.swap (other.mat) ;
+			ext.swap (other.ext) ;
+			std::swap (mode2D, other.mode2D) ;
+			std::swap (mode3D, other.mode3D) ;
+			std::swap (d_path, other.d_path) ;
+			std::swap (z_path, other.z_path) ;
+		}
 		/*
 		 * indirect 
 		 */
@@ -8,6 +8,9 @@
  * changes:
  *
  *	28/11/2013	this header and licensing conditions added
+ *
+ *	18/10/2026	gcc versions return the new value (as InterlockedIncrement/Decrement) and
+ *				atomic_decrement no longer increments the counter
  * ------------------------------------------------------------------------------------------------- 
  */
 #include "ReferenceObject.h"
@@ -30,7 +33,7 @@ namespace System
 #else
 namespace System
 {
-	long atomic_increment (volatile long* x) { return __sync_fetch_and_add(x, 1); }
-	long atomic_decrement (volatile long* x) { return __sync_fetch_and_add(x, 1); }
+	long atomic_increment (volatile long* x) { return __sync_add_and_fetch(x, 1); }
+	long atomic_decrement (volatile long* x) { return __sync_sub_and_fetch(x, 1); }
 }
 #endif
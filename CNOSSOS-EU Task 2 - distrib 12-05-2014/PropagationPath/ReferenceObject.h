@@ -9,6 +9,8 @@
  * changes:
  *
  *	28/11/2013	this header and licensing conditions added
+ *
+ *	18/10/2026	objects confined to a single thread may use non-atomic reference counting
  * ------------------------------------------------------------------------------------------------- 
  */
 #include <typeinfo>
@@ -68,12 +70,19 @@ namespace System
 	 *
 	 * this will disconnect the pointer from the reference holder and pass on the standard
 	 * pointer to the library...
+	 *
+	 * by default, the reference counter is updated by means of atomic operations so that
+	 * objects can be shared between threads (e.g. the materials in the global catalogue).
+	 * Objects that are owned by a single thread (e.g. the vertical extensions and source
+	 * geometries that are cloned together with the control points of a path) may use plain 
+	 * increments and decrements instead, see setThreadLocal. Copies of an object inherit 
+	 * its ownership mode.
 	 */
 	class ReferenceObject
 	{
 	public:
 
-		ReferenceObject (void) : refCount(0)
+		ReferenceObject (void) : refCount(0), threadLocal(false)
 		{
 		}
 
@@ -81,9 +90,15 @@ namespace System
 		{ 
 		}
 
-		ReferenceObject (ReferenceObject const& other) : refCount(0)
+		ReferenceObject (ReferenceObject const& other) : refCount(0), threadLocal(other.threadLocal)
 		{
 		}
+		/*
+		 * select non-atomic reference counting ; only use this for objects that are never
+		 * referenced by ref_ptr's living in different threads
+		 */
+		void setThreadLocal (bool on_off = true) { threadLocal = on_off ; }
+		bool isThreadLocal (void) const { return threadLocal ; }
 
 	protected:
 				
@@ -91,25 +106,32 @@ namespace System
 
 		void addref (void) 
 		{ 
-			atomic_increment (&refCount) ; 
+			if (threadLocal) 
+				++refCount ;
+			else
+				atomic_increment (&refCount) ; 
 		}
 
 		bool unref (void)
 		{
 			assert (refCount > 0) ;
-			atomic_decrement (&refCount) ;
-			return refCount == 0 ;
+			if (threadLocal) return --refCount == 0 ;
+			return atomic_decrement (&refCount) == 0 ;
 		}
 
 		void unref_nodelete (void)
 		{
-			atomic_decrement (&refCount) ;
+			if (threadLocal) 
+				--refCount ;
+			else
+				atomic_decrement (&refCount) ;
 		}
 
 	private:
 
 		ReferenceObject& operator= (ReferenceObject const&) ;
 		volatile long refCount ;
+		bool threadLocal ;
 	};
 
 	/*
@@ -201,6 +223,15 @@ namespace System
 			obj = 0 ;
 			return tmp ;
 		}
+		/*
+		 * exchange the pointee objects of two ref_ptr's, without updating the reference counters
+		 */
+		void swap (ref_ptr<T>& other)
+		{
+			T* tmp = obj ;
+			obj = other.obj ;
+			other.obj = tmp ;
+		}
 		/*
 		 * cast to a different (derived) pointer type 
 		 */
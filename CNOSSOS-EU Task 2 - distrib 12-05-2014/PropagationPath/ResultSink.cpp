@@ -0,0 +1,384 @@
+/*
+ * ------------------------------------------------------------------------------------------------
+ * file:		ResultSink.cpp
+ * version:		1.0
+ * author:		dirk.van-maercke@cstb.fr
+ * copyright:	see file licence.EU.txt
+ * description: output of the results of large numbers of propagation paths
+ * changes:
+ *
+ *	18/10/2026	initial version
+ * -------------------------------------------------------------------------------------------------
+ */
+#include "ResultSink.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <string>
+#ifdef __GNUC__
+#define _finite finite
+#endif
+
+using namespace CnossosEU ;
+
+static const char MAGIC[8] = { 'C', 'N', 'O', 'S', 'R', 'S', 'L', 'T' } ;
+static const uint32_t VERSION = 1 ;
+static const unsigned int HEADER_SIZE = 32 ;
+static const unsigned int NB_RESULTS_OFFSET = 24 ;
+/*
+ * the buffer is written to the file once it exceeds this size
+ */
+static const unsigned int BUFFER_SIZE = 1 << 20 ;
+/*
+ * columns, either a scalar or a spectrum of the result. The first columns are written in all cases,
+ * the other ones only if details are requested.
+ */
+struct ResultColumn
+{
+	const char* name ;
+	double PathResult::* scalar ;
+	Spectrum PathResult::* spectrum ;
+} ;
+
+static const ResultColumn result_columns[] =
+{
+	{ "LeqA",		&PathResult::Leq_dBA,	0 },
+	{ "LpFA",		&PathResult::LpF_dBA,	0 },
+	{ "LpHA",		&PathResult::LpH_dBA,	0 },
+	{ "Leq",		0,	&PathResult::Leq },
+	{ "LpF",		0,	&PathResult::LpF },
+	{ "LpH",		0,	&PathResult::LpH },
+	{ "attGeo",		&PathResult::AttGeo,	0 },
+	{ "Lw",			0,	&PathResult::Lw },
+	{ "dBA",		0,	&PathResult::dBA },
+	{ "deltaLw",	0,	&PathResult::delta_Lw },
+	{ "attAir",		0,	&PathResult::AttAir },
+	{ "attRef",		0,	&PathResult::AttAbsMat },
+	{ "attDif",		0,	&PathResult::AttLatDif },
+	{ "attSize",	0,	&PathResult::AttSize },
+	{ "attF",		0,	&PathResult::AttF },
+	{ "attH",		0,	&PathResult::AttH }
+} ;
+
+static const unsigned int NB_COLUMNS = sizeof(result_columns) / sizeof(result_columns[0]) ;
+static const unsigned int NB_BASIC_COLUMNS = 6 ;
+
+static unsigned int get_width (unsigned int column)
+{
+	return result_columns[column].scalar != 0 ? 1 : Spectrum::nbFreq ;
+}
+/*
+ * encoding of scalar values in little-endian byte order, whatever the byte order of the host
+ */
+static bool host_is_little_endian (void)
+{
+	uint16_t x = 1 ;
+	return *(unsigned char*) &x == 1 ;
+}
+
+static const bool little_endian = host_is_little_endian() ;
+
+template <class T> static void put (std::vector<unsigned char>& buffer, T value)
+{
+	unsigned char b[sizeof(T)] ;
+	memcpy (b, &value, sizeof(T)) ;
+	if (!little_endian) std::reverse (b, b + sizeof(T)) ;
+	buffer.insert (buffer.end(), b, b + sizeof(T)) ;
+}
+
+template <class T> static T get (const unsigned char* p)
+{
+	unsigned char b[sizeof(T)] ;
+	memcpy (b, p, sizeof(T)) ;
+	if (!little_endian) std::reverse (b, b + sizeof(T)) ;
+	T value ;
+	memcpy (&value, b, sizeof(T)) ;
+	return value ;
+}
+/*
+ * append an array of values in one go
+ */
+template <class T> static void put_values (std::vector<unsigned char>& buffer, const double* values, unsigned int n)
+{
+	size_t pos = buffer.size() ;
+	buffer.resize (pos + n * sizeof(T)) ;
+	unsigned char* p = &buffer[pos] ;
+	for (unsigned int i = 0 ; i < n ; ++i, p += sizeof(T))
+	{
+		T value = (T) values[i] ;
+		memcpy (p, &value, sizeof(T)) ;
+		if (!little_endian) std::reverse (p, p + sizeof(T)) ;
+	}
+}
+/*
+ * fixed-point formatting of a value with the given number of decimals, rounded to the nearest ;
+ * large values are written in exponential notation. Returns the end of the string (not terminated).
+ */
+static char* format_value (char* s, double x, unsigned int decimals)
+{
+	static const double scale[10] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9 } ;
+	if (!_finite (x))
+	{
+		const char* text = (x != x) ? "nan" : (x < 0) ? "-inf" : "inf" ;
+		while (*text) *s++ = *text++ ;
+		return s ;
+	}
+	double scaled = fabs (x) * scale[decimals] + 0.5 ;
+	if (scaled >= 1e15) return s + sprintf (s, "%.17g", x) ;
+
+	uint64_t n = (uint64_t) scaled ;
+	if (x < 0 && n != 0) *s++ = '-' ;
+	char digits[24] ;
+	unsigned int nb_digits = 0 ;
+	do
+	{
+		digits[nb_digits++] = (char) ('0' + n % 10) ;
+		n /= 10 ;
+	}
+	while (n > 0 || nb_digits <= decimals) ;
+	while (nb_digits > decimals) *s++ = digits[--nb_digits] ;
+	if (decimals > 0)
+	{
+		*s++ = '.' ;
+		while (nb_digits > 0) *s++ = digits[--nb_digits] ;
+	}
+	return s ;
+}
+
+ResultSink::ResultSink (void)
+: fp (0), options(), failed (false), nbResults (0), count (0), columns(), start(), block(), buffer()
+{
+}
+
+ResultSink::~ResultSink (void)
+{
+	if (fp != 0) close() ;
+}
+
+bool ResultSink::open (const char* fileName, ResultSinkOptions const& _options)
+{
+	if (fp != 0) close() ;
+	fp = fopen (fileName, "wb") ;
+	if (fp == 0) return false ;
+
+	options = _options ;
+	options.Decimals = std::min (options.Decimals, 9u) ;
+	options.BlockSize = std::max (options.BlockSize, 1u) ;
+	failed = false ;
+	nbResults = 0 ;
+	count = 0 ;
+
+	columns.clear() ;
+	start.clear() ;
+	unsigned int size = 0 ;
+	for (unsigned int c = 0 ; c < (options.Details ? NB_COLUMNS : NB_BASIC_COLUMNS) ; ++c)
+	{
+		columns.push_back (c) ;
+		start.push_back (size) ;
+		size += get_width (c) * options.BlockSize ;
+	}
+	block.resize (size) ;
+	buffer.clear() ;
+	buffer.reserve (BUFFER_SIZE + size * sizeof(double)) ;
+
+	if (options.CSV)
+	{
+		std::string header ;
+		char text[64] ;
+		for (unsigned int k = 0 ; k < columns.size() ; ++k)
+		{
+			ResultColumn const& column = result_columns[columns[k]] ;
+			for (unsigned int i = 0 ; i < get_width (columns[k]) ; ++i)
+			{
+				if (k > 0 || i > 0) header += ',' ;
+				header += column.name ;
+				if (column.spectrum == 0) continue ;
+				sprintf (text, "_%.0f", Spectrum::freq (i)) ;
+				header += text ;
+			}
+		}
+		header += '\n' ;
+		buffer.insert (buffer.end(), header.begin(), header.end()) ;
+	}
+	else
+	{
+		buffer.insert (buffer.end(), MAGIC, MAGIC + 8) ;
+		put<uint32_t> (buffer, VERSION) ;
+		put<uint32_t> (buffer, Spectrum::nbFreq) ;
+		put<uint32_t> (buffer, options.Float32 ? 4 : 8) ;
+		put<uint32_t> (buffer, columns.size()) ;
+		put<uint64_t> (buffer, 0) ;
+		for (unsigned int k = 0 ; k < columns.size() ; ++k)
+		{
+			const char* name = result_columns[columns[k]].name ;
+			put<uint16_t> (buffer, (uint16_t) strlen (name)) ;
+			buffer.insert (buffer.end(), name, name + strlen (name)) ;
+			put<uint32_t> (buffer, get_width (columns[k])) ;
+		}
+	}
+	return true ;
+}
+
+bool ResultSink::add (PathResult const& result)
+{
+	if (fp == 0) return false ;
+	for (unsigned int k = 0 ; k < columns.size() ; ++k)
+	{
+		ResultColumn const& column = result_columns[columns[k]] ;
+		if (column.scalar != 0)
+		{
+			block[start[k] + count] = result.*column.scalar ;
+		}
+		else
+		{
+			Spectrum const& spec = result.*column.spectrum ;
+			std::copy (spec.val, spec.val + Spectrum::nbFreq, &block[start[k] + count * Spectrum::nbFreq]) ;
+		}
+	}
+	nbResults++ ;
+	if (++count == options.BlockSize) writeBlock() ;
+	return !failed ;
+}
+/*
+ * encode the current block into the buffer
+ */
+void ResultSink::writeBlock (void)
+{
+	if (count == 0) return ;
+	if (options.CSV)
+	{
+		/*
+		 * one line per result ; the size of the buffer is adjusted once per block, assuming at most
+		 * 32 characters per value
+		 */
+		unsigned int nb_values = 0 ;
+		for (unsigned int k = 0 ; k < columns.size() ; ++k) nb_values += get_width (columns[k]) ;
+		size_t pos = buffer.size() ;
+		buffer.resize (pos + count * nb_values * 32) ;
+		char* s = (char*) &buffer[pos] ;
+		for (unsigned int r = 0 ; r < count ; ++r)
+		{
+			for (unsigned int k = 0 ; k < columns.size() ; ++k)
+			{
+				unsigned int width = get_width (columns[k]) ;
+				const double* values = &block[start[k] + r * width] ;
+				for (unsigned int i = 0 ; i < width ; ++i)
+				{
+					s = format_value (s, values[i], options.Decimals) ;
+					*s++ = ',' ;
+				}
+			}
+			s[-1] = '\n' ;
+		}
+		buffer.resize (s - (char*) &buffer[0]) ;
+	}
+	else
+	{
+		put<uint32_t> (buffer, count) ;
+		for (unsigned int k = 0 ; k < columns.size() ; ++k)
+		{
+			unsigned int n = count * get_width (columns[k]) ;
+			if (options.Float32)
+				put_values<float> (buffer, &block[start[k]], n) ;
+			else
+				put_values<double> (buffer, &block[start[k]], n) ;
+		}
+	}
+	count = 0 ;
+	if (buffer.size() >= BUFFER_SIZE) writeBuffer() ;
+}
+
+void ResultSink::writeBuffer (void)
+{
+	if (buffer.empty()) return ;
+	if (fwrite (&buffer[0], 1, buffer.size(), fp) != buffer.size()) failed = true ;
+	buffer.clear() ;
+}
+
+bool ResultSink::close (void)
+{
+	if (fp == 0) return false ;
+	writeBlock() ;
+	writeBuffer() ;
+	if (!options.CSV)
+	{
+		put<uint64_t> (buffer, nbResults) ;
+		if (fseek (fp, NB_RESULTS_OFFSET, SEEK_SET) != 0) failed = true ;
+		writeBuffer() ;
+	}
+	if (fclose (fp) != 0) failed = true ;
+	fp = 0 ;
+	block.clear() ;
+	buffer.clear() ;
+	return !failed ;
+}
+
+bool CnossosEU::readResultFile (const char* fileName, std::vector<PathResult>& results)
+{
+	results.clear() ;
+	FILE* fp = fopen (fileName, "rb") ;
+	if (fp == 0) return false ;
+	std::vector<unsigned char> data ;
+	unsigned char chunk[65536] ;
+	size_t n ;
+	while ((n = fread (chunk, 1, sizeof(chunk), fp)) > 0) data.insert (data.end(), chunk, chunk + n) ;
+	fclose (fp) ;
+
+	if (data.size() < HEADER_SIZE || memcmp (&data[0], MAGIC, 8) != 0) return false ;
+	const unsigned char* p = &data[0] ;
+	const unsigned char* end = p + data.size() ;
+	if (get<uint32_t> (p + 8) != VERSION || get<uint32_t> (p + 12) != (uint32_t) Spectrum::nbFreq) return false ;
+	unsigned int value_size = get<uint32_t> (p + 16) ;
+	unsigned int nb_columns = get<uint32_t> (p + 20) ;
+	uint64_t nb_results = get<uint64_t> (p + NB_RESULTS_OFFSET) ;
+	if (value_size != 4 && value_size != 8) return false ;
+	/*
+	 * match the columns of the file with the members of the result, unknown columns are skipped
+	 */
+	std::vector<int> column ;
+	std::vector<unsigned int> width ;
+	p += HEADER_SIZE ;
+	for (unsigned int k = 0 ; k < nb_columns ; ++k)
+	{
+		if (end - p < 2) return false ;
+		unsigned int len = get<uint16_t> (p) ;
+		if ((size_t) (end - p) < 6u + len) return false ;
+		std::string name ((const char*) p + 2, len) ;
+		width.push_back (get<uint32_t> (p + 2 + len)) ;
+		p += 6 + len ;
+		column.push_back (-1) ;
+		for (unsigned int c = 0 ; c < NB_COLUMNS ; ++c)
+		{
+			if (name == result_columns[c].name && width.back() == get_width (c)) column.back() = c ;
+		}
+	}
+
+	results.reserve ((size_t) nb_results) ;
+	while (results.size() < nb_results)
+	{
+		if (end - p < 4) return false ;
+		unsigned int count = get<uint32_t> (p) ;
+		p += 4 ;
+		size_t first = results.size() ;
+		if (count == 0 || first + count > nb_results) return false ;
+		results.resize (first + count) ;
+		for (unsigned int k = 0 ; k < nb_columns ; ++k)
+		{
+			size_t size = (size_t) count * width[k] * value_size ;
+			if ((size_t) (end - p) < size) return false ;
+			for (unsigned int r = 0 ; r < count && column[k] >= 0 ; ++r)
+			{
+				ResultColumn const& c = result_columns[column[k]] ;
+				double* values = (c.scalar != 0) ? &(results[first + r].*c.scalar) : (results[first + r].*c.spectrum).val ;
+				for (unsigned int i = 0 ; i < width[k] ; ++i)
+				{
+					const unsigned char* q = p + (r * width[k] + i) * value_size ;
+					values[i] = (value_size == 4) ? (double) get<float> (q) : get<double> (q) ;
+				}
+			}
+			p += size ;
+		}
+	}
+	return true ;
+}
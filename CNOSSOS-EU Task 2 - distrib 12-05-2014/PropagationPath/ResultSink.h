@@ -0,0 +1,90 @@
+#pragma once
+/*
+ * ------------------------------------------------------------------------------------------------
+ * file:		ResultSink.h
+ * version:		1.0
+ * author:		dirk.van-maercke@cstb.fr
+ * copyright:	see file licence.EU.txt
+ * description: output of the results of large numbers of propagation paths
+ * note:		results are accumulated in blocks, column by column, and each block is written to a
+ *				memory buffer that is flushed to the file in large chunks. The output is either a
+ *				comma-separated text file, with one line per result, or a binary file with the
+ *				following layout (all values in little-endian byte order)
+ *
+ *					header		magic "CNOSRSLT", version, number of frequency bands, size of the
+ *								values (4 or 8 bytes), number of columns and number of results
+ *					columns		name and number of values (1 or number of frequency bands) per result
+ *					blocks		number of results in the block, followed by the values of each column,
+ *								result by result
+ *
+ *				The columns are named after the tags of the XML output (see PathResult.h).
+ * changes:
+ *
+ *	18/10/2026	initial version
+ * -------------------------------------------------------------------------------------------------
+ */
+#include "PathResult.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <vector>
+
+namespace CnossosEU
+{
+	struct ResultSinkOptions
+	{
+		bool			CSV ;			// write a text file instead of a binary file
+		bool			Float32 ;		// binary file: store values in single precision
+		unsigned int	Decimals ;		// text file: number of decimals (at most 9)
+		bool			Details ;		// write all spectra, otherwise only the dB(A) levels and the Leq, LpF and LpH spectra
+		unsigned int	BlockSize ;		// number of results per block
+
+		ResultSinkOptions (void) : CSV (false), Float32 (false), Decimals (1), Details (true), BlockSize (4096) { }
+	} ;
+	/*
+	 * write the results of a sequence of propagation paths to a single file
+	 */
+	class ResultSink
+	{
+	public:
+		ResultSink (void) ;
+		~ResultSink (void) ;
+		/*
+		 * create the file, returns false if the file cannot be created
+		 */
+		bool open (const char* fileName, ResultSinkOptions const& options = ResultSinkOptions()) ;
+		/*
+		 * append a result, returns false in case of a write error
+		 */
+		bool add (PathResult const& result) ;
+		/*
+		 * write the last block and close the file, returns false in case of a write error
+		 */
+		bool close (void) ;
+
+		uint64_t getNbResults (void) const { return nbResults ; }
+
+	private:
+
+		FILE*						fp ;
+		ResultSinkOptions			options ;
+		bool						failed ;
+		uint64_t					nbResults ;
+		unsigned int				count ;			// number of results in the current block
+		std::vector<unsigned int>	columns ;		// selected columns
+		std::vector<unsigned int>	start ;			// position of each column in the block
+		std::vector<double>			block ;
+		std::vector<unsigned char>	buffer ;
+
+		void writeBlock (void) ;
+		void writeBuffer (void) ;
+
+		ResultSink (ResultSink const&) ;
+		ResultSink& operator= (ResultSink const&) ;
+	} ;
+	/*
+	 * read a binary file created by ResultSink. Columns not present in the file are set to zero.
+	 * Returns false if the file cannot be read or is not a valid result file for the current
+	 * number of frequency bands.
+	 */
+	bool readResultFile (const char* fileName, std::vector<PathResult>& results) ;
+}
@@ -10,6 +10,8 @@
  * changes:
  *
  *	28/11/2013	initial version 1.001
+ *
+ *	18/10/2026	optional statically dispatched pipeline
  * ------------------------------------------------------------------------------------------------- 
  */
 #include "JRC-draft-2010.h"
@@ -20,16 +22,32 @@
 
 using namespace CnossosEU ;
 
+static bool static_pipeline = false ;
+
+void CnossosEU::SetStaticPipeline (bool on_off)
+{
+	static_pipeline = on_off ;
+}
+
 CalculationMethod* CnossosEU::getCalculationMethod (const char* id)
 {
 	if (id == 0) return NULL ;
 	/*
 	 * three methods are currently available
 	 */
-	if (_strcmpi (id, "CNOSSOS-2018") == 0) return new CNOSSOS_2018() ;
-	if (_strcmpi (id, "ISO-9613-2") == 0) return new ISO_9613_2() ;
-	if (_strcmpi (id, "JRC-2012") == 0) return new JRC2012() ;
-	if (_strcmpi (id, "JRC-DRAFT-2010") == 0) return new JRCdraft2010() ;
-
+	if (static_pipeline)
+	{
+		if (_strcmpi (id, "CNOSSOS-2018") == 0) return new StaticPipeline<CNOSSOS_2018>() ;
+		if (_strcmpi (id, "ISO-9613-2") == 0) return new StaticPipeline<ISO_9613_2>() ;
+		if (_strcmpi (id, "JRC-2012") == 0) return new StaticPipeline<JRC2012>() ;
+		if (_strcmpi (id, "JRC-DRAFT-2010") == 0) return new StaticPipeline<JRCdraft2010>() ;
+	}
+	else
+	{
+		if (_strcmpi (id, "CNOSSOS-2018") == 0) return new CNOSSOS_2018() ;
+		if (_strcmpi (id, "ISO-9613-2") == 0) return new ISO_9613_2() ;
+		if (_strcmpi (id, "JRC-2012") == 0) return new JRC2012() ;
+		if (_strcmpi (id, "JRC-DRAFT-2010") == 0) return new JRCdraft2010() ;
+	}
 	return NULL ;
 }
@@ -19,6 +19,8 @@
  *
  *  02/12/2013	added support for evaluation of directivity in local coordinates
  *
+ *	18/10/2026	source geometries use non-atomic reference counting (see ReferenceObject.h)
+ *
  * ------------------------------------------------------------------------------------------------- 
  */
 #include "Geometry3D.h"
@@ -37,9 +39,10 @@ namespace CnossosEU
 	{
 	public:
 		/*
-		 * default constructor
+		 * default constructor ; source geometries are cloned together with the source extension
+		 * and are never shared between threads
 		 */
-		SourceGeometry (void) : System::ReferenceObject() { }
+		SourceGeometry (void) : System::ReferenceObject() { setThreadLocal() ; }
 		/*
 		 * virtual copy operator is undefined for the base class
 		 */
@@ -0,0 +1,186 @@
+/*
+ * ------------------------------------------------------------------------------------------------
+ * file:		SourceTree.cpp
+ * version:		1.0
+ * author:		dirk.van-maercke@cstb.fr
+ * copyright:	see file licence.EU.txt
+ * description: hierarchical clustering of point sources
+ * changes:
+ *
+ *	18/10/2026	initial version
+ * -------------------------------------------------------------------------------------------------
+ */
+#include "SourceTree.h"
+#include <math.h>
+#include <algorithm>
+
+using namespace CnossosEU ;
+using namespace Geometry ;
+
+static const double PI = 3.1415926 ;
+/*
+ * limits the depth of the tree for (nearly) coincident sources
+ */
+static const unsigned int MAX_DEPTH = 24 ;
+
+SourceTree::SourceTree (unsigned int _leafSize)
+: leafSize (std::max (_leafSize, 1u)), items(), order(), nodes()
+{
+}
+
+SourceTree::~SourceTree (void)
+{
+}
+
+unsigned int SourceTree::addSource (Point3D const& pos, ElementarySource const& source)
+{
+	Item item ;
+	item.pos = pos ;
+	item.source = source ;
+	item.weight = 0 ;
+	for (unsigned int i = 0 ; i < source.soundPower.size() ; ++i)
+	{
+		double Lw = source.soundPower[i] ;
+		if (source.frequencyWeighting != FrequencyWeighting::dBA) Lw += Spectrum::dBA(i) ;
+		item.weight += POW10 (Lw) ;
+	}
+	items.push_back (item) ;
+	return items.size() - 1 ;
+}
+/*
+ * combine the members of a node
+ */
+void SourceTree::initNode (unsigned int index, unsigned int first, unsigned int count)
+{
+	SourceCluster& node = nodes[index] ;
+	Item const& ref = items[order[first]] ;
+	node.first = first ;
+	node.count = count ;
+	node.child = 0 ;
+	node.nbChildren = 0 ;
+	node.merged = true ;
+	node.xmin = node.xmax = ref.pos.x ;
+	node.ymin = node.ymax = ref.pos.y ;
+
+	double total = 0 ;
+	for (unsigned int k = first ; k < first + count ; ++k) total += items[order[k]].weight ;
+
+	Spectrum energy (0.0) ;
+	double x = 0, y = 0, z = 0, h = 0 ;
+	for (unsigned int k = first ; k < first + count ; ++k)
+	{
+		Item const& item = items[order[k]] ;
+		double w = (total > 0) ? item.weight / total : 1.0 / count ;
+		x += w * item.pos.x ;
+		y += w * item.pos.y ;
+		z += w * item.pos.z ;
+		h += w * item.source.sourceHeight ;
+		energy += POW10 (item.source.soundPower) ;
+		node.xmin = std::min (node.xmin, item.pos.x) ;
+		node.xmax = std::max (node.xmax, item.pos.x) ;
+		node.ymin = std::min (node.ymin, item.pos.y) ;
+		node.ymax = std::max (node.ymax, item.pos.y) ;
+		if (item.source.frequencyWeighting != ref.source.frequencyWeighting ||
+			item.source.measurementType != ref.source.measurementType) node.merged = false ;
+	}
+	node.pos = Point3D (x, y, z) ;
+	node.source = ref.source ;
+	node.source.sourceHeight = h ;
+	node.source.spectrumType = SpectrumType::PointSource ;
+	node.source.soundPower = LOG10 (energy) ;
+
+	node.radius = 0 ;
+	for (unsigned int k = first ; k < first + count ; ++k)
+	{
+		Point3D const& p = items[order[k]].pos ;
+		node.radius = std::max (node.radius, sqrt ((p.x - x) * (p.x - x) + (p.y - y) * (p.y - y))) ;
+	}
+}
+/*
+ * split a node into (at most) four quadrants around the middle of its extent
+ */
+void SourceTree::splitNode (unsigned int index, unsigned int depth)
+{
+	SourceCluster node = nodes[index] ;
+	if (node.count <= leafSize || depth >= MAX_DEPTH) return ;
+	if (node.xmax <= node.xmin && node.ymax <= node.ymin) return ;
+
+	double xm = 0.5 * (node.xmin + node.xmax) ;
+	double ym = 0.5 * (node.ymin + node.ymax) ;
+	std::vector<unsigned int> quadrant[4] ;
+	for (unsigned int k = node.first ; k < node.first + node.count ; ++k)
+	{
+		Point3D const& p = items[order[k]].pos ;
+		quadrant[(p.x >= xm ? 1 : 0) + (p.y >= ym ? 2 : 0)].push_back (order[k]) ;
+	}
+	unsigned int first_child = nodes.size() ;
+	unsigned int nb_children = 0 ;
+	unsigned int pos = node.first ;
+	for (unsigned int q = 0 ; q < 4 ; ++q)
+	{
+		if (quadrant[q].empty()) continue ;
+		std::copy (quadrant[q].begin(), quadrant[q].end(), order.begin() + pos) ;
+		pos += quadrant[q].size() ;
+		nb_children++ ;
+	}
+	nodes.resize (first_child + nb_children) ;
+	nodes[index].child = first_child ;
+	nodes[index].nbChildren = nb_children ;
+
+	pos = node.first ;
+	unsigned int child = first_child ;
+	for (unsigned int q = 0 ; q < 4 ; ++q)
+	{
+		if (quadrant[q].empty()) continue ;
+		initNode (child++, pos, quadrant[q].size()) ;
+		pos += quadrant[q].size() ;
+	}
+	for (unsigned int k = 0 ; k < nb_children ; ++k) splitNode (first_child + k, depth + 1) ;
+}
+
+void SourceTree::build (void)
+{
+	nodes.clear() ;
+	order.resize (items.size()) ;
+	for (unsigned int k = 0 ; k < order.size() ; ++k) order[k] = k ;
+	if (items.empty()) return ;
+
+	nodes.resize (1) ;
+	initNode (0, 0, items.size()) ;
+	splitNode (0, 0) ;
+}
+
+void SourceTree::select (double xmin, double ymin, double xmax, double ymax, double maxAngle, double maxDistance,
+						 std::vector<unsigned int>& clusters, std::vector<unsigned int>& sources) const
+{
+	if (nodes.empty()) return ;
+	/*
+	 * the cluster is seen under an angle less than 2.atan(radius/d) from any point at a distance d
+	 * or more from its extent
+	 */
+	double t = tan (0.5 * maxAngle * PI / 180) ;
+	std::vector<unsigned int> stack (1, 0) ;
+	while (!stack.empty())
+	{
+		SourceCluster const& node = nodes[stack.back()] ;
+		stack.pop_back() ;
+
+		double dx = std::max (0.0, std::max (node.xmin - xmax, xmin - node.xmax)) ;
+		double dy = std::max (0.0, std::max (node.ymin - ymax, ymin - node.ymax)) ;
+		double d2 = dx * dx + dy * dy ;
+		if (d2 > maxDistance * maxDistance) continue ;
+
+		if (node.count > 1 && node.merged && d2 > 0 && node.radius <= t * sqrt (d2))
+		{
+			clusters.push_back (&node - &nodes[0]) ;
+		}
+		else if (node.nbChildren == 0)
+		{
+			for (unsigned int k = node.first ; k < node.first + node.count ; ++k) sources.push_back (order[k]) ;
+		}
+		else
+		{
+			for (unsigned int k = 0 ; k < node.nbChildren ; ++k) stack.push_back (node.child + k) ;
+		}
+	}
+}
@@ -0,0 +1,100 @@
+#pragma once
+/*
+ * ------------------------------------------------------------------------------------------------
+ * file:		SourceTree.h
+ * version:		1.0
+ * author:		dirk.van-maercke@cstb.fr
+ * copyright:	see file licence.EU.txt
+ * description: hierarchical clustering of point sources, for the calculation of far-field
+ *				contributions by means of equivalent sources
+ * note:		the sources are stored in a quadtree. Each node of the tree is a cluster of sources
+ *				with the combined sound power of its members, located at their energy-weighted
+ *				centre. Seen from receivers far away compared to the size of the cluster, i.e. under
+ *				a small opening angle, the cluster is replaced by this equivalent source ; closer
+ *				receivers descend into the children of the cluster.
+ * changes:
+ *
+ *	18/10/2026	initial version
+ * -------------------------------------------------------------------------------------------------
+ */
+#include "ElementarySource.h"
+#include <vector>
+
+namespace CnossosEU
+{
+	/*
+	 * node of the tree
+	 */
+	struct SourceCluster
+	{
+		Geometry::Point3D	pos ;			// centre of the members, weighted by their A-weighted sound power
+		ElementarySource	source ;		// combined sound power, weighted mean of the source heights
+		double				xmin ;			// extent of the members in the horizontal plane
+		double				ymin ;
+		double				xmax ;
+		double				ymax ;
+		double				radius ;		// largest horizontal distance between pos and a member
+		unsigned int		first ;			// members are getMember(first) ... getMember(first + count - 1)
+		unsigned int		count ;
+		unsigned int		child ;			// index of the first child, children are consecutive (0 = leaf)
+		unsigned int		nbChildren ;
+		bool				merged ;		// false if the members cannot be combined in a single source
+	} ;
+	/*
+	 * quadtree of point sources. The tree is read-only once built and can be shared by multiple
+	 * threads.
+	 */
+	class SourceTree
+	{
+	public:
+		/*
+		 * nodes with leafSize members or less are not subdivided
+		 */
+		SourceTree (unsigned int leafSize = 4) ;
+		~SourceTree (void) ;
+		/*
+		 * add a point source and return its index. Only sources with the same frequency weighting
+		 * and measurement conditions are combined.
+		 */
+		unsigned int addSource (Geometry::Point3D const& pos, ElementarySource const& source) ;
+		/*
+		 * construct the tree, must be called after adding the sources and before any query
+		 */
+		void build (void) ;
+		/*
+		 * select the clusters and the individual sources representing all sources for the receivers
+		 * in the rectangle (xmin,ymin)-(xmax,ymax). Clusters are selected if they are seen from any
+		 * point in the rectangle under an angle (degrees) less than maxAngle. Sources and clusters
+		 * further away than maxDistance from the rectangle are ignored.
+		 */
+		void select (double xmin, double ymin, double xmax, double ymax, double maxAngle, double maxDistance,
+					 std::vector<unsigned int>& clusters, std::vector<unsigned int>& sources) const ;
+		/*
+		 * access to the nodes and to the sources, in the order of the tree
+		 */
+		unsigned int getNbClusters (void) const { return nodes.size() ; }
+		SourceCluster const& getCluster (unsigned int k) const { return nodes[k] ; }
+		unsigned int getNbSources (void) const { return items.size() ; }
+		unsigned int getMember (unsigned int k) const { return order[k] ; }
+
+	private:
+
+		struct Item
+		{
+			Geometry::Point3D	pos ;
+			ElementarySource	source ;
+			double				weight ;		// A-weighted sound power (W)
+		} ;
+
+		unsigned int leafSize ;
+		std::vector<Item> items ;
+		std::vector<unsigned int> order ;
+		std::vector<SourceCluster> nodes ;
+
+		void initNode (unsigned int index, unsigned int first, unsigned int count) ;
+		void splitNode (unsigned int index, unsigned int depth) ;
+
+		SourceTree (SourceTree const&) ;
+		SourceTree& operator= (SourceTree const&) ;
+	} ;
+}
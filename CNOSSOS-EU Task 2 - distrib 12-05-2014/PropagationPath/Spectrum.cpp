@@ -8,21 +8,63 @@
  * changes:
  *
  *	18/10/2013	initial version
+ *
+ *	18/10/2026	band tables for 24 and 27 one-third octave bands
  * ------------------------------------------------------------------------------------------------- 
  */
 #include "./Spectrum.h"
 
 using namespace CnossosEU ;
 
-static double _fixedFreq[]    = {   63,   125,  250,  500, 1000, 2000, 4000, 8000 } ;
-/*
- * note that dB(A) weighting is not defined for 1/1 octave bands. An estimate can be made by 
- * using 1/3 octave band values, assuming a constant spectral density in each 1/3 octave band
- */
-static double _dBAweighting[] = {-25.2, -15.6, -8.4, -3.1,  0.0,  1.2,  0.9, -2.4 } ; 
-
 namespace CnossosEU
 {
+	const double FrequencyBands<8>::freq[8]  = {   63,   125,  250,  500, 1000, 2000, 4000, 8000 } ;
+	/*
+	 * note that dB(A) weighting is not defined for 1/1 octave bands. An estimate can be made by 
+	 * using 1/3 octave band values, assuming a constant spectral density in each 1/3 octave band
+	 */
+	const double FrequencyBands<8>::dBA[8]   = {-25.2, -15.6, -8.4, -3.1,  0.0,  1.2,  0.9, -2.4 } ; 
+	const unsigned int FrequencyBands<8>::octave[8] = { 0, 1, 2, 3, 4, 5, 6, 7 } ;
+	/*
+	 * one-third octave bands from 50Hz to 10kHz, as used by the source models
+	 */
+	const double FrequencyBands<24>::freq[24] = 
+	{
+		   50,    63,    80,   100,   125,   160,   200,   250,   315,   400,   500,   630,
+		  800,  1000,  1250,  1600,  2000,  2500,  3150,  4000,  5000,  6300,  8000, 10000 
+	} ;
+	const double FrequencyBands<24>::dBA[24] = 
+	{
+		-30.2, -26.2, -22.5, -19.1, -16.1, -13.4, -10.9,  -8.6,  -6.6,  -4.8,  -3.2,  -1.9,
+		 -0.8,   0.0,   0.6,   1.0,   1.2,   1.3,   1.2,   1.0,   0.5,  -0.1,  -1.1,  -2.5
+	} ;
+	const unsigned int FrequencyBands<24>::octave[24] = 
+	{
+		    0,     0,     0,     1,     1,     1,     2,     2,     2,     3,     3,     3,
+		    4,     4,     4,     5,     5,     5,     6,     6,     6,     7,     7,     7
+	} ;
+	/*
+	 * one-third octave bands from 25Hz to 10kHz, as used by the Harmonoise model
+	 */
+	const double FrequencyBands<27>::freq[27] = 
+	{
+		   25,    32,    40,    50,    63,    80,   100,   125,   160,   200,   250,   315,   400,
+		  500,   630,   800,  1000,  1250,  1600,  2000,  2500,  3150,  4000,  5000,  6300,  8000, 
+		10000 
+	} ;
+	const double FrequencyBands<27>::dBA[27] = 
+	{
+		-44.7, -39.4, -34.6, -30.2, -26.2, -22.5, -19.1, -16.1, -13.4, -10.9,  -8.6,  -6.6,  -4.8,
+		 -3.2,  -1.9,  -0.8,   0.0,   0.6,   1.0,   1.2,   1.3,   1.2,   1.0,   0.5,  -0.1,  -1.1,
+		 -2.5
+	} ;
+	const unsigned int FrequencyBands<27>::octave[27] = 
+	{
+		    0,     0,     0,     0,     0,     0,     1,     1,     1,     2,     2,     2,     3,
+		    3,     3,     4,     4,     4,     5,     5,     5,     6,     6,     6,     7,     7,
+		    7
+	} ;
+
 	double negative_inf = -std::numeric_limits<double>::infinity() ;
 	double positive_inf =  std::numeric_limits<double>::infinity() ;
 
@@ -39,16 +81,4 @@ namespace CnossosEU
 			positive_inf =  std::numeric_limits<double>::max() ;
 		}
 	}
-
-	double Spectrum::freq (unsigned int index)
-	{
-		assert (index < nbFreq) ;
-		return _fixedFreq[index] ;
-	}
-
-	double Spectrum::dBA (unsigned int index)
-	{
-		assert (index < nbFreq) ;
-		return _dBAweighting[index] ;
-	}
 }
\ No newline at end of file
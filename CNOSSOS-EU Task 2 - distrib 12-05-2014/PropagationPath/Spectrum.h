@@ -19,6 +19,16 @@
  *
  *  23/10/2013	added complex spectra type
  *
+ *	18/10/2026	spectra are templated on the number of frequency bands : 8 octave bands (default), 
+ *				24 one-third octave bands (50Hz-10kHz, as in the source models) or 27 one-third octave
+ *				bands (25Hz-10kHz, as in the Harmonoise model). The band set used by the calculation
+ *				methods is selected at compile time by CNOSSOS_SPECTRUM_BANDS ; with the number of
+ *				bands known at compile time, all loops over the bands have a fixed trip count and 
+ *				are fully vectorized by the compiler.
+ *
+ *	18/10/2026	ExpandOctaveBands (moved from PathParseXML.cpp), the power of an octave band is only
+ *				divided over the bands that receive power
+ *
  * ------------------------------------------------------------------------------------------------- 
  */
 #include <assert.h>
@@ -28,6 +38,12 @@
 #ifdef __GNUC__
 #define _finite finite
 #endif
+/*
+ * number of frequency bands used by the calculation methods : 8, 24 or 27
+ */
+#ifndef CNOSSOS_SPECTRUM_BANDS
+#define CNOSSOS_SPECTRUM_BANDS 8
+#endif
 namespace CnossosEU
 {
 	extern double negative_inf ;
@@ -57,12 +73,42 @@ namespace CnossosEU
 		return _finite(x) ? pow(10., x/20.) : 0.0 ;
 	}
 
-	struct Spectrum
+	/*
+	 * center frequencies, dB(A) weighting, octave band index and bandwidth (in octaves) of the 
+	 * supported band sets, see Spectrum.cpp
+	 */
+	template <int N> struct FrequencyBands ;
+
+	template <> struct FrequencyBands<8>
+	{
+		static const double freq[8] ;
+		static const double dBA[8] ;
+		static const unsigned int octave[8] ;
+		static double bandWidth (void) { return 1.0 ; }
+	} ;
+
+	template <> struct FrequencyBands<24>
+	{
+		static const double freq[24] ;
+		static const double dBA[24] ;
+		static const unsigned int octave[24] ;
+		static double bandWidth (void) { return 1.0 / 3.0 ; }
+	} ;
+
+	template <> struct FrequencyBands<27>
+	{
+		static const double freq[27] ;
+		static const double dBA[27] ;
+		static const unsigned int octave[27] ;
+		static double bandWidth (void) { return 1.0 / 3.0 ; }
+	} ;
+
+	template <int N> struct SpectrumT
 	{
 		/*
 		 * number of frequency bands
 		 */
-		static const int nbFreq = 8 ;
+		static const int nbFreq = N ;
 		/*
 		 * internal representation of spectra by means of fixd-size array
 		 */
@@ -71,9 +117,16 @@ namespace CnossosEU
 		 * accessors for size, center frequency and values associated with frequency bands
 		 */
 		size_t size (void) const { return nbFreq ; }
-		static double freq (unsigned int index) ;
-		static double dBA (unsigned int index) ;
+		static double freq (unsigned int index) { assert (index < nbFreq) ; return FrequencyBands<N>::freq[index] ; }
+		static double dBA (unsigned int index) { assert (index < nbFreq) ; return FrequencyBands<N>::dBA[index] ; }
 		double data (unsigned int index) const { assert (index < nbFreq) ; return val[index] ; }
+		/*
+		 * bandwidth in octaves and index (0...7) of the octave band (63Hz...8kHz) containing a band, for
+		 * methods based on tabulated octave band values. Bands outside this range are associated with the
+		 * lowest or the highest octave band.
+		 */
+		static double bandWidth (void) { return FrequencyBands<N>::bandWidth() ; }
+		static unsigned int octave (unsigned int index) { assert (index < nbFreq) ; return FrequencyBands<N>::octave[index] ; }
 		/*
 		 * direct access to values by means of indexed notation (no checking)
 		 */
@@ -82,28 +135,28 @@ namespace CnossosEU
 		/*
 		 * default constructor
 		 */
-		explicit Spectrum (double init_value = 0) 
+		explicit SpectrumT (double init_value = 0) 
 		{ 
 			for (unsigned int i = 0 ; i < nbFreq ; ++i) val[i] = init_value ; 
 		}
 		/*
 		 * constructor from array of values
 		 */
-		Spectrum (double const values[8])
+		SpectrumT (double const values[N])
 		{ 
 			for (unsigned int i = 0 ; i < nbFreq ; ++i) val[i] = values[i] ; 
 		}
 		/*
 		 * copy constructor
 		 */
-		Spectrum (Spectrum const& other)
+		SpectrumT (SpectrumT const& other)
 		{ 
 			for (unsigned int i = 0 ; i < nbFreq ; ++i) val[i] = other.val[i] ; 
 		}
 		/*
 		 * assignment operator
 		 */
-		Spectrum& operator= (Spectrum const& other)
+		SpectrumT& operator= (SpectrumT const& other)
 		{ 
 			for (unsigned int i = 0 ; i < nbFreq ; ++i) val[i] = other.val[i] ; 
 			return *this ;
@@ -111,7 +164,7 @@ namespace CnossosEU
 		/*
 		 * unary operators, combine spectrum + spectrum
 		 */
-		Spectrum& operator- (void)
+		SpectrumT& operator- (void)
 		{ 
 			for (unsigned int i = 0 ; i < nbFreq ; ++i) val[i] = -val[i] ; 
 			return *this ;
@@ -119,22 +172,22 @@ namespace CnossosEU
 		/*
 		 * internal operators, combine this spectrum with another spectrum
 		 */
-		Spectrum& operator+= (Spectrum const& other)
+		SpectrumT& operator+= (SpectrumT const& other)
 		{ 
 			for (unsigned int i = 0 ; i < nbFreq ; ++i) val[i] += other.val[i] ; 
 			return *this ;
 		}
-		Spectrum& operator-= (Spectrum const& other)
+		SpectrumT& operator-= (SpectrumT const& other)
 		{ 
 			for (unsigned int i = 0 ; i < nbFreq ; ++i) val[i] -= other.val[i] ; 
 			return *this ;
 		}
-		Spectrum& operator*= (Spectrum const& other)
+		SpectrumT& operator*= (SpectrumT const& other)
 		{ 
 			for (unsigned int i = 0 ; i < nbFreq ; ++i) val[i] *= other.val[i] ; 
 			return *this ;
 		}
-		Spectrum& operator/= (Spectrum const& other)
+		SpectrumT& operator/= (SpectrumT const& other)
 		{ 
 			for (unsigned int i = 0 ; i < nbFreq ; ++i) val[i] /= other.val[i] ; 
 			return *this ;
@@ -142,22 +195,22 @@ namespace CnossosEU
 		/*
 		 * internal operators, combine this spectrum with a numerical constant
 		 */
-		Spectrum& operator+= (double value)
+		SpectrumT& operator+= (double value)
 		{ 
 			for (unsigned int i = 0 ; i < nbFreq ; ++i) val[i] += value ; 
 			return *this ;
 		}
-		Spectrum& operator-= (double value)
+		SpectrumT& operator-= (double value)
 		{ 
 			for (unsigned int i = 0 ; i < nbFreq ; ++i) val[i] -= value ; 
 			return *this ;
 		}
-		Spectrum& operator*= (double value)
+		SpectrumT& operator*= (double value)
 		{ 
 			for (unsigned int i = 0 ; i < nbFreq ; ++i) val[i] *= value ; 
 			return *this ;
 		}
-		Spectrum& operator/= (double value)
+		SpectrumT& operator/= (double value)
 		{ 
 			for (unsigned int i = 0 ; i < nbFreq ; ++i) val[i] /= value ; 
 			return *this ;
@@ -166,83 +219,111 @@ namespace CnossosEU
 	/*
 	 * binary operators on spectra
 	 */
-	inline Spectrum operator+ (Spectrum const& s1, Spectrum const& s2)
+	template <int N> inline SpectrumT<N> operator+ (SpectrumT<N> const& s1, SpectrumT<N> const& s2)
 	{
-		Spectrum res(s1) ;
+		SpectrumT<N> res(s1) ;
 		return res += s2 ;
 	};
-	inline Spectrum operator- (Spectrum const& s1, Spectrum const& s2)
+	template <int N> inline SpectrumT<N> operator- (SpectrumT<N> const& s1, SpectrumT<N> const& s2)
 	{
-		Spectrum res(s1) ;
+		SpectrumT<N> res(s1) ;
 		return res -= s2 ;
 	};
-	inline Spectrum operator* (Spectrum const& s1, Spectrum const& s2)
+	template <int N> inline SpectrumT<N> operator* (SpectrumT<N> const& s1, SpectrumT<N> const& s2)
 	{
-		Spectrum res(s1) ;
+		SpectrumT<N> res(s1) ;
 		return res *= s2 ;
 	};
-	inline Spectrum operator/ (Spectrum const& s1, Spectrum const& s2)
+	template <int N> inline SpectrumT<N> operator/ (SpectrumT<N> const& s1, SpectrumT<N> const& s2)
 	{
-		Spectrum res(s1) ;
+		SpectrumT<N> res(s1) ;
 		return res /= s2 ;
 	};
 	/*
 	 * binary operators on spectrum + numerical value
 	 */
-	inline Spectrum operator+ (Spectrum const& s1, double value)
+	template <int N> inline SpectrumT<N> operator+ (SpectrumT<N> const& s1, double value)
 	{
-		Spectrum res(s1) ;
+		SpectrumT<N> res(s1) ;
 		return res += value ;
 	};
-	inline Spectrum operator- (Spectrum const& s1, double value)
+	template <int N> inline SpectrumT<N> operator- (SpectrumT<N> const& s1, double value)
 	{
-		Spectrum res(s1) ;
+		SpectrumT<N> res(s1) ;
 		return res -= value ;
 	};
-	inline Spectrum operator* (Spectrum const& s1, double value)
+	template <int N> inline SpectrumT<N> operator* (SpectrumT<N> const& s1, double value)
 	{
-		Spectrum res(s1) ;
+		SpectrumT<N> res(s1) ;
 		return res *= value ;
 	};
-	inline Spectrum operator* (double value, Spectrum const& s1)
+	template <int N> inline SpectrumT<N> operator* (double value, SpectrumT<N> const& s1)
 	{
-		Spectrum res(s1) ;
+		SpectrumT<N> res(s1) ;
 		return res *= value ;
 	};
-	inline Spectrum operator/ (Spectrum const& s1, double value)
+	template <int N> inline SpectrumT<N> operator/ (SpectrumT<N> const& s1, double value)
 	{
-		Spectrum res(s1) ;
+		SpectrumT<N> res(s1) ;
 		return res /= value ;
 	};
 	/*
 	 * lin-log conversion for spectra
 	 */
-	inline Spectrum LOG10 (Spectrum const& other)
+	template <int N> inline SpectrumT<N> LOG10 (SpectrumT<N> const& other)
 	{
-		Spectrum res (other);
+		SpectrumT<N> res (other);
 		for (unsigned int i = 0 ; i < res.size() ; ++i) { res[i] = LOG10 (res[i]) ; }
 		return res ;
 	};
-	inline Spectrum POW10 (Spectrum const& other)
+	template <int N> inline SpectrumT<N> POW10 (SpectrumT<N> const& other)
 	{
-		Spectrum res (other) ;
+		SpectrumT<N> res (other) ;
 		for (unsigned int i = 0 ; i < res.size() ; ++i) { res[i] = POW10 (res[i]) ; }
 		return res ;
 	};
+	/*
+	 * convert octave band values (63Hz...8kHz) to the frequency bands of a spectrum. Each band takes 
+	 * the value of the octave band it belongs to ; for power levels, the power of each octave band is 
+	 * distributed evenly over the bands it contains, so that the total power of the octave band is
+	 * preserved, and bands outside 63Hz...8kHz get no power.
+	 */
+	template <int N> inline void ExpandOctaveBands (double const octave[8], SpectrumT<N>& spec, bool power)
+	{
+		unsigned int count[8] = { 0, 0, 0, 0, 0, 0, 0, 0 } ;
+		bool inside[N] ;
+		for (unsigned int i = 0 ; i < N ; i++)
+		{
+			unsigned int k = SpectrumT<N>::octave(i) ;
+			double r = SpectrumT<N>::freq(i) / FrequencyBands<8>::freq[k] ;
+			inside[i] = (r > 0.7 && r < 1.42) ;
+			if (inside[i]) count[k]++ ;
+		}
+		for (unsigned int i = 0 ; i < N ; i++)
+		{
+			unsigned int k = SpectrumT<N>::octave(i) ;
+			spec[i] = octave[k] ;
+			if (power) spec[i] = inside[i] ? octave[k] - 10. * log10 ((double) count[k]) : negative_inf ;
+		}
+	}
+	/*
+	 * spectra used by the calculation methods
+	 */
+	typedef SpectrumT<CNOSSOS_SPECTRUM_BANDS> Spectrum ;
 
 	typedef std::complex<double> Complex ;
 	
-	struct ComplexSpectrum
+	template <int N> struct ComplexSpectrumT
 	{
 		/*
 		 * internal representation of spectra by means of fixd-size array
 		 */
-		Complex val[Spectrum::nbFreq] ;
+		Complex val[N] ;
 		/*
 		 * accessors for size, center frequency and values associated with frequency bands
 		 */
-		size_t  size (void) { return Spectrum::nbFreq ; }
-		double  freq (unsigned int index) { return Spectrum::freq(index) ; }
+		size_t  size (void) { return N ; }
+		double  freq (unsigned int index) { return SpectrumT<N>::freq(index) ; }
 		Complex data (unsigned int index) { assert (index < size()) ; return val[index] ; }
 		/*
 		 * direct access to values by means of indexed notation (no checking)
@@ -250,4 +331,6 @@ namespace CnossosEU
 		Complex      & operator[] (unsigned int index) { return val[index] ; }
 		Complex const& operator[] (unsigned int index) const { return val[index] ; }
 	} ;
+
+	typedef ComplexSpectrumT<CNOSSOS_SPECTRUM_BANDS> ComplexSpectrum ;
 }
\ No newline at end of file
@@ -0,0 +1,126 @@
+#pragma once
+/*
+ * ------------------------------------------------------------------------------------------------
+ * file:		StaticPipeline.h
+ * version:		1.0
+ * author:		dirk.van-maercke@cstb.fr
+ * copyright:	see file licence.EU.txt
+ * description: calculation pipeline shared by the virtual and the statically dispatched calculation
+ *				methods
+ * note:		this file is included by CalculationMethod.cpp, where the pipeline is instantiated for
+ *				the virtual calculation steps, and by the implementation of each calculation method,
+ *				where the statically dispatched pipeline is explicitly instantiated so that the method
+ *				specific calculation steps can be inlined
+ * changes:
+ *
+ *	18/10/2026	initial version
+ *
+ *	18/10/2026	the virtual and the static pipeline share the same implementation (runCalculationSteps)
+ * -------------------------------------------------------------------------------------------------
+ */
+#include "CalculationMethod.h"
+#include "PropagationPath.h"
+#include "PathResult.h"
+#include "SystemClock.h"
+
+namespace CnossosEU
+{
+	/*
+	 * calculate the partial noise level associated with a propagation path
+	 *
+	 * this is implemented as a three step process:
+	 *
+	 *	1) geometrical analysis of the path and construction of the Fermat ray path
+	 *
+	 *	2) calculate the different components of the noise model
+	 *
+	 *  3) calculate noise levels
+	 *
+	 * The calculation steps are called on an object of type Method : through the virtual function
+	 * table if Method is CalculationMethod, directly if Method is a StaticPipeline. The function is
+	 * a friend of both classes.
+	 */
+	template <class Method> bool runCalculationSteps (Method& method, PropagationPath& path, PathResult& result)
+	{
+		SystemClock clock ;
+		PropagationPathOptions const& options = method.options ;
+		/*
+		 * setup local variables
+		 */
+		method.initCalculation() ;
+		/*
+		 * geometrical analysis of the path
+		 */
+		if (!path.analyze_path(options)) return false ;
+		/*
+		 * evaluate the sound power of the source
+		 */
+		result.Lw = options.ExcludeSoundPower ? Spectrum(0.0) : method.getSoundPower (path) ;
+		/*
+		 * convert sound power to dB(A) values if needed
+		 */
+		result.dBA = method.getFrequencyWeighting (path) ;
+		/*
+		 * evaluate the sound power adaptation of the source
+		 */
+		result.delta_Lw = method.getSoundPowerAdaptation (path) ;
+		/*
+		 * evaluate the geometrical spread
+		 */
+		result.AttGeo = options.ExcludeGeometricalSpread ? 0.0 : method.getGeometricalSpread (path) ;
+		/*
+		 * evaluate air absorption
+		 */
+		result.AttAir = options.ExcludeGeometricalSpread ? Spectrum (0.0) : method.getAirAbsorption (path) ;
+		/*
+		 * evaluate attenuation due to absorption by reflecting obstacles
+		 */
+		result.AttAbsMat = method.getAbsorption (path) ;
+		/*
+		 * evaluate attenuation due to lateral diffraction
+		 */
+		result.AttLatDif = method.getLateralDiffraction (path) ;
+		/*
+		 * evaluate attenuation due to finite size of obstacles
+		 */
+		result.AttSize = method.getFiniteSizeCorrection (path) ;
+		/*
+		 * evaluate excess attenuation
+		 */
+		result.AttF = method.getExcessAttenuation (path, true) ;
+		result.AttH = method.getExcessAttenuation (path, false) ;
+		/*
+		 * calculate levels
+		 */
+		result.LpF = method.getNoiseLevel (result, true) ;
+		result.LpH = method.getNoiseLevel (result, false) ;
+		/*
+		 * estimate long-time averaged noise level
+		 */
+		result.Leq = method.getNoiseLevel (path, result) ;
+		/*
+		 * convert values to dB(A) values
+		 */
+		result.LpF_dBA = method.getNoiseLevel (result.LpF) ;
+		result.LpH_dBA = method.getNoiseLevel (result.LpH) ;
+		result.Leq_dBA = method.getNoiseLevel (result.Leq) ;
+		/*
+		 * cleanup local variables
+		 */
+		method.exitCalculation() ;
+		/*
+		 * update performance counters
+		 */
+		method.countCalculation (clock.get()) ;
+
+		return true ;
+	}
+	/*
+	 * StaticPipeline is a final class, so that all calculation steps are called without going
+	 * through the virtual function table
+	 */
+	template <class Method> bool StaticPipeline<Method>::doCalculation (PropagationPath& path, PathResult& result)
+	{
+		return runCalculationSteps (*this, path, result) ;
+	}
+}
@@ -0,0 +1,445 @@
+/*
+ * ------------------------------------------------------------------------------------------------
+ * file:		TerrainModel.cpp
+ * version:		1.0
+ * author:		dirk.van-maercke@cstb.fr
+ * copyright:	see file licence.EU.txt
+ * description: extraction of vertical profiles from a digital elevation model (DEM) and a raster
+ *				of ground classes
+ * changes:
+ *
+ *	18/10/2026	initial version
+ * -------------------------------------------------------------------------------------------------
+ */
+#include "TerrainModel.h"
+#include "ErrorMessage.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <string>
+#include <algorithm>
+
+#ifdef __GNUC__
+#define _strcmpi strcasecmp
+#endif
+
+using namespace CnossosEU ;
+using namespace System ;
+
+#define POW2(x) ((x)*(x))
+#define return_error(x) { signal_error (ErrorMessage(x)) ; return false ; }
+
+TerrainModel::TerrainModel (double _x0, double _y0, double _cellSize, unsigned int _nx, unsigned int _ny)
+: x0 (_x0), y0 (_y0), cellSize (_cellSize), nx (_nx), ny (_ny)
+{
+	assert (cellSize > 0) ;
+	assert (nx >= 2 && ny >= 2) ;
+	ntx = (nx + TILE_MASK) >> TILE_BITS ;
+	nty = (ny + TILE_MASK) >> TILE_BITS ;
+	Tile flat = { 0.0, 0.0, 0, 0, 0 } ;
+	tiles.resize (ntx * nty, flat) ;
+	/*
+	 * ground classes 0 to 7 correspond to ground types A to H
+	 */
+	const char* id[8] = { "A", "B", "C", "D", "E", "F", "G", "H" } ;
+	for (unsigned int k = 0 ; k < 8 ; ++k) materials[k] = CnossosEU::getMaterial (id[k]) ;
+}
+
+TerrainModel::~TerrainModel (void)
+{
+	for (unsigned int k = 0 ; k < tiles.size() ; ++k)
+	{
+		delete [] tiles[k].z ;
+		delete [] tiles[k].g ;
+	}
+}
+/*
+ * set elevations, tile by tile
+ */
+void TerrainModel::setElevation (const float* z)
+{
+	for (unsigned int ty = 0 ; ty < nty ; ++ty)
+	{
+		for (unsigned int tx = 0 ; tx < ntx ; ++tx)
+		{
+			Tile& t = tiles[ty * ntx + tx] ;
+			unsigned int i0 = tx << TILE_BITS, i1 = std::min (i0 + TILE_SIZE, nx) ;
+			unsigned int j0 = ty << TILE_BITS, j1 = std::min (j0 + TILE_SIZE, ny) ;
+			/*
+			 * range of elevations in the tile
+			 */
+			double zmin = z[j0 * nx + i0] ;
+			double zmax = zmin ;
+			for (unsigned int j = j0 ; j < j1 ; ++j)
+			{
+				for (unsigned int i = i0 ; i < i1 ; ++i)
+				{
+					zmin = std::min (zmin, (double) z[j * nx + i]) ;
+					zmax = std::max (zmax, (double) z[j * nx + i]) ;
+				}
+			}
+			delete [] t.z ;
+			t.z = 0 ;
+			t.z0 = zmin ;
+			t.dz = std::max (0.01, (zmax - zmin) / 65535.) ;
+			if (zmax == zmin) continue ;
+			/*
+			 * quantize elevations relative to the lowest point
+			 */
+			t.z = new unsigned short[TILE_SIZE * TILE_SIZE] ;
+			memset (t.z, 0, TILE_SIZE * TILE_SIZE * sizeof(unsigned short)) ;
+			for (unsigned int j = j0 ; j < j1 ; ++j)
+			{
+				for (unsigned int i = i0 ; i < i1 ; ++i)
+				{
+					t.z[index(i,j)] = (unsigned short) floor ((z[j * nx + i] - zmin) / t.dz + 0.5) ;
+				}
+			}
+		}
+	}
+}
+/*
+ * set ground classes, tile by tile
+ */
+void TerrainModel::setGroundClass (const unsigned char* g)
+{
+	for (unsigned int ty = 0 ; ty < nty ; ++ty)
+	{
+		for (unsigned int tx = 0 ; tx < ntx ; ++tx)
+		{
+			Tile& t = tiles[ty * ntx + tx] ;
+			unsigned int i0 = tx << TILE_BITS, i1 = std::min (i0 + TILE_SIZE, nx) ;
+			unsigned int j0 = ty << TILE_BITS, j1 = std::min (j0 + TILE_SIZE, ny) ;
+			bool constant = true ;
+			for (unsigned int j = j0 ; j < j1 && constant ; ++j)
+			{
+				for (unsigned int i = i0 ; i < i1 && constant ; ++i)
+				{
+					constant = (g[j * nx + i] == g[j0 * nx + i0]) ;
+				}
+			}
+			delete [] t.g ;
+			t.g = 0 ;
+			t.g0 = std::min (g[j0 * nx + i0], (unsigned char) 7) ;
+			if (constant) continue ;
+
+			t.g = new unsigned char[TILE_SIZE * TILE_SIZE] ;
+			memset (t.g, 0, TILE_SIZE * TILE_SIZE) ;
+			for (unsigned int j = j0 ; j < j1 ; ++j)
+			{
+				for (unsigned int i = i0 ; i < i1 ; ++i)
+				{
+					t.g[index(i,j)] = std::min (g[j * nx + i], (unsigned char) 7) ;
+				}
+			}
+		}
+	}
+}
+/*
+ * bilinear interpolation in grid coordinates
+ */
+double TerrainModel::interpolate (double u, double v) const
+{
+	unsigned int i = (u > 0) ? std::min ((unsigned int) u, nx - 2) : 0 ;
+	unsigned int j = (v > 0) ? std::min ((unsigned int) v, ny - 2) : 0 ;
+	double fu = u - i ;
+	double fv = v - j ;
+	double z00 = node (i, j) ;
+	double z10 = node (i+1, j) ;
+	double z01 = node (i, j+1) ;
+	double z11 = node (i+1, j+1) ;
+	return (1 - fv) * (z00 + fu * (z10 - z00)) + fv * (z01 + fu * (z11 - z01)) ;
+}
+/*
+ * linear interpolation along the grid lines, i.e. for integer values of u or v
+ */
+double TerrainModel::interpolateAlongU (unsigned int i, double v) const
+{
+	unsigned int j = (v > 0) ? std::min ((unsigned int) v, ny - 2) : 0 ;
+	double z0 = node (i, j) ;
+	return z0 + (v - j) * (node (i, j+1) - z0) ;
+}
+
+double TerrainModel::interpolateAlongV (double u, unsigned int j) const
+{
+	unsigned int i = (u > 0) ? std::min ((unsigned int) u, nx - 2) : 0 ;
+	double z0 = node (i, j) ;
+	return z0 + (u - i) * (node (i+1, j) - z0) ;
+}
+
+Material* TerrainModel::materialAt (double u, double v) const
+{
+	unsigned int i = (u > 0) ? std::min ((unsigned int) (u + 0.5), nx - 1) : 0 ;
+	unsigned int j = (v > 0) ? std::min ((unsigned int) (v + 0.5), ny - 1) : 0 ;
+	return materials[groundClass (i, j)] ;
+}
+
+bool TerrainModel::isInside (double x, double y) const
+{
+	double u = (x - x0) / cellSize ;
+	double v = (y - y0) / cellSize ;
+	return u >= 0 && v >= 0 && u <= nx - 1 && v <= ny - 1 ;
+}
+
+double TerrainModel::getElevation (double x, double y) const
+{
+	assert (isInside (x, y)) ;
+	return interpolate ((x - x0) / cellSize, (y - y0) / cellSize) ;
+}
+
+Material* TerrainModel::getMaterial (double x, double y) const
+{
+	assert (isInside (x, y)) ;
+	return materialAt ((x - x0) / cellSize, (y - y0) / cellSize) ;
+}
+
+size_t TerrainModel::getMemoryUsage (void) const
+{
+	size_t size = sizeof (TerrainModel) + tiles.size() * sizeof (Tile) ;
+	for (unsigned int k = 0 ; k < tiles.size() ; ++k)
+	{
+		if (tiles[k].z) size += TILE_SIZE * TILE_SIZE * sizeof (unsigned short) ;
+		if (tiles[k].g) size += TILE_SIZE * TILE_SIZE ;
+	}
+	return size ;
+}
+/*
+ * sample of the vertical profile
+ */
+struct ProfileSample
+{
+	double	  t ;		// relative position along the profile
+	double	  z ;		// elevation
+	Material* mat ;		// material of the segment ending at this sample
+
+	ProfileSample (double _t, double _z) : t(_t), z(_z), mat(0) { }
+} ;
+
+bool TerrainModel::getProfile (double xs, double ys, double xr, double yr, PropagationPath& path,
+							   TerrainProfileOptions const& options) const
+{
+	if (!isInside (xs, ys) || !isInside (xr, yr))
+	{
+		return_error ("Source or receiver outside of the terrain model") ;
+	}
+	double u0 = (xs - x0) / cellSize ;
+	double v0 = (ys - y0) / cellSize ;
+	double du = (xr - xs) / cellSize ;
+	double dv = (yr - ys) / cellSize ;
+	double length = sqrt (POW2(xr - xs) + POW2(yr - ys)) ;
+	if (length == 0)
+	{
+		return_error ("Source and receiver at the same position") ;
+	}
+
+	std::vector<ProfileSample> samples ;
+	samples.reserve (2 + (unsigned int) (fabs(du) + fabs(dv))) ;
+	samples.push_back (ProfileSample (0.0, interpolate (u0, v0))) ;
+
+	if (options.SamplingStep > 0)
+	{
+		/*
+		 * regular sampling along the profile
+		 */
+		unsigned int n = (unsigned int) ceil (length / options.SamplingStep) ;
+		for (unsigned int k = 1 ; k < n ; ++k)
+		{
+			double t = (double) k / n ;
+			samples.push_back (ProfileSample (t, interpolate (u0 + t * du, v0 + t * dv))) ;
+		}
+	}
+	else
+	{
+		/*
+		 * sample at the intersections with the grid lines, traversing the cells from source to receiver
+		 */
+		double ku = (du > 0) ? floor (u0) + 1 : ceil (u0) - 1 ;
+		double kv = (dv > 0) ? floor (v0) + 1 : ceil (v0) - 1 ;
+		double su = (du > 0) ? 1 : -1 ;
+		double sv = (dv > 0) ? 1 : -1 ;
+		double tu = (du != 0) ? (ku - u0) / du : 2.0 ;
+		double tv = (dv != 0) ? (kv - v0) / dv : 2.0 ;
+		double dtu = (du != 0) ? fabs (1 / du) : 0.0 ;
+		double dtv = (dv != 0) ? fabs (1 / dv) : 0.0 ;
+		while (tu < 1 || tv < 1)
+		{
+			if (tu <= tv)
+			{
+				samples.push_back (ProfileSample (tu, interpolateAlongU ((unsigned int) ku, v0 + tu * dv))) ;
+				if (tv == tu)
+				{
+					kv += sv ; tv += dtv ;
+				}
+				ku += su ; tu += dtu ;
+			}
+			else
+			{
+				samples.push_back (ProfileSample (tv, interpolateAlongV (u0 + tv * du, (unsigned int) kv))) ;
+				kv += sv ; tv += dtv ;
+			}
+		}
+	}
+	samples.push_back (ProfileSample (1.0, interpolate (u0 + du, v0 + dv))) ;
+	/*
+	 * materials are associated with the end points of the segments, taken at the middle of each segment
+	 */
+	unsigned int n = samples.size() ;
+	for (unsigned int k = 1 ; k < n ; ++k)
+	{
+		double t = 0.5 * (samples[k-1].t + samples[k].t) ;
+		samples[k].mat = materialAt (u0 + t * du, v0 + t * dv) ;
+	}
+	samples[0].mat = samples[1].mat ;
+	/*
+	 * remove intermediate points, keeping all removed points within the tolerance of the simplified
+	 * profile: the slopes from the last point kept to the next point must stay inside the range of
+	 * slopes allowed by all points skipped so far
+	 */
+	std::vector<bool> keep (n, true) ;
+	if (options.Tolerance > 0)
+	{
+		double tol = options.Tolerance ;
+		unsigned int a = 0 ;
+		double lo = -HUGE_VAL ;
+		double hi = +HUGE_VAL ;
+		for (unsigned int k = 1 ; k < n ; ++k)
+		{
+			double d = (samples[k].t - samples[a].t) * length ;
+			double s = (samples[k].z - samples[a].z) / d ;
+			if (k > a + 1 && (s < lo || s > hi || samples[k].mat != samples[a+1].mat))
+			{
+				/*
+				 * the previous point becomes the start of a new segment
+				 */
+				a = k - 1 ;
+				d = (samples[k].t - samples[a].t) * length ;
+				lo = -HUGE_VAL ;
+				hi = +HUGE_VAL ;
+			}
+			else if (k > a + 1)
+			{
+				keep[k-1] = false ;
+			}
+			lo = std::max (lo, (samples[k].z - tol - samples[a].z) / d) ;
+			hi = std::min (hi, (samples[k].z + tol - samples[a].z) / d) ;
+		}
+	}
+	/*
+	 * construct the control points
+	 */
+	unsigned int nb_points = 0 ;
+	for (unsigned int k = 0 ; k < n ; ++k) if (keep[k]) nb_points++ ;
+	path.clear() ;
+	path.resize (nb_points) ;
+	unsigned int pos = 0 ;
+	for (unsigned int k = 0 ; k < n ; ++k)
+	{
+		if (!keep[k]) continue ;
+		double t = samples[k].t ;
+		path[pos].pos = Position (xs + t * (xr - xs), ys + t * (yr - ys), samples[k].z) ;
+		path[pos].mat = samples[k].mat ;
+		pos++ ;
+	}
+	return true ;
+}
+/*
+ * read an ESRI ASCII grid file
+ */
+struct AsciiGrid
+{
+	unsigned int ncols ;
+	unsigned int nrows ;
+	double x0 ;
+	double y0 ;
+	double cellSize ;
+	std::vector<float> values ;		// row-major, first row = southern most row
+} ;
+
+static void read_ascii_grid (const char* fileName, AsciiGrid& grid)
+{
+	FILE* fp = fopen (fileName, "rt") ;
+	if (fp == 0) signal_error (ErrorMessage ((std::string ("Cannot open file ") + fileName).c_str())) ;
+
+	double xll = 0, yll = 0, nodata = -9999 ;
+	bool center = false ;
+	grid.ncols = grid.nrows = 0 ;
+	grid.cellSize = 0 ;
+	/*
+	 * header, the first numerical value is the first value of the grid
+	 */
+	char token[64] ;
+	double first = 0 ;
+	bool has_first = false ;
+	while (fscanf (fp, "%63s", token) == 1)
+	{
+		if (!isalpha (token[0]))
+		{
+			first = atof (token) ;
+			has_first = true ;
+			break ;
+		}
+		double value = 0 ;
+		if (fscanf (fp, "%lf", &value) != 1) break ;
+		if (_strcmpi (token, "ncols") == 0) grid.ncols = (unsigned int) value ;
+		else if (_strcmpi (token, "nrows") == 0) grid.nrows = (unsigned int) value ;
+		else if (_strcmpi (token, "xllcorner") == 0) xll = value ;
+		else if (_strcmpi (token, "yllcorner") == 0) yll = value ;
+		else if (_strcmpi (token, "xllcenter") == 0) { xll = value ; center = true ; }
+		else if (_strcmpi (token, "yllcenter") == 0) { yll = value ; center = true ; }
+		else if (_strcmpi (token, "cellsize") == 0) grid.cellSize = value ;
+		else if (_strcmpi (token, "nodata_value") == 0) nodata = value ;
+	}
+	if (!has_first || grid.ncols < 2 || grid.nrows < 2 || grid.cellSize <= 0)
+	{
+		fclose (fp) ;
+		signal_error (ErrorMessage ((std::string ("Invalid ESRI ASCII grid header in file ") + fileName).c_str())) ;
+	}
+	grid.x0 = center ? xll : xll + 0.5 * grid.cellSize ;
+	grid.y0 = center ? yll : yll + 0.5 * grid.cellSize ;
+	/*
+	 * values, from north to south ; missing values are replaced by zero
+	 */
+	grid.values.resize (grid.ncols * grid.nrows) ;
+	for (unsigned int row = 0 ; row < grid.nrows ; ++row)
+	{
+		float* p = &grid.values[(grid.nrows - 1 - row) * grid.ncols] ;
+		for (unsigned int col = 0 ; col < grid.ncols ; ++col)
+		{
+			double value = first ;
+			if ((row > 0 || col > 0) && fscanf (fp, "%lf", &value) != 1)
+			{
+				fclose (fp) ;
+				signal_error (ErrorMessage ((std::string ("Missing values in file ") + fileName).c_str())) ;
+			}
+			p[col] = (value == nodata) ? 0.0f : (float) value ;
+		}
+	}
+	fclose (fp) ;
+}
+
+TerrainModel* TerrainModel::LoadFromFile (const char* elevationFile, const char* groundFile)
+{
+	AsciiGrid dem ;
+	read_ascii_grid (elevationFile, dem) ;
+	TerrainModel* terrain = new TerrainModel (dem.x0, dem.y0, dem.cellSize, dem.ncols, dem.nrows) ;
+	terrain->setElevation (&dem.values[0]) ;
+	if (groundFile != 0)
+	{
+		AsciiGrid ground ;
+		read_ascii_grid (groundFile, ground) ;
+		if (ground.ncols != dem.ncols || ground.nrows != dem.nrows || ground.x0 != dem.x0 ||
+			ground.y0 != dem.y0 || ground.cellSize != dem.cellSize)
+		{
+			delete terrain ;
+			signal_error (ErrorMessage ("The ground classes and elevations must be defined on the same grid")) ;
+		}
+		std::vector<unsigned char> g (ground.values.size()) ;
+		for (unsigned int k = 0 ; k < g.size() ; ++k)
+		{
+			g[k] = (unsigned char) std::max (0.0f, std::min (ground.values[k], 7.0f)) ;
+		}
+		terrain->setGroundClass (&g[0]) ;
+	}
+	return terrain ;
+}
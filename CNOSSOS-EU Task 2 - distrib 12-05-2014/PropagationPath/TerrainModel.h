@@ -0,0 +1,142 @@
+#pragma once
+/*
+ * ------------------------------------------------------------------------------------------------
+ * file:		TerrainModel.h
+ * version:		1.0
+ * author:		dirk.van-maercke@cstb.fr
+ * copyright:	see file licence.EU.txt
+ * description: extraction of vertical profiles from a digital elevation model (DEM) and a raster
+ *				of ground classes, for the automatic construction of propagation paths
+ * note:		the rasters are stored in tiles of 64 x 64 nodes. Elevations are quantized to 16 bits
+ *				relative to the lowest point in each tile (with a resolution of 1cm, or less if the
+ *				range of elevations in the tile exceeds 655m). Tiles with constant elevation and/or
+ *				ground class only store the constant value.
+ * changes:
+ *
+ *	18/10/2026	initial version
+ * -------------------------------------------------------------------------------------------------
+ */
+#include "PropagationPath.h"
+#include "Material.h"
+#include <vector>
+
+namespace CnossosEU
+{
+	/*
+	 * options for the extraction of vertical profiles
+	 */
+	struct TerrainProfileOptions
+	{
+		/*
+		 * distance between samples along the profile, in meters. If zero, the terrain is sampled
+		 * at each intersection of the profile with the lines of the grid, which is exact for
+		 * terrain models made of bilinear patches.
+		 */
+		double SamplingStep ;
+		/*
+		 * intermediate points whose elevation deviates less than this value (in meters) from the
+		 * simplified profile are removed, provided that the ground class doesn't change. If zero,
+		 * all samples are kept.
+		 */
+		double Tolerance ;
+
+		TerrainProfileOptions (void) : SamplingStep (0.0), Tolerance (0.01) { }
+	} ;
+	/*
+	 * regular grid of elevations and ground classes
+	 *
+	 * the grid consists of nx * ny nodes with coordinates (x0 + i * cellSize, y0 + j * cellSize).
+	 * Elevations are interpolated bilinearly between the nodes, ground classes are taken from the
+	 * nearest node. Ground classes 0 to 7 correspond to the ground types A to H of the material
+	 * database.
+	 *
+	 * once constructed, the terrain model can be shared by multiple threads.
+	 */
+	class TerrainModel
+	{
+	public:
+		/*
+		 * construct a flat terrain of ground class 0 (A)
+		 */
+		TerrainModel (double x0, double y0, double cellSize, unsigned int nx, unsigned int ny) ;
+		~TerrainModel (void) ;
+		/*
+		 * load the elevations and, optionally, the ground classes from ESRI ASCII grid files. Both
+		 * files must define the same grid. Values are associated with the centers of the cells.
+		 */
+		static TerrainModel* LoadFromFile (const char* elevationFile, const char* groundFile = 0) ;
+		/*
+		 * set all elevations, respectively ground classes, from a row-major array of nx * ny values,
+		 * starting at (x0, y0)
+		 */
+		void setElevation (const float* z) ;
+		void setGroundClass (const unsigned char* g) ;
+		/*
+		 * access the terrain at any position inside the grid
+		 */
+		double	  getElevation (double x, double y) const ;
+		Material* getMaterial (double x, double y) const ;
+		bool	  isInside (double x, double y) const ;
+		/*
+		 * construct the control points of the vertical profile between a source and a receiver.
+		 * The first and last control points are located at the source and receiver positions, the
+		 * caller must associate the appropriate extensions with these points. Materials are
+		 * associated with the end points of the segments.
+		 */
+		bool getProfile (double xs, double ys, double xr, double yr, PropagationPath& path,
+						 TerrainProfileOptions const& options = TerrainProfileOptions()) const ;
+		/*
+		 * memory used by the rasters, in bytes
+		 */
+		size_t getMemoryUsage (void) const ;
+
+	private:
+
+		enum { TILE_BITS = 6, TILE_SIZE = 1 << TILE_BITS, TILE_MASK = TILE_SIZE - 1 } ;
+
+		struct Tile
+		{
+			double			z0 ;		// elevation = z0 + dz * z[index]
+			double			dz ;
+			unsigned short*	z ;			// null if all elevations are equal to z0
+			unsigned char	g0 ;		// ground class if constant
+			unsigned char*	g ;			// null if all ground classes are equal to g0
+		} ;
+
+		double x0 ;
+		double y0 ;
+		double cellSize ;
+		unsigned int nx ;
+		unsigned int ny ;
+		unsigned int ntx ;
+		unsigned int nty ;
+		std::vector<Tile> tiles ;
+		System::ref_ptr<Material> materials[8] ;
+
+		Tile const& tile (unsigned int i, unsigned int j) const
+		{
+			return tiles[(j >> TILE_BITS) * ntx + (i >> TILE_BITS)] ;
+		}
+		static unsigned int index (unsigned int i, unsigned int j)
+		{
+			return ((j & TILE_MASK) << TILE_BITS) + (i & TILE_MASK) ;
+		}
+		double node (unsigned int i, unsigned int j) const
+		{
+			Tile const& t = tile (i, j) ;
+			return t.z ? t.z0 + t.dz * t.z[index(i,j)] : t.z0 ;
+		}
+		unsigned int groundClass (unsigned int i, unsigned int j) const
+		{
+			Tile const& t = tile (i, j) ;
+			return t.g ? t.g[index(i,j)] : t.g0 ;
+		}
+		double interpolate (double u, double v) const ;
+		double interpolateAlongU (unsigned int i, double v) const ;
+		double interpolateAlongV (double u, unsigned int j) const ;
+		Material* materialAt (double u, double v) const ;
+
+		TerrainModel (TerrainModel const&) ;
+		TerrainModel& operator= (TerrainModel const&) ;
+	} ;
+}
@@ -0,0 +1,174 @@
+/*
+ * ------------------------------------------------------------------------------------------------
+ * file:		Trace.cpp
+ * version:		1.0
+ * author:		dirk.van-maercke@cstb.fr
+ * copyright:	see file licence.EU.txt
+ * description: structured tracing of diagnostic messages
+ * changes:
+ *
+ *	18/10/2026	initial version
+ * -------------------------------------------------------------------------------------------------
+ */
+#include "Trace.h"
+#include "SystemClock.h"
+#include "ReferenceObject.h"
+#include <stdarg.h>
+#include <string.h>
+
+#ifdef WIN32
+#include <windows.h>
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL __thread
+#endif
+
+#ifdef __GNUC__
+#define vsnprintf_s(buffer,size,count,format,args) vsnprintf(buffer,size,format,args)
+#endif
+
+using namespace CnossosEU ;
+
+#ifdef _DEBUG
+int CnossosEU::traceLevel = TRACE_DEBUG ;
+static bool traceEcho = true ;
+#else
+int CnossosEU::traceLevel = TRACE_OFF ;
+static bool traceEcho = false ;
+#endif
+/*
+ * ring buffer, owned by a single thread
+ *
+ * only the owner writes records and increments the head counter. The buffers are linked in a
+ * global list and never released, so that they can be dumped from any thread.
+ */
+static const unsigned int TRACE_BUFFER_SIZE = 1024 ;
+
+struct TraceBuffer
+{
+	TraceRecord		record[TRACE_BUFFER_SIZE] ;
+	volatile long	head ;			// number of records written
+	long			tail ;			// number of records dumped or cleared
+	long			thread ;		// sequence number of the owner thread
+	TraceBuffer*	next ;
+} ;
+
+static TraceBuffer* volatile bufferList = 0 ;
+static volatile long nbThreads = 0 ;
+static THREAD_LOCAL TraceBuffer* localBuffer = 0 ;
+static SystemClock::COUNTER startTime = 0 ;
+/*
+ * insert a new buffer in the global list, without locking
+ */
+static bool push_buffer (TraceBuffer* buffer, TraceBuffer* head)
+{
+	buffer->next = head ;
+#ifdef WIN32
+	return InterlockedCompareExchangePointer ((PVOID volatile*) &bufferList, buffer, head) == head ;
+#else
+	return __sync_bool_compare_and_swap (&bufferList, head, buffer) ;
+#endif
+}
+
+static TraceBuffer* getLocalBuffer (void)
+{
+	if (localBuffer == 0)
+	{
+		TraceBuffer* buffer = new TraceBuffer ;
+		buffer->head = 0 ;
+		buffer->tail = 0 ;
+		buffer->thread = System::atomic_increment (&nbThreads) ;
+		while (!push_buffer (buffer, bufferList)) ;
+		localBuffer = buffer ;
+	}
+	return localBuffer ;
+}
+
+static const char* level_name (int level)
+{
+	switch (level)
+	{
+	case TRACE_ERROR:	return "ERROR" ;
+	case TRACE_WARNING: return "WARNING" ;
+	case TRACE_INFO:	return "INFO" ;
+	default:			return "DEBUG" ;
+	}
+}
+
+static const char* base_name (const char* file)
+{
+	const char* name = file ;
+	for (const char* p = file ; *p != 0 ; ++p)
+	{
+		if (*p == '/' || *p == '\\') name = p + 1 ;
+	}
+	return name ;
+}
+
+void CnossosEU::SetTraceLevel (int level)
+{
+	traceLevel = level ;
+}
+
+int CnossosEU::GetTraceLevel (void)
+{
+	return traceLevel ;
+}
+
+void CnossosEU::SetTraceEcho (bool on_off)
+{
+	traceEcho = on_off ;
+}
+
+void CnossosEU::AddTraceRecord (int level, const char* file, int line, const char* format, ...)
+{
+	if (startTime == 0) startTime = SystemClock::counter() ;
+	TraceBuffer* buffer = getLocalBuffer() ;
+	TraceRecord& rec = buffer->record[buffer->head % TRACE_BUFFER_SIZE] ;
+	rec.time  = (double) (SystemClock::counter() - startTime) / (double) SystemClock::units_per_sec() ;
+	rec.level = level ;
+	rec.file  = file ;
+	rec.line  = line ;
+
+	va_list args ;
+	va_start (args, format) ;
+	vsnprintf_s (rec.text, sizeof(rec.text), _TRUNCATE, format, args) ;
+	va_end (args) ;
+	/*
+	 * in echo mode, the message is printed as is (like the former print_debug function)
+	 */
+	if (traceEcho) printf ("%s", rec.text) ;
+	/*
+	 * trailing new lines are not part of the record
+	 */
+	size_t len = strlen (rec.text) ;
+	while (len > 0 && (rec.text[len-1] == '\n' || rec.text[len-1] == ' ')) rec.text[--len] = 0 ;
+	/*
+	 * make the record visible to DumpTrace
+	 */
+	buffer->head = buffer->head + 1 ;
+}
+
+unsigned int CnossosEU::DumpTrace (FILE* fp, bool clear)
+{
+	unsigned int nb_records = 0 ;
+	for (TraceBuffer* buffer = bufferList ; buffer != 0 ; buffer = buffer->next)
+	{
+		long head = buffer->head ;
+		long first = buffer->tail ;
+		if (head - first > (long) TRACE_BUFFER_SIZE)
+		{
+			if (fp) fprintf (fp, "[thread %ld] %ld records lost\n", buffer->thread, head - first - TRACE_BUFFER_SIZE) ;
+			first = head - TRACE_BUFFER_SIZE ;
+		}
+		for (long i = first ; i < head ; ++i)
+		{
+			TraceRecord& rec = buffer->record[i % TRACE_BUFFER_SIZE] ;
+			if (fp) fprintf (fp, "[thread %ld] %10.6f %-7s %s:%d %s\n", buffer->thread, rec.time,
+				             level_name (rec.level), base_name (rec.file), rec.line, rec.text) ;
+			nb_records++ ;
+		}
+		if (clear) buffer->tail = head ;
+	}
+	return nb_records ;
+}
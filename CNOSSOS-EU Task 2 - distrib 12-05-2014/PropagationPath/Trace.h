@@ -0,0 +1,89 @@
+#pragma once
+/*
+ * ------------------------------------------------------------------------------------------------
+ * file:		Trace.h
+ * version:		1.0
+ * author:		dirk.van-maercke@cstb.fr
+ * copyright:	see file licence.EU.txt
+ * description: structured tracing of diagnostic messages
+ * note:		messages are recorded in a ring buffer owned by the calling thread, recording is
+ *				lock-free. The buffers are written to a file on request (DumpTrace).
+ *
+ *				the maximum trace level is selected at compile time by CNOSSOS_TRACE_LEVEL, calls
+ *				above this level are removed by the compiler, including the evaluation of their
+ *				arguments. The actual level is selected at run time by SetTraceLevel.
+ * changes:
+ *
+ *	18/10/2026	initial version
+ * -------------------------------------------------------------------------------------------------
+ */
+#include <stdio.h>
+
+namespace CnossosEU
+{
+	/*
+	 * trace levels
+	 */
+	enum TraceLevel
+	{
+		TRACE_OFF     = 0,
+		TRACE_ERROR   = 1,
+		TRACE_WARNING = 2,
+		TRACE_INFO    = 3,
+		TRACE_DEBUG   = 4
+	} ;
+	/*
+	 * structured trace record
+	 */
+	struct TraceRecord
+	{
+		double		time ;			// time since the first trace record, in seconds
+		int			level ;			// trace level
+		const char*	file ;			// source file
+		int			line ;			// line number in the source file
+		char		text[128] ;		// formatted message, truncated if necessary
+	} ;
+	/*
+	 * actual trace level, do not modify directly, use SetTraceLevel instead
+	 */
+	extern int traceLevel ;
+	/*
+	 * select the actual trace level (default = TRACE_DEBUG in debug builds, TRACE_OFF otherwise)
+	 */
+	void SetTraceLevel (int level) ;
+	int  GetTraceLevel (void) ;
+	/*
+	 * if enabled, messages are also written to the standard output at the moment they are recorded
+	 * (default = enabled in debug builds, disabled otherwise)
+	 */
+	void SetTraceEcho (bool on_off = true) ;
+	/*
+	 * record a message in the ring buffer of the calling thread, don't call directly but use
+	 * the CNOSSOS_TRACE macro
+	 */
+	void AddTraceRecord (int level, const char* file, int line, const char* format, ...) ;
+	/*
+	 * write the contents of the ring buffers of all threads to a file, optionally clear the buffers
+	 * and return the number of records written. Records from threads that are still calculating
+	 * may be incomplete.
+	 */
+	unsigned int DumpTrace (FILE* fp = stdout, bool clear = true) ;
+}
+/*
+ * maximum trace level included at compile time
+ */
+#ifndef CNOSSOS_TRACE_LEVEL
+#ifdef _DEBUG
+#define CNOSSOS_TRACE_LEVEL 4
+#else
+#define CNOSSOS_TRACE_LEVEL 3
+#endif
+#endif
+/*
+ * record a diagnostic message, using printf style formatting
+ */
+#define CNOSSOS_TRACE(level, ...) \
+	do { \
+		if ((level) <= CNOSSOS_TRACE_LEVEL && (level) <= CnossosEU::traceLevel) \
+			CnossosEU::AddTraceRecord ((level), __FILE__, __LINE__, __VA_ARGS__) ; \
+	} while (0)
@@ -14,6 +14,8 @@
  *
  *	13/11/2013	type of extension made a private member of the Extension class
  *
+ *	18/10/2026	extensions use non-atomic reference counting (see ReferenceObject.h)
+ *
  * ------------------------------------------------------------------------------------------------- 
  */
 #include "ReferenceObject.h"
@@ -44,8 +46,11 @@ namespace CnossosEU
 		double h ;
 		/*
 		 * constructor
+		 *
+		 * extensions are cloned together with the control points and are therefore never shared 
+		 * between paths (nor between threads), reference counting doesn't need atomic operations
 		 */
-		VerticalExt (VerticalExtType _type, double _h = 0.0) : type(_type), h(_h) { }
+		VerticalExt (VerticalExtType _type, double _h = 0.0) : type(_type), h(_h) { setThreadLocal() ; }
 		/*
 		 * abstract base classes cannot be copied but may support cloning
 		 */
@@ -63,7 +68,7 @@ namespace CnossosEU
 		/*
 		 * copy construct is protected (for use in derived classes only)
 		 */
-		VerticalExt (VerticalExt const& other) : type (other.type), h (other.h) { } ;
+		VerticalExt (VerticalExt const& other) : System::ReferenceObject (other), type (other.type), h (other.h) { } ;
 	
 	private:
 		/*
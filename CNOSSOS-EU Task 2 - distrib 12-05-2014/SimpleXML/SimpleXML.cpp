@@ -13,15 +13,24 @@
  *
  *	15/11/2013	support added to convert numerical error codes to human-readable text
  *
+ *	18/10/2026	added class XMLStreamLoader (incremental loading of the children of the root node)
+ *
+ *	18/10/2026	added class XMLArena ; the nodes of a document and their strings are allocated in
+ *				the arena of the loader and released all together with the document
+ *
+ *	18/10/2026	bug fixed: ParseFile closes the file and releases the parser in all cases
+ *
  * ------------------------------------------------------------------------------------------------- 
  */
 #include "./SimpleXML.h"
+#include <new>
 #ifdef __GNUC__
 #define strcat_s strcat
 #define strncpy_s strncpy
 #define _access access
 #define _read read
 #define _open open
+#define _close close
 #endif
 // ------------------------------------------------------------------------------------------------
 // interface avec EXPAT
@@ -59,13 +68,6 @@ bool XMLFileParser::ParseFile (const char* fileName)
 {
 	const int BUFF_SIZE = 4096 ;
 
-	XML_Parser p = XML_ParserCreate(NULL) ;
-
-	XML_SetUserData (p, (void*) this) ;
-
-	XML_SetElementHandler(p, start_handler, end_handler) ;
-	XML_SetCharacterDataHandler(p, text_handler) ;
-
 	last_line = 0 ;
 	last_char = 0 ;
 	last_error = 0 ;
@@ -83,6 +85,13 @@ bool XMLFileParser::ParseFile (const char* fileName)
 		return false ;
 	}
 
+	XML_Parser p = XML_ParserCreate(NULL) ;
+
+	XML_SetUserData (p, (void*) this) ;
+
+	XML_SetElementHandler(p, start_handler, end_handler) ;
+	XML_SetCharacterDataHandler(p, text_handler) ;
+
 	while (true)
 	{
 		void *buff = XML_GetBuffer(p, BUFF_SIZE);
@@ -113,6 +122,7 @@ bool XMLFileParser::ParseFile (const char* fileName)
 	last_char = XML_GetCurrentColumnNumber (p) ;
 
 	XML_ParserFree (p) ;
+	_close (file_id) ;
 
 	return (last_error == XML_ERROR_NONE) ;
 }
@@ -151,42 +161,137 @@ void XMLDumpFile::addText(const XML_Char *s, int len)
 }
 
 // ------------------------------------------------------------------------------------------------
-// utilitaires pour manipuler des cha�nes de caract�res
+// mmoire d'un document XML
 // ------------------------------------------------------------------------------------------------
 
-static char* copy_text (const char* text, int len = -1)
+static const size_t ALIGN = 2 * sizeof(void*) ;
+
+XMLArena::XMLArena (size_t _block_size)
+{
+	first      = NULL ;
+	current    = NULL ;
+	pos        = NULL ;
+	end        = NULL ;
+	last_text  = NULL ;
+	block_size = _block_size ;
+}
+
+// passage au bloc suivant, d'une taille au moins gale  size ; les blocs existants sont rutiliss
+// s'ils sont assez grands, sinon un nouveau bloc est ajout en fin de liste
+
+void XMLArena::NextBlock (size_t size)
+{
+	Block *prev  = current ;
+	Block *block = current ? current->next : first ;
+	while (block && block->size < size)
+	{
+		prev  = block ;
+		block = block->next ;
+	}
+	if (block == NULL)
+	{
+		size_t n = size > block_size ? size : block_size ;
+		block = (Block*) malloc (sizeof(Block) + n) ;
+		block->next = NULL ;
+		block->size = n ;
+		if (prev) prev->next = block ; else first = block ;
+	}
+	current = block ;
+	pos = (char*) (block + 1) ;
+	end = pos + block->size ;
+}
+
+void* XMLArena::Allocate (size_t size)
+{
+	size = (size + ALIGN - 1) & ~(ALIGN - 1) ;
+	size_t offset = pos ? (ALIGN - ((size_t) pos & (ALIGN - 1))) & (ALIGN - 1) : 0 ;
+	if (pos == NULL || (size_t) (end - pos) < offset + size)
+	{
+		NextBlock (size) ;
+		offset = 0 ;
+	}
+	void* p = pos + offset ;
+	pos += offset + size ;
+	last_text = NULL ;
+	return p ;
+}
+
+char* XMLArena::CopyText (const char* text, int len)
 {
 	if (len < 0) len = (int) strlen(text) ;
-	char* s = (char*) malloc((len+1) * sizeof(char)) ;
-	strncpy (s, text, len) ;
+	if (pos == NULL || (size_t) (end - pos) < (size_t) len + 1) NextBlock (len + 1) ;
+	char* s = pos ;
+	memcpy (s, text, len) ;
 	s[len] = 0 ;
+	pos += len + 1 ;
+	last_text = s ;
 	return s ;
 }
 
-static char* append_text (char *init, const char* text, int len = -1)
+char* XMLArena::AppendText (char *init, const char* text, int len)
 {
-	if (init == NULL) return copy_text (text, len) ;
+	if (init == NULL) return CopyText (text, len) ;
 
 	if (len < 0) len = (int) strlen(text) ;
+	if (init == last_text && (size_t) (end - pos) >= (size_t) len)
+	{
+		// prolongation sur place,  la place du 0 terminal
+		memcpy (pos - 1, text, len) ;
+		pos += len ;
+		pos[-1] = 0 ;
+		return init ;
+	}
 	size_t init_len = strlen (init) ;
-	char* s = (char*) malloc((init_len + len + 1) * sizeof(char)) ;
-	strncpy (s, init, init_len) ;
-	strncpy (s+init_len, text, len) ;
-	s[init_len+len] = 0 ;
-	free (init) ;
+	if ((size_t) (end - pos) < init_len + len + 1) NextBlock (init_len + len + 1) ;
+	char* s = pos ;
+	memcpy (s, init, init_len) ;
+	memcpy (s + init_len, text, len) ;
+	s[init_len + len] = 0 ;
+	pos += init_len + len + 1 ;
+	last_text = s ;
 	return s ;
 }
 
-static char** copy_attrib (const char** attrib) 
+void XMLArena::Reset (void)
+{
+	current   = NULL ;
+	pos       = NULL ;
+	end       = NULL ;
+	last_text = NULL ;
+}
+
+void XMLArena::Release (void)
+{
+	while (first)
+	{
+		Block *next = first->next ;
+		free (first) ;
+		first = next ;
+	}
+	Reset() ;
+}
+
+size_t XMLArena::GetCapacity (void)
+{
+	size_t size = 0 ;
+	for (Block *block = first ; block ; block = block->next) size += block->size ;
+	return size ;
+}
+
+// ------------------------------------------------------------------------------------------------
+// utilitaires pour manipuler des cha�nes de caract�res
+// ------------------------------------------------------------------------------------------------
+
+static char** copy_attrib (XMLArena& arena, const char** attrib) 
 {
 	int n;
 	for (n = 0 ; attrib[n] ; n+=2) ;
-	char** list = (char**) malloc((n+1) * sizeof(char*)) ;
+	char** list = (char**) arena.Allocate((n+1) * sizeof(char*)) ;
 
 	int i;
 	for (i = 0 ; i < n ; i++)
 	{
-		list[i] = copy_text (attrib[i]) ;
+		list[i] = arena.CopyText (attrib[i]) ;
 	}
 	list[i] = NULL ;
 	return list ;
@@ -199,18 +304,25 @@ static char** copy_attrib (const char** attrib)
 
 void XMLNode::addText (const char* new_text, int len_text)
 {
-	text = append_text (text, new_text, len_text) ;
+	text = arena->AppendText (text, new_text, len_text) ;
 }   
 
-XMLNode::XMLNode (XMLNode *_parent, const char* _name, const char** _attrib)
+XMLNode* XMLNode::Create (XMLArena& arena, XMLNode *parent, const char* name, const char** attrib)
+{
+	void* p = arena.Allocate (sizeof(XMLNode)) ;
+	return new (p) XMLNode (&arena, parent, name, attrib) ;
+}
+
+XMLNode::XMLNode (XMLArena *_arena, XMLNode *_parent, const char* _name, const char** _attrib)
 {
+	arena       = _arena ;
 	parent      = _parent ;
 	next        = NULL ;
 	first_child = NULL ;
 	last_child  = NULL ;
-	name        = copy_text(_name) ;
+	name        = arena->CopyText(_name) ;
 	text        = NULL ;
-	attrib      = copy_attrib(_attrib) ;
+	attrib      = copy_attrib(*arena, _attrib) ;
 
 	if (parent)
 	{
@@ -299,29 +411,10 @@ void XMLNode::dump (int level)
 }
 
 
-XMLNode::~XMLNode (void)
+void XMLNode::DetachChildren (void)
 {
-	XMLNode *child = first_child ;
-	while (child)
-	{
-		XMLNode *next = child->next ;
-		delete child ;
-		child = next ;
-	}
-
-	if(attrib)
-	{
-		for (int i = 0 ; attrib[i] != NULL; i += 2)
-		{
-			free (attrib[i]) ;
-			free (attrib[i+1]) ;
-		}
-
-		free (attrib) ;	
-	}
-
-	if(name) free (name) ;
-	if(text) free(text) ;
+	first_child = NULL ;
+	last_child  = NULL ;
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -330,7 +423,7 @@ XMLNode::~XMLNode (void)
 
 void XMLFileLoader::startEntity (const char *element_name, const char **attr) 
 {
-	XMLNode* node = new XMLNode (current, element_name, attr) ;
+	XMLNode* node = XMLNode::Create (arena, current, element_name, attr) ;
 	if (!root) root = node ;
 	current = node ;
 }
@@ -345,6 +438,140 @@ void XMLFileLoader::addText (const XML_Char* text, int len_text)
 	current->addText (text, len_text) ;
 }
 
+// ------------------------------------------------------------------------------------------------
+// chargement incrmental des enfants de la racine
+// ------------------------------------------------------------------------------------------------
+
+void XMLStreamLoader::startEntity (const char *element_name, const char **attr) 
+{
+	XMLNode* node = XMLNode::Create (root ? arena : root_arena, current, element_name, attr) ;
+	if (!root) 
+	{
+		root = node ;
+		XML_StopParser (parser, XML_TRUE) ;
+	}
+	current = node ;
+}
+
+void XMLStreamLoader::endEntity (const char *element_name) 
+{
+	current = current->GetParent() ;
+	if (current != NULL && current == root)
+	{
+		ready = true ;
+		XML_StopParser (parser, XML_TRUE) ;
+	}
+}
+
+void XMLStreamLoader::addText (const XML_Char* text, int len_text) 
+{
+	if (current) current->addText (text, len_text) ;
+}
+
+bool XMLStreamLoader::Open (const char* fileName)
+{
+	Close() ;
+
+	last_line = 0 ;
+	last_char = 0 ;
+	last_error = 0 ;
+
+	if (fileName == 0 || _access (fileName,0) != 0)
+	{
+		last_error = XML_FILE_NOT_FOUND ;
+		return false ;
+	}
+
+	file_id = _open (fileName, O_RDONLY | O_BINARY) ;
+	if (file_id < 0)
+	{
+		last_error = XML_FILE_NO_ACCESS ;
+		return false ;
+	}
+
+	parser = XML_ParserCreate(NULL) ;
+	XML_SetUserData (parser, (void*) this) ;
+	XML_SetElementHandler(parser, start_handler, end_handler) ;
+	XML_SetCharacterDataHandler(parser, text_handler) ;
+	/*
+	 * le parseur est suspendu ds la lecture de la balise de dbut de la racine
+	 */
+	while (root == NULL && Continue()) ;
+	if (root == NULL && last_error == XML_ERROR_NONE) last_error = XML_ERROR_NO_ELEMENTS ;
+	return (root != NULL) ;
+}
+
+// envoi de la suite du fichier au parseur EXPAT, retourne false  la fin du document ou en cas 
+// d'erreur
+
+bool XMLStreamLoader::Continue (void)
+{
+	const int BUFF_SIZE = 4096 ;
+
+	if (parser == NULL || last_error != XML_ERROR_NONE) return false ;
+
+	XML_ParsingStatus status ;
+	XML_GetParsingStatus (parser, &status) ;
+	if (status.parsing == XML_FINISHED) return false ;
+
+	enum XML_Status result ;
+	if (status.parsing == XML_SUSPENDED)
+	{
+		result = XML_ResumeParser (parser) ;
+	}
+	else
+	{
+		void *buff = XML_GetBuffer (parser, BUFF_SIZE) ;
+		if (buff == NULL) 
+		{
+			last_error = XML_GetErrorCode (parser) ;
+			return false ;
+		}
+		int bytes_read = _read (file_id, buff, BUFF_SIZE) ;
+		if (bytes_read < 0)
+		{
+			last_error = XML_FILE_NO_ACCESS ;
+			return false ;
+		}
+		result = XML_ParseBuffer (parser, bytes_read, bytes_read == 0) ;
+	}
+
+	last_line = XML_GetCurrentLineNumber (parser) ;
+	last_char = XML_GetCurrentColumnNumber (parser) ;
+
+	if (result == XML_STATUS_ERROR)
+	{
+		last_error = XML_GetErrorCode (parser) ;
+		return false ;
+	}
+	return true ;
+}
+
+XMLNode* XMLStreamLoader::GetNextEntity (void)
+{
+	if (root == NULL) return NULL ;
+	/*
+	 * libration de l'entit prcdente
+	 */
+	root->DetachChildren() ;
+	arena.Reset() ;
+	ready = false ;
+	while (!ready && Continue()) ;
+	return ready ? root->GetFirstChild() : NULL ;
+}
+
+void XMLStreamLoader::Close (void)
+{
+	if (parser) XML_ParserFree (parser) ;
+	if (file_id >= 0) _close (file_id) ;
+	root_arena.Release() ;
+	arena.Release() ;
+	parser = NULL ;
+	file_id = -1 ;
+	root = current = NULL ;
+	ready = false ;
+}
+
 // ------------------------------------------------------------------------------------------------
 // transformation d'un code d'erreur num�rique en une cha�ne de caract�res correspondante
 // ------------------------------------------------------------------------------------------------
@@ -14,6 +14,11 @@
  *
  *	15/11/2013	support added to convert numerical error codes to human-readable text
  *
+ *	18/10/2026	added class XMLStreamLoader (incremental loading of the children of the root node)
+ *
+ *	18/10/2026	added class XMLArena ; the nodes of a document and their strings are allocated in
+ *				the arena of the loader and released all together with the document
+ *
  * ------------------------------------------------------------------------------------------------- 
  */
 #include <stdlib.h>
@@ -99,14 +104,66 @@ class XMLDumpFile : public XMLFileParser
    }
 } ;
 
+// ------------------------------------------------------------------------------------------------
+// classe XMLArena : mmoire d'un document XML
+//
+// la mmoire est alloue par blocs, dans lesquels les noeuds, les noms, les textes et les listes
+// d'attributs sont rangs les uns  la suite des autres. Les textes sont prolongs sur place tant
+// qu'aucune autre allocation n'a eu lieu. La mmoire n'est jamais libre individuellement :
+//
+//  Reset :       libre le contenu de l'arne en une seule opration ; les blocs sont conservs et
+//                rutiliss pour le document suivant.
+//  Release :     rend les blocs au systme.
+//
+// ------------------------------------------------------------------------------------------------
+
+class XMLArena
+{
+    struct Block
+    {
+        Block  *next ;
+        size_t  size ;
+    } ;
+
+    Block  *first ;
+    Block  *current ;
+    char   *pos ;
+    char   *end ;
+    char   *last_text ;
+    size_t  block_size ;
+
+    void NextBlock (size_t size) ;
+
+    XMLArena (XMLArena const&) ;
+    XMLArena& operator= (XMLArena const&) ;
+
+ public:
+
+   XMLArena (size_t _block_size = 16384) ;
+   ~XMLArena (void) { Release() ; }
+
+   void* Allocate (size_t size) ;
+   char* CopyText (const char* text, int len = -1) ;
+   char* AppendText (char* init, const char* text, int len = -1) ;
+
+   void Reset (void) ;
+   void Release (void) ;
+
+// taille totale des blocs
+
+   size_t GetCapacity (void) ;
+} ;
+
 // ------------------------------------------------------------------------------------------------
 // clsse XMLNode ; reprsentation d'un document XML sous forme d'une arborescence 
 //
-// A FAIRE: destruction et libration de la mmoire alloue.
+// les noeuds sont crs dans l'arne du document et ne sont pas dtruits individuellement ; la 
+// mmoire est libre avec celle de l'arne.
 // ------------------------------------------------------------------------------------------------
 
 class XMLNode 
 {
+    XMLArena *arena ;
     XMLNode *parent ;
     XMLNode *next ;
     XMLNode *first_child ;
@@ -115,15 +172,16 @@ class XMLNode
     char    *text ;
     char   **attrib ;
  
+ // construction dans l'arne uniquement (voir Create), pas de destruction individuelle
+
+    XMLNode (XMLArena *_arena, XMLNode *_parent, const char* _name, const char** _attrib) ;
+    ~XMLNode (void) ;
+
  public:   
  
  // cration
  
-    XMLNode (XMLNode *_parent, const char* _name, const char** _attrib) ;
- 
- // destruction
- 
-    ~XMLNode (void) ;
+    static XMLNode* Create (XMLArena& arena, XMLNode *parent, const char* name, const char** attrib) ;
     
  // chaque noeud a un nom, un texte et une liste d'attributs
  
@@ -157,6 +215,10 @@ class XMLNode
  
     void addText (const char* new_text, int len_text = -1) ;    
 
+ // dtache les enfants du noeud (leur mmoire reste alloue dans l'arne)
+
+    void DetachChildren (void) ;
+
  // affiche l'arborescence  l'cran
  
     void dump (int level) ;
@@ -171,12 +233,14 @@ class XMLNode
 // cette classe implmente ses propres versions des fonctions virtuelles startEntity, endEntity 
 // et addText
 //
-// A FAIRE: destruction et libration de la mmoire...
+// l'arborescence est libre par Cleanup ou  la destruction du loader. Aprs Cleanup, la mmoire
+// est rutilise pour le fichier suivant.
 //
 // ------------------------------------------------------------------------------------------------
 
 class XMLFileLoader : public XMLFileParser
 {
+    XMLArena arena ;
     XMLNode *root ;
     XMLNode *current ;
     
@@ -203,10 +267,61 @@ class XMLFileLoader : public XMLFileParser
    
    void Cleanup (void)
    {
-       if (root) delete root ;
+       arena.Reset() ;
        root = current = NULL ;
    }
 } ;
 
+// ------------------------------------------------------------------------------------------------
+// classe XMLStreamLoader : chargement incrmental d'un fichier XML
+//
+// la racine du document est charge  l'ouverture du fichier, sans ses enfants. Les enfants de 
+// la racine sont ensuite chargs un par un, chacun sous la forme d'une arborescence complte de 
+// XMLNode's, par des appels successifs  GetNextEntity. La racine et les enfants sont rangs dans
+// deux arnes distinctes ; l'arne des enfants est vide  chaque appel, de sorte que la mmoire
+// utilise ne dpend pas de la taille du fichier.
+//
+// le parseur EXPAT est suspendu  la fin de chaque enfant de la racine et reprend au mme endroit
+// lors de l'appel suivant.
+//
+// ------------------------------------------------------------------------------------------------
+
+class XMLStreamLoader : public XMLFileParser
+{
+    XML_Parser parser ;
+    int        file_id ;
+    XMLArena   root_arena ;
+    XMLArena   arena ;
+    XMLNode   *root ;
+    XMLNode   *current ;
+    bool       ready ;
+
+    bool Continue (void) ;
+    
+ public:  
+ 
+   void startEntity (const char *element_name, const char **attr) ;
+   void endEntity (const char *element_name) ;
+   void addText (const XML_Char* text, int len_text) ;
+   
+   XMLStreamLoader() { parser = NULL ; file_id = -1 ; root = current = NULL ; ready = false ; } 
+
+   ~XMLStreamLoader() { Close() ; }
+
+// ouverture du fichier et lecture jusqu' la balise de dbut de la racine
+
+   bool Open (const char* filename) ;
+
+// accs  la racine du document (sans ses enfants)
+
+   XMLNode* GetRoot (void) { return root ; } 
+
+// enfant suivant de la racine, NULL  la fin du document ou en cas d'erreur (last_error)
+
+   XMLNode* GetNextEntity (void) ;
+
+   void Close (void) ;
+} ;
+
 
 
@@ -0,0 +1,342 @@
+/*
+ * ------------------------------------------------------------------------------------------------
+ * file:		BenchHarmonoise.cpp
+ * version:		1.0
+ * author:		dirk.van-maercke@cstb.fr
+ * copyright:	see file licence.EU.txt
+ * description: checks and benchmarks of the Harmonoise point-to-point engine. The engine is linked
+ *				in from a test build of PointToPoint.cpp (-D_TEST_GROUND_EFFECT_ and
+ *				-D_TEST_SPECIAL_FUNCTIONS_), which keeps the original implementations as reference.
+ * changes:
+ *
+ *	18/10/2026	initial version
+ * -------------------------------------------------------------------------------------------------
+ */
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+#include "TestCnossosBench.h"
+#include "CalculationMethod.h"
+#define _TEST_GROUND_EFFECT_
+#define _TEST_SPECIAL_FUNCTIONS_
+#include "../HarmonoiseP2P/PointToPoint.hpp"
+#include <math.h>
+#include <algorithm>
+
+using namespace CnossosEU ;
+using namespace System ;
+/*
+ * 500m ground profile with the given number of segments, either smooth or a zigzag of 2m high
+ * steps, with alternating patches of soft and hard ground
+ */
+static void set_profile (void* p2p, int nb_segments, bool zigzag)
+{
+	P2P_Clear (p2p) ;
+	for (int i = 0 ; i <= nb_segments ; ++i)
+	{
+		double x = 500. * i / nb_segments ;
+		double z = zigzag ? 2.0 * (i % 2) : 2.0 + 2.0 * sin (x / 80.) ;
+		P2P_AddSegment (p2p, x, z, ((i / 5) % 2) ? groundSigma_200 : groundSigma_20000) ;
+	}
+	P2P_SetSourceHeight (p2p, 0.5, 0.0) ;
+	P2P_SetReceiverHeight (p2p, 4.0, 0.0) ;
+}
+
+static const char* profile_name (int nb_segments, bool zigzag)
+{
+	static char name[64] ;
+	sprintf (name, "%d segments, %s", nb_segments, zigzag ? "zigzag" : "smooth") ;
+	return name ;
+}
+/*
+ * the ground effect accumulates the contributions of the segments over all frequency bands at once ;
+ * each call is repeated band by band with the original complex arithmetic and the results must be
+ * bit-identical. Paths: the data corpus with JRC-draft-2010 and 500m profiles.
+ */
+void test_ground_effect (void)
+{
+	int nb_calls, nb_values, nb_diffs ;
+	P2P_CheckGroundEffect (true, 0, 0) ;
+	ref_ptr<CalculationMethod> method = getCalculationMethod ("JRC-draft-2010") ;
+	std::vector<std::string> const& files = data_files() ;
+	for (unsigned int i = 0 ; i < files.size() ; ++i)
+	{
+		PropagationPath path ;
+		PropagationPathOptions options ;
+		if (!parse_xml_path (files[i].c_str(), path, options)) continue ;
+		ref_ptr<CalculationMethod> fileMethod = options.method ;
+		options.method = method ;
+		PathResult result ;
+		calculate_path (path, options, result) ;
+	}
+	nb_diffs = P2P_CheckGroundEffect (true, &nb_calls, &nb_values) ;
+	report ("data corpus, JRC-draft-2010 : %d calls, %d values, %d differences", nb_calls, nb_values, nb_diffs) ;
+	check (nb_calls > 0 && nb_diffs == 0, "ground effect differs from the original calculation") ;
+
+	void* p2p = P2P_Create() ;
+	double att[MAX_FREQ] ;
+	for (int zigzag = 0 ; zigzag < 2 ; ++zigzag)
+	{
+		for (int nb_segments = 25 ; nb_segments <= 50 ; nb_segments += 25)
+		{
+			set_profile (p2p, nb_segments, zigzag != 0) ;
+			P2P_CheckGroundEffect (true, 0, 0) ;
+			P2P_GetResults (p2p, att) ;
+			nb_diffs = P2P_CheckGroundEffect (false, &nb_calls, &nb_values) ;
+			report ("%-30s : %d calls, %d values, %d differences", profile_name (nb_segments, zigzag != 0),
+					nb_calls, nb_values, nb_diffs) ;
+			check (nb_calls > 0 && nb_diffs == 0, "ground effect differs from the original calculation") ;
+		}
+	}
+	/*
+	 * time per path with the check disabled
+	 */
+	unsigned int nb_loops = scaled (20, 1000) ;
+	for (int zigzag = 0 ; zigzag < 2 ; ++zigzag)
+	{
+		for (int nb_segments = 25 ; nb_segments <= 50 ; nb_segments += 25)
+		{
+			set_profile (p2p, nb_segments, zigzag != 0) ;
+			SystemClock clock ;
+			for (unsigned int k = 0 ; k < nb_loops ; ++k) P2P_GetResults (p2p, att) ;
+			report_time (profile_name (nb_segments, zigzag != 0), clock.get(), nb_loops) ;
+		}
+	}
+	P2P_Delete (p2p) ;
+}
+/*
+ * Fref, Qref and HaddenPierce against their original implementations, over grids of arguments covering
+ * the range used by the engine (see P2P_TestSpecialFunctions) : the relative deviation must stay below 
+ * 1e-10 and no NaN may appear
+ */
+void test_special_functions (void)
+{
+	int nb_failed = P2P_TestSpecialFunctions (scaled (1, 20), 1.E-10) ;
+	check (nb_failed == 0, "%d functions deviate from their original implementation", nb_failed) ;
+}
+/*
+ * Delany & Bazley impedance spectra are shared by all engines through a cache keyed on the flow
+ * resistivity, the layer thickness, the sound speed and the frequency array. Each band of a spectrum
+ * must be bit-identical to the same impedance calculated on its own (single band frequency array),
+ * and spectra with different keys must differ.
+ */
+void test_impedance_cache (void)
+{
+	void* p2p = P2P_Create() ;
+	void* single = P2P_Create() ;
+	int nb_freq = P2P_GetNbFreq (p2p) ;
+	double freq[MAX_FREQ] ;
+	P2P_GetFreqArray (p2p, freq) ;
+
+	unsigned int nb_diffs = 0 ;
+	Complex Z[MAX_FREQ], Z1[MAX_FREQ], Z2[MAX_FREQ] ;
+	for (int i = groundUserDefined ; i < groundUserDefined + 20 ; ++i)
+	{
+		double sigma = 10.0 + 7.5 * i ;
+		double thickness = (i % 3) * 0.01 ;
+		P2P_SetImpedanceDB (p2p, i, sigma, thickness) ;
+		P2P_GetImpedance (p2p, i, Z) ;
+		for (int j = 0 ; j < nb_freq ; ++j)
+		{
+			P2P_SetFreqArray (single, 1, freq + j) ;
+			P2P_SetImpedanceDB (single, i, sigma, thickness) ;
+			P2P_GetImpedance (single, i, Z1) ;
+			if (Z1[0] != Z[j]) nb_diffs++ ;
+		}
+	}
+	report ("20 impedances, %d bands : %d differences with single band spectra", nb_freq, nb_diffs) ;
+	check (nb_diffs == 0, "cached impedance spectra differ from the calculated ones") ;
+
+	P2P_SetImpedanceDB (p2p, groundUserDefined, 200.0, 0.0) ;
+	P2P_GetImpedance (p2p, groundUserDefined, Z1) ;
+	P2P_SetImpedanceDB (p2p, groundUserDefined, 200.0, 0.01) ;
+	P2P_GetImpedance (p2p, groundUserDefined, Z2) ;
+	check (Z1[0] != Z2[0], "spectra with different layer thickness are the same") ;
+	/*
+	 * time to define 90 user classes, to create an engine and to change its frequency array
+	 */
+	unsigned int nb_loops = scaled (50, 1000) ;
+	SystemClock clock ;
+	for (unsigned int k = 0 ; k < nb_loops ; ++k)
+	{
+		for (int i = groundUserDefined ; i < MAX_IMPEDANCE ; ++i) P2P_SetImpedanceDB (p2p, i, 10.0 + 7.5 * i, (i % 3) * 0.01) ;
+	}
+	report_time ("P2P_SetImpedanceDB, 90 classes", clock.get (true), nb_loops, "set") ;
+	for (unsigned int k = 0 ; k < nb_loops ; ++k) P2P_Delete (P2P_Create()) ;
+	report_time ("P2P_Create + P2P_Delete", clock.get (true), nb_loops, "engine") ;
+	double octaves[8] = { 63, 125, 250, 500, 1000, 2000, 4000, 8000 } ;
+	for (unsigned int k = 0 ; k < nb_loops ; ++k) P2P_SetFreqArray (single, 8, octaves) ;
+	report_time ("P2P_SetFreqArray, 8 bands", clock.get (true), nb_loops, "call") ;
+
+	P2P_Delete (single) ;
+	P2P_Delete (p2p) ;
+}
+/*
+ * per-stage timers over refracted paths on smooth and zigzag profiles : with enableProfiling, each
+ * stage must be called and timed, its longest call may not exceed its total time, the stages called
+ * from ExcessAttenuation may not take more time than ExcessAttenuation itself, and a reset must clear
+ * the counters. Without the option, nothing may be counted.
+ */
+void test_stage_timers (void)
+{
+	void* p2p = P2P_Create() ;
+	double att[MAX_FREQ] ;
+	unsigned int nb_loops = scaled (20, 1000) ;
+	for (int profiling = 0 ; profiling < 2 ; ++profiling)
+	{
+		OPTIONS options = P2P_GetOptions (p2p) ;
+		P2P_SetOptions (p2p, profiling ? (options | enableProfiling) : (options & ~enableProfiling)) ;
+		for (int zigzag = 0 ; zigzag < 2 ; ++zigzag)
+		{
+			set_profile (p2p, 25, zigzag != 0) ;
+			P2P_SetSoundSpeedProfile (p2p, 0.1, 0.2, 0, 0) ;
+			for (unsigned int k = 0 ; k < nb_loops ; ++k) P2P_GetResults (p2p, att) ;
+		}
+		int nb_calls[NB_STAGES] ;
+		double total[NB_STAGES], max[NB_STAGES] ;
+		for (int i = 0 ; i < NB_STAGES ; ++i) P2P_GetStageTimer (p2p, i, &nb_calls[i], &total[i], &max[i], false) ;
+		if (!profiling)
+		{
+			int nb_counted = 0 ;
+			for (int i = 0 ; i < NB_STAGES ; ++i) nb_counted += nb_calls[i] ;
+			check (nb_counted == 0, "%d calls counted without enableProfiling", nb_counted) ;
+			continue ;
+		}
+		double excess = total[STAGE_EXCESS_ATTENUATION] ;
+		for (int i = 0 ; i < NB_STAGES ; ++i)
+		{
+			const char* name = P2P_GetStageName (i) ;
+			report ("%-18s: %7d calls, %8.3f ms, max %8.3f us, %5.1f %% of ExcessAttenuation", name, nb_calls[i],
+					1000 * total[i], 1e6 * max[i], excess > 0 ? 100 * total[i] / excess : 0.0) ;
+			check (nb_calls[i] > 0 && total[i] > 0, "%s : not timed", name) ;
+			check (max[i] <= total[i], "%s : longest call exceeds the total time", name) ;
+			if (i != STAGE_CREATE_SEGMENTS && i != STAGE_CURVATURE && i != STAGE_EXCESS_ATTENUATION)
+				check (total[i] <= excess, "%s : exceeds the time of ExcessAttenuation", name) ;
+		}
+		int nb_counted = 0 ;
+		for (int i = 0 ; i < NB_STAGES ; ++i)
+		{
+			P2P_GetStageTimer (p2p, i, 0, 0, 0, true) ;
+			P2P_GetStageTimer (p2p, i, &nb_calls[i], &total[i], &max[i], false) ;
+			if (nb_calls[i] != 0 || total[i] != 0 || max[i] != 0) nb_counted++ ;
+		}
+		check (nb_counted == 0, "%d stages not cleared by a reset", nb_counted) ;
+	}
+	P2P_Delete (p2p) ;
+}
+/*
+ * elapsed time in seconds (SystemClock measures the CPU time of the process on POSIX systems,
+ * i.e. the sum over all threads)
+ */
+static double wall_time (void)
+{
+#ifdef WIN32
+	LARGE_INTEGER counter, frequency ;
+	QueryPerformanceCounter (&counter) ;
+	QueryPerformanceFrequency (&frequency) ;
+	return (double) counter.QuadPart / (double) frequency.QuadPart ;
+#else
+	timespec t ;
+	clock_gettime (CLOCK_MONOTONIC, &t) ;
+	return t.tv_sec + 1.E-9 * t.tv_nsec ;
+#endif
+}
+/*
+ * long-term results over a wind rose : P2P_GetWindRoseResults against a loop over the conditions with
+ * P2P_SetupMeteoParameters and P2P_GetResults, in a single thread and in 4 threads. The results of each
+ * condition must be bit-identical and the sound speed profile of the engine must be left unchanged.
+ */
+void test_wind_rose (void)
+{
+	struct WindRose
+	{
+		int nb_segments ;
+		int nb_directions ;
+		int nb_speeds ;
+	} ;
+	WindRose cases[] = { { 25, 5, 1 }, { 50, 5, 1 }, { 25, 5, 5 }, { 10, 8, 5 } } ;
+	const double speeds[5] = { 0.5, 2.0, 4.5, 7.5, 10.0 } ;
+	const int nb_classes = 5 ;
+	unsigned int nb_loops = scaled (1, 10) ;
+
+	void* p2p = P2P_Create() ;
+	int nb_freq = P2P_GetNbFreq (p2p) ;
+	for (unsigned int c = 0 ; c < sizeof(cases) / sizeof(cases[0]) ; ++c)
+	{
+		WindRose const& rose = cases[c] ;
+		std::vector<double> windSpeed, cosWind, weight ;
+		std::vector<int> stability ;
+		for (int d = 0 ; d < rose.nb_directions ; ++d)
+		{
+			for (int v = 0 ; v < rose.nb_speeds ; ++v)
+			{
+				for (int k = 0 ; k < nb_classes ; ++k)
+				{
+					windSpeed.push_back (rose.nb_speeds == 1 ? 5.0 : speeds[v]) ;
+					cosWind.push_back (cos (2 * 3.141592653589793 * d / rose.nb_directions)) ;
+					stability.push_back (k) ;
+					weight.push_back (1.0 + (d + v + k) % 3) ;
+				}
+			}
+		}
+		int nb_cond = (int) weight.size() ;
+		std::vector<double> att_cond (nb_cond * nb_freq), att_threads (nb_cond * nb_freq), ref_cond (nb_cond * nb_freq) ;
+		double att[MAX_FREQ], ref[MAX_FREQ] ;
+		double A0, B0, C0, D0, A1, B1, C1, D1 ;
+
+		set_profile (p2p, rose.nb_segments, false) ;
+		P2P_SetSoundSpeedProfile (p2p, 0.1, 0.2, 0, 0) ;
+		P2P_GetSoundSpeedProfile (p2p, &A0, &B0, &C0, &D0) ;
+		double t0 = wall_time() ;
+		for (unsigned int k = 0 ; k < nb_loops ; ++k)
+		{
+			P2P_GetWindRoseResults (p2p, nb_cond, &windSpeed[0], &cosWind[0], &stability[0], &weight[0], &att_cond[0], att) ;
+		}
+		double t_rose = wall_time() - t0 ;
+		P2P_GetSoundSpeedProfile (p2p, &A1, &B1, &C1, &D1) ;
+		check (A0 == A1 && B0 == B1 && C0 == C1 && D0 == D1, "sound speed profile modified by P2P_GetWindRoseResults") ;
+
+		P2P_SetNbThreads (p2p, 4) ;
+		t0 = wall_time() ;
+		for (unsigned int k = 0 ; k < nb_loops ; ++k)
+		{
+			P2P_GetWindRoseResults (p2p, nb_cond, &windSpeed[0], &cosWind[0], &stability[0], &weight[0], &att_threads[0], 0) ;
+		}
+		double t_threads = wall_time() - t0 ;
+		P2P_SetNbThreads (p2p, 1) ;
+
+		t0 = wall_time() ;
+		for (unsigned int k = 0 ; k < nb_loops ; ++k)
+		{
+			for (int i = 0 ; i < nb_cond ; ++i)
+			{
+				P2P_SetupMeteoParameters (p2p, windSpeed[i], cosWind[i], stability[i]) ;
+				P2P_GetResults (p2p, &ref_cond[i * nb_freq]) ;
+			}
+		}
+		double t_loop = wall_time() - t0 ;
+
+		double sum_w = 0 ;
+		for (int j = 0 ; j < nb_freq ; ++j) ref[j] = 0 ;
+		for (int i = 0 ; i < nb_cond ; ++i)
+		{
+			sum_w += weight[i] ;
+			for (int j = 0 ; j < nb_freq ; ++j) ref[j] += weight[i] * pow (10, 0.1 * ref_cond[i * nb_freq + j]) ;
+		}
+		unsigned int nb_diffs = 0 ;
+		double max_diff = 0 ;
+		for (int j = 0 ; j < nb_freq ; ++j) max_diff = std::max (max_diff, fabs (att[j] - 10 * log10 (ref[j] / sum_w))) ;
+		for (int i = 0 ; i < nb_cond * nb_freq ; ++i) if (att_cond[i] != ref_cond[i]) nb_diffs++ ;
+		unsigned int nb_diffs_threads = 0 ;
+		for (int i = 0 ; i < nb_cond * nb_freq ; ++i) if (att_threads[i] != ref_cond[i]) nb_diffs_threads++ ;
+
+		report ("%d segments, %d conditions : %.2f -> %.2f ms (%.2f ms in 4 threads), %d differences", rose.nb_segments, 
+				nb_cond, 1000 * t_loop / nb_loops, 1000 * t_rose / nb_loops, 1000 * t_threads / nb_loops, nb_diffs + nb_diffs_threads) ;
+		check (nb_diffs == 0, "results differ from the calculation condition by condition") ;
+		check (nb_diffs_threads == 0, "results in 4 threads differ from the calculation condition by condition") ;
+		check (max_diff < 1.E-9, "long-term average differs by %g dB", max_diff) ;
+	}
+	P2P_Delete (p2p) ;
+}
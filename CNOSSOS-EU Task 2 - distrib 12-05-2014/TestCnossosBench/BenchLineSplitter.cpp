@@ -0,0 +1,157 @@
+/*
+ * ------------------------------------------------------------------------------------------------
+ * file:		BenchLineSplitter.cpp
+ * version:		1.0
+ * author:		dirk.van-maercke@cstb.fr
+ * copyright:	see file licence.EU.txt
+ * description: checks and benchmarks of the adaptive subdivision of line sources
+ * changes:
+ *
+ *	18/10/2026	initial version
+ * -------------------------------------------------------------------------------------------------
+ */
+#include "TestCnossosBench.h"
+#include "CalculationMethod.h"
+#include "LineSplitter.h"
+#include <math.h>
+#include <algorithm>
+
+using namespace CnossosEU ;
+using namespace System ;
+/*
+ * level (dB(A)) at the receiver due to the road polylines, each elementary source being calculated
+ * as a separate propagation path over flat ground in the synthetic city
+ */
+static double get_road_level (CalculationMethod* method, ObstacleIndex& index, std::vector< std::vector<Position> >& roads,
+							  ElementarySource const& source, ReceiverExt* receiver, Position const& rec,
+							  LineSplitOptions const& options, unsigned int& nb_paths)
+{
+	std::vector<LineElement> elements ;
+	for (unsigned int k = 0 ; k < roads.size() ; ++k) splitLineSource (roads[k], rec, elements, options) ;
+
+	double energy = 0 ;
+	PropagationPath path ;
+	PathResult result ;
+	for (unsigned int k = 0 ; k < elements.size() ; ++k)
+	{
+		LineElement& e = elements[k] ;
+		path.clear() ;
+		path.resize (2) ;
+		path[0].pos = Position (e.pos.x, e.pos.y, 0.0) ;
+		path[0].mat = getMaterial ("H") ;
+		path[0].ext = new SourceExt (source, new LineSource (e.length, e.orientation)) ;
+		path[0].ext->h = source.sourceHeight ;
+		path[1].pos = Position (rec.x, rec.y, 0.0) ;
+		path[1].mat = getMaterial ("H") ;
+		path[1].ext = receiver ;
+		index.insertObstacles (path) ;
+		try
+		{
+			if (!method->doCalculation (path, result)) continue ;
+		}
+		catch (std::exception&)
+		{
+			continue ;
+		}
+		energy += POW10 (result.Leq_dBA) ;
+		nb_paths++ ;
+	}
+	return LOG10 (energy) ;
+}
+/*
+ * the adaptive subdivision of 6 roads of about 1km in the synthetic city against subdivisions in
+ * pieces of fixed length or fixed angle of view, at random receivers. The reference solution uses
+ * pieces of 1m. The levels with the adaptive subdivision must stay within its tolerance and must be
+ * calculated with fewer paths than with the subdivision in pieces of 10m.
+ */
+void test_line_splitter (void)
+{
+	ObstacleIndex index ;
+	std::vector<Polygon2D> obstacles ;
+	create_synthetic_city (index, obstacles) ;
+	index.build() ;
+
+	ElementarySource source ;
+	double road[8] = { 80, 85, 88, 92, 95, 92, 86, 78 } ;
+	source.sourceHeight = 0.05 ;
+	source.spectrumType = SpectrumType::LineSource ;
+	source.measurementType = MeasurementType::HemiSpherical ;
+	source.frequencyWeighting = FrequencyWeighting::dBLIN ;
+	for (unsigned int i = 0 ; i < source.soundPower.size() ; ++i) source.soundPower[i] = road[Spectrum::octave(i)] ;
+	ref_ptr<ReceiverExt> receiver = new ReceiverExt (4.0) ;
+	/*
+	 * roads and receivers at the height of the sources and receivers above the (flat) ground
+	 */
+	unsigned int seed = 5 ;
+	std::vector< std::vector<Position> > roads (6) ;
+	for (unsigned int k = 0 ; k < roads.size() ; ++k)
+	{
+		double x = 4500 + 1000 * random_value (seed) ;
+		double y = 4500 + 1000 * random_value (seed) ;
+		double a = 2 * 3.1415926 * random_value (seed) ;
+		roads[k].push_back (Position (x, y, source.sourceHeight)) ;
+		for (unsigned int i = 0 ; i < 10 ; ++i)
+		{
+			double l = 50 + 100 * random_value (seed) ;
+			a += 0.6 * (random_value (seed) - 0.5) ;
+			x += l * cos (a) ;
+			y += l * sin (a) ;
+			roads[k].push_back (Position (x, y, source.sourceHeight)) ;
+		}
+	}
+	std::vector<Position> receivers (scaled (10, 50)) ;
+	for (unsigned int k = 0 ; k < receivers.size() ; ++k)
+	{
+		receivers[k] = Position (4500 + 1000 * random_value (seed), 4500 + 1000 * random_value (seed), receiver->h) ;
+	}
+
+	ref_ptr<CalculationMethod> method = getCalculationMethod ("CNOSSOS-2018") ;
+	PropagationPathOptions pathOptions ;
+	method->setOptions (pathOptions) ;
+
+	const char* names[9] = { "reference 1m", "fixed 10m", "fixed 50m", "fixed 2deg", "fixed 5deg",
+							 "adaptive 0.01dB", "adaptive 0.1dB", "adaptive 0.5dB", "0.1dB + 5deg" } ;
+	LineSplitOptions options[9] ;
+	for (int test = 0 ; test < 9 ; ++test)
+	{
+		options[test].Tolerance = 0 ;
+		options[test].MinLength = 0.5 ;
+	}
+	options[0].MaxLength = 1.0 ;
+	options[1].MaxLength = 10.0 ;
+	options[2].MaxLength = 50.0 ;
+	options[3].MaxAngle = 2.0 ;
+	options[4].MaxAngle = 5.0 ;
+	options[5].Tolerance = 0.01 ;
+	options[6].Tolerance = 0.1 ;
+	options[7].Tolerance = 0.5 ;
+	options[8].Tolerance = 0.1 ;
+	options[8].MaxAngle = 5.0 ;
+
+	std::vector<double> Lref (receivers.size()) ;
+	unsigned int nb_paths_10m = 0 ;
+	for (int test = 0 ; test < 9 ; ++test)
+	{
+		SystemClock clock ;
+		unsigned int nb_paths = 0 ;
+		double max_error = 0 ;
+		double sum_error = 0 ;
+		for (unsigned int k = 0 ; k < receivers.size() ; ++k)
+		{
+			double L = get_road_level (method, index, roads, source, receiver, receivers[k], options[test], nb_paths) ;
+			if (test == 0) Lref[k] = L ;
+			max_error = std::max (max_error, fabs (L - Lref[k])) ;
+			sum_error += fabs (L - Lref[k]) ;
+		}
+		double t = clock.get() ;
+		report ("%-16s %7.1f paths/receiver, %8.2f ms/receiver, error max %.3f dB, mean %.3f dB", names[test],
+				(double) nb_paths / receivers.size(), t * 1000 / receivers.size(), max_error, sum_error / receivers.size()) ;
+		check (nb_paths > 0, "%s : no path calculated", names[test]) ;
+		if (test == 1) nb_paths_10m = nb_paths ;
+		if (options[test].Tolerance > 0)
+		{
+			check (max_error <= options[test].Tolerance, "%s : levels differ by %.3f dB", names[test], max_error) ;
+			check (nb_paths < nb_paths_10m, "%s : more paths than the subdivision in pieces of 10m", names[test]) ;
+		}
+	}
+}
@@ -0,0 +1,460 @@
+/*
+ * ------------------------------------------------------------------------------------------------
+ * file:		BenchNoiseMap.cpp
+ * version:		1.0
+ * author:		dirk.van-maercke@cstb.fr
+ * copyright:	see file licence.EU.txt
+ * description: checks and benchmarks of the noise map engine
+ * changes:
+ *
+ *	18/10/2026	initial version
+ * -------------------------------------------------------------------------------------------------
+ */
+#include "TestCnossosBench.h"
+#include "NoiseMap.h"
+#include "TerrainModel.h"
+#include "CalculationMethod.h"
+#include <stdio.h>
+#include <math.h>
+#include <algorithm>
+
+using namespace CnossosEU ;
+using namespace System ;
+
+static bool same_file_contents (const char* file1, const char* file2)
+{
+	FILE* fp1 = fopen (file1, "rb") ;
+	FILE* fp2 = fopen (file2, "rb") ;
+	bool same = (fp1 != 0 && fp2 != 0) ;
+	while (same)
+	{
+		int c1 = fgetc (fp1) ;
+		int c2 = fgetc (fp2) ;
+		same = (c1 == c2) ;
+		if (c1 == EOF) break ;
+	}
+	if (fp1) fclose (fp1) ;
+	if (fp2) fclose (fp2) ;
+	return same ;
+}
+/*
+ * maximum (and optionally mean) absolute difference between the levels in two ESRI ASCII grids of
+ * the same size
+ */
+static double max_difference (const char* file1, const char* file2, double* mean = 0)
+{
+	FILE* fp1 = fopen (file1, "rt") ;
+	FILE* fp2 = fopen (file2, "rt") ;
+	double dmax = (fp1 != 0 && fp2 != 0) ? 0.0 : HUGE_VAL ;
+	char line[256] ;
+	for (int i = 0 ; i < 6 && fp1 && fp2 ; ++i)
+	{
+		if (fgets (line, sizeof(line), fp1) == 0 || fgets (line, sizeof(line), fp2) == 0) break ;
+	}
+	double v1, v2, sum = 0 ;
+	unsigned int n = 0 ;
+	while (fp1 && fp2 && fscanf (fp1, "%lf", &v1) == 1 && fscanf (fp2, "%lf", &v2) == 1)
+	{
+		dmax = std::max (dmax, fabs (v1 - v2)) ;
+		sum += fabs (v1 - v2) ;
+		n++ ;
+	}
+	if (fp1) fclose (fp1) ;
+	if (fp2) fclose (fp2) ;
+	if (mean) *mean = (n > 0) ? sum / n : 0.0 ;
+	return dmax ;
+}
+/*
+ * grid of receivers (1 km x 1 km) in the center of the synthetic city, with 80 road segments of 20m
+ * and 20 industrial point sources, on flat ground. The map is calculated with 1 and 2 threads, both
+ * results must be identical. With the culling of weak contributions, the levels must stay within
+ * the tolerance (plus the rounding of the output file).
+ */
+void test_noise_map (void)
+{
+	ObstacleIndex index ;
+	std::vector<Polygon2D> obstacles ;
+	create_synthetic_city (index, obstacles) ;
+	index.build() ;
+
+	NoiseMapGrid grid ;
+	grid.nx = scaled (10, 50) ;
+	grid.ny = grid.nx ;
+	grid.step = 1000. / grid.nx ;
+	grid.x0 = 4500 + grid.step / 2 ;
+	grid.y0 = 4500 + grid.step / 2 ;
+	grid.height = 4.0 ;
+	NoiseMap map (grid) ;
+	map.setObstacles (&index) ;
+
+	unsigned int seed = 3 ;
+	double road[8] = { 80, 85, 88, 92, 95, 92, 86, 78 } ;
+	double industry[8] = { 95, 98, 100, 100, 98, 95, 90, 85 } ;
+	ElementarySource source ;
+	source.measurementType = MeasurementType::HemiSpherical ;
+	source.frequencyWeighting = FrequencyWeighting::dBLIN ;
+	for (unsigned int k = 0 ; k < 100 ; ++k)
+	{
+		double x = 3500 + 3000 * random_value (seed) ;
+		double y = 3500 + 3000 * random_value (seed) ;
+		if (k < 80)
+		{
+			double a = 2 * 3.1415926 * random_value (seed) ;
+			source.sourceHeight = 0.05 ;
+			source.spectrumType = SpectrumType::LineSource ;
+			for (unsigned int i = 0 ; i < source.soundPower.size() ; ++i) source.soundPower[i] = road[Spectrum::octave(i)] ;
+			ref_ptr<LineSegment> segment = new LineSegment (Position (x, y, 0), Position (x + 20 * cos (a), y + 20 * sin (a), 0)) ;
+			map.addSource (Position (x, y, 0), source, segment) ;
+		}
+		else
+		{
+			source.sourceHeight = 5.0 ;
+			source.spectrumType = SpectrumType::PointSource ;
+			for (unsigned int i = 0 ; i < source.soundPower.size() ; ++i) source.soundPower[i] = industry[Spectrum::octave(i)] ;
+			map.addSource (Position (x, y, 0), source) ;
+		}
+	}
+
+	NoiseMapOptions options ;
+	options.Method = "CNOSSOS-2018" ;
+	options.MaxDistance = 1000 ;
+	const char* fileName[2] = { "bench_noise_map_1.asc", "bench_noise_map_2.asc" } ;
+	double nb_pairs = (double) grid.nx * grid.ny * map.getNbSources() ;
+	double t_ref = 0 ;
+	for (unsigned int test = 0 ; test < 2 ; ++test)
+	{
+		options.NbThreads = test + 1 ;
+		bool ok = map.calculate (options, fileName[test]) ;
+		double t = map.getElapsedTime() ;
+		if (test == 0) t_ref = t ;
+		report ("%d x %d receivers, %d sources, %d thread(s) : %.0f paths, %.0f failed, %.3fs, %.0f receivers.sources/s, %.1f us/path",
+				grid.nx, grid.ny, map.getNbSources(), options.NbThreads, map.getNbPaths(), map.getNbFailures(), t,
+				nb_pairs / t, t * 1.E6 / map.getNbPaths()) ;
+		check (ok && map.getNbPaths() > 0, "no map calculated with %d thread(s)", options.NbThreads) ;
+	}
+	check (same_file_contents (fileName[0], fileName[1]), "results with 1 and 2 threads differ") ;
+	remove (fileName[1]) ;
+	/*
+	 * culling of weak contributions
+	 */
+	double tolerance[3] = { 0.01, 0.1, 1.0 } ;
+	options.NbThreads = 1 ;
+	for (unsigned int test = 0 ; test < 3 ; ++test)
+	{
+		options.Tolerance = tolerance[test] ;
+		map.calculate (options, fileName[1]) ;
+		double t = map.getElapsedTime() ;
+		double dmax = max_difference (fileName[0], fileName[1]) ;
+		report ("tolerance %.2f dB: %.0f paths, %.0f skipped, %.3fs (x%.1f), max. difference %.2f dB",
+				options.Tolerance, map.getNbPaths(), map.getNbSkipped(), t, t_ref / t, dmax) ;
+		check (dmax <= options.Tolerance + 0.01 + 1.E-9, "tolerance %.2f dB : levels differ by %.2f dB", options.Tolerance, dmax) ;
+	}
+	remove (fileName[0]) ;
+	remove (fileName[1]) ;
+}
+/*
+ * upper bounds of the noise levels against the levels calculated for random source and receiver 
+ * positions in random scenes (hilly terrain with random ground types, barriers and buildings), with 
+ * all calculation methods and random source types. The bounds are strict for ISO-9613-2 and JRC-2012 
+ * and rely on an empirical maximum gain of the excess attenuation for the other methods (see 
+ * CalculationMethod::getMaxExcessGain) ; a level above the bound is reported as a failure in both
+ * cases.
+ */
+void test_upper_bounds (void)
+{
+	const char* methods[4] = { "ISO-9613-2", "JRC-2012", "CNOSSOS-2018", "JRC-draft-2010" } ;
+	const unsigned int nb_scenes = scaled (5, 20) ;
+	const unsigned int nb_pairs = scaled (50, 200) ;
+	const unsigned int n = 201 ;
+	const double cell = 10.0 ;
+	unsigned int seed = 11 ;
+	ref_ptr<ReceiverExt> receiver = new ReceiverExt (4.0) ;
+	for (unsigned int m = 0 ; m < 4 ; ++m)
+	{
+		ref_ptr<CalculationMethod> method = getCalculationMethod (methods[m]) ;
+		PropagationPathOptions pathOptions ;
+		method->setOptions (pathOptions) ;
+		unsigned int nb_tried = 0 ;
+		unsigned int nb_paths = 0 ;
+		unsigned int nb_errors = 0 ;
+		double max_excess = -HUGE_VAL ;
+		double sum_margin = 0 ;
+		SystemClock clock ;
+		double t_bounds = 0 ;
+		for (unsigned int scene = 0 ; scene < nb_scenes ; ++scene)
+		{
+			/*
+			 * terrain of 2km x 2km, hills of up to 50m and patches of random ground types
+			 */
+			double amp = 50 * random_value (seed) ;
+			double fx = 100 + 500 * random_value (seed) ;
+			double fy = 100 + 500 * random_value (seed) ;
+			std::vector<float> z (n * n) ;
+			std::vector<unsigned char> g (n * n) ;
+			for (unsigned int j = 0 ; j < n ; ++j)
+			{
+				for (unsigned int i = 0 ; i < n ; ++i)
+				{
+					z[j * n + i] = (float) std::max (amp * sin (i * cell / fx) * cos (j * cell / fy), 0.0) ;
+					g[j * n + i] = (unsigned char) ((i / 20 + 3 * (j / 20) + scene) % 8) ;
+				}
+			}
+			TerrainModel terrain (0.0, 0.0, cell, n, n) ;
+			terrain.setElevation (&z[0]) ;
+			terrain.setGroundClass (&g[0]) ;
+			/*
+			 * 200 barriers and buildings
+			 */
+			ObstacleIndex index ;
+			for (unsigned int k = 0 ; k < 200 ; ++k)
+			{
+				double xc = 100 + 1800 * random_value (seed) ;
+				double yc = 100 + 1800 * random_value (seed) ;
+				double w = 5 + 30 * random_value (seed) ;
+				double a = 3.1415926 * random_value (seed) ;
+				double h = 1 + 20 * random_value (seed) ;
+				Polygon2D pos ;
+				pos.push_back (Geometry::Point2D (xc, yc)) ;
+				pos.push_back (Geometry::Point2D (xc + w * cos (a), yc + w * sin (a))) ;
+				if (k % 2 == 0)
+				{
+					pos.push_back (Geometry::Point2D (xc + w * cos (a) - w * sin (a), yc + w * sin (a) + w * cos (a))) ;
+					pos.push_back (Geometry::Point2D (xc - w * sin (a), yc + w * cos (a))) ;
+					index.addBuilding (pos, h) ;
+				}
+				else
+				{
+					index.addBarrier (pos, h) ;
+				}
+			}
+			index.build() ;
+
+			for (unsigned int k = 0 ; k < nb_pairs ; ++k)
+			{
+				ElementarySource source ;
+				source.sourceHeight = 0.05 + 10 * random_value (seed) ;
+				source.measurementType = (random_value (seed) < 0.5) ? MeasurementType::FreeField : MeasurementType::HemiSpherical ;
+				source.frequencyWeighting = (random_value (seed) < 0.5) ? FrequencyWeighting::dBA : FrequencyWeighting::dBLIN ;
+				for (unsigned int i = 0 ; i < source.soundPower.size() ; ++i) source.soundPower[i] = 70 + 30 * random_value (seed) ;
+				Geometry::Point2D src (50 + 1900 * random_value (seed), 50 + 1900 * random_value (seed)) ;
+				Geometry::Point2D rec (50 + 1900 * random_value (seed), 50 + 1900 * random_value (seed)) ;
+				ref_ptr<SourceExt> ext ;
+				if (random_value (seed) < 0.5)
+				{
+					source.spectrumType = SpectrumType::PointSource ;
+					ext = new SourceExt (source, new PointSource()) ;
+				}
+				else
+				{
+					source.spectrumType = SpectrumType::LineSource ;
+					double zs = terrain.getElevation (src.x, src.y) ;
+					ext = new SourceExt (source, new LineSegment (Position (src.x - 1, src.y - 10, zs), Position (src.x + 1, src.y + 10, zs))) ;
+				}
+				ext->h = source.sourceHeight ;
+
+				nb_tried++ ;
+				PropagationPath path ;
+				PathResult result ;
+				Spectrum Lmax ;
+				terrain.getProfile (src.x, src.y, rec.x, rec.y, path) ;
+				index.insertObstacles (path) ;
+				path[0].ext = ext ;
+				path[path.size()-1].ext = receiver ;
+				try
+				{
+					if (!method->doCalculation (path, result)) continue ;
+				}
+				catch (std::exception&)
+				{
+					continue ;
+				}
+				clock.get (true) ;
+				bool ok = method->getUpperBound (ext, path[0].pos, receiver, path[path.size()-1].pos, Lmax) ;
+				t_bounds += clock.get (true) ;
+				if (!ok) continue ;
+				nb_paths++ ;
+				double excess = -HUGE_VAL ;
+				double bound = 0 ;
+				for (unsigned int i = 0 ; i < Lmax.size() ; ++i)
+				{
+					excess = std::max (excess, result.Leq[i] - Lmax[i]) ;
+					bound += POW10 (Lmax[i]) ;
+				}
+				if (excess > 1.E-6) nb_errors++ ;
+				max_excess = std::max (max_excess, excess) ;
+				sum_margin += LOG10 (bound) - result.Leq_dBA ;
+			}
+		}
+		report ("%-15s %d/%d paths, %d above the bound, max(Leq - bound) = %.2f dB, mean margin %.1f dB(A), %.1f us/bound",
+				methods[m], nb_paths, nb_tried, nb_errors, max_excess, sum_margin / nb_paths, 1.E6 * t_bounds / nb_paths) ;
+		check (nb_paths > 0, "%s : no path calculated", methods[m]) ;
+		check (nb_errors == 0, "%s : %d levels above the upper bound", methods[m], nb_errors) ;
+	}
+}
+/*
+ * line segments in the noise map: 20 roads made of segments of 200m in the center of the synthetic 
+ * city, calculated with the equivalent source at the projection of each receiver and with the 
+ * adaptive subdivision of the segments. The reference splits the segments in pieces of 1m (10m
+ * by default). With the adaptive subdivision, the mean difference must stay within the tolerance and
+ * below the one of the projection, with fewer paths than the reference ; the maximum difference is
+ * only reported, as the tolerance bounds the error of the geometrical spread, not of the screening
+ * by the buildings.
+ */
+void test_split_lines (void)
+{
+	ObstacleIndex index ;
+	std::vector<Polygon2D> obstacles ;
+	create_synthetic_city (index, obstacles) ;
+	index.build() ;
+
+	NoiseMapGrid grid ;
+	grid.nx = scaled (8, 40) ;
+	grid.ny = grid.nx ;
+	grid.step = 1000. / grid.nx ;
+	grid.x0 = 4500 + grid.step / 2 ;
+	grid.y0 = 4500 + grid.step / 2 ;
+	grid.height = 4.0 ;
+	NoiseMap map (grid) ;
+	map.setObstacles (&index) ;
+
+	unsigned int seed = 5 ;
+	double road[8] = { 80, 85, 88, 92, 95, 92, 86, 78 } ;
+	ElementarySource source ;
+	source.sourceHeight = 0.05 ;
+	source.spectrumType = SpectrumType::LineSource ;
+	source.measurementType = MeasurementType::HemiSpherical ;
+	source.frequencyWeighting = FrequencyWeighting::dBLIN ;
+	for (unsigned int i = 0 ; i < source.soundPower.size() ; ++i) source.soundPower[i] = road[Spectrum::octave(i)] ;
+	for (unsigned int k = 0 ; k < 20 ; ++k)
+	{
+		double x = 4000 + 2000 * random_value (seed) ;
+		double y = 4000 + 2000 * random_value (seed) ;
+		double a = 2 * 3.1415926 * random_value (seed) ;
+		for (unsigned int i = 0 ; i < 5 ; ++i)
+		{
+			double x2 = x + 200 * cos (a) ;
+			double y2 = y + 200 * sin (a) ;
+			ref_ptr<LineSegment> segment = new LineSegment (Position (x, y, 0), Position (x2, y2, 0)) ;
+			map.addSource (Position (x, y, 0), source, segment) ;
+			a += 0.6 * (random_value (seed) - 0.5) ;
+			x = x2 ;
+			y = y2 ;
+		}
+	}
+
+	NoiseMapOptions options ;
+	options.Method = "CNOSSOS-2018" ;
+	options.MaxDistance = 1000 ;
+	options.NbThreads = 1 ;
+	options.SplitLines = true ;
+	options.LineSplit.Tolerance = 0 ;
+	options.LineSplit.MaxLength = scaled (10, 1) ;
+	options.LineSplit.MinLength = 0.5 ;
+	const char* fileName[2] = { "bench_split_lines_ref.asc", "bench_split_lines.asc" } ;
+	bool ok = map.calculate (options, fileName[0]) ;
+	double t_ref = map.getElapsedTime() ;
+	double n_ref = map.getNbPaths() ;
+	report ("%d x %d receivers, %d segments", grid.nx, grid.ny, map.getNbSources()) ;
+	char label[32] ;
+	sprintf (label, "reference %.0fm", options.LineSplit.MaxLength) ;
+	report ("%-20s %9.0f paths, %.3fs", label, n_ref, t_ref) ;
+	check (ok && n_ref > 0, "no reference map calculated") ;
+
+	const char* names[3] = { "projection", "adaptive 0.1dB", "adaptive 0.5dB" } ;
+	double tolerance[3] = { 0.0, 0.1, 0.5 } ;
+	double mean_projection = 0 ;
+	for (unsigned int test = 0 ; test < 3 ; ++test)
+	{
+		options.SplitLines = (test > 0) ;
+		options.LineSplit = LineSplitOptions() ;
+		options.LineSplit.Tolerance = tolerance[test] ;
+		map.calculate (options, fileName[1]) ;
+		double t = map.getElapsedTime() ;
+		double mean ;
+		double dmax = max_difference (fileName[0], fileName[1], &mean) ;
+		report ("%-20s %9.0f paths, %.3fs (x%.1f), difference max %.2f dB, mean %.3f dB",
+				names[test], map.getNbPaths(), t, t_ref / t, dmax, mean) ;
+		if (!options.SplitLines)
+		{
+			mean_projection = mean ;
+			continue ;
+		}
+		check (mean <= options.LineSplit.Tolerance, "%s : mean difference %.3f dB", names[test], mean) ;
+		check (mean < mean_projection, "%s : mean difference above the one of the projection", names[test]) ;
+		check (map.getNbPaths() < n_ref, "%s : no fewer paths than the reference", names[test]) ;
+	}
+	remove (fileName[0]) ;
+	remove (fileName[1]) ;
+}
+/*
+ * accuracy versus speed of the clustering of point sources: 500 point sources (2000 with -full, 
+ * e.g. industrial equipment and elementary sources of roads) spread over 3km x 3km around a grid
+ * of receivers (1 km x 1 km) in the center of the synthetic city. The reference is calculated
+ * without clustering ; larger cluster angles must need fewer paths and, up to 10 degrees, the
+ * levels must stay within 0.1 dB of the reference.
+ */
+void test_source_clusters (void)
+{
+	ObstacleIndex index ;
+	std::vector<Polygon2D> obstacles ;
+	create_synthetic_city (index, obstacles) ;
+	index.build() ;
+
+	NoiseMapGrid grid ;
+	grid.nx = scaled (10, 25) ;
+	grid.ny = grid.nx ;
+	grid.step = 1000. / grid.nx ;
+	grid.x0 = 4500 + grid.step / 2 ;
+	grid.y0 = 4500 + grid.step / 2 ;
+	grid.height = 4.0 ;
+	NoiseMap map (grid) ;
+	map.setObstacles (&index) ;
+
+	unsigned int seed = 7 ;
+	double industry[8] = { 95, 98, 100, 100, 98, 95, 90, 85 } ;
+	ElementarySource source ;
+	source.measurementType = MeasurementType::HemiSpherical ;
+	source.frequencyWeighting = FrequencyWeighting::dBLIN ;
+	source.spectrumType = SpectrumType::PointSource ;
+	const unsigned int nb_sources = scaled (500, 2000) ;
+	for (unsigned int k = 0 ; k < nb_sources ; ++k)
+	{
+		double x = 3500 + 3000 * random_value (seed) ;
+		double y = 3500 + 3000 * random_value (seed) ;
+		double dL = -20 * random_value (seed) ;
+		source.sourceHeight = 0.5 + 4.5 * random_value (seed) ;
+		for (unsigned int i = 0 ; i < source.soundPower.size() ; ++i) source.soundPower[i] = industry[Spectrum::octave(i)] + dL ;
+		map.addSource (Position (x, y, 0), source) ;
+	}
+
+	NoiseMapOptions options ;
+	options.Method = "CNOSSOS-2018" ;
+	options.MaxDistance = 1000 ;
+	options.NbThreads = 1 ;
+	const char* fileName[2] = { "bench_clusters_ref.asc", "bench_clusters.asc" } ;
+	bool ok = map.calculate (options, fileName[0]) ;
+	double t_ref = map.getElapsedTime() ;
+	double n_ref = map.getNbPaths() ;
+	report ("%d x %d receivers, %d sources", grid.nx, grid.ny, map.getNbSources()) ;
+	report ("no clustering: %.0f paths, %.3fs", n_ref, t_ref) ;
+	check (ok && n_ref > 0, "no reference map calculated") ;
+
+	double angles[6] = { 2, 5, 10, 20, 40, 60 } ;
+	double nb_paths = n_ref ;
+	for (unsigned int test = 0 ; test < 6 ; ++test)
+	{
+		options.ClusterAngle = angles[test] ;
+		map.calculate (options, fileName[1]) ;
+		double t = map.getElapsedTime() ;
+		double mean ;
+		double dmax = max_difference (fileName[0], fileName[1], &mean) ;
+		report ("cluster angle %2.0f deg: %.0f paths (%.1f%%), %.3fs (x%.1f), difference max %.2f dB, mean %.3f dB",
+				options.ClusterAngle, map.getNbPaths(), 100 * map.getNbPaths() / n_ref, t, t_ref / t, dmax, mean) ;
+		check (map.getNbPaths() <= nb_paths, "cluster angle %.0f deg : more paths than with a smaller angle", options.ClusterAngle) ;
+		if (options.ClusterAngle <= 10) check (dmax <= 0.1, "cluster angle %.0f deg : levels differ by %.2f dB", options.ClusterAngle, dmax) ;
+		nb_paths = map.getNbPaths() ;
+	}
+	check (nb_paths < n_ref, "no paths saved by the clustering") ;
+	remove (fileName[0]) ;
+	remove (fileName[1]) ;
+}
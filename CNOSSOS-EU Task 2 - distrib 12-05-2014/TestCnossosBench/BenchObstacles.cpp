@@ -0,0 +1,172 @@
+/*
+ * ------------------------------------------------------------------------------------------------
+ * file:		BenchObstacles.cpp
+ * version:		1.0
+ * author:		dirk.van-maercke@cstb.fr
+ * copyright:	see file licence.EU.txt
+ * description: synthetic city, checks and benchmarks of the spatial index of obstacles
+ * changes:
+ *
+ *	18/10/2026	initial version
+ * -------------------------------------------------------------------------------------------------
+ */
+#include "TestCnossosBench.h"
+#include "ObstacleIndex.h"
+#include <math.h>
+
+using namespace CnossosEU ;
+
+void create_synthetic_city (ObstacleIndex& index, std::vector<Polygon2D>& obstacles)
+{
+	unsigned int seed = 7 ;
+	for (unsigned int k = 0 ; k < synthetic_city_buildings ; ++k)
+	{
+		double xc = 10000 * random_value (seed) ;
+		double yc = 10000 * random_value (seed) ;
+		double w = 8 + 22 * random_value (seed) ;
+		double l = 8 + 22 * random_value (seed) ;
+		double a = 3.1415926 * random_value (seed) ;
+		double h = 4 + 36 * random_value (seed) ;
+		double px[4] = { -w/2, w/2, w/2, -w/2 } ;
+		double py[4] = { -l/2, -l/2, l/2, l/2 } ;
+		Polygon2D footprint (4) ;
+		for (int i = 0 ; i < 4 ; ++i)
+		{
+			footprint[i] = Geometry::Point2D (xc + px[i] * cos (a) - py[i] * sin (a), yc + px[i] * sin (a) + py[i] * cos (a)) ;
+		}
+		index.addBuilding (footprint, h) ;
+		obstacles.push_back (footprint) ;
+	}
+	for (unsigned int k = 0 ; k < 1000 ; ++k)
+	{
+		Polygon2D polyline (11) ;
+		polyline[0] = Geometry::Point2D (10000 * random_value (seed), 10000 * random_value (seed)) ;
+		double a = 2 * 3.1415926 * random_value (seed) ;
+		for (int i = 1 ; i <= 10 ; ++i)
+		{
+			double l = 20 + 30 * random_value (seed) ;
+			a += 0.5 * (random_value (seed) - 0.5) ;
+			polyline[i] = Geometry::Point2D (polyline[i-1].x + l * cos (a), polyline[i-1].y + l * sin (a)) ;
+		}
+		index.addBarrier (polyline, 2 + 3 * random_value (seed)) ;
+		obstacles.push_back (polyline) ;
+	}
+}
+/*
+ * reference solution: test all edges of all obstacles (same rules as ObstacleIndex::getCrossings)
+ */
+static unsigned int count_crossings (std::vector<Polygon2D>& obstacles, unsigned int nb_buildings,
+									 Geometry::Point2D const& src, Geometry::Point2D const& rec)
+{
+	unsigned int count = 0 ;
+	Geometry::Vector2D d = rec - src ;
+	for (unsigned int k = 0 ; k < obstacles.size() ; ++k)
+	{
+		Polygon2D& pos = obstacles[k] ;
+		unsigned int n = pos.size() ;
+		unsigned int nb_edges = (k < nb_buildings) ? n : n - 1 ;
+		for (unsigned int i = 0 ; i < nb_edges ; ++i)
+		{
+			Geometry::Vector2D de = pos[(i + 1) % n] - pos[i] ;
+			double det = d ^ de ;
+			if (det == 0) continue ;
+			Geometry::Vector2D w = pos[i] - src ;
+			double t = (w ^ de) / det ;
+			double s = (w ^ d) / det ;
+			bool last = (k >= nb_buildings && i == nb_edges - 1) ;
+			if (t > 0 && t < 1 && s >= 0 && (s < 1 || (s == 1 && last))) count++ ;
+		}
+	}
+	return count ;
+}
+/*
+ * queries between random source and receiver positions, at distances between 10m and 2000m: the
+ * number of crossings must match the reference solution (on a subset of the queries), crossings
+ * must be ordered from source to receiver and insertObstacles must insert one control point per
+ * crossing
+ */
+void test_obstacle_index (void)
+{
+	ObstacleIndex index ;
+	std::vector<Polygon2D> obstacles ;
+	create_synthetic_city (index, obstacles) ;
+	SystemClock clock ;
+	index.build() ;
+	double t_build = clock.get (true) ;
+	report ("synthetic city 10km x 10km, %d obstacles, %d edges, %d cells, %.1f MB, built in %.3fs",
+			index.getNbObstacles(), index.getNbEdges(), index.getNbCells(), index.getMemoryUsage() / 1.E6, t_build) ;
+
+	const unsigned int nb_queries = scaled (10000, 1000000) ;
+	const unsigned int verify_step = scaled (100, 1000) ;
+	std::vector<ObstacleCrossing> crossings ;
+	for (int test = 0 ; test < 2 ; ++test)
+	{
+		unsigned int seed = 1 ;
+		double nb_crossings = 0 ;
+		unsigned int nb_verified = 0 ;
+		unsigned int nb_errors = 0 ;
+		unsigned int nb_unordered = 0 ;
+		double t_verify = 0 ;
+		PropagationPath path ;
+		clock.get (true) ;
+		for (unsigned int i = 0 ; i < nb_queries ; ++i)
+		{
+			double xs = 500 + 9000 * random_value (seed) ;
+			double ys = 500 + 9000 * random_value (seed) ;
+			double d = 10 + 1990 * random_value (seed) ;
+			double a = 2 * 3.1415926 * random_value (seed) ;
+			Geometry::Point2D src (xs, ys) ;
+			Geometry::Point2D rec (xs + d * cos (a), ys + d * sin (a)) ;
+			if (test == 0)
+			{
+				nb_crossings += index.getCrossings (src, rec, crossings) ;
+				/*
+				 * verify a subset of the queries (not included in the timing)
+				 */
+				if (i % verify_step == 0)
+				{
+					SystemClock verify ;
+					if (count_crossings (obstacles, synthetic_city_buildings, src, rec) != crossings.size()) nb_errors++ ;
+					for (unsigned int k = 1 ; k < crossings.size() ; ++k)
+					{
+						if (crossings[k].t < crossings[k-1].t) nb_unordered++ ;
+					}
+					nb_verified++ ;
+					t_verify += verify.get() ;
+				}
+			}
+			else
+			{
+				/*
+				 * construct a path on flat ground and insert the diffraction points
+				 */
+				path.resize (2) ;
+				path[0].pos = Position (src.x, src.y, 0.0) ;
+				path[1].pos = Position (rec.x, rec.y, 0.0) ;
+				unsigned int nb_inserted = index.insertObstacles (path) ;
+				nb_crossings += nb_inserted ;
+				if (i % verify_step == 0)
+				{
+					SystemClock verify ;
+					if (nb_inserted != index.getCrossings (src, rec, crossings) || path.size() != nb_inserted + 2) nb_errors++ ;
+					nb_verified++ ;
+					t_verify += verify.get() ;
+				}
+			}
+		}
+		double t = clock.get() - t_verify ;
+		if (test == 0)
+		{
+			report_time ("getCrossings", t, nb_queries, "query") ;
+			report ("  %.1f crossings/query, reference %.0f us/query, %d differences in %d queries",
+					nb_crossings / nb_queries, t_verify * 1.E6 / nb_verified, nb_errors, nb_verified) ;
+			check (nb_errors == 0, "getCrossings : %d queries differ from the reference solution", nb_errors) ;
+			check (nb_unordered == 0, "getCrossings : %d crossings not ordered from source to receiver", nb_unordered) ;
+		}
+		else
+		{
+			report_time ("insertObstacles", t, nb_queries) ;
+			check (nb_errors == 0, "insertObstacles : %d paths differ from getCrossings", nb_errors) ;
+		}
+	}
+}
@@ -0,0 +1,120 @@
+/*
+ * ------------------------------------------------------------------------------------------------
+ * file:		BenchPathBatch.cpp
+ * version:		1.0
+ * author:		dirk.van-maercke@cstb.fr
+ * copyright:	see file licence.EU.txt
+ * description: checks and benchmarks of the binary batch files
+ * changes:
+ *
+ *	18/10/2026	initial version
+ * -------------------------------------------------------------------------------------------------
+ */
+#include "TestCnossosBench.h"
+#include "PathBatch.h"
+#include "Material.h"
+#include <stdio.h>
+
+using namespace CnossosEU ;
+using namespace System ;
+/*
+ * the files of the data corpus are written to a batch file, each file with its own materials ;
+ * paths read from the batch file and paths converted back to XML must give the same results as
+ * the original files. The throughput of the XML parser is compared with the throughput of the
+ * batch reader.
+ */
+void test_path_batch (void)
+{
+	const char* batchFile = "bench_path_batch.batch" ;
+	const char* xmlFile = "bench_path_batch.xml" ;
+	const unsigned int nb_repeat_xml = scaled (2, 20) ;
+	const unsigned int nb_repeat_batch = scaled (20, 2000) ;
+	std::vector<std::string> const& files = data_files() ;
+	/*
+	 * parse the XML files, write the batch file and calculate the reference results
+	 */
+	PathBatchWriter writer ;
+	if (!check (writer.open (batchFile), "cannot create %s", batchFile)) return ;
+	std::vector<PathResult> reference ;
+	std::vector<bool> valid ;
+	double xml_time = 0 ;
+	double xml_size = 0 ;
+	for (unsigned int repeat = 0 ; repeat < nb_repeat_xml ; ++repeat)
+	{
+		for (unsigned int i = 0 ; i < files.size() ; ++i)
+		{
+			MaterialSnapshot materials ;
+			PropagationPath path ;
+			PropagationPathOptions options ;
+			SystemClock clock ;
+			bool ok = parse_xml_path (files[i].c_str(), path, options) ;
+			xml_time += clock.get() ;
+			ref_ptr<CalculationMethod> method = options.method ;
+			if (repeat > 0 || !ok) continue ;
+
+			xml_size += get_file_size (files[i].c_str()) ;
+			check (writer.write (path, options), "%s : write error", files[i].c_str()) ;
+			PathResult result ;
+			valid.push_back (calculate_path (path, options, result)) ;
+			reference.push_back (result) ;
+		}
+	}
+	check (writer.close(), "%s : write error", batchFile) ;
+	unsigned int nb_paths = reference.size() ;
+	if (!check (nb_paths > 0, "no input file")) return ;
+	/*
+	 * decode all paths into the same path object
+	 */
+	PathBatchReader reader ;
+	PropagationPath path ;
+	PropagationPathOptions options ;
+	SystemClock clock ;
+	bool ok = reader.open (batchFile) ;
+	double open_time = clock.get (true) ;
+	if (!check (ok && reader.getNbPaths() == nb_paths, "%s : invalid batch file", batchFile)) return ;
+	unsigned int nb_errors = 0 ;
+	for (unsigned int repeat = 0 ; repeat < nb_repeat_batch ; ++repeat)
+	{
+		for (unsigned int k = 0 ; k < reader.getNbPaths() ; ++k)
+		{
+			if (!reader.read (k, path, &options)) nb_errors++ ;
+		}
+	}
+	double batch_time = clock.get() ;
+	reader.close() ;
+	check (nb_errors == 0, "%d paths not read from the batch file", nb_errors) ;
+	/*
+	 * check the results, for paths read from the batch file and for paths converted back to XML
+	 */
+	unsigned int nb_valid = 0 ;
+	unsigned int nb_same_batch = 0 ;
+	unsigned int nb_same_xml = 0 ;
+	reader.open (batchFile) ;
+	for (unsigned int k = 0 ; k < nb_paths ; ++k)
+	{
+		if (!valid[k]) continue ;
+		nb_valid++ ;
+		PathResult result ;
+		if (reader.read (k, path, &options) && calculate_path (path, options, result) &&
+			same_results (result, reference[k])) nb_same_batch++ ;
+
+		MaterialSnapshot materials ;
+		PropagationPath copy ;
+		PropagationPathOptions copyOptions ;
+		bool ok = reader.exportXML (k, xmlFile) && parse_xml_path (xmlFile, copy, copyOptions) ;
+		ref_ptr<CalculationMethod> method = copyOptions.method ;
+		if (ok && calculate_path (copy, copyOptions, result) && same_results (result, reference[k])) nb_same_xml++ ;
+		remove (xmlFile) ;
+	}
+	reader.close() ;
+	double batch_size = get_file_size (batchFile) ;
+	remove (batchFile) ;
+
+	report ("%d paths, %d files", nb_paths, (int) files.size()) ;
+	report ("XML files   : %9.0f bytes, %8.3f us/path", xml_size, xml_time * 1e6 / (nb_paths * nb_repeat_xml)) ;
+	report ("batch file  : %9.0f bytes, %8.3f us/path (%.3f ms to open the file)", batch_size,
+			batch_time * 1e6 / (nb_paths * nb_repeat_batch), open_time * 1000) ;
+	report ("identical results: %d / %d (batch), %d / %d (batch to XML)", nb_same_batch, nb_valid, nb_same_xml, nb_valid) ;
+	check (nb_same_batch == nb_valid, "%d paths read from the batch file give different results", nb_valid - nb_same_batch) ;
+	check (nb_same_xml == nb_valid, "%d paths converted back to XML give different results", nb_valid - nb_same_xml) ;
+}
@@ -0,0 +1,157 @@
+/*
+ * ------------------------------------------------------------------------------------------------
+ * file:		BenchPathStream.cpp
+ * version:		1.0
+ * author:		dirk.van-maercke@cstb.fr
+ * copyright:	see file licence.EU.txt
+ * description: checks and benchmarks of the streaming parser of files containing multiple paths
+ * changes:
+ *
+ *	18/10/2026	initial version
+ * -------------------------------------------------------------------------------------------------
+ */
+#include "TestCnossosBench.h"
+#include "CalculationMethod.h"
+#include <stdio.h>
+#include <math.h>
+#include <algorithm>
+
+using namespace CnossosEU ;
+using namespace System ;
+/*
+ * random path over uneven ground, with a barrier in one path out of three
+ */
+static void print_random_path (FILE* fp, unsigned int& seed)
+{
+	static const char* ground[4] = { "H", "D", "F", "G" } ;
+	double d = 20 + 480 * random_value (seed) ;
+	unsigned int n = 2 + (unsigned int) (4 * random_value (seed)) ;
+	bool barrier = random_value (seed) < 0.33 ;
+	fprintf (fp, "\t<path>\n") ;
+	for (unsigned int i = 0 ; i <= n ; ++i)
+	{
+		double z = (i == 0) ? 0.0 : 2 * random_value (seed) ;
+		fprintf (fp, "\t\t<cp>\n") ;
+		fprintf (fp, "\t\t\t<pos> <x> %.3f </x> <y> 0.00 </y> <z> %.4f </z> </pos>\n", d * i / n, z) ;
+		fprintf (fp, "\t\t\t<mat id=\"%s\" />\n", ground[(unsigned int) (4 * random_value (seed))]) ;
+		if (i == 0)
+		{
+			fprintf (fp, "\t\t\t<ext>\n\t\t\t\t<source>\n\t\t\t\t\t<h> 0.50 </h>\n") ;
+			fprintf (fp, "\t\t\t\t\t<Lw sourceType=\"PointSource\" measurementType=\"HemiSpherical\" frequencyWeighting=\"LIN\">") ;
+			fprintf (fp, " 80.0 90.0 95.0 100.0 100.0 100.0 95.0 90.0 </Lw>\n") ;
+			fprintf (fp, "\t\t\t\t</source>\n\t\t\t</ext>\n") ;
+		}
+		else if (i == n)
+		{
+			fprintf (fp, "\t\t\t<ext>\n\t\t\t\t<receiver> <h> 4.00 </h> </receiver>\n\t\t\t</ext>\n") ;
+		}
+		else if (i == 1 && barrier)
+		{
+			fprintf (fp, "\t\t\t<ext>\n\t\t\t\t<barrier> <h> %.2f </h> <mat id=\"A0\" /> </barrier>\n\t\t\t</ext>\n",
+					 1 + 3 * random_value (seed)) ;
+		}
+		fprintf (fp, "\t\t</cp>\n") ;
+	}
+	fprintf (fp, "\t</path>\n") ;
+}
+/*
+ * generated document of 8 MB (1 GB with -full) containing random paths, with a <method> element
+ * every 100 paths: all paths must be read by the streaming parser, the first one with the same
+ * results as the same path in a single path document, and the resident memory must not grow with
+ * the size of the document while it is parsed (only checked on Linux). The streaming parser is compared with the
+ * parsing of single path documents.
+ */
+void test_path_stream (void)
+{
+	const char* fileName = "bench_path_stream.xml" ;
+	const char* singleFile = "bench_path_single.xml" ;
+	const double size = scaled (8, 1024) ;
+	/*
+	 * generate the documents
+	 */
+	unsigned int seed = 1 ;
+	FILE* fp = fopen (singleFile, "wt") ;
+	if (!check (fp != 0, "cannot create %s", singleFile)) return ;
+	fprintf (fp, "<?xml version=\"1.0\" encoding=\"UTF-8\" ?>\n<CNOSSOS-EU>\n") ;
+	fprintf (fp, "\t<method> <select id=\"CNOSSOS-2018\" /> </method>\n") ;
+	print_random_path (fp, seed) ;
+	fprintf (fp, "</CNOSSOS-EU>\n") ;
+	fclose (fp) ;
+
+	SystemClock clock ;
+	fp = fopen (fileName, "wt") ;
+	if (!check (fp != 0, "cannot create %s", fileName)) return ;
+	fprintf (fp, "<?xml version=\"1.0\" encoding=\"UTF-8\" ?>\n<CNOSSOS-EU>\n") ;
+	fprintf (fp, "\t<materials> <mat id=\"H\"> <G> 0.0 </G> </mat> </materials>\n") ;
+	seed = 1 ;
+	unsigned int nb_paths = 0 ;
+	while (ftell (fp) < size * 1024 * 1024)
+	{
+		if (nb_paths % 100 == 0) fprintf (fp, "\t<method> <select id=\"CNOSSOS-2018\" /> </method>\n") ;
+		print_random_path (fp, seed) ;
+		nb_paths++ ;
+	}
+	fprintf (fp, "</CNOSSOS-EU>\n") ;
+	double file_size = ftell (fp) / (1024. * 1024.) ;
+	fclose (fp) ;
+	report ("generated %d paths, %.1f MB in %.1f s", nb_paths, file_size, clock.get()) ;
+	/*
+	 * single path documents
+	 */
+	const unsigned int nb_single = scaled (1000, 10000) ;
+	PropagationPath path ;
+	PropagationPathOptions options ;
+	PathResult single ;
+	clock.reset() ;
+	for (unsigned int i = 0 ; i < nb_single ; ++i)
+	{
+		XMLFileLoader xmlFile ;
+		xmlFile.ParseFile (singleFile) ;
+		ParsePathFromFile (xmlFile.GetRoot(), path, options) ;
+		ref_ptr<CalculationMethod> method = options.method ;
+		options.method = 0 ;
+	}
+	report_time ("single path document (DOM)", clock.get(), nb_single) ;
+	check (parse_xml_path (singleFile, path, options), "%s : parse error", singleFile) ;
+	ref_ptr<CalculationMethod> singleMethod = options.method ;
+	bool single_ok = calculate_path (path, options, single) ;
+	/*
+	 * parse only, then parse and calculate, sampling the resident memory every 1000 paths
+	 */
+	double resident = get_resident_memory() ;
+	double max_resident = resident ;
+	for (int test = 0 ; test < 2 ; ++test)
+	{
+		XMLPathStream stream ;
+		PathResult result ;
+		double energy = 0 ;
+		unsigned int nb_failed = 0 ;
+		clock.reset() ;
+		stream.Open (fileName) ;
+		while (stream.ReadPath (path, options))
+		{
+			if (stream.GetNbPaths() % 1000 == 0) max_resident = std::max (max_resident, get_resident_memory()) ;
+			if (test == 0) continue ;
+			if (!calculate_path (path, options, result))
+			{
+				nb_failed++ ;
+				continue ;
+			}
+			if (stream.GetNbPaths() == 1) check (single_ok && same_results (result, single), "first path : results differ from the single path document") ;
+			energy += pow (10., result.Leq_dBA / 10) ;
+		}
+		stream.Close() ;
+		double t = clock.get() ;
+		const char* label = (test == 0) ? "stream (parse)" : "stream (parse + calculate)" ;
+		report ("%-28s: %8.2f us/path, %7.1f MB/s, %d paths", label, t * 1e6 / stream.GetNbPaths(),
+				file_size / t, stream.GetNbPaths()) ;
+		if (test == 1) report ("  total %.2f dB(A), %d paths not calculated", 10 * log10 (energy), nb_failed) ;
+		check (stream.GetNbPaths() == nb_paths, "%s : %d of %d paths read", label, stream.GetNbPaths(), nb_paths) ;
+		check (nb_failed == 0, "%s : %d paths not calculated", label, nb_failed) ;
+	}
+	double growth = max_resident - resident ;
+	report ("resident memory %.1f MB before parsing, at most %.1f MB while parsing", resident, max_resident) ;
+	check (growth < 0.25 * file_size, "resident memory grows by %.1f MB while streaming %.1f MB", growth, file_size) ;
+	remove (fileName) ;
+	remove (singleFile) ;
+}
@@ -0,0 +1,199 @@
+/*
+ * ------------------------------------------------------------------------------------------------
+ * file:		BenchPipeline.cpp
+ * version:		1.0
+ * author:		dirk.van-maercke@cstb.fr
+ * copyright:	see file licence.EU.txt
+ * description: checks and benchmarks of the calculation pipeline and of the reference counting of
+ *				the objects owned by the propagation paths
+ * changes:
+ *
+ *	18/10/2026	initial version
+ * -------------------------------------------------------------------------------------------------
+ */
+#include "TestCnossosBench.h"
+#include "CalculationMethod.h"
+
+using namespace CnossosEU ;
+using namespace System ;
+/*
+ * the statically dispatched pipeline (see StaticPipeline.h) against the virtual pipeline: results
+ * must be bit-identical for all methods and all files in the data corpus. Both pipelines are timed
+ * on the same paths.
+ */
+void test_pipeline (void)
+{
+	const char* methods[] = { "ISO-9613-2", "JRC-2012", "CNOSSOS-2018", "JRC-draft-2010" } ;
+	std::vector<std::string> const& files = data_files() ;
+	unsigned int nb_loops = scaled (2, 100) ;
+	report ("%d files, %d bands, %d loops per file", (int) files.size(), (int) Spectrum::nbFreq, nb_loops) ;
+	report ("%-20s %10s %10s", "", "virtual", "static") ;
+	for (unsigned int m = 0 ; m < sizeof(methods) / sizeof(methods[0]) ; ++m)
+	{
+		SetStaticPipeline (false) ;
+		ref_ptr<CalculationMethod> virtual_method = getCalculationMethod (methods[m]) ;
+		SetStaticPipeline (true) ;
+		ref_ptr<CalculationMethod> static_method = getCalculationMethod (methods[m]) ;
+		SetStaticPipeline (false) ;
+
+		unsigned int nb_paths = 0 ;
+		unsigned int nb_diffs = 0 ;
+		double t_virtual = 0 ;
+		double t_static = 0 ;
+		for (unsigned int i = 0 ; i < files.size() ; ++i)
+		{
+			PropagationPath path ;
+			PropagationPathOptions options ;
+			if (!parse_xml_path (files[i].c_str(), path, options)) continue ;
+			ref_ptr<CalculationMethod> fileMethod = options.method ;
+
+			PathResult r1, r2 ;
+			options.method = virtual_method ;
+			bool ok1 = calculate_path (path, options, r1) ;
+			options.method = static_method ;
+			bool ok2 = calculate_path (path, options, r2) ;
+			if (ok1 != ok2 || (ok1 && !same_results (r1, r2)))
+			{
+				check (false, "%s, %s : results differ", methods[m], files[i].c_str()) ;
+				nb_diffs++ ;
+			}
+			if (!ok1) continue ;
+			nb_paths++ ;
+
+			SystemClock clock ;
+			for (unsigned int k = 0 ; k < nb_loops ; ++k) virtual_method->doCalculation (path, r1) ;
+			t_virtual += clock.get (true) ;
+			for (unsigned int k = 0 ; k < nb_loops ; ++k) static_method->doCalculation (path, r2) ;
+			t_static += clock.get (true) ;
+		}
+		report ("%-20s %10.3f %10.3f us/path, %d paths, %d differences", methods[m],
+				1.E6 * t_virtual / (nb_paths * nb_loops), 1.E6 * t_static / (nb_paths * nb_loops), nb_paths, nb_diffs) ;
+		check (nb_paths > 0, "%s : no path calculated", methods[m]) ;
+	}
+}
+/*
+ * select atomic or non-atomic reference counting for the extensions and source geometries of a path
+ * (the copies of the path inherit this setting)
+ */
+static void setThreadLocal (PropagationPath& path, bool on_off)
+{
+	for (unsigned int i = 0 ; i < path.size() ; ++i)
+	{
+		if (!path[i].ext) continue ;
+		path[i].ext->setThreadLocal (on_off) ;
+		SourceExt* source = path[i].ext.cast_to_ptr<SourceExt>() ;
+		if (source && source->geo) source->geo->setThreadLocal (on_off) ;
+	}
+}
+/*
+ * number of objects owned by the path using the given reference counting mode
+ */
+static unsigned int countThreadLocal (PropagationPath& path, bool on_off)
+{
+	unsigned int count = 0 ;
+	for (unsigned int i = 0 ; i < path.size() ; ++i)
+	{
+		if (!path[i].ext) continue ;
+		if (path[i].ext->isThreadLocal() == on_off) count++ ;
+		SourceExt* source = path[i].ext.cast_to_ptr<SourceExt>() ;
+		if (source && source->geo && source->geo->isThreadLocal() == on_off) count++ ;
+	}
+	return count ;
+}
+/*
+ * the extensions and source geometries of a path use non-atomic reference counting by default, the
+ * materials, which are shared with the global catalogue, use atomic reference counting ; copies of
+ * the path inherit the mode of the original and the results do not depend on the mode. 
+ * The construction, copying and analysis of the path with the most control points in the data 
+ * corpus are timed with atomic and non-atomic reference counting.
+ */
+void test_reference_counting (void)
+{
+	std::vector<std::string> const& files = data_files() ;
+	PropagationPath input ;
+	PropagationPathOptions options ;
+	ref_ptr<CalculationMethod> method = getCalculationMethod ("JRC-2012") ;
+	std::string input_file ;
+	for (unsigned int i = 0 ; i < files.size() ; ++i)
+	{
+		PropagationPath path ;
+		PropagationPathOptions file_options ;
+		if (!parse_xml_path (files[i].c_str(), path, file_options)) continue ;
+		ref_ptr<CalculationMethod> fileMethod = file_options.method ;
+		file_options.method = 0 ;
+
+		unsigned int nb_owned = countThreadLocal (path, true) ;
+		check (countThreadLocal (path, false) == 0, "%s : objects using atomic reference counting", files[i].c_str()) ;
+		for (unsigned int k = 0 ; k < path.size() ; ++k)
+		{
+			if (path[k].mat && path[k].mat->isThreadLocal())
+			{
+				check (false, "%s : material using non-atomic reference counting", files[i].c_str()) ;
+				break ;
+			}
+		}
+
+		PathResult r1, r2 ;
+		file_options.method = method ;
+		PropagationPath atomic = path ;
+		setThreadLocal (atomic, false) ;
+		PropagationPath copy = atomic ;
+		check (countThreadLocal (copy, false) == nb_owned, "%s : copy does not inherit the reference counting mode", files[i].c_str()) ;
+		bool ok1 = calculate_path (path, file_options, r1) ;
+		bool ok2 = calculate_path (copy, file_options, r2) ;
+		check (ok1 == ok2 && (!ok1 || same_results (r1, r2)), "%s : results depend on the reference counting mode", files[i].c_str()) ;
+		file_options.method = 0 ;
+
+		if (input_file.empty() || path.cp.size() > input.cp.size())
+		{
+			input = path ;
+			options = file_options ;
+			input_file = files[i] ;
+		}
+	}
+	if (!check (!input_file.empty(), "no input file")) return ;
+
+	unsigned int nb_loops = scaled (1000, 100000) ;
+	report ("%s, %d control points, %d loops", input_file.c_str(), (int) input.cp.size(), nb_loops) ;
+	report ("%-20s %10s %10s", "", "atomic", "non-atomic") ;
+	double t_copy[2], t_analyze[2], t_refs[2] ;
+	for (int mode = 0 ; mode < 2 ; ++mode)
+	{
+		PropagationPath path = input ;
+		setThreadLocal (path, mode == 1) ;
+		SystemClock clock ;
+		/*
+		 * copy the path, i.e. clone all extensions and add references to the materials
+		 */
+		for (unsigned int i = 0 ; i < nb_loops ; ++i)
+		{
+			PropagationPath copy = path ;
+		}
+		t_copy[mode] = clock.get (true) ;
+		/*
+		 * copy and analyze the path, as is done for each calculation
+		 */
+		for (unsigned int i = 0 ; i < nb_loops ; ++i)
+		{
+			PropagationPath copy = path ;
+			copy.analyze_path (options) ;
+		}
+		t_analyze[mode] = clock.get (true) ;
+		/*
+		 * copy the ref_ptr's held by the path, without cloning
+		 */
+		for (unsigned int i = 0 ; i < nb_loops ; ++i)
+		{
+			for (unsigned int j = 0 ; j < path.size() ; ++j)
+			{
+				ref_ptr<Material> mat = path[j].mat ;
+				ref_ptr<VerticalExt> ext = path[j].ext ;
+			}
+		}
+		t_refs[mode] = clock.get (true) ;
+	}
+	double scale = 1.E6 / nb_loops ;
+	report ("%-20s %10.3f %10.3f us", "copy path", t_copy[0] * scale, t_copy[1] * scale) ;
+	report ("%-20s %10.3f %10.3f us", "copy + analyze path", t_analyze[0] * scale, t_analyze[1] * scale) ;
+	report ("%-20s %10.3f %10.3f us", "copy ref_ptr's", t_refs[0] * scale, t_refs[1] * scale) ;
+}
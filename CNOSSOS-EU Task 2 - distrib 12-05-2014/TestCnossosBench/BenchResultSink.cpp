@@ -0,0 +1,160 @@
+/*
+ * ------------------------------------------------------------------------------------------------
+ * file:		BenchResultSink.cpp
+ * version:		1.0
+ * author:		dirk.van-maercke@cstb.fr
+ * copyright:	see file licence.EU.txt
+ * description: checks and benchmarks of the output of large numbers of results
+ * changes:
+ *
+ *	18/10/2026	initial version
+ * -------------------------------------------------------------------------------------------------
+ */
+#include "TestCnossosBench.h"
+#include "ResultSink.h"
+#include <stdio.h>
+#include <math.h>
+#include <algorithm>
+
+using namespace CnossosEU ;
+using namespace System ;
+/*
+ * random results, with levels in the usual ranges
+ */
+static void random_spectrum (Spectrum& spec, double min, double max, unsigned int& seed)
+{
+	for (unsigned int i = 0 ; i < spec.size() ; ++i) spec[i] = min + (max - min) * random_value (seed) ;
+}
+
+static void random_result (PathResult& result, unsigned int& seed)
+{
+	random_spectrum (result.Lw, 80, 110, seed) ;
+	for (unsigned int i = 0 ; i < result.dBA.size() ; ++i) result.dBA[i] = Spectrum::dBA (i) ;
+	random_spectrum (result.delta_Lw, 0, 5, seed) ;
+	result.AttGeo = 30 + 30 * random_value (seed) ;
+	random_spectrum (result.AttAir, 0, 10, seed) ;
+	random_spectrum (result.AttAbsMat, 0, 3, seed) ;
+	random_spectrum (result.AttLatDif, 0, 20, seed) ;
+	random_spectrum (result.AttSize, 0, 1, seed) ;
+	random_spectrum (result.AttF, -3, 25, seed) ;
+	random_spectrum (result.AttH, -3, 25, seed) ;
+	random_spectrum (result.LpF, 0, 60, seed) ;
+	random_spectrum (result.LpH, 0, 60, seed) ;
+	random_spectrum (result.Leq, 0, 60, seed) ;
+	result.LpF_dBA = 30 + 30 * random_value (seed) ;
+	result.LpH_dBA = 30 + 30 * random_value (seed) ;
+	result.Leq_dBA = 30 + 30 * random_value (seed) ;
+}
+/*
+ * largest difference between the values of two results, either all values or only the values
+ * written without details (dB(A) levels and the Leq, LpF and LpH spectra)
+ */
+static double max_difference (PathResult const& r1, PathResult const& r2, bool details)
+{
+	double diff = 0 ;
+	if (details)
+	{
+		const double* v1 = (const double*) &r1 ;
+		const double* v2 = (const double*) &r2 ;
+		for (unsigned int i = 0 ; i < sizeof(PathResult) / sizeof(double) ; ++i) diff = std::max (diff, fabs (v1[i] - v2[i])) ;
+		return diff ;
+	}
+	diff = std::max (fabs (r1.Leq_dBA - r2.Leq_dBA), std::max (fabs (r1.LpF_dBA - r2.LpF_dBA), fabs (r1.LpH_dBA - r2.LpH_dBA))) ;
+	for (unsigned int i = 0 ; i < r1.Leq.size() ; ++i)
+	{
+		diff = std::max (diff, fabs (r1.Leq[i] - r2.Leq[i])) ;
+		diff = std::max (diff, fabs (r1.LpF[i] - r2.LpF[i])) ;
+		diff = std::max (diff, fabs (r1.LpH[i] - r2.LpH[i])) ;
+	}
+	return diff ;
+}
+
+static unsigned int count_lines (const char* fileName)
+{
+	unsigned int nb_lines = 0 ;
+	FILE* fp = fopen (fileName, "rb") ;
+	if (fp == 0) return 0 ;
+	char buffer[65536] ;
+	size_t n ;
+	while ((n = fread (buffer, 1, sizeof(buffer), fp)) > 0) nb_lines += (unsigned int) std::count (buffer, buffer + n, '\n') ;
+	fclose (fp) ;
+	return nb_lines ;
+}
+/*
+ * the output of 100000 results (1000000 with -full) to a single file, in XML, CSV and binary
+ * format, against the output of the results to individual XML files. CSV files must contain a
+ * line per result, binary files must be read back with the values written (exactly in double
+ * precision, within 1e-4 dB in single precision) and must be smaller than the XML file.
+ */
+void test_result_sink (void)
+{
+	const char* fileName = "bench_result_sink.results" ;
+	const unsigned int nb_results = scaled (100000, 1000000) ;
+	const unsigned int nb_random = 1000 ;
+	const unsigned int nb_files = scaled (1000, 10000) ;
+	unsigned int seed = 1 ;
+	std::vector<PathResult> results (nb_random) ;
+	for (unsigned int k = 0 ; k < nb_random ; ++k) random_result (results[k], seed) ;
+	/*
+	 * XML, one file per result and all results in a single file
+	 */
+	SystemClock clock ;
+	bool ok = true ;
+	for (unsigned int k = 0 ; k < nb_files ; ++k) ok = output_results_to_XML (fileName, results[k % nb_random]) && ok ;
+	double t = clock.get() ;
+	check (ok, "%s : write error", fileName) ;
+	report ("%-26s: %8.3f us/result, %9.0f bytes/result", "XML (one file per result)", t * 1e6 / nb_files,
+			get_file_size (fileName)) ;
+
+	clock.reset() ;
+	FILE* fp = fopen (fileName, "wt") ;
+	if (!check (fp != 0, "cannot create %s", fileName)) return ;
+	for (unsigned int k = 0 ; k < nb_results ; ++k) output_results_to_XML (fp, results[k % nb_random]) ;
+	fclose (fp) ;
+	double xml_time = clock.get() ;
+	double xml_size = get_file_size (fileName) ;
+	report ("%-26s: %8.3f us/result, %9.1f bytes/result", "XML (single file)", xml_time * 1e6 / nb_results,
+			xml_size / nb_results) ;
+	/*
+	 * result sink, all formats with and without details
+	 */
+	for (int test = 0 ; test < 6 ; ++test)
+	{
+		ResultSinkOptions options ;
+		options.CSV = (test % 3 == 0) ;
+		options.Float32 = (test % 3 == 2) ;
+		options.Details = (test < 3) ;
+		const char* format = options.CSV ? "CSV" : options.Float32 ? "binary (float32)" : "binary (float64)" ;
+		const char* details = options.Details ? "" : ", no details" ;
+		clock.reset() ;
+		ResultSink sink ;
+		ok = sink.open (fileName, options) ;
+		for (unsigned int k = 0 ; k < nb_results && ok ; ++k) ok = sink.add (results[k % nb_random]) ;
+		ok = sink.close() && ok ;
+		t = clock.get() ;
+		double size = get_file_size (fileName) ;
+		report ("%-26s: %8.3f us/result, %9.1f bytes/result, x%.1f%s", format, t * 1e6 / nb_results,
+				size / nb_results, xml_time / t, details) ;
+		if (!check (ok && sink.getNbResults() == nb_results, "%s%s : write error", format, details)) continue ;
+
+		if (options.CSV)
+		{
+			unsigned int nb_lines = count_lines (fileName) ;
+			check (nb_lines == nb_results + 1, "%s%s : %d lines for %d results", format, details, nb_lines, nb_results) ;
+			continue ;
+		}
+		std::vector<PathResult> copy ;
+		ok = readResultFile (fileName, copy) && copy.size() == nb_results ;
+		if (!check (ok, "%s%s : invalid file", format, details)) continue ;
+		double diff = 0 ;
+		for (unsigned int k = 0 ; k < copy.size() ; ++k)
+		{
+			diff = std::max (diff, max_difference (copy[k], results[k % nb_random], options.Details)) ;
+		}
+		double tolerance = options.Float32 ? 1e-4 : 0 ;
+		report ("  max. error %.2g dB", diff) ;
+		check (diff <= tolerance, "%s%s : values differ by %.2g dB", format, details, diff) ;
+		check (size < xml_size, "%s%s : larger than the XML file", format, details) ;
+	}
+	remove (fileName) ;
+}
@@ -0,0 +1,106 @@
+/*
+ * ------------------------------------------------------------------------------------------------
+ * file:		BenchSpectrum.cpp
+ * version:		1.0
+ * author:		dirk.van-maercke@cstb.fr
+ * copyright:	see file licence.EU.txt
+ * description: checks and benchmarks of the spectra for all supported band sets (8, 24 and 27
+ *				bands), independently of the band set selected for the calculation methods
+ * changes:
+ *
+ *	18/10/2026	initial version
+ * -------------------------------------------------------------------------------------------------
+ */
+#include "TestCnossosBench.h"
+#include "Spectrum.h"
+#include <math.h>
+#include <algorithm>
+
+using namespace CnossosEU ;
+/*
+ * expand random octave band spectra and compare the power of each octave band, and the total 
+ * power, before and after the conversion ; values (not power) are copied to all bands of the
+ * octave band
+ */
+template <int N> static void check_octave_bands (unsigned int nb_spectra)
+{
+	unsigned int seed = 12345 ;
+	double max_error = 0 ;
+	unsigned int nb_errors = 0 ;
+	for (unsigned int n = 0 ; n < nb_spectra ; ++n)
+	{
+		double octave[8] ;
+		for (unsigned int k = 0 ; k < 8 ; ++k) octave[k] = 60. + 50. * random_value (seed) ;
+
+		SpectrumT<N> power, value ;
+		ExpandOctaveBands (octave, power, true) ;
+		ExpandOctaveBands (octave, value, false) ;
+
+		double sum[8] = { 0, 0, 0, 0, 0, 0, 0, 0 } ;
+		double total = 0 ;
+		for (unsigned int i = 0 ; i < N ; ++i)
+		{
+			sum[SpectrumT<N>::octave(i)] += POW10 (power[i]) ;
+			total += POW10 (power[i]) ;
+			if (value[i] != octave[SpectrumT<N>::octave(i)]) nb_errors++ ;
+		}
+		double ref = 0 ;
+		for (unsigned int k = 0 ; k < 8 ; ++k)
+		{
+			max_error = std::max (max_error, fabs (LOG10 (sum[k]) - octave[k])) ;
+			ref += POW10 (octave[k]) ;
+		}
+		max_error = std::max (max_error, fabs (LOG10 (total) - LOG10 (ref))) ;
+	}
+	report ("%2d bands : octave band power preserved within %.2g dB", N, max_error) ;
+	check (max_error < 1.E-9, "%d bands : power of octave bands not preserved", N) ;
+	check (nb_errors == 0, "%d bands : %d values differ from the octave band value", N, nb_errors) ;
+}
+/*
+ * time per spectrum of the typical operations of the calculation methods : energetic sum of two 
+ * levels minus an attenuation, and the dB(A) sum
+ */
+template <int N> static void time_spectrum (unsigned int nb_loops)
+{
+	SpectrumT<N> a, b, c ;
+	unsigned int seed = 12345 ;
+	for (unsigned int i = 0 ; i < N ; ++i)
+	{
+		a[i] = 80. + 20. * random_value (seed) ;
+		b[i] = 80. + 20. * random_value (seed) ;
+		c[i] = 10. * random_value (seed) ;
+	}
+	double sum = 0 ;
+	SystemClock clock ;
+	for (unsigned int k = 0 ; k < nb_loops ; ++k)
+	{
+		a[k % N] += 1.E-6 ;
+		SpectrumT<N> res = LOG10 (POW10 (a) + POW10 (b)) - c ;
+		sum += res[k % N] ;
+	}
+	double t_sum = clock.get (true) ;
+	for (unsigned int k = 0 ; k < nb_loops ; ++k)
+	{
+		a[k % N] += 1.E-6 ;
+		double dBA = 0 ;
+		for (unsigned int i = 0 ; i < N ; ++i) dBA += POW10 (a[i] + SpectrumT<N>::dBA(i)) ;
+		sum += LOG10 (dBA) ;
+	}
+	double t_dBA = clock.get (true) ;
+	report ("%2d bands : LOG10 (POW10 (a) + POW10 (b)) - c %8.1f ns, dB(A) sum %8.1f ns (checksum %.0f)", N, 
+			1.E9 * t_sum / nb_loops, 1.E9 * t_dBA / nb_loops, sum) ;
+}
+
+void test_spectrum (void)
+{
+	report ("calculation methods use %d bands", (int) Spectrum::nbFreq) ;
+	unsigned int nb_spectra = scaled (1000, 100000) ;
+	check_octave_bands<8> (nb_spectra) ;
+	check_octave_bands<24> (nb_spectra) ;
+	check_octave_bands<27> (nb_spectra) ;
+
+	unsigned int nb_loops = scaled (100000, 10000000) ;
+	time_spectrum<8> (nb_loops) ;
+	time_spectrum<24> (nb_loops) ;
+	time_spectrum<27> (nb_loops) ;
+}
@@ -0,0 +1,164 @@
+/*
+ * ------------------------------------------------------------------------------------------------
+ * file:		BenchTerrain.cpp
+ * version:		1.0
+ * author:		dirk.van-maercke@cstb.fr
+ * copyright:	see file licence.EU.txt
+ * description: checks and benchmarks of the extraction of profiles from a terrain model
+ * changes:
+ *
+ *	18/10/2026	initial version
+ * -------------------------------------------------------------------------------------------------
+ */
+#include "TestCnossosBench.h"
+#include "TerrainModel.h"
+#include "VerticalExt.h"
+#include <stdio.h>
+#include <math.h>
+#include <algorithm>
+
+using namespace CnossosEU ;
+using namespace System ;
+
+static const unsigned int terrain_nodes = 2001 ;
+static const double terrain_cell = 5.0 ;
+/*
+ * elevation and ground class of the synthetic terrain: hills, a flat plain and patches of
+ * different ground types
+ */
+static double synthetic_elevation (double x, double y)
+{
+	double h = 40 * sin (x / 700) * cos (y / 900) + 15 * sin ((x + y) / 300) + 2 * sin (x / 37) * sin (y / 53) ;
+	return std::max (h, 0.0) ;
+}
+
+static unsigned char synthetic_ground (double x, double y)
+{
+	if (synthetic_elevation (x, y) <= 0) return 7 ;
+	return (unsigned char) (((int) (x / 400) + 3 * (int) (y / 600)) % 7) ;
+}
+/*
+ * synthetic terrain of 10km x 10km with a 5m grid
+ */
+static TerrainModel* create_synthetic_terrain (void)
+{
+	const unsigned int n = terrain_nodes ;
+	std::vector<float> z (n * n) ;
+	std::vector<unsigned char> g (n * n) ;
+	for (unsigned int j = 0 ; j < n ; ++j)
+	{
+		for (unsigned int i = 0 ; i < n ; ++i)
+		{
+			z[j * n + i] = (float) synthetic_elevation (i * terrain_cell, j * terrain_cell) ;
+			g[j * n + i] = synthetic_ground (i * terrain_cell, j * terrain_cell) ;
+		}
+	}
+	TerrainModel* terrain = new TerrainModel (0.0, 0.0, terrain_cell, n, n) ;
+	terrain->setElevation (&z[0]) ;
+	terrain->setGroundClass (&g[0]) ;
+	report ("synthetic terrain 10km x 10km, %d x %d nodes, %.1f MB (%.1f MB as float + byte arrays)",
+			n, n, terrain->getMemoryUsage() / 1.E6, n * n * 5 / 1.E6) ;
+	return terrain ;
+}
+/*
+ * maximum deviation between the simplified profile and the samples of the full profile
+ */
+static double max_deviation (PropagationPath& full, PropagationPath& simple)
+{
+	double dmax = 0 ;
+	unsigned int k = 0 ;
+	for (unsigned int i = 0 ; i < full.size() ; ++i)
+	{
+		double d = Geometry::dist ((Geometry::Point2D) full[0].pos, (Geometry::Point2D) full[i].pos) ;
+		while (k + 2 < simple.size() && Geometry::dist ((Geometry::Point2D) simple[0].pos, (Geometry::Point2D) simple[k+1].pos) < d) k++ ;
+		double d1 = Geometry::dist ((Geometry::Point2D) simple[0].pos, (Geometry::Point2D) simple[k].pos) ;
+		double d2 = Geometry::dist ((Geometry::Point2D) simple[0].pos, (Geometry::Point2D) simple[k+1].pos) ;
+		double z = simple[k].pos.z + (simple[k+1].pos.z - simple[k].pos.z) * (d - d1) / (d2 - d1) ;
+		dmax = std::max (dmax, fabs (z - full[i].pos.z)) ;
+	}
+	return dmax ;
+}
+/*
+ * the elevations stored in the terrain model are quantized with a resolution of 1cm ; the samples
+ * of the full profiles are interpolated on the terrain model and the simplified profiles pass
+ * within the tolerance of all samples of the full profile. Profiles between random source and
+ * receiver positions, at distances between 10m and 2000m, are timed for different options.
+ */
+void test_terrain_profiles (void)
+{
+	TerrainModel* terrain = create_synthetic_terrain() ;
+	/*
+	 * elevations at the nodes of the grid
+	 */
+	unsigned int seed = 3 ;
+	double max_error = 0 ;
+	unsigned int nb_ground_errors = 0 ;
+	for (unsigned int k = 0 ; k < 10000 ; ++k)
+	{
+		double x = terrain_cell * (unsigned int) ((terrain_nodes - 1) * random_value (seed)) ;
+		double y = terrain_cell * (unsigned int) ((terrain_nodes - 1) * random_value (seed)) ;
+		max_error = std::max (max_error, fabs (terrain->getElevation (x, y) - (float) synthetic_elevation (x, y))) ;
+		char id[2] = { (char) ('A' + synthetic_ground (x, y)), 0 } ;
+		if (terrain->getMaterial (x, y) != getMaterial (id)) nb_ground_errors++ ;
+	}
+	report ("elevations at the nodes within %.4fm", max_error) ;
+	check (max_error <= 0.005 + 1.E-6, "elevations not within the 1cm resolution") ;
+	check (nb_ground_errors == 0, "%d ground classes differ", nb_ground_errors) ;
+
+	const unsigned int nb_profiles = scaled (10000, 1000000) ;
+	double step[3] = { 0.0, 0.0, 10.0 } ;
+	double tolerance[3] = { 0.0, 0.01, 0.01 } ;
+	for (int test = 0 ; test < 3 ; ++test)
+	{
+		TerrainProfileOptions options ;
+		options.SamplingStep = step[test] ;
+		options.Tolerance = tolerance[test] ;
+		PropagationPath path ;
+		PropagationPath full ;
+		seed = 1 ;
+		double nb_points = 0 ;
+		double deviation = 0 ;
+		double interpolation = 0 ;
+		unsigned int nb_failed = 0 ;
+		double t_verify = 0 ;
+		SystemClock clock ;
+		for (unsigned int i = 0 ; i < nb_profiles ; ++i)
+		{
+			double xs = 500 + 9000 * random_value (seed) ;
+			double ys = 500 + 9000 * random_value (seed) ;
+			double d = 10 + 1990 * random_value (seed) ;
+			double a = 2 * 3.1415926 * random_value (seed) ;
+			double xr = std::max (0.0, std::min (xs + d * cos (a), 10000.)) ;
+			double yr = std::max (0.0, std::min (ys + d * sin (a), 10000.)) ;
+			if (!terrain->getProfile (xs, ys, xr, yr, path, options) || path.size() < 2) nb_failed++ ;
+			nb_points += path.size() ;
+			/*
+			 * verify the profiles on a subset of the profiles (not included in the timing)
+			 */
+			if (i % 100 == 0)
+			{
+				SystemClock verify ;
+				TerrainProfileOptions no_simplification = options ;
+				no_simplification.Tolerance = 0 ;
+				terrain->getProfile (xs, ys, xr, yr, full, no_simplification) ;
+				for (unsigned int k = 0 ; k < full.size() ; ++k)
+				{
+					double z = terrain->getElevation (full[k].pos.x, full[k].pos.y) ;
+					interpolation = std::max (interpolation, fabs (full[k].pos.z - z)) ;
+				}
+				if (options.Tolerance > 0) deviation = std::max (deviation, max_deviation (full, path)) ;
+				t_verify += verify.get() ;
+			}
+		}
+		double t = clock.get() - t_verify ;
+		char label[64] ;
+		sprintf (label, "step=%4.1fm tolerance=%4.2fm", options.SamplingStep, options.Tolerance) ;
+		report_time (label, t, nb_profiles, "profile") ;
+		report ("  %.1f points/profile, samples within %.2gm of the terrain, max. deviation %.4fm",
+				nb_points / nb_profiles, interpolation, deviation) ;
+		check (nb_failed == 0, "%s : %d profiles not extracted", label, nb_failed) ;
+		check (interpolation < 1.E-6, "%s : samples not on the terrain", label) ;
+		check (deviation <= options.Tolerance + 1.E-9, "%s : simplified profile deviates %.4fm", label, deviation) ;
+	}
+	delete terrain ;
+}
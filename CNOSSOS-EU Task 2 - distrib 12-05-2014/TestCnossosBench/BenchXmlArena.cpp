@@ -0,0 +1,96 @@
+/*
+ * ------------------------------------------------------------------------------------------------
+ * file:		BenchXmlArena.cpp
+ * version:		1.0
+ * author:		dirk.van-maercke@cstb.fr
+ * copyright:	see file licence.EU.txt
+ * description: soak test and benchmarks of the XML parser and of the arena of the XML documents
+ * changes:
+ *
+ *	18/10/2026	initial version
+ * -------------------------------------------------------------------------------------------------
+ */
+#include "TestCnossosBench.h"
+#include "CalculationMethod.h"
+#include <string.h>
+
+using namespace CnossosEU ;
+using namespace System ;
+/*
+ * the files of the data corpus are parsed 100 times (10000 times with -full), both the documents and
+ * the propagation paths they contain : each pass must parse the same number of paths and the resident
+ * memory must not grow after the first passes (only checked on Linux). Then
+ * the documents are loaded in a new loader and in a loader that is reused from one document to the
+ * next, which must give the same documents.
+ */
+void test_xml_arena (void)
+{
+	std::vector<std::string> const& files = data_files() ;
+	const unsigned int nb_files = files.size() ;
+	const unsigned int nb_repeat = scaled (100, 10000) ;
+	if (!check (nb_files > 0, "no input file")) return ;
+	/*
+	 * soak test
+	 */
+	PropagationPath path ;
+	PropagationPathOptions options ;
+	unsigned int nb_paths_first = 0 ;
+	unsigned int nb_passes_differ = 0 ;
+	double resident = 0 ;
+	SystemClock clock ;
+	for (unsigned int repeat = 1 ; repeat <= nb_repeat ; ++repeat)
+	{
+		unsigned int nb_paths = 0 ;
+		for (unsigned int i = 0 ; i < nb_files ; ++i)
+		{
+			if (parse_xml_path (files[i].c_str(), path, options)) nb_paths++ ;
+			/*
+			 * the method selected in the file is owned by the caller, release it
+			 */
+			ref_ptr<CalculationMethod> method = options.method ;
+			options.method = 0 ;
+		}
+		if (repeat == 1) nb_paths_first = nb_paths ;
+		if (nb_paths != nb_paths_first) nb_passes_differ++ ;
+		if (repeat == nb_repeat / 10) resident = get_resident_memory() ;
+		if (repeat == 1 || repeat == 10 || repeat == 100 || repeat % 1000 == 0 || repeat == nb_repeat)
+		{
+			report ("%6d: %8.2f us/file, %7.2f MB resident memory, %d paths of %d files", repeat,
+					clock.get() * 1e6 / (repeat * nb_files), get_resident_memory(), nb_paths, nb_files) ;
+		}
+	}
+	double growth = get_resident_memory() - resident ;
+	check (nb_paths_first > 0, "no path parsed") ;
+	check (nb_passes_differ == 0, "%d passes parse a different number of paths", nb_passes_differ) ;
+	check (growth < 2.0, "resident memory grows by %.2f MB after pass %d", growth, nb_repeat / 10) ;
+	/*
+	 * documents only, in a new loader and in a reused loader
+	 */
+	const unsigned int nb_load = scaled (10, 100) ;
+	std::vector<std::string> roots (nb_files) ;
+	clock.reset() ;
+	for (unsigned int repeat = 0 ; repeat < nb_load ; ++repeat)
+	{
+		for (unsigned int i = 0 ; i < nb_files ; ++i)
+		{
+			XMLFileLoader xmlFile ;
+			if (xmlFile.ParseFile (files[i].c_str()) && xmlFile.GetRoot() != 0) roots[i] = xmlFile.GetRoot()->GetName() ;
+		}
+	}
+	report ("new loader    : %8.2f us/file", clock.get() * 1e6 / (nb_load * nb_files)) ;
+
+	unsigned int nb_differ = 0 ;
+	clock.reset() ;
+	XMLFileLoader xmlFile ;
+	for (unsigned int repeat = 0 ; repeat < nb_load ; ++repeat)
+	{
+		for (unsigned int i = 0 ; i < nb_files ; ++i)
+		{
+			xmlFile.Cleanup() ;
+			bool ok = xmlFile.ParseFile (files[i].c_str()) && xmlFile.GetRoot() != 0 ;
+			if (ok != !roots[i].empty() || (ok && roots[i] != xmlFile.GetRoot()->GetName())) nb_differ++ ;
+		}
+	}
+	report ("reused loader : %8.2f us/file", clock.get() * 1e6 / (nb_load * nb_files)) ;
+	check (nb_differ == 0, "%d documents differ in the reused loader", nb_differ) ;
+}
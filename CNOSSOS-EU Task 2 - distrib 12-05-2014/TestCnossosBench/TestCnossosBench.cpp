@@ -0,0 +1,340 @@
+/*
+ * ------------------------------------------------------------------------------------------------
+ * file:		TestCnossosBench.cpp
+ * version:		1.0
+ * author:		dirk.van-maercke@cstb.fr
+ * copyright:	see file licence.EU.txt
+ * description: main program for the checks and benchmarks of the propagation library and the
+ *				Harmonoise engine (see TestCnossosBench.h)
+ * changes:
+ *
+ *	18/10/2026	initial version
+ * -------------------------------------------------------------------------------------------------
+ */
+#ifdef WIN32
+#include <io.h>
+#include <direct.h>
+#else
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <malloc.h>
+#define _getcwd getcwd
+#define _chdir chdir
+#endif
+#include "TestCnossosBench.h"
+#include "CalculationMethod.h"
+#include "Material.h"
+#include "ErrorMessage.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <algorithm>
+
+using namespace CnossosEU ;
+
+static const char* usage =
+"\n"
+"Usage:\n"
+"\n"
+"  TestCnossosBench [-full] [-data=<folder>] [<test> ...]\n"
+"  TestCnossosBench -list\n"
+"\n"
+"  .runs the given tests, or all tests if none is specified, and returns a non-zero\n"
+"   exit code if any of them fails\n"
+"\n"
+"  .if -full is specified, the tests run the full benchmarks, otherwise they use\n"
+"   reduced problem sizes\n"
+"\n"
+"  .data folder = the folder containing the XML test files (default ../data)\n"
+"\n"
+;
+/*
+ * list of tests
+ */
+struct BenchTest
+{
+	const char* name ;
+	void (*run) (void) ;
+	const char* description ;
+} ;
+
+static BenchTest tests[] =
+{
+	{ "ground-effect",		test_ground_effect,		"Harmonoise ground effect against the original calculation" },
+	{ "special-functions",	test_special_functions,	"Harmonoise Fref, Qref and HaddenPierce against the original functions" },
+	{ "impedance-cache",	test_impedance_cache,	"Harmonoise cache of impedance spectra" },
+	{ "stage-timers",		test_stage_timers,		"Harmonoise per-stage timers" },
+	{ "wind-rose",			test_wind_rose,			"Harmonoise long-term results over a wind rose" },
+	{ "spectrum",			test_spectrum,			"conversion of octave bands and spectrum operations for 8, 24 and 27 bands" },
+	{ "pipeline",			test_pipeline,			"statically dispatched against virtual calculation pipeline" },
+	{ "reference-counting",	test_reference_counting,"atomic and non-atomic reference counting of the objects owned by a path" },
+	{ "terrain-profiles",	test_terrain_profiles,	"extraction of profiles from a terrain model" },
+	{ "obstacle-index",		test_obstacle_index,	"spatial index of barriers and buildings in a synthetic city" },
+	{ "noise-map",			test_noise_map,			"noise map engine with 1 and 2 threads, culling of weak contributions" },
+	{ "upper-bounds",		test_upper_bounds,		"upper bounds of the noise levels on random scenes" },
+	{ "split-lines",		test_split_lines,		"noise map engine with the adaptive subdivision of line segments" },
+	{ "source-clusters",	test_source_clusters,	"noise map engine with the clustering of distant point sources" },
+	{ "line-splitter",		test_line_splitter,		"adaptive subdivision of line sources against fixed subdivisions" },
+	{ "path-batch",			test_path_batch,		"batch files against the XML files of the data corpus" },
+	{ "path-stream",		test_path_stream,		"streaming parser of files containing multiple paths" },
+	{ "result-sink",		test_result_sink,		"output of large numbers of results" },
+	{ "xml-arena",			test_xml_arena,			"soak test of the XML parser and of the arena of the documents" },
+} ;
+
+static const unsigned int nb_tests = sizeof(tests) / sizeof(tests[0]) ;
+/*
+ * state of the current run
+ */
+static bool full_benchmarks = false ;
+static std::string data_folder = "../data" ;
+static unsigned int nb_failed_checks = 0 ;
+
+bool full_mode (void)
+{
+	return full_benchmarks ;
+}
+
+unsigned int scaled (unsigned int quick, unsigned int full)
+{
+	return full_benchmarks ? full : quick ;
+}
+
+bool check (bool ok, const char* format, ...)
+{
+	if (ok) return true ;
+	nb_failed_checks++ ;
+	printf ("  FAILED: ") ;
+	va_list args ;
+	va_start (args, format) ;
+	vprintf (format, args) ;
+	va_end (args) ;
+	printf ("\n") ;
+	return false ;
+}
+
+void report (const char* format, ...)
+{
+	printf ("  ") ;
+	va_list args ;
+	va_start (args, format) ;
+	vprintf (format, args) ;
+	va_end (args) ;
+	printf ("\n") ;
+}
+
+void report_time (const char* label, double seconds, double nb_items, const char* unit)
+{
+	report ("%-40s %10.3f us/%s", label, nb_items > 0 ? 1.E6 * seconds / nb_items : 0.0, unit) ;
+}
+/*
+ * input files
+ */
+std::vector<std::string> const& data_files (void)
+{
+	static std::vector<std::string> files ;
+	static bool done = false ;
+	if (done) return files ;
+	done = true ;
+#ifdef WIN32
+	struct _finddata_t info ;
+	intptr_t handle = _findfirst ((data_folder + "/*.xml").c_str(), &info) ;
+	if (handle == -1) return files ;
+	do files.push_back (data_folder + "/" + info.name) ; while (_findnext (handle, &info) == 0) ;
+	_findclose (handle) ;
+#else
+	DIR* dir = opendir (data_folder.c_str()) ;
+	if (dir == 0) return files ;
+	while (struct dirent* entry = readdir (dir))
+	{
+		size_t len = strlen (entry->d_name) ;
+		if (len > 4 && strcmp (entry->d_name + len - 4, ".xml") == 0) files.push_back (data_folder + "/" + entry->d_name) ;
+	}
+	closedir (dir) ;
+#endif
+	std::sort (files.begin(), files.end()) ;
+	return files ;
+}
+
+bool parse_xml_path (const char* fileName, PropagationPath& path, PropagationPathOptions& options, bool verbose)
+{
+	XMLFileLoader xmlFile ;
+	if (!xmlFile.ParseFile (fileName))
+	{
+		if (verbose) printf ("Syntax error in file %s \n", fileName) ;
+		return false ;
+	}
+	char* old_dir = _getcwd (NULL, 0) ;
+	std::string new_dir = fileName ;
+	size_t pos = new_dir.find_last_of ("/\\") ;
+	new_dir = (pos == std::string::npos) ? "." : new_dir.substr (0, pos) ;
+	_chdir (new_dir.c_str()) ;
+	bool ok = false ;
+	try
+	{
+		ok = ParsePathFromFile (xmlFile.GetRoot(), path, options) ;
+	}
+	catch (ErrorMessage& err)
+	{
+		if (verbose) err.print() ;
+	}
+	_chdir (old_dir) ;
+	free (old_dir) ;
+	return ok ;
+}
+
+bool calculate_path (PropagationPath& path, PropagationPathOptions const& options, PathResult& result)
+{
+	try
+	{
+		options.method->setOptions (options) ;
+		return options.method->doCalculation (path, result) ;
+	}
+	catch (std::exception&)
+	{
+		return false ;
+	}
+}
+
+bool same_results (PathResult const& r1, PathResult const& r2)
+{
+	bool same = (r1.Leq_dBA == r2.Leq_dBA && r1.LpF_dBA == r2.LpF_dBA && r1.LpH_dBA == r2.LpH_dBA) ;
+	for (unsigned int i = 0 ; i < r1.Leq.size() ; ++i) same = same && (r1.Leq[i] == r2.Leq[i]) ;
+	return same ;
+}
+/*
+ * utilities
+ */
+double random_value (unsigned int& seed)
+{
+	seed = seed * 1103515245 + 12345 ;
+	return ((seed >> 8) & 0xFFFFFF) / 16777216.0 ;
+}
+
+double get_file_size (const char* fileName)
+{
+	double size = 0 ;
+	FILE* fp = fopen (fileName, "rb") ;
+	if (fp != 0 && fseek (fp, 0, SEEK_END) == 0) size = ftell (fp) ;
+	if (fp != 0) fclose (fp) ;
+	return size ;
+}
+
+double get_peak_memory (void)
+{
+#ifdef WIN32
+	return 0 ;
+#else
+	struct rusage usage ;
+	getrusage (RUSAGE_SELF, &usage) ;
+	return usage.ru_maxrss / 1024. ;
+#endif
+}
+
+double get_resident_memory (void)
+{
+#ifdef WIN32
+	return 0 ;
+#else
+#ifdef __GLIBC__
+	malloc_trim (0) ;
+#endif
+	double size = 0 ;
+	FILE* fp = fopen ("/proc/self/statm", "rt") ;
+	if (fp == 0) return 0 ;
+	long pages, resident ;
+	if (fscanf (fp, "%ld %ld", &pages, &resident) == 2) size = resident * (double) sysconf (_SC_PAGESIZE) ;
+	fclose (fp) ;
+	return size / (1024. * 1024.) ;
+#endif
+}
+/*
+ * run a single test, returns true if all its checks pass ; the materials defined in the files
+ * parsed by the test do not apply to the following tests
+ */
+static bool run_test (BenchTest const& test)
+{
+	printf ("[%s] %s\n", test.name, test.description) ;
+	fflush (stdout) ;
+	nb_failed_checks = 0 ;
+	MaterialSnapshot materials ;
+	SystemClock clock ;
+	try
+	{
+		test.run () ;
+	}
+	catch (ErrorMessage& err)
+	{
+		err.print() ;
+		check (false, "unexpected error") ;
+	}
+	if (nb_failed_checks == 0)
+	{
+		printf ("  passed (%.1f s)\n", clock.get()) ;
+	}
+	else
+	{
+		printf ("  FAILED, %d checks (%.1f s)\n", nb_failed_checks, clock.get()) ;
+	}
+	fflush (stdout) ;
+	return nb_failed_checks == 0 ;
+}
+
+int main (int argc, char* argv[])
+{
+	std::vector<BenchTest> selected ;
+	for (int i = 1 ; i < argc ; ++i)
+	{
+		/*
+		 * option "-full" : run the full benchmarks
+		 */
+		if (strcmp (argv[i], "-full") == 0)
+		{
+			full_benchmarks = true ;
+		}
+		/*
+		 * option "-data=" : folder containing the XML test files
+		 */
+		else if (strncmp (argv[i], "-data=", 6) == 0)
+		{
+			data_folder = argv[i] + 6 ;
+		}
+		/*
+		 * option "-list" : print the list of tests
+		 */
+		else if (strcmp (argv[i], "-list") == 0)
+		{
+			for (unsigned int k = 0 ; k < nb_tests ; ++k) printf ("%-20s %s\n", tests[k].name, tests[k].description) ;
+			return 0 ;
+		}
+		else if (argv[i][0] == '-')
+		{
+			printf ("%s", usage) ;
+			return 1 ;
+		}
+		/*
+		 * name of a test
+		 */
+		else
+		{
+			unsigned int k = 0 ;
+			while (k < nb_tests && strcmp (argv[i], tests[k].name) != 0) k++ ;
+			if (k == nb_tests)
+			{
+				printf ("Unknown test %s \n", argv[i]) ;
+				return 1 ;
+			}
+			selected.push_back (tests[k]) ;
+		}
+	}
+	if (selected.empty()) selected.assign (tests, tests + nb_tests) ;
+
+	unsigned int nb_failed = 0 ;
+	for (unsigned int k = 0 ; k < selected.size() ; ++k)
+	{
+		if (!run_test (selected[k])) nb_failed++ ;
+	}
+	printf ("%d tests, %d passed, %d failed\n", (int) selected.size(), (int) (selected.size() - nb_failed), nb_failed) ;
+	return nb_failed == 0 ? 0 : 1 ;
+}
@@ -0,0 +1,140 @@
+#pragma once
+/*
+ * ------------------------------------------------------------------------------------------------
+ * file:		TestCnossosBench.h
+ * version:		1.0
+ * author:		dirk.van-maercke@cstb.fr
+ * copyright:	see file licence.EU.txt
+ * description: checks and benchmarks of the propagation library and the Harmonoise engine
+ * note:		each test is a function without arguments, registered in the table in
+ *				TestCnossosBench.cpp. Tests report their measurements with report() and their
+ *				pass/fail conditions with check() ; a test fails if any of its checks fails. By
+ *				default, tests run on reduced problem sizes so that all of them complete in a few
+ *				seconds (make check) ; with option -full they run the full benchmarks.
+ * changes:
+ *
+ *	18/10/2026	initial version
+ * -------------------------------------------------------------------------------------------------
+ */
+#include "PropagationPath.h"
+#include "PathParseXML.h"
+#include "PathResult.h"
+#include "SystemClock.h"
+#include "ObstacleIndex.h"
+#include <string>
+#include <vector>
+
+/*
+ * true if the full benchmarks are requested (option -full)
+ */
+bool full_mode (void) ;
+/*
+ * problem size, number of loops or repetitions : the first value by default, the second one for
+ * the full benchmarks
+ */
+unsigned int scaled (unsigned int quick, unsigned int full) ;
+/*
+ * record the outcome of a check of the current test, the message is printed if the check fails
+ * (returns the outcome)
+ */
+bool check (bool ok, const char* format, ...) ;
+/*
+ * print a line of the report of the current test
+ */
+void report (const char* format, ...) ;
+/*
+ * print the time per item (in microseconds) of a timed loop
+ */
+void report_time (const char* label, double seconds, double nb_items, const char* unit = "path") ;
+/*
+ * names of the XML files in the data folder (option -data=<folder>), in alphabetical order
+ */
+std::vector<std::string> const& data_files (void) ;
+/*
+ * parse a propagation path from an XML file, file names in the input file being relative to the
+ * folder containing the file. Errors are reported only if verbose is set.
+ */
+bool parse_xml_path (const char* fileName, CnossosEU::PropagationPath& path,
+					 CnossosEU::PropagationPathOptions& options, bool verbose = false) ;
+/*
+ * calculate a path with the method and options read from the input file (returns false on error)
+ */
+bool calculate_path (CnossosEU::PropagationPath& path, CnossosEU::PropagationPathOptions const& options,
+					 CnossosEU::PathResult& result) ;
+/*
+ * test bitwise identity of the results of two calculations
+ */
+bool same_results (CnossosEU::PathResult const& r1, CnossosEU::PathResult const& r2) ;
+/*
+ * pseudo-random numbers in [0,1[, reproducible on all platforms
+ */
+double random_value (unsigned int& seed) ;
+/*
+ * size of a file (bytes), peak memory used by the process (MB, not available on Windows) and
+ * memory currently resident once the free memory of the heap is returned to the system (MB, only
+ * available on Linux) ; the peak memory depends on all tests that ran before in the same process,
+ * checks of the memory used by a test use the resident memory
+ */
+double get_file_size (const char* fileName) ;
+double get_peak_memory (void) ;
+double get_resident_memory (void) ;
+/*
+ * synthetic city of 10km x 10km: buildings (closed footprints) of 8m to 30m, randomly oriented,
+ * followed by 1000 barriers (polylines) made of 10 segments of 20m to 50m. The obstacles are added
+ * to the index and to the list of polygons (BenchObstacles.cpp).
+ */
+typedef std::vector<Geometry::Point2D> Polygon2D ;
+const unsigned int synthetic_city_buildings = 100000 ;
+void create_synthetic_city (CnossosEU::ObstacleIndex& index, std::vector<Polygon2D>& obstacles) ;
+/*
+ * Harmonoise engine (BenchHarmonoise.cpp)
+ */
+void test_ground_effect (void) ;
+void test_special_functions (void) ;
+void test_impedance_cache (void) ;
+void test_stage_timers (void) ;
+void test_wind_rose (void) ;
+/*
+ * spectra (BenchSpectrum.cpp)
+ */
+void test_spectrum (void) ;
+/*
+ * calculation pipeline and propagation paths (BenchPipeline.cpp)
+ */
+void test_pipeline (void) ;
+void test_reference_counting (void) ;
+/*
+ * terrain model (BenchTerrain.cpp)
+ */
+void test_terrain_profiles (void) ;
+/*
+ * spatial index of obstacles (BenchObstacles.cpp)
+ */
+void test_obstacle_index (void) ;
+/*
+ * noise map engine (BenchNoiseMap.cpp)
+ */
+void test_noise_map (void) ;
+void test_upper_bounds (void) ;
+void test_split_lines (void) ;
+void test_source_clusters (void) ;
+/*
+ * adaptive subdivision of line sources (BenchLineSplitter.cpp)
+ */
+void test_line_splitter (void) ;
+/*
+ * batch files (BenchPathBatch.cpp)
+ */
+void test_path_batch (void) ;
+/*
+ * streaming parser (BenchPathStream.cpp)
+ */
+void test_path_stream (void) ;
+/*
+ * output of large numbers of results (BenchResultSink.cpp)
+ */
+void test_result_sink (void) ;
+/*
+ * XML parser (BenchXmlArena.cpp)
+ */
+void test_xml_arena (void) ;
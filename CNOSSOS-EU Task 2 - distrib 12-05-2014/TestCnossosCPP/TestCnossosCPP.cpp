@@ -38,7 +38,7 @@ static void show_details (PropagationPath& path, PathResult& result)
  */
 static SourceExt* getSourceModel (void)
 {
-	double LwValues[8] = { 80., 85., 90., 95., 100., 100., 95.0, 90.0 } ;
+	double LwValues[8] = { 80., 85., 90., 95., 100., 100., 95.0, 90.0 } ;	// octave bands 63Hz...8kHz
 	/*
 	 * create the elementary source
 	 */
@@ -47,7 +47,7 @@ static SourceExt* getSourceModel (void)
 	Lw.frequencyWeighting = FrequencyWeighting::dBLIN ;
 	Lw.measurementType = MeasurementType::HemiSpherical ;
 	Lw.spectrumType = SpectrumType::LineSource ;
-	Lw.soundPower = Spectrum (LwValues) ;
+	ExpandOctaveBands (LwValues, Lw.soundPower, true) ;
 	/*
 	 * create the source extension adapter
 	 */
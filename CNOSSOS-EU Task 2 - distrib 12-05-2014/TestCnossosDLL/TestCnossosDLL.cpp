@@ -16,6 +16,8 @@
  *
  *	09/12/2013	error handling added and tested
  *
+ *	18/10/2026	spectral arrays sized from the number of frequency bands of the library
+ *
  * ------------------------------------------------------------------------------------------------- 
  */
 #ifdef WIN32
@@ -24,7 +26,9 @@
 #endif
 #include "../CnossosPropagation/CnossosPropagation.h"
 #include <stdio.h>
+#include <math.h>
 #include <limits>
+#include <vector>
 #ifdef __GNUC__
 #ifndef WIN32
 #include <curses.h>
@@ -35,16 +39,38 @@
 /*
  *  utility function for printing out spectral values
  */
-void print_spectrum (const char* id, const char* fmt, double* val)
+void print_spectrum (const char* id, const char* fmt, std::vector<double> const& val)
 {
 	printf ("%8.8s", id) ;
-	for (unsigned int i = 0 ; i < 8 ; ++i) 
+	for (unsigned int i = 0 ; i < val.size() ; ++i) 
 	{
 		printf ("  ") ;
 		printf (fmt, val[i]) ;
 	}
 	printf ("\n") ;
 }
+/*
+ * sound power in the frequency bands of the library from octave band values (63Hz...8kHz) : the 
+ * power of each octave band is divided over the bands it contains
+ */
+std::vector<double> octave_band_power (double const Lw[8], std::vector<double> const& freq)
+{
+	const double octave_freq[8] = { 63, 125, 250, 500, 1000, 2000, 4000, 8000 } ;
+	std::vector<double> val (freq.size(), -std::numeric_limits<double>::infinity()) ;
+	for (unsigned int k = 0 ; k < 8 ; ++k)
+	{
+		unsigned int count = 0 ;
+		for (unsigned int i = 0 ; i < freq.size() ; ++i) 
+		{
+			if (freq[i] > 0.7 * octave_freq[k] && freq[i] < 1.42 * octave_freq[k]) count++ ;
+		}
+		for (unsigned int i = 0 ; i < freq.size() ; ++i) 
+		{
+			if (freq[i] > 0.7 * octave_freq[k] && freq[i] < 1.42 * octave_freq[k]) val[i] = Lw[k] - 10. * log10 ((double) count) ;
+		}
+	}
+	return val ;
+}
 /*
  * main entry point
  */
@@ -66,13 +92,14 @@ int _tmain (int argc, _TCHAR* argv[])
 	CNOSSOS_P2P_MATERIAL* mat = CNOSSOS_P2P_GetMaterial ("A4", false) ;
 	double G ;
 	double sigma ;
-	double alpha[8] ;
-	double freq[8] ;
+	unsigned int nbFreq = CNOSSOS_P2P_GetFreq (NULL) ;
+	std::vector<double> alpha (nbFreq) ;
+	std::vector<double> freq (nbFreq) ;
 
-	CNOSSOS_P2P_GetFreq (freq) ;
+	CNOSSOS_P2P_GetFreq (&freq[0]) ;
 	CNOSSOS_P2P_GetGValue (mat,G) ;
 	CNOSSOS_P2P_GetSigma (mat, sigma) ;
-	CNOSSOS_P2P_GetAlpha (mat, alpha) ;
+	CNOSSOS_P2P_GetAlpha (mat, &alpha[0]) ;
 
 	printf ("Material ID=""A4"", G=%.2f, sigma=%.0f\n", G, sigma) ;
 	print_spectrum ("freq:", "%4.0f", freq) ;
@@ -124,10 +151,11 @@ int _tmain (int argc, _TCHAR* argv[])
 	pos[1] = 10.0 ;
 	nbPoints = CNOSSOS_P2P_AddToPath (p2p, pos, CNOSSOS_P2P_GetMaterial("D"), CNOSSOS_P2P_CreateReceiver (2.5)) ;
 	/*
-		* define sound power associated with the source
+		* define sound power associated with the source (octave bands 63Hz...8kHz)
  		*/
 	double Lw[] = { 90, 95, 100, 105, 105, 100, 95, 90 } ;
-	CNOSSOS_P2P_SetSoundPower (p2p, Lw) ;
+	std::vector<double> LwBands = octave_band_power (Lw, freq) ;
+	CNOSSOS_P2P_SetSoundPower (p2p, &LwBands[0]) ;
 	/*
 		* setup options (optionally)
 		*/
@@ -148,12 +176,12 @@ int _tmain (int argc, _TCHAR* argv[])
 	/*
 		* read out the results (the first read will trigger the actual calculation) 
 		*/
-	double fav[8] ;
-	double hom[8] ;
-	double leq[8] ;
-	unsigned int ok_fav = CNOSSOS_P2P_GetResult (p2p, CNOSSOS_P2P_RESULT_LP_FAV, fav) ;
-	unsigned int ok_hom = CNOSSOS_P2P_GetResult (p2p, CNOSSOS_P2P_RESULT_LP_HOM, hom) ;
-	unsigned int ok_leq = CNOSSOS_P2P_GetResult (p2p, CNOSSOS_P2P_RESULT_LP_AVG, leq) ;
+	std::vector<double> fav (nbFreq) ;
+	std::vector<double> hom (nbFreq) ;
+	std::vector<double> leq (nbFreq) ;
+	unsigned int ok_fav = CNOSSOS_P2P_GetResult (p2p, CNOSSOS_P2P_RESULT_LP_FAV, &fav[0]) ;
+	unsigned int ok_hom = CNOSSOS_P2P_GetResult (p2p, CNOSSOS_P2P_RESULT_LP_HOM, &hom[0]) ;
+	unsigned int ok_leq = CNOSSOS_P2P_GetResult (p2p, CNOSSOS_P2P_RESULT_LP_AVG, &leq[0]) ;
 	/*
 		* print out results
 		*/
@@ -0,0 +1,47 @@
+#!/bin/sh
+#
+# round trip of the XML files in the data folder through a batch file (options -pack= and -unpack=
+# of TestCnossos): all files are packed into a single batch file, which is unpacked again ; each
+# unpacked file must give the same noise levels as the original file.
+#
+# usage: check_batch.sh <TestCnossos> <data folder>
+#
+test_cnossos=$1
+data=$2
+tmp=${TMPDIR:-/tmp}/check_batch.$$
+mkdir -p "$tmp" || exit 1
+trap 'rm -rf "$tmp"' EXIT
+
+levels ()
+{
+	"$test_cnossos" -i="$1" | sed -n '/^Noise levels/,$p'
+}
+
+if ! "$test_cnossos" -pack="$tmp/data.batch" "$data"/*.xml > "$tmp/pack.log" ; then
+	cat "$tmp/pack.log"
+	echo "batch round trip FAILED: cannot pack the files"
+	exit 1
+fi
+if ! "$test_cnossos" -unpack="$tmp/data.batch" > /dev/null ; then
+	echo "batch round trip FAILED: cannot unpack the batch file"
+	exit 1
+fi
+
+k=0
+nb_diffs=0
+for file in "$data"/*.xml ; do
+	grep -qxF "Skipping file $file " "$tmp/pack.log" && continue
+	levels "$file" > "$tmp/original.txt"
+	levels "$tmp/data.batch.$k.xml" > "$tmp/unpacked.txt"
+	if ! cmp -s "$tmp/original.txt" "$tmp/unpacked.txt" ; then
+		echo "  $file : levels differ after the round trip"
+		nb_diffs=$((nb_diffs + 1))
+	fi
+	k=$((k + 1))
+done
+
+if [ $k -eq 0 ] || [ $nb_diffs -ne 0 ] ; then
+	echo "batch round trip FAILED: $nb_diffs of $k files differ"
+	exit 1
+fi
+echo "batch round trip passed: $k files"
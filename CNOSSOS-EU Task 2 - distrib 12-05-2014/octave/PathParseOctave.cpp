@@ -4,6 +4,7 @@
 #include "../system/environment.h"
 using namespace CnossosEU;
 
+#undef print_debug
 #ifdef DEBUG
 #include <cstdio>
 #include <iostream>
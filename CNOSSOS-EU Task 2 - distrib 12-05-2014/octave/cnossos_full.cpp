@@ -7,6 +7,7 @@
 #include "Geometry3D.h"
 using namespace CnossosEU;
 
+#undef print_debug
 #ifdef DEBUG
 #include <cstdio>
 #include <iostream>
@@ -0,0 +1,301 @@
+#pragma once
+// CNOSSOS_BATCH.cpp : Calculation of a batch of input files with one of the source models.
+//
+
+#include "stdafx.h"
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <map>
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#endif
+
+#include "CNOSSOS_BATCH.h"
+#include "CNOSSOS_BENCHMARK.h"
+#include "CNOSSOS_THREAD.h"
+
+using namespace std;
+
+namespace CNOSSOS
+{
+	// maximum number of failures that are listed individually
+	static const size_t MAX_LISTED_FAILURES = 1000;
+
+	// --------------------------------------------------------------------------------------------------------
+	// true if name ends with ".xml", in any case
+	// --------------------------------------------------------------------------------------------------------
+	static bool has_xml_extension(const string name)
+	{
+		if (name.length() < 4)
+			return false;
+		string ext = name.substr(name.length() - 4);
+		transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+		return ext == ".xml";
+	}
+
+	// --------------------------------------------------------------------------------------------------------
+	// file name without the directory
+	// --------------------------------------------------------------------------------------------------------
+	static string base_name(const string path)
+	{
+		size_t pos = path.find_last_of("/\\");
+		return (pos == string::npos) ? path : path.substr(pos + 1);
+	}
+
+	// --------------------------------------------------------------------------------------------------------
+	// directory of a file, "." if the path has no directory
+	// --------------------------------------------------------------------------------------------------------
+	static string dir_name(const string path)
+	{
+		size_t pos = path.find_last_of("/\\");
+		return (pos == string::npos) ? "." : path.substr(0, pos + 1);
+	}
+
+	// --------------------------------------------------------------------------------------------------------
+	// absolute path of an existing file or directory, with symbolic links resolved (in lower case on Windows), 
+	// to compare two paths. Returns the path as given if it cannot be resolved.
+	// --------------------------------------------------------------------------------------------------------
+	static string full_path(const string path)
+	{
+#ifdef WIN32
+		char buffer[MAX_PATH];
+		DWORD length = GetFullPathNameA(path.c_str(), MAX_PATH, buffer, NULL);
+		if (length == 0 || length >= MAX_PATH)
+			return path;
+		string full = buffer;
+		replace(full.begin(), full.end(), '/', '\\');
+		while (full.length() > 3 && full[full.length() - 1] == '\\')
+			full.erase(full.length() - 1);
+		transform(full.begin(), full.end(), full.begin(), ::tolower);
+		return full;
+#else
+		char *resolved = realpath(path.c_str(), NULL);
+		if (resolved == NULL)
+			return path;
+		string full = resolved;
+		free(resolved);
+		return full;
+#endif
+	}
+
+	// --------------------------------------------------------------------------------------------------------
+	// output file of each input file, in outdir and with the same name as the input file. Returns false if 
+	// two input files have the same name (in any case on Windows), their results would overwrite each other, 
+	// or if an input file is in outdir, it would be overwritten by its own result.
+	// --------------------------------------------------------------------------------------------------------
+	static bool list_output_files(const vector<string> &files, const string outdir, vector<string> &outfiles)
+	{
+		outfiles.clear();
+		vector< pair<string, size_t> > names;
+		const string outpath = full_path(outdir);
+		map<string, string> dirs;
+		bool distinct = true;
+		for (size_t i = 0; i < files.size(); i++)
+		{
+			string name = base_name(files[i]);
+			outfiles.push_back(outdir + "/" + name);
+			string dir = dir_name(files[i]);
+			map<string, string>::iterator it = dirs.find(dir);
+			if (it == dirs.end())
+				it = dirs.insert(make_pair(dir, full_path(dir))).first;
+			if (it->second == outpath)
+			{
+				cerr << "Output file " << outfiles[i] << " would overwrite the input file " << files[i] << endl;
+				distinct = false;
+			}
+#ifdef WIN32
+			transform(name.begin(), name.end(), name.begin(), ::tolower);
+#endif
+			names.push_back(make_pair(name, i));
+		}
+		sort(names.begin(), names.end());
+		bool unique = true;
+		for (size_t i = 1; i < names.size(); i++)
+		{
+			if (names[i].first != names[i - 1].first)
+				continue;
+			cerr << "Same output file " << outfiles[names[i].second] << " for " << files[names[i - 1].second] 
+				 << " and " << files[names[i].second] << endl;
+			unique = false;
+		}
+		return unique && distinct;
+	}
+
+	// --------------------------------------------------------------------------------------------------------
+	static bool is_directory(const string path)
+	{
+#ifdef WIN32
+		DWORD attributes = GetFileAttributesA(path.c_str());
+		return attributes != INVALID_FILE_ATTRIBUTES && (attributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+#else
+		struct stat st;
+		return stat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+#endif
+	}
+
+	// --------------------------------------------------------------------------------------------------------
+	bool list_input_files(const string source, vector<string> &files)
+	{
+		files.clear();
+		if (is_directory(source))
+		{
+#ifdef WIN32
+			WIN32_FIND_DATAA data;
+			HANDLE h = FindFirstFileA((source + "\\*.xml").c_str(), &data);
+			if (h == INVALID_HANDLE_VALUE)
+				return true;
+			do
+			{
+				if ((data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == 0)
+					files.push_back(source + "\\" + data.cFileName);
+			} while (FindNextFileA(h, &data));
+			FindClose(h);
+#else
+			DIR *dir = opendir(source.c_str());
+			if (dir == NULL)
+				return false;
+			struct dirent *entry;
+			while ((entry = readdir(dir)) != NULL)
+			{
+				string name = entry->d_name;
+				if (has_xml_extension(name) && !is_directory(source + "/" + name))
+					files.push_back(source + "/" + name);
+			}
+			closedir(dir);
+#endif
+			sort(files.begin(), files.end());
+			return true;
+		}
+
+		ifstream list(source.c_str());
+		if (!list)
+			return false;
+		string line;
+		while (getline(list, line))
+		{
+			// ignore trailing white space (and the CR of a DOS text file) and empty lines
+			size_t end = line.find_last_not_of(" \t\r");
+			if (end != string::npos)
+				files.push_back(line.substr(0, end + 1));
+		}
+		return true;
+	}
+
+	// --------------------------------------------------------------------------------------------------------
+	// shared state of the worker threads of run_batch
+	// --------------------------------------------------------------------------------------------------------
+	struct batch_run
+	{
+		const source_model *model;
+		const vector<string> *files;
+		const vector<string> *outfiles;
+		Mutex mutex;
+		size_t next_file;
+		size_t done;
+		size_t report_interval;
+		size_t failed;
+		vector<string> failures;
+		double start_time;
+	};
+
+	static void batch_worker(void *arg)
+	{
+		batch_run *batch = (batch_run*)arg;
+		void *context = batch->model->create_context();
+
+		for (;;)
+		{
+			batch->mutex.lock();
+			size_t index = batch->next_file++;
+			batch->mutex.unlock();
+			if (index >= batch->files->size())
+				break;
+
+			const string &infile = (*batch->files)[index];
+			const string &outfile = (*batch->outfiles)[index];
+			int result = (context != NULL) ? batch->model->calc_from_file(context, infile, outfile) : -1;
+
+			batch->mutex.lock();
+			if (result != 0)
+			{
+				batch->failed++;
+				if (batch->failures.size() < MAX_LISTED_FAILURES)
+					batch->failures.push_back(infile);
+			}
+			batch->done++;
+			if (batch->done % batch->report_interval == 0)
+			{
+				double elapsed = max(wall_time() - batch->start_time, 1e-9);
+				cout << batch->done << " of " << batch->files->size() << " files, "
+					 << batch->done / elapsed << " files/s" << endl;
+			}
+			batch->mutex.unlock();
+		}
+
+		if (context != NULL)
+			batch->model->release_context(context);
+	}
+
+	// --------------------------------------------------------------------------------------------------------
+	int run_batch(const source_model &model, const string source, const string outdir, const int threads)
+	{
+		vector<string> files;
+		if (!list_input_files(source, files))
+		{
+			cerr << "Unable to read the input files from " << source << endl;
+			return 1;
+		}
+		if (files.empty())
+		{
+			cerr << "No input files in " << source << endl;
+			return 1;
+		}
+		if (is_directory(source) && full_path(source) == full_path(outdir))
+		{
+			cerr << "The output directory " << outdir << " is the input directory, the input files would be overwritten" << endl;
+			return 1;
+		}
+		vector<string> outfiles;
+		if (!list_output_files(files, outdir, outfiles))
+			return 1;
+
+		batch_run batch;
+		batch.model = &model;
+		batch.files = &files;
+		batch.outfiles = &outfiles;
+		batch.next_file = 0;
+		batch.done = 0;
+		batch.report_interval = max(files.size() / 10, (size_t)1);
+		batch.failed = 0;
+
+		int workers = (threads > 0) ? threads : processor_count();
+		workers = max(1, min(workers, (int)files.size()));
+		cout << "Input files       : " << files.size() << endl;
+		cout << "Worker threads    : " << workers << endl;
+
+		batch.start_time = wall_time();
+		run_parallel(workers, batch_worker, &batch);
+		double elapsed = max(wall_time() - batch.start_time, 1e-9);
+
+		cout << "Calculated        : " << files.size() - batch.failed << " files in " << elapsed << " s, "
+			 << files.size() / elapsed << " files/s" << endl;
+		if (batch.failed > 0)
+		{
+			sort(batch.failures.begin(), batch.failures.end());
+			cout << "Failed            : " << batch.failed << " files" << endl;
+			for (size_t i = 0; i < batch.failures.size(); i++)
+				cout << "  " << batch.failures[i] << endl;
+			if (batch.failed > batch.failures.size())
+				cout << "  ... and " << batch.failed - batch.failures.size() << " more" << endl;
+			return 1;
+		}
+		return 0;
+	}
+}
@@ -0,0 +1,41 @@
+#pragma once
+// CNOSSOS_BATCH.h : Calculation of a batch of input files with one of the source models.
+//
+
+#include <string>
+#include <vector>
+#include "CNOSSOS_MODELS.h"
+
+using namespace std;
+
+namespace CNOSSOS
+{
+	// --------------------------------------------------------------------------------------------------------
+	// Collects the input files of a batch
+	//
+	// Parameters :
+	//				source	: a directory, of which all *.xml files are taken (sorted by name), or a text
+	//						  file with the name of one input file on each line
+	//				files	: receives the names of the input files
+	//
+	// Return value :		  false if the source can not be read
+	// --------------------------------------------------------------------------------------------------------
+	bool list_input_files(const string source, vector<string> &files);
+
+	// --------------------------------------------------------------------------------------------------------
+	// Calculates a batch of input files. The catalogue of the source model is loaded once (by model.init),
+	// the files are distributed over a pool of worker threads, each with its own calculation context. The
+	// result of each input file is written to the output directory under the name of the input file. A
+	// failing file does not stop the batch; the failures are listed at the end. Nothing is calculated if 
+	// two input files have the same name, or if an input file is in the output directory.
+	//
+	// Parameters :
+	//				model	: the source model, initialized
+	//				source	: directory or list file with the input files, see list_input_files
+	//				outdir	: directory for the output files
+	//				threads	: number of worker threads, 0 = number of processors
+	//
+	// Return value :		  0 if all files were calculated, 1 otherwise
+	// --------------------------------------------------------------------------------------------------------
+	int run_batch(const source_model &model, const string source, const string outdir, const int threads);
+}
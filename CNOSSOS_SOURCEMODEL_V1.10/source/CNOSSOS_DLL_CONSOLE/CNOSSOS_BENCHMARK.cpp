@@ -0,0 +1,447 @@
+#pragma once
+// CNOSSOS_BENCHMARK.cpp : Timing and consistency checks of the source models, run from the console application.
+//
+
+#include "stdafx.h"
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <ctime>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#ifdef WIN32
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+#include "CNOSSOS_BENCHMARK.h"
+#include "CNOSSOS_THREAD.h"
+#include "../CNOSSOS_ROADNOISE_DLL/CNOSSOS_ROADNOISE_DLL.h"
+
+using namespace std;
+
+namespace CNOSSOS
+{
+	// --------------------------------------------------------------------------------------------------------
+	double cpu_time(void)
+	{
+		return (double)clock() / CLOCKS_PER_SEC;
+	}
+
+	// --------------------------------------------------------------------------------------------------------
+	double wall_time(void)
+	{
+#ifdef WIN32
+		LARGE_INTEGER count, frequency;
+		QueryPerformanceCounter(&count);
+		QueryPerformanceFrequency(&frequency);
+		return (double)count.QuadPart / (double)frequency.QuadPart;
+#else
+		struct timeval tv;
+		gettimeofday(&tv, NULL);
+		return tv.tv_sec + 1e-6 * tv.tv_usec;
+#endif
+	}
+
+	// --------------------------------------------------------------------------------------------------------
+	// uniformly distributed random number in [low, high]
+	// --------------------------------------------------------------------------------------------------------
+	static double random_value(const double low, const double high)
+	{
+		return low + (high - low) * ((double)rand() / RAND_MAX);
+	}
+
+	// --------------------------------------------------------------------------------------------------------
+	int benchmark_road_segments(const int count)
+	{
+		using namespace CNOSSOS_ROADNOISE;
+
+		const int numCat = GetNumCategories();
+		const int numSurfaces = GetNumSurfaces();
+		const int numBands = NUM_OCTAVE_BANDS;
+		if (numCat <= 0 || numSurfaces <= 0 || count <= 0)
+		{
+			cerr << "No road noise catalogue loaded" << endl;
+			return 1;
+		}
+
+		// random, but reproducible, road segments
+		srand(12345);
+		vector<double> v(numCat * count), Q(numCat * count), Fstud(numCat * count);
+		vector<int> surface(count), studdedMonths(count), junctionType(count);
+		vector<double> temperature(count), gradient(count), accDistance(count);
+		for (int s = 0; s < count; s++)
+		{
+			surface[s] = rand() % numSurfaces;
+			studdedMonths[s] = rand() % 5;
+			junctionType[s] = rand() % 3;
+			temperature[s] = random_value(-5, 30);
+			gradient[s] = random_value(-8, 8);
+			accDistance[s] = random_value(0, 150);
+			for (int m = 0; m < numCat; m++)
+			{
+				v[m * count + s] = random_value(20, 130);
+				Q[m * count + s] = (rand() % 4 == 0) ? 0.0 : random_value(1, 2000);
+				Fstud[m * count + s] = random_value(0, 0.5);
+			}
+		}
+
+		// single segment interface
+		vector<double> single(numBands * count);
+		double t0 = cpu_time();
+		for (int s = 0; s < count; s++)
+		{
+			SetSurface(GetSurfaceID(surface[s]));
+			SetStuddedMonths(studdedMonths[s]);
+			SetTemperatureProperties(temperature[s]);
+			SetGradientProperties(gradient[s]);
+			SetAccelerationProperties(accDistance[s], junctionType[s]);
+			for (int m = 0; m < numCat; m++)
+			{
+				SetSpeed(m, v[m * count + s]);
+				SetTraffic(m, Q[m * count + s]);
+				SetStuddedFraction(m, Fstud[m * count + s]);
+			}
+			CalcSegment();
+			double spec[NUM_OCTAVE_BANDS];
+			GetTotalSpectrum(spec);
+			for (int i = 0; i < numBands; i++)
+				single[i * count + s] = spec[i];
+		}
+		double t1 = cpu_time();
+
+		// multiple segment interface
+		vector<double> multiple(numBands * count);
+		RoadSegmentArrays segments;
+		segments.count = count;
+		segments.v = &v[0];
+		segments.Q = &Q[0];
+		segments.Fstud = &Fstud[0];
+		segments.surface = &surface[0];
+		segments.studdedMonths = &studdedMonths[0];
+		segments.temperature = &temperature[0];
+		segments.gradient = &gradient[0];
+		segments.accDistance = &accDistance[0];
+		segments.junctionType = &junctionType[0];
+		segments.TotalSpec = &multiple[0];
+		int result = CalcSegments(&segments);
+		double t2 = cpu_time();
+
+		if (result != 0)
+		{
+			cerr << "CalcSegments failed with error code " << result << endl;
+			return 1;
+		}
+
+		double maxDiff = 0.0;
+		for (int k = 0; k < numBands * count; k++)
+			maxDiff = max(maxDiff, fabs(single[k] - multiple[k]));
+
+		cout << "Road segments              : " << count << endl;
+		cout << "Single segment interface   : " << (t1 - t0) << " s, " << count / max(t1 - t0, 1e-9) << " segments/s" << endl;
+		cout << "Multiple segment interface : " << (t2 - t1) << " s, " << count / max(t2 - t1, 1e-9) << " segments/s" << endl;
+		cout << "Max. difference            : " << maxDiff << " dB" << endl;
+
+		return (maxDiff < 1e-9) ? 0 : 1;
+	}
+
+	// --------------------------------------------------------------------------------------------------------
+	int benchmark_road_table(const int links)
+	{
+		using namespace CNOSSOS_ROADNOISE;
+
+		const int numCat = GetNumCategories();
+		const int numSurfaces = GetNumSurfaces();
+		const int numBands = NUM_OCTAVE_BANDS;
+		const int numHours = 24;
+		if (numCat <= 0 || numSurfaces <= 0 || links <= 0)
+		{
+			cerr << "No road noise catalogue loaded" << endl;
+			return 1;
+		}
+
+		// hourly traffic models only use a few distinct speeds
+		const double speeds[] = { 10, 27.5, 33, 47, 52, 64, 71, 83, 88, 97, 104, 117, 126 };
+		const int numSpeeds = sizeof(speeds) / sizeof(speeds[0]);
+
+		// random, but reproducible, road links; traffic and speeds per hour
+		srand(54321);
+		vector<int> surface(links), studdedMonths(links), junctionType(links);
+		vector<double> temperature(links), gradient(links), accDistance(links), Fstud(numCat * links);
+		vector<double> v(numHours * numCat * links), Q(numHours * numCat * links);
+		for (int s = 0; s < links; s++)
+		{
+			surface[s] = rand() % numSurfaces;
+			studdedMonths[s] = rand() % 5;
+			junctionType[s] = rand() % 3;
+			temperature[s] = random_value(-5, 30);
+			gradient[s] = random_value(-8, 8);
+			accDistance[s] = random_value(0, 150);
+			for (int m = 0; m < numCat; m++)
+			{
+				Fstud[m * links + s] = random_value(0, 0.5);
+				double speed = speeds[rand() % numSpeeds];
+				for (int h = 0; h < numHours; h++)
+				{
+					// congestion during rush hours
+					bool rush = (h == 8 || h == 17);
+					v[(h * numCat + m) * links + s] = rush ? min(speed, 30.0) : speed;
+					Q[(h * numCat + m) * links + s] = (rand() % 4 == 0) ? 0.0 : random_value(1, 2000);
+				}
+			}
+		}
+
+		RoadSegmentArrays segments;
+		segments.count = links;
+		segments.Fstud = &Fstud[0];
+		segments.surface = &surface[0];
+		segments.studdedMonths = &studdedMonths[0];
+		segments.temperature = &temperature[0];
+		segments.gradient = &gradient[0];
+		segments.accDistance = &accDistance[0];
+		segments.junctionType = &junctionType[0];
+
+		vector<double> exact(numHours * numBands * links), tabulated(numHours * numBands * links);
+		double timing[2];
+		double buildTime = 0.0;
+		int numNodes = 0;
+		for (int pass = 0; pass < 2; pass++)
+		{
+			double t0 = cpu_time();
+			if (pass == 1)
+			{
+				numNodes = SetEmissionTable(20, 130, 0.01);
+				buildTime = cpu_time() - t0;
+				t0 = cpu_time();
+			}
+			for (int h = 0; h < numHours; h++)
+			{
+				segments.v = &v[h * numCat * links];
+				segments.Q = &Q[h * numCat * links];
+				segments.TotalSpec = (pass == 0) ? &exact[h * numBands * links] : &tabulated[h * numBands * links];
+				if (CalcSegments(&segments) != 0)
+				{
+					cerr << "CalcSegments failed" << endl;
+					return 1;
+				}
+			}
+			timing[pass] = cpu_time() - t0;
+		}
+		double bound = GetEmissionTableError();
+		SetEmissionTable(0, 0, 0);
+
+		double maxDiff = 0.0;
+		for (size_t k = 0; k < exact.size(); k++)
+		{
+			if (exact[k] > -1e300)
+				maxDiff = max(maxDiff, fabs(exact[k] - tabulated[k]));
+		}
+
+		double linkHours = (double)links * numHours;
+		cout << "Road links x hours      : " << links << " x " << numHours << endl;
+		cout << "Emission table          : " << numNodes << " speeds, built in " << buildTime << " s" << endl;
+		cout << "Exact calculation       : " << timing[0] << " s, " << linkHours / max(timing[0], 1e-9) << " link hours/s" << endl;
+		cout << "Tabulated calculation   : " << timing[1] << " s, " << linkHours / max(timing[1], 1e-9) << " link hours/s" << endl;
+		cout << "Error bound of table    : " << bound << " dB" << endl;
+		cout << "Max. difference         : " << maxDiff << " dB" << endl;
+
+		return (maxDiff <= bound + 1e-9) ? 0 : 1;
+	}
+
+	// --------------------------------------------------------------------------------------------------------
+	double resident_memory(void)
+	{
+#ifdef WIN32
+		PROCESS_MEMORY_COUNTERS pmc;
+		if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+			return (double)pmc.WorkingSetSize;
+		return 0.0;
+#else
+		// the second field of statm is the resident set size in pages
+		long pages = 0, resident = 0;
+		ifstream statm("/proc/self/statm");
+		if (statm >> pages >> resident)
+			return (double)resident * sysconf(_SC_PAGESIZE);
+		return 0.0;
+#endif
+	}
+
+	// --------------------------------------------------------------------------------------------------------
+	int soak_road_segment(const int updates)
+	{
+		using namespace CNOSSOS_ROADNOISE;
+
+		const int numCat = GetNumCategories();
+		const int numSurfaces = GetNumSurfaces();
+		const int numCheckpoints = 10;
+		// allowed growth of the resident set after the warm-up, in bytes
+		const double tolerance = 256 * 1024;
+		if (numCat <= 0 || numSurfaces <= 0 || updates <= 0)
+		{
+			cerr << "No road noise catalogue loaded" << endl;
+			return 1;
+		}
+
+		srand(24680);
+		const int warmup = max(updates / 100, 1);
+		double rssStart = 0.0, rssMax = 0.0;
+		double t0 = cpu_time();
+		for (int n = 0; n < updates; n++)
+		{
+			// hourly re-parameterization of the same segment, with and without junction
+			SetTemperatureProperties(random_value(-5, 30));
+			SetGradientProperties(random_value(-8, 8));
+			SetAccelerationProperties(random_value(0, 150), n % 3);
+			SetStuddedMonths(n % 5);
+			if (n % 24 == 0)
+				SetSurface(GetSurfaceID(rand() % numSurfaces));
+			for (int m = 0; m < numCat; m++)
+			{
+				SetSpeed(m, random_value(20, 130));
+				SetTraffic(m, random_value(1, 2000));
+				SetStuddedFraction(m, random_value(0, 0.5));
+			}
+			CalcSegment();
+
+			if (n + 1 == warmup)
+			{
+				rssStart = resident_memory();
+				rssMax = rssStart;
+			}
+			else if (n + 1 > warmup && (n + 1) % max(updates / numCheckpoints, 1) == 0)
+			{
+				double rss = resident_memory();
+				rssMax = max(rssMax, rss);
+				cout << "After " << (n + 1) << " updates : " << rss / 1024 << " kB resident" << endl;
+			}
+		}
+		double t1 = cpu_time();
+		double growth = rssMax - rssStart;
+
+		cout << "Updates            : " << updates << ", " << updates / max(t1 - t0, 1e-9) << " updates/s" << endl;
+		cout << "Resident at start  : " << rssStart / 1024 << " kB" << endl;
+		cout << "Growth             : " << growth / 1024 << " kB" << endl;
+
+		return (growth <= tolerance) ? 0 : 1;
+	}
+
+	// --------------------------------------------------------------------------------------------------------
+	// contents of a file, empty if the file cannot be read
+	// --------------------------------------------------------------------------------------------------------
+	static string read_file(const string fn)
+	{
+		ifstream f(fn.c_str(), ios::in | ios::binary);
+		ostringstream oss;
+		oss << f.rdbuf();
+		return oss.str();
+	}
+
+	// --------------------------------------------------------------------------------------------------------
+	// shared state of the threads of check_concurrency
+	// --------------------------------------------------------------------------------------------------------
+	struct concurrency_check
+	{
+		const source_model *model;
+		string infile;
+		string outdir;
+		string reference;
+		int repeat;
+		Mutex mutex;
+		int next_thread;
+		int failures;
+		int differences;
+	};
+
+	static void concurrency_thread(void *arg)
+	{
+		concurrency_check *check = (concurrency_check*)arg;
+
+		check->mutex.lock();
+		int index = check->next_thread++;
+		check->mutex.unlock();
+
+		ostringstream oss;
+		oss << check->outdir << "/thread" << index << ".xml";
+		string outfile = oss.str();
+
+		int failures = 0;
+		int differences = 0;
+		void *context = check->model->create_context();
+		for (int r = 0; r < check->repeat; r++)
+		{
+			if (check->model->calc_from_file(context, check->infile, outfile) != 0)
+				failures++;
+			else if (read_file(outfile) != check->reference)
+				differences++;
+		}
+		check->model->release_context(context);
+
+		check->mutex.lock();
+		check->failures += failures;
+		check->differences += differences;
+		check->mutex.unlock();
+	}
+
+	// --------------------------------------------------------------------------------------------------------
+	int check_concurrency(const source_model &model, const string infile, const string outdir)
+	{
+		concurrency_check check;
+		check.model = &model;
+		check.infile = infile;
+		check.outdir = outdir;
+
+		// single threaded reference result
+		string reffile = outdir + "/reference.xml";
+		void *context = model.create_context();
+		if (context == NULL || model.calc_from_file(context, infile, reffile) != 0)
+		{
+			cerr << "Failed to calculate " << infile << endl;
+			model.release_context(context);
+			return 1;
+		}
+		model.release_context(context);
+		check.reference = read_file(reffile);
+
+		// choose the number of files per thread such that the single threaded run takes about one second
+		double t0 = wall_time();
+		int calibrate = 0;
+		context = model.create_context();
+		while (wall_time() - t0 < 0.2 && calibrate < 100000)
+		{
+			model.calc_from_file(context, infile, reffile);
+			calibrate++;
+		}
+		model.release_context(context);
+		check.repeat = max(1, (int)(5 * calibrate));
+
+		cout << "Processors        : " << processor_count() << endl;
+		cout << "Files per thread  : " << check.repeat << endl;
+
+		int result = 0;
+		double base = 0.0;
+		for (int threads = 1; threads <= 8; threads *= 2)
+		{
+			check.next_thread = 0;
+			check.failures = 0;
+			check.differences = 0;
+
+			double t1 = wall_time();
+			run_parallel(threads, concurrency_thread, &check);
+			double elapsed = max(wall_time() - t1, 1e-9);
+
+			double rate = threads * check.repeat / elapsed;
+			if (threads == 1)
+				base = rate;
+			cout << threads << " thread(s) : " << rate << " files/s, speedup " << rate / base 
+				 << ", " << check.failures << " failures, " << check.differences << " differences" << endl;
+			if (check.failures > 0 || check.differences > 0)
+				result = 1;
+		}
+		return result;
+	}
+}
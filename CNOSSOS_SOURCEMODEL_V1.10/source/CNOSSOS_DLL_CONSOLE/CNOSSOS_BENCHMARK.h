@@ -0,0 +1,73 @@
+#pragma once
+// CNOSSOS_BENCHMARK.h : Timing and consistency checks of the source models, run from the console application.
+//
+
+#include <string>
+#include "CNOSSOS_MODELS.h"
+
+using namespace std;
+
+namespace CNOSSOS
+{
+	// --------------------------------------------------------------------------------------------------------
+	// Compares the throughput of the multiple segment interface (CalcSegments) of the road noise 
+	// model with a loop over the single segment interface, using a set of random road segments.
+	//
+	// Parameters :
+	//				count	: number of road segments
+	//
+	// Return value :		  0 if both interfaces give the same results, 1 otherwise
+	// --------------------------------------------------------------------------------------------------------
+	int benchmark_road_segments(const int count);
+
+	// --------------------------------------------------------------------------------------------------------
+	// Accuracy and timing of the road noise emission table : re-emits a set of random road links for 
+	// 24 hourly periods, with and without the table.
+	//
+	// Parameters :
+	//				links	: number of road links
+	//
+	// Return value :		  0 if the differences are within the error bound of the table, 1 otherwise
+	// --------------------------------------------------------------------------------------------------------
+	int benchmark_road_table(const int links);
+
+	// --------------------------------------------------------------------------------------------------------
+	// Soak test of the single segment interface of the road noise model : the same road segment is 
+	// re-parameterized and calculated repeatedly, and the resident memory is sampled after a warm-up.
+	//
+	// Parameters :
+	//				updates	: number of updates of the road segment
+	//
+	// Return value :		  0 if the resident memory stays flat, 1 otherwise
+	// --------------------------------------------------------------------------------------------------------
+	int soak_road_segment(const int updates);
+
+	// --------------------------------------------------------------------------------------------------------
+	// Multi-threaded consistency check and scaling benchmark of the handle based interface of a source 
+	// model : the input file is calculated repeatedly by 1, 2, 4 and 8 threads at the same time, each 
+	// thread with its own context, and every result is compared with the single threaded result.
+	//
+	// Parameters :
+	//				model	: the source model, initialized
+	//				infile	: the input file
+	//				outdir	: directory for the output files
+	//
+	// Return value :		  0 if all results are identical, 1 otherwise
+	// --------------------------------------------------------------------------------------------------------
+	int check_concurrency(const source_model &model, const string infile, const string outdir);
+
+	// --------------------------------------------------------------------------------------------------------
+	// Processor time used by the current process, in seconds
+	// --------------------------------------------------------------------------------------------------------
+	double cpu_time(void);
+
+	// --------------------------------------------------------------------------------------------------------
+	// Elapsed real time since an arbitrary moment, in seconds
+	// --------------------------------------------------------------------------------------------------------
+	double wall_time(void);
+
+	// --------------------------------------------------------------------------------------------------------
+	// Resident memory (working set) of the current process, in bytes
+	// --------------------------------------------------------------------------------------------------------
+	double resident_memory(void);
+}
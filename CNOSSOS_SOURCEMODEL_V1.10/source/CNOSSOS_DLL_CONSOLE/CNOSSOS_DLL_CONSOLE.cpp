@@ -9,10 +9,14 @@
 #endif
 #include <string>
 #include <sstream>
+#include <cstdlib>
 
 #include "../CNOSSOS_ROADNOISE_DLL/CNOSSOS_ROADNOISE_DLL.h"
 #include "../CNOSSOS_INDUSTRIAL_NOISE_DLL/CNOSSOS_INDUSTRIAL_NOISE_DLL.h"
 #include "../CNOSSOS_RAILNOISE_DLL/CNOSSOS_RAILNOISE_DLL.h"
+#include "CNOSSOS_BENCHMARK.h"
+#include "CNOSSOS_MODELS.h"
+#include "CNOSSOS_BATCH.h"
 
 using namespace std;
 
@@ -20,17 +24,101 @@ void show_usage(string program_name)
 {
 	cout << "Usage:" << endl;
 	cout << program_name << " <-road | -rail | -industry> infile outfile" << endl;
+	cout << program_name << " -road -benchmark segments" << endl;
+	cout << program_name << " -road -table links" << endl;
+	cout << program_name << " -road -soak updates" << endl;
+	cout << program_name << " <-road | -rail | -industry> -concurrency infile outdir" << endl;
+	cout << program_name << " <-road | -rail | -industry> -batch <indir | listfile> outdir [threads]" << endl;
 }
 
 int main(int argc, char** argv)
 {
-	if (argc == 4)
+	CNOSSOS::source_model model;
+	if (argc == 5 && string(argv[2]).compare("-concurrency") == 0 && CNOSSOS::select_source_model(argv[1], model))
+	{
+		cout << "Starting CNOSSOS " << model.name << " concurrency check" << endl;
+		if (model.init() >= 0)
+		{
+			int result = CNOSSOS::check_concurrency(model, argv[3], argv[4]);
+			model.release();
+			return result;
+		}
+		else
+		{
+			cerr << "Failed to initialize DLL" << endl;
+			return 1;
+		}
+	}
+	else if ((argc == 5 || argc == 6) && string(argv[2]).compare("-batch") == 0 && CNOSSOS::select_source_model(argv[1], model))
+	{
+		cout << "Starting CNOSSOS " << model.name << " batch calculation" << endl;
+		if (model.init() >= 0)
+		{
+			int result = CNOSSOS::run_batch(model, argv[3], argv[4], (argc == 6) ? atoi(argv[5]) : 0);
+			model.release();
+			return result;
+		}
+		else
+		{
+			cerr << "Failed to initialize DLL" << endl;
+			return 1;
+		}
+	}
+	else if (argc == 4)
 	{
 		string t = argv[1];		
 		string infile = argv[2];
 		string outfile = argv[3];
 		// ----------------------------------------------------------------------------------------
-		if (t.compare("-road") == 0)
+		if (t.compare("-road") == 0 && infile.compare("-benchmark") == 0)
+		{
+			cout << "Starting CNOSSOS road noise benchmark" << endl;
+			if (CNOSSOS_ROADNOISE::InitDLL() >= 0)
+			{
+				int result = CNOSSOS::benchmark_road_segments(atoi(argv[3]));
+				CNOSSOS_ROADNOISE::ReleaseDLL();
+				return result;
+			}
+			else
+			{
+				cerr << "Failed to initialize DLL" << endl;
+				return 1;
+			}
+		}
+		// ----------------------------------------------------------------------------------------
+		else if (t.compare("-road") == 0 && infile.compare("-table") == 0)
+		{
+			cout << "Starting CNOSSOS road noise emission table benchmark" << endl;
+			if (CNOSSOS_ROADNOISE::InitDLL() >= 0)
+			{
+				int result = CNOSSOS::benchmark_road_table(atoi(argv[3]));
+				CNOSSOS_ROADNOISE::ReleaseDLL();
+				return result;
+			}
+			else
+			{
+				cerr << "Failed to initialize DLL" << endl;
+				return 1;
+			}
+		}
+		// ----------------------------------------------------------------------------------------
+		else if (t.compare("-road") == 0 && infile.compare("-soak") == 0)
+		{
+			cout << "Starting CNOSSOS road noise soak test" << endl;
+			if (CNOSSOS_ROADNOISE::InitDLL() >= 0)
+			{
+				int result = CNOSSOS::soak_road_segment(atoi(argv[3]));
+				CNOSSOS_ROADNOISE::ReleaseDLL();
+				return result;
+			}
+			else
+			{
+				cerr << "Failed to initialize DLL" << endl;
+				return 1;
+			}
+		}
+		// ----------------------------------------------------------------------------------------
+		else if (t.compare("-road") == 0)
 		{
 			cout << "Starting CNOSSOS road noise calculation" << endl;
 			if (CNOSSOS_ROADNOISE::InitDLL() >= 0)
@@ -0,0 +1,51 @@
+#pragma once
+// CNOSSOS_MODELS.cpp : Uniform access to the entry points of the three source model DLLs.
+//
+
+#include "stdafx.h"
+#include "CNOSSOS_MODELS.h"
+
+#include "../CNOSSOS_ROADNOISE_DLL/CNOSSOS_ROADNOISE_DLL.h"
+#include "../CNOSSOS_INDUSTRIAL_NOISE_DLL/CNOSSOS_INDUSTRIAL_NOISE_DLL.h"
+#include "../CNOSSOS_RAILNOISE_DLL/CNOSSOS_RAILNOISE_DLL.h"
+
+using namespace std;
+
+namespace CNOSSOS
+{
+	// --------------------------------------------------------------------------------------------------------
+	bool select_source_model(const string option, source_model &model)
+	{
+		if (option.compare("-road") == 0)
+		{
+			model.name = "road noise";
+			model.init = CNOSSOS_ROADNOISE::InitDLL;
+			model.release = CNOSSOS_ROADNOISE::ReleaseDLL;
+			model.create_context = CNOSSOS_ROADNOISE::CreateContext;
+			model.release_context = CNOSSOS_ROADNOISE::ReleaseContext;
+			model.calc_from_file = CNOSSOS_ROADNOISE::CalcFromFileWithContext;
+			return true;
+		}
+		else if (option.compare("-rail") == 0)
+		{
+			model.name = "rail noise";
+			model.init = CNOSSOS_RAILNOISE::InitDLL;
+			model.release = CNOSSOS_RAILNOISE::ReleaseDLL;
+			model.create_context = CNOSSOS_RAILNOISE::CreateContext;
+			model.release_context = CNOSSOS_RAILNOISE::ReleaseContext;
+			model.calc_from_file = CNOSSOS_RAILNOISE::CalcFromFileWithContext;
+			return true;
+		}
+		else if (option.compare("-industry") == 0)
+		{
+			model.name = "industrial noise";
+			model.init = CNOSSOS_INDUSTRIAL_NOISE::InitDLL;
+			model.release = CNOSSOS_INDUSTRIAL_NOISE::ReleaseDLL;
+			model.create_context = CNOSSOS_INDUSTRIAL_NOISE::CreateContext;
+			model.release_context = CNOSSOS_INDUSTRIAL_NOISE::ReleaseContext;
+			model.calc_from_file = CNOSSOS_INDUSTRIAL_NOISE::CalcFromFileWithContext;
+			return true;
+		}
+		return false;
+	}
+}
@@ -0,0 +1,34 @@
+#pragma once
+// CNOSSOS_MODELS.h : Uniform access to the entry points of the three source model DLLs.
+//
+
+#include <string>
+
+using namespace std;
+
+namespace CNOSSOS
+{
+	// --------------------------------------------------------------------------------------------------------
+	// Entry points of one of the source model DLLs
+	// --------------------------------------------------------------------------------------------------------
+	struct source_model
+	{
+		string	name;
+		int		(*init)(void);
+		int		(*release)(void);
+		void*	(*create_context)(void);
+		int		(*release_context)(void *context);
+		int		(*calc_from_file)(void *context, const string infile, const string outfile);
+	};
+
+	// --------------------------------------------------------------------------------------------------------
+	// Selects the source model given by a command line option
+	//
+	// Parameters :
+	//				option	: -road, -rail or -industry
+	//				model	: receives the entry points of the selected model
+	//
+	// Return value :		  false if the option does not select a source model
+	// --------------------------------------------------------------------------------------------------------
+	bool select_source_model(const string option, source_model &model);
+}
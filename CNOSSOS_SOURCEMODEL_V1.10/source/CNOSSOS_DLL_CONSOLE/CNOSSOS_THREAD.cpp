@@ -0,0 +1,104 @@
+#pragma once
+// CNOSSOS_THREAD.cpp : Minimal portable threading support for the console application.
+//
+
+#include "stdafx.h"
+#include "CNOSSOS_THREAD.h"
+#include <vector>
+#ifdef WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace CNOSSOS
+{
+	struct thread_start
+	{
+		thread_function function;
+		void *arg;
+	};
+
+#ifdef WIN32
+	static unsigned __stdcall thread_entry(void *p)
+	{
+		thread_start *start = (thread_start*)p;
+		start->function(start->arg);
+		return 0;
+	}
+#else
+	static void* thread_entry(void *p)
+	{
+		thread_start *start = (thread_start*)p;
+		start->function(start->arg);
+		return NULL;
+	}
+#endif
+
+	// --------------------------------------------------------------------------------------------------------
+	void run_parallel(const int count, thread_function function, void *arg)
+	{
+		if (count <= 1)
+		{
+			function(arg);
+			return;
+		}
+
+		thread_start start;
+		start.function = function;
+		start.arg = arg;
+
+#ifdef WIN32
+		vector<HANDLE> threads;
+		for (int i = 0; i < count; i++)
+		{
+			HANDLE h = (HANDLE)_beginthreadex(NULL, 0, thread_entry, &start, 0, NULL);
+			if (h != 0)
+				threads.push_back(h);
+		}
+		for (size_t i = 0; i < threads.size(); i++)
+		{
+			WaitForSingleObject(threads[i], INFINITE);
+			CloseHandle(threads[i]);
+		}
+#else
+		vector<pthread_t> threads;
+		for (int i = 0; i < count; i++)
+		{
+			pthread_t t;
+			if (pthread_create(&t, NULL, thread_entry, &start) == 0)
+				threads.push_back(t);
+		}
+		for (size_t i = 0; i < threads.size(); i++)
+			pthread_join(threads[i], NULL);
+#endif
+	}
+
+	// --------------------------------------------------------------------------------------------------------
+	int processor_count(void)
+	{
+#ifdef WIN32
+		SYSTEM_INFO info;
+		GetSystemInfo(&info);
+		return (int)info.dwNumberOfProcessors;
+#else
+		long n = sysconf(_SC_NPROCESSORS_ONLN);
+		return (n > 0) ? (int)n : 1;
+#endif
+	}
+
+	// --------------------------------------------------------------------------------------------------------
+#ifdef WIN32
+	Mutex::Mutex()				{ InitializeCriticalSection(&cs); }
+	Mutex::~Mutex()				{ DeleteCriticalSection(&cs); }
+	void Mutex::lock(void)		{ EnterCriticalSection(&cs); }
+	void Mutex::unlock(void)	{ LeaveCriticalSection(&cs); }
+#else
+	Mutex::Mutex()				{ pthread_mutex_init(&mutex, NULL); }
+	Mutex::~Mutex()				{ pthread_mutex_destroy(&mutex); }
+	void Mutex::lock(void)		{ pthread_mutex_lock(&mutex); }
+	void Mutex::unlock(void)	{ pthread_mutex_unlock(&mutex); }
+#endif
+}
@@ -0,0 +1,55 @@
+#pragma once
+// CNOSSOS_THREAD.h : Minimal portable threading support for the console application.
+//
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+namespace CNOSSOS
+{
+	// --------------------------------------------------------------------------------------------------------
+	// Function executed by each thread started by run_parallel
+	// --------------------------------------------------------------------------------------------------------
+	typedef void (*thread_function)(void *arg);
+
+	// --------------------------------------------------------------------------------------------------------
+	// Runs function(arg) on "count" threads at the same time and waits until all threads are finished
+	//
+	// Parameters :
+	//				count		: number of threads
+	//				function	: function to be executed by each thread
+	//				arg			: argument passed to each call of function
+	// --------------------------------------------------------------------------------------------------------
+	void run_parallel(const int count, thread_function function, void *arg);
+
+	// --------------------------------------------------------------------------------------------------------
+	// Number of processors available to the current process
+	// --------------------------------------------------------------------------------------------------------
+	int processor_count(void);
+
+	// --------------------------------------------------------------------------------------------------------
+	// Mutual exclusion between the threads started by run_parallel
+	// --------------------------------------------------------------------------------------------------------
+	class Mutex
+	{
+		private:
+#ifdef WIN32
+			CRITICAL_SECTION cs;
+#else
+			pthread_mutex_t mutex;
+#endif
+			// not copyable
+			Mutex(const Mutex&);
+			Mutex& operator=(const Mutex&);
+
+		public:
+			Mutex();
+			~Mutex();
+
+			void lock(void);
+			void unlock(void);
+	};
+}
@@ -82,6 +82,8 @@ namespace CNOSSOS_INDUSTRIAL_NOISE
 			delete currentSourceSet;
 			// destroy catalogue
 			delete catalogue;
+			currentSourceSet = NULL;
+			catalogue = NULL;
 
 			return 0;
 		}
@@ -93,33 +95,34 @@ namespace CNOSSOS_INDUSTRIAL_NOISE
 
 	// --------------------------------------------------------------------------------------------------------
 	/// <summary>
-	/// Calculates from file.
+	/// Calculates from file, using the given source set.
 	/// </summary>
+	/// <param name="sourceSet">The source set used for the calculation.</param>
 	/// <param name="infile">The input XML file.</param>
 	/// <param name="outfile">The output XML file.</param>
 	/// <returns>0 = OK, 1 = error while loading, 2 = error while calculating, 3 = error while saving, 4 = internal error</returns>
-	int CalcFromFile(const string infile, const string outfile)
+	static int CalcSourceSetFromFile(IndustrySourceSet *sourceSet, const string infile, const string outfile)
 	{
 		int result = 0;
-		if (currentSourceSet == NULL)
+		if (sourceSet == NULL)
 		{
 			return 4;
 		}
-		else if (currentSourceSet->loadFromXmlFile(infile))
+		else if (sourceSet->loadFromXmlFile(infile))
 		{
-			result = currentSourceSet->Calculate();
-			if (!currentSourceSet->saveResultsToXmlFile(outfile))
+			result = sourceSet->Calculate();
+			if (!sourceSet->saveResultsToXmlFile(outfile))
 			{
 				cerr << "Error while trying to save " << outfile << "." << endl;
 				if (result == 0)
 					result = 2;
 			}
 
-			if (currentSourceSet->doDebug)
+			if (sourceSet->doDebug)
 			{
 				string debugfile = outfile;
 				debugfile = debugfile.substr(0, debugfile.find_last_of(".")) + ".csv";
-				if (currentSourceSet->writeDebugData(debugfile))
+				if (sourceSet->writeDebugData(debugfile))
 				{
 					cout << "Test file saved to " << debugfile << "." << endl;
 				}
@@ -129,4 +132,64 @@ namespace CNOSSOS_INDUSTRIAL_NOISE
 		}
 		return 1;
 	};
+
+	// --------------------------------------------------------------------------------------------------------
+	/// <summary>
+	/// Calculates from file.
+	/// </summary>
+	/// <param name="infile">The input XML file.</param>
+	/// <param name="outfile">The output XML file.</param>
+	/// <returns>0 = OK, 1 = error while loading, 2 = error while calculating, 3 = error while saving, 4 = internal error</returns>
+	int CalcFromFile(const string infile, const string outfile)
+	{
+		return CalcSourceSetFromFile(currentSourceSet, infile, outfile);
+	};
+
+	// --------------------------------------------------------------------------------------------------------
+	/// <summary>
+	/// Creates a new calculation context, with its own source set.
+	/// </summary>
+	/// <returns>The handle of the context, NULL if the DLL is not initialized</returns>
+	ContextHandle CreateContext(void)
+	{
+		if (catalogue == NULL)
+			return NULL;
+		try
+		{
+			return new IndustrySourceSet(catalogue);
+		}
+		catch (...)
+		{
+			return NULL;
+		}
+	};
+
+	// --------------------------------------------------------------------------------------------------------
+	/// <summary>
+	/// Releases a calculation context created by CreateContext.
+	/// </summary>
+	/// <returns>0 if all went well, -1 if something went wrong</returns>
+	int ReleaseContext(ContextHandle context)
+	{
+		try
+		{
+			if (context != NULL)
+				delete (IndustrySourceSet*)context;
+			return 0;
+		}
+		catch (...)
+		{
+			return -1;
+		}
+	};
+
+	// --------------------------------------------------------------------------------------------------------
+	/// <summary>
+	/// Calculates from file, using the source set of the given context.
+	/// </summary>
+	/// <returns>0 = OK, 1 = error while loading, 2 = error while calculating, 3 = error while saving, 4 = internal error</returns>
+	int CalcFromFileWithContext(ContextHandle context, const string infile, const string outfile)
+	{
+		return CalcSourceSetFromFile((IndustrySourceSet*)context, infile, outfile);
+	};
 }
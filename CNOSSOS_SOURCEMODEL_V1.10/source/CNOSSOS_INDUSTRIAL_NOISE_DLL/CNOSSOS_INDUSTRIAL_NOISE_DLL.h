@@ -7,7 +7,7 @@
 // CNOSSOS_DLL_EXPORTS functions as being imported from a DLL, whereas this DLL sees symbols
 // defined with this macro as being exported.
 #ifndef WIN32
-#define CNOSSOS_DLL_API extern "C"
+#define CNOSSOS_DLL_API
 #elif CNOSSOS_DLL_EXPORTS
 #define CNOSSOS_DLL_API __declspec(dllexport)
 #else
@@ -30,4 +30,19 @@ namespace CNOSSOS_INDUSTRIAL_NOISE
 
 	// Get the current version of the Cnossos Industrial Source module shared library.
 	CNOSSOS_DLL_API char* GetVersionDLL (void);
+
+	// -------------------------------------------------------------------------------------------------------------
+	// handle based interface : all contexts share the catalogue loaded by InitDLL, but each context has its 
+	// own source set, so different contexts can be used by different threads at the same time.
+	// -------------------------------------------------------------------------------------------------------------
+	typedef void* ContextHandle;
+
+	// Create a new calculation context, NULL if the DLL is not initialized
+	CNOSSOS_DLL_API ContextHandle CreateContext(void);
+
+	// Release a calculation context
+	CNOSSOS_DLL_API int ReleaseContext(ContextHandle context);
+
+	// Calculate the source power given by the infile and the place the results in the outfile, using the given context
+	CNOSSOS_DLL_API int CalcFromFileWithContext(ContextHandle context, const string infile, const string outfile);
 }
@@ -201,6 +201,7 @@ namespace CNOSSOS_INDUSTRIAL_NOISE
 			}
 
 			this->doDebug = CNOSSOS::boolFromElement(root, "Test");
+			this->sources.clear();
 
 			TiXmlElement *src = root->FirstChildElement("Source");
 			if (src == NULL)
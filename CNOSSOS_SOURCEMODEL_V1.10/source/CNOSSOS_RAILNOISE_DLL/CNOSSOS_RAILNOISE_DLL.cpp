@@ -38,8 +38,8 @@ namespace CNOSSOS_RAILNOISE
 		#endif
 	}
 
-	RailCatalogue *catalogue;
-	RailSection *currentSection;
+	RailCatalogue *catalogue = NULL;
+	RailSection *currentSection = NULL;
 
 	// --------------------------------------------------------------------------------------------------------
 	/// <summary>
@@ -89,6 +89,8 @@ namespace CNOSSOS_RAILNOISE
 			if (currentSection != NULL)
 				delete currentSection;
 			delete catalogue;
+			currentSection = NULL;
+			catalogue = NULL;
 
 			return 0;
 		}
@@ -99,37 +101,38 @@ namespace CNOSSOS_RAILNOISE
 
 	// --------------------------------------------------------------------------------------------------------
 	/// <summary>
-	/// Calculates from file.
+	/// Calculates from file, using the given rail section.
 	/// </summary>
+	/// <param name="section">The rail section used for the calculation.</param>
 	/// <param name="infile">The input XML file.</param>
 	/// <param name="outfile">The output XML file.</param>
 	/// <returns>0 = OK, 1 = error while loading, 2 = error while calculating, 3 = error while saving, 4 = internal error</returns>
-	int CalcFromFile(const string infile, const string outfile)
+	static int CalcSectionFromFile(RailSection *section, const string infile, const string outfile)
 	{
 		int result = 0;
-		if (currentSection == NULL)
+		if (section == NULL)
 		{
 			return 4;
 		}
-		else if (currentSection->load_from_xml_file(infile))
+		else if (section->load_from_xml_file(infile))
 		{
-			if (!currentSection->calculate()) {
+			if (!section->calculate()) {
 				cerr << "Error while calculating " << outfile << "." << endl;
 				result = 2;
 			}
 				
-			if (!currentSection->save_results_to_xml_file(outfile))
+			if (!section->save_results_to_xml_file(outfile))
 			{
 				cerr << "Error while trying to save " << outfile << "." << endl;
 				if (result == 0)
 					result = 2;
 			}
 
-			if (currentSection->doDebug)
+			if (section->doDebug)
 			{
 				string debugfile = outfile;
 				debugfile = debugfile.substr(0, debugfile.find_last_of(".")) + ".csv";
-				if (currentSection->writeDebugData(debugfile))
+				if (section->writeDebugData(debugfile))
 				{
 					cout << "Test file saved to " << debugfile << "." << endl;
 				}
@@ -140,4 +143,63 @@ namespace CNOSSOS_RAILNOISE
 		return 1;
 	}
 
+	// --------------------------------------------------------------------------------------------------------
+	/// <summary>
+	/// Calculates from file.
+	/// </summary>
+	/// <param name="infile">The input XML file.</param>
+	/// <param name="outfile">The output XML file.</param>
+	/// <returns>0 = OK, 1 = error while loading, 2 = error while calculating, 3 = error while saving, 4 = internal error</returns>
+	int CalcFromFile(const string infile, const string outfile)
+	{
+		return CalcSectionFromFile(currentSection, infile, outfile);
+	}
+
+	// --------------------------------------------------------------------------------------------------------
+	/// <summary>
+	/// Creates a new calculation context, with its own rail section.
+	/// </summary>
+	/// <returns>The handle of the context, NULL if the DLL is not initialized</returns>
+	ContextHandle CreateContext(void)
+	{
+		if (catalogue == NULL)
+			return NULL;
+		try
+		{
+			return new RailSection(catalogue);
+		}
+		catch (...)
+		{
+			return NULL;
+		}
+	}
+
+	// --------------------------------------------------------------------------------------------------------
+	/// <summary>
+	/// Releases a calculation context created by CreateContext.
+	/// </summary>
+	/// <returns>0 if all went well, -1 if something went wrong</returns>
+	int ReleaseContext(ContextHandle context)
+	{
+		try
+		{
+			if (context != NULL)
+				delete (RailSection*)context;
+			return 0;
+		}
+		catch (...)
+		{
+			return -1;
+		}
+	}
+
+	// --------------------------------------------------------------------------------------------------------
+	/// <summary>
+	/// Calculates from file, using the rail section of the given context.
+	/// </summary>
+	/// <returns>0 = OK, 1 = error while loading, 2 = error while calculating, 3 = error while saving, 4 = internal error</returns>
+	int CalcFromFileWithContext(ContextHandle context, const string infile, const string outfile)
+	{
+		return CalcSectionFromFile((RailSection*)context, infile, outfile);
+	}
 }
\ No newline at end of file
@@ -707,17 +707,15 @@ namespace CNOSSOS_RAILNOISE
 				report_error(ERRMSG_MISSING_OR_INVALID_ELEMENT + ": Source", fn, root->FirstChild("Source"));
 			}
 			
-			// load the vehicle definitions
+			// load the vehicle definitions; vehicles of a previous load refer to the old document
+			this->vehicles.clear();
 			TiXmlElement* vehicle = vehicles->FirstChildElement("Vehicle");
 			while (vehicle != NULL)
 			{
 				RailVehicle* oVehicle = new RailVehicle(catalogue, vehicle);
-				if (oVehicle->xmlDefinition == NULL)
-				{
-					delete oVehicle;
-					oVehicle = NULL;
-				}
-				this->vehicles.push_back(*oVehicle);
+				if (oVehicle->xmlDefinition != NULL)
+					this->vehicles.push_back(*oVehicle);
+				delete oVehicle;
 				
 				vehicle = vehicle->NextSiblingElement(vehicle->Value());
 			}
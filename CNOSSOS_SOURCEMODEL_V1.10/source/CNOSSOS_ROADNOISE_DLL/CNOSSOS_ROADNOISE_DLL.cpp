@@ -17,6 +17,7 @@
 
 #include "CNOSSOS_ROADNOISE_DLL_DATA.h"
 #include "CNOSSOS_ROADNOISE_DLL.h"
+#include "CNOSSOS_ROADNOISE_DLL_BATCH.h"
 #include "../tinyxml/tinyxml.h"
 #include <stdexcept>
 #include <stdlib.h>
@@ -30,6 +31,8 @@ using namespace std;
 
 namespace CNOSSOS_ROADNOISE
 {
+	// optional table used by CalcSegments
+	static RoadEmissionTable* emissionTable = NULL;
 
 
 	// --------------------------------------------------------------------------------------------------------
@@ -55,6 +58,10 @@ namespace CNOSSOS_ROADNOISE
 		{
 			if (currentSegment != NULL)
 				delete currentSegment;
+			currentSegment = NULL;
+			if (emissionTable != NULL)
+				delete emissionTable;
+			emissionTable = NULL;
 
 			return 0;
 		}
@@ -91,7 +98,7 @@ namespace CNOSSOS_ROADNOISE
 	{
 		if (currentSegment != NULL)
 		{
-			currentSegment->TempProp = new TempProperties(temperature);
+			currentSegment->setTemperature(temperature);
 		}
 	}
 
@@ -107,7 +114,7 @@ namespace CNOSSOS_ROADNOISE
 	{
 		if (currentSegment != NULL)
 		{
-			currentSegment->GradProp = new GradientProperties(gradient);
+			currentSegment->setGradient(gradient);
 		}
 	}
 
@@ -116,15 +123,14 @@ namespace CNOSSOS_ROADNOISE
 	//
 	// Parameter :
 	//				distance	: distance in m to the junction		
-	//				junctionType : 1 = crossing with traffic ligths, 2 = roundabout
+	//				junctionType : 1 = crossing with traffic ligths, 2 = roundabout, 0 = no junction
 	// 
 	// --------------------------------------------------------------------------------------------------------
 	void SetAccelerationProperties(const double distance, const int junctionType)
 	{
 		if (currentSegment != NULL)
 		{
-			currentSegment->AccProp = new AccelerationProperties(distance, junctionType);
-			
+			currentSegment->setAcceleration(distance, junctionType);
 		}
 	}
 
@@ -177,7 +183,184 @@ namespace CNOSSOS_ROADNOISE
 	}
 
 
+	// --------------------------------------------------------------------------------------------------------
+	// Set the fraction of vehicles equipped with studded tyres for a specific category of vehicles
+	//
+	// Parameter :
+	//				cat			: the category of vehicles ( 0 .. 5)
+	//				fraction	: the fraction of vehicles of category "cat" with studded tyres
+	// 
+	// --------------------------------------------------------------------------------------------------------
+	void SetStuddedFraction(const int cat, const double fraction)
+	{
+		if (currentSegment != NULL)
+		{
+			currentSegment->Fstud[cat] = fraction;
+		}
+	}
+
+	// --------------------------------------------------------------------------------------------------------
+	/// <summary>
+	/// Set the road surface of the current road segment
+	/// </summary>
+	/// <param name='id'>The ID of the road surface in CNOSSOS_Road_Surfaces.xml</param>
+	/// <returns>0 if all is OK, -1 if the surface is unknown</returns>
+	// --------------------------------------------------------------------------------------------------------
+	int SetSurface(const string id)
+	{
+		if (currentSegment != NULL && currentSegment->setSurfaceID(id) != NULL)
+			return 0;
+		else
+			return -1;
+	}
+
+	// --------------------------------------------------------------------------------------------------------
+	/// <summary>
+	/// Copies the total source power of the current road segment, as calculated by CalcSegment
+	/// </summary>
+	/// <param name='spec'>Array receiving the source power in each octave band</param>
+	/// <returns>0 if all is OK, -1 otherwise</returns>
+	// --------------------------------------------------------------------------------------------------------
+	int GetTotalSpectrum(double *spec)
+	{
+		if (currentSegment == NULL)
+			return -1;
+		for (int i = 0; i < MAX_FREQ_BAND_CENTRE; i++)
+			spec[i] = currentSegment->TotalSpec[i];
+		return 0;
+	}
+
+	// --------------------------------------------------------------------------------------------------------
+	/// <summary>
+	/// Calculates the source power of a set of road segments, see RoadSegmentArrays
+	/// </summary>
+	/// <param name='segments'>input arrays and result array for all road segments</param>
+	/// <returns>0 if all is OK, 1 if the input contains an invalid surface index, an invalid junction type or junction types 
+	/// without distances, 4 = internal error</returns>
+	// --------------------------------------------------------------------------------------------------------
+	int CalcSegments(RoadSegmentArrays *segments)
+	{
+		if (catalog == NULL || segments == NULL)
+			return 4;
+		return CalcSegmentArrays(catalog, segments, emissionTable);
+	}
+
+	// --------------------------------------------------------------------------------------------------------
+	/// <summary>
+	/// Creates or removes the table with the speed dependent emission terms used by CalcSegments
+	/// </summary>
+	/// <param name='minSpeed'>lowest speed in the table, in km/h</param>
+	/// <param name='maxSpeed'>highest speed in the table, in km/h</param>
+	/// <param name='tolerance'>maximum interpolation error in dB, 0 to remove the table</param>
+	/// <returns>the number of speeds in the table, 0 if the table was removed, -1 if something went wrong</returns>
+	// --------------------------------------------------------------------------------------------------------
+	int SetEmissionTable(const double minSpeed, const double maxSpeed, const double tolerance)
+	{
+		try
+		{
+			if (emissionTable != NULL)
+				delete emissionTable;
+			emissionTable = NULL;
+
+			if (catalog == NULL)
+				return -1;
+			if (tolerance <= 0.0)
+				return 0;
+
+			emissionTable = new RoadEmissionTable(catalog, minSpeed, maxSpeed, tolerance);
+			return emissionTable->numNodes;
+		}
+		catch (...)
+		{
+			return -1;
+		}
+	}
+
+	// --------------------------------------------------------------------------------------------------------
+	/// <summary>
+	/// Upper limit of the interpolation error of the emission table : the largest error of the tabulated 
+	/// rolling noise and the studded tyre factor add up, the propulsion noise error is not larger.
+	/// </summary>
+	/// <returns>the maximum error in dB, 0 if there is no table</returns>
+	// --------------------------------------------------------------------------------------------------------
+	double GetEmissionTableError(void)
+	{
+		if (emissionTable == NULL)
+			return 0.0;
+		return 2 * emissionTable->maxError;
+	}
+
+	// --------------------------------------------------------------------------------------------------------
+	/// <summary>
+	/// Number of vehicle categories defined in the catalogue
+	/// </summary>
+	// --------------------------------------------------------------------------------------------------------
+	int GetNumCategories(void)
+	{
+		if (catalog == NULL)
+			return 0;
+		return catalog->numCategories;
+	}
+
+	// --------------------------------------------------------------------------------------------------------
+	/// <summary>
+	/// Index of the vehicle category with the given ID, -1 if unknown
+	/// </summary>
+	// --------------------------------------------------------------------------------------------------------
+	int GetCategoryIndex(const string id)
+	{
+		if (catalog == NULL)
+			return -1;
+		return catalog->indexOfCategory(id);
+	}
+
+	// --------------------------------------------------------------------------------------------------------
+	/// <summary>
+	/// Number of road surfaces defined in the catalogue
+	/// </summary>
+	// --------------------------------------------------------------------------------------------------------
+	int GetNumSurfaces(void)
+	{
+		if (catalog == NULL)
+			return 0;
+		return (int)catalog->surfaces.size();
+	}
+
+	// --------------------------------------------------------------------------------------------------------
+	/// <summary>
+	/// ID of the road surface with the given index, NULL if the index is out of range
+	/// </summary>
+	// --------------------------------------------------------------------------------------------------------
+	const char* GetSurfaceID(const int index)
+	{
+		if (catalog == NULL)
+			return NULL;
+		int i = 0;
+		for (list<RoadSurface>::iterator rsi = catalog->surfaces.begin(); rsi != catalog->surfaces.end(); ++rsi, ++i)
+		{
+			if (i == index)
+				return rsi->id.c_str();
+		}
+		return NULL;
+	}
 
+	// --------------------------------------------------------------------------------------------------------
+	/// <summary>
+	/// Index of the road surface with the given ID, -1 if unknown
+	/// </summary>
+	// --------------------------------------------------------------------------------------------------------
+	int GetSurfaceIndex(const string id)
+	{
+		if (catalog == NULL)
+			return -1;
+		int index = 0;
+		for (list<RoadSurface>::iterator rsi = catalog->surfaces.begin(); rsi != catalog->surfaces.end(); ++rsi, ++index)
+		{
+			if (id.compare(rsi->id) == 0)
+				return index;
+		}
+		return -1;
+	}
 
 	// --------------------------------------------------------------------------------------------------------
 	string getDllPath()
@@ -228,34 +411,35 @@ namespace CNOSSOS_ROADNOISE
 
 	// --------------------------------------------------------------------------------------------------------
 	/// <summary>
-	/// Reads a xml input file, calculates the roadsegment source power and outputs the results the an xml output file
+	/// Reads a xml input file, calculates the source power of the given roadsegment and outputs the results the an xml output file
 	/// </summary>
+	/// <param name='segment'>the road segment used for the calculation</param>
 	/// <param name='infile'>filename of the xml input file</param>
 	/// <param name='outfile'>filename of the xml output file</param>
 	/// <returns>0 = OK, 1 = error while loading, 2 = error while calculating, 3 = error while saving, 4 = internal error</returns>
 	// --------------------------------------------------------------------------------------------------------
-	int CalcFromFile(const string infile, const string outfile)
+	static int CalcSegmentFromFile(RoadSegment *segment, const string infile, const string outfile)
 	{
 		int result = 0; // 0 = OK, 1 = error while loading, 2 = error while calculating, 3 = error while saving, 4 = internal error
-		if (currentSegment == NULL)
+		if (segment == NULL)
 		{
 			return 4;
 		}
-		else if (currentSegment->loadFromXMLFile(infile))
+		else if (segment->loadFromXMLFile(infile))
 		{
-			result = currentSegment->CalcSegment();
-			if (!currentSegment->saveResultsToXMLFile(outfile))
+			result = segment->CalcSegment();
+			if (!segment->saveResultsToXMLFile(outfile))
 			{
 				cerr << "Error while trying to save " << outfile << endl;
 				if (result == 0)
 					result = 2;
 			}
 
-			if (currentSegment->doDebug)
+			if (segment->doDebug)
 			{
 				string debugfile = outfile;
 				debugfile = debugfile.substr(0, debugfile.find_last_of(".")) + ".csv";
-				if (currentSegment->writeDebugData(debugfile))
+				if (segment->writeDebugData(debugfile))
 				{
 					cout << "Test file saved to " << debugfile << "." << endl;
 				}
@@ -267,6 +451,70 @@ namespace CNOSSOS_ROADNOISE
 		return 1;
 	}
 
+	// --------------------------------------------------------------------------------------------------------
+	/// <summary>
+	/// Reads a xml input file, calculates the roadsegment source power and outputs the results the an xml output file
+	/// </summary>
+	/// <param name='infile'>filename of the xml input file</param>
+	/// <param name='outfile'>filename of the xml output file</param>
+	/// <returns>0 = OK, 1 = error while loading, 2 = error while calculating, 3 = error while saving, 4 = internal error</returns>
+	// --------------------------------------------------------------------------------------------------------
+	int CalcFromFile(const string infile, const string outfile)
+	{
+		return CalcSegmentFromFile(currentSegment, infile, outfile);
+	}
+
+	// --------------------------------------------------------------------------------------------------------
+	/// <summary>
+	/// Creates a new calculation context, with its own road segment
+	/// </summary>
+	/// <returns>the handle of the context, NULL if the DLL is not initialized</returns>
+	// --------------------------------------------------------------------------------------------------------
+	ContextHandle CreateContext(void)
+	{
+		if (catalog == NULL)
+			return NULL;
+		try
+		{
+			return new RoadSegment(catalog);
+		}
+		catch (...)
+		{
+			return NULL;
+		}
+	}
+
+	// --------------------------------------------------------------------------------------------------------
+	/// <summary>
+	/// Releases a calculation context created by CreateContext
+	/// </summary>
+	/// <returns>0 if all went well, -1 if something went wrong</returns>
+	// --------------------------------------------------------------------------------------------------------
+	int ReleaseContext(ContextHandle context)
+	{
+		try
+		{
+			if (context != NULL)
+				delete (RoadSegment*)context;
+			return 0;
+		}
+		catch (...)
+		{
+			return -1;
+		}
+	}
+
+	// --------------------------------------------------------------------------------------------------------
+	/// <summary>
+	/// Same as CalcFromFile, using the road segment of the given context
+	/// </summary>
+	/// <returns>0 = OK, 1 = error while loading, 2 = error while calculating, 3 = error while saving, 4 = internal error</returns>
+	// --------------------------------------------------------------------------------------------------------
+	int CalcFromFileWithContext(ContextHandle context, const string infile, const string outfile)
+	{
+		return CalcSegmentFromFile((RoadSegment*)context, infile, outfile);
+	}
+
 	// --------------------------------------------------------------------------------------------------------
 	void WriteToXMLFile(const string fn)
 	{
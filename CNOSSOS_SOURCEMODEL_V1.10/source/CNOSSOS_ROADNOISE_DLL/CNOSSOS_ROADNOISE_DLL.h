@@ -16,7 +16,7 @@
 // ----------------------------------------------------------------------------------------------------- 
 
 #ifndef WIN32
-#define CNOSSOS_DLL_API extern "C"
+#define CNOSSOS_DLL_API
 #elif CNOSSOS_DLL_EXPORTS
 #define CNOSSOS_DLL_API __declspec(dllexport) 
 #else
@@ -43,4 +43,86 @@ namespace CNOSSOS_ROADNOISE
 
 	// Get the current version of the Cnossos Road Source module shared library.
 	CNOSSOS_DLL_API char* GetVersionDLL (void);
+
+	// -------------------------------------------------------------------------------------------------------------
+	// handle based interface : all contexts share the catalogue loaded by InitDLL, but each context has its 
+	// own road segment, so different contexts can be used by different threads at the same time.
+	// -------------------------------------------------------------------------------------------------------------
+	typedef void* ContextHandle;
+
+	// Create a new calculation context, NULL if the DLL is not initialized
+	CNOSSOS_DLL_API ContextHandle CreateContext(void);
+
+	// Release a calculation context
+	CNOSSOS_DLL_API int ReleaseContext(ContextHandle context);
+
+	// Calculate the source power given by the infile and the place the results in the outfile, using the given context
+	CNOSSOS_DLL_API int CalcFromFileWithContext(ContextHandle context, const string infile, const string outfile);
+
+	// -------------------------------------------------------------------------------------------------------------
+	// single segment interface, working on the segment created by InitDLL
+	// -------------------------------------------------------------------------------------------------------------
+
+	// Set the properties of the current road segment
+	CNOSSOS_DLL_API void SetTemperatureProperties(const double temperature);
+	CNOSSOS_DLL_API void SetGradientProperties(const double gradient);
+	CNOSSOS_DLL_API void SetAccelerationProperties(const double distance, const int junctionType);
+	CNOSSOS_DLL_API void SetStuddedMonths(const int months);
+	CNOSSOS_DLL_API void SetSpeed(const int cat, const double speed);
+	CNOSSOS_DLL_API void SetTraffic(const int cat, const double amount);
+	CNOSSOS_DLL_API void SetStuddedFraction(const int cat, const double fraction);
+	CNOSSOS_DLL_API int SetSurface(const string id);
+
+	// Calculate the source power of the current road segment
+	CNOSSOS_DLL_API int CalcSegment(void);
+
+	// Copy the total source power of the current road segment (8 octave bands, 63 Hz .. 8 kHz) to spec
+	CNOSSOS_DLL_API int GetTotalSpectrum(double *spec);
+
+	// -------------------------------------------------------------------------------------------------------------
+	// multiple segment interface
+	// -------------------------------------------------------------------------------------------------------------
+
+	// Number of octave bands in the results of CalcSegments
+	const int NUM_OCTAVE_BANDS = 8;
+
+	// Struct-of-arrays description of a set of road segments. 
+	// 
+	// Per segment arrays hold "count" values. Per category arrays hold "count" values for each category 
+	// of the catalogue, stored category by category : value[category * count + segment]. The category 
+	// index is the order of the categories in CNOSSOS_Road_Params.xml (see GetCategoryIndex).
+	// Optional arrays may be NULL, in which case the corresponding correction is not applied.
+	struct RoadSegmentArrays
+	{
+		int				count;			// number of road segments
+		const double	*v;				// speed per category, in km/h
+		const double	*Q;				// traffic flow per category, in vehicles per hour
+		const double	*Fstud;			// optional, fraction of vehicles equipped with studded tyres, per category
+		const int		*surface;		// index of the road surface (see GetSurfaceIndex), per segment
+		const int		*studdedMonths;	// optional, months per year studded tyres are used, per segment
+		const double	*temperature;	// optional, average air temperature in degrees Celcius, per segment
+		const double	*gradient;		// optional, slope of the road in %, per segment
+		const double	*accDistance;	// distance to the junction in m, per segment, required if junctionType is given
+		const int		*junctionType;	// optional, 0 = none, 1 = crossing with traffic lights, 2 = roundabout, per segment
+		double			*TotalSpec;		// result, total source power per band : TotalSpec[band * count + segment]
+	};
+
+	// Calculate the source power of all segments in one call
+	CNOSSOS_DLL_API int CalcSegments(RoadSegmentArrays *segments);
+
+	// Use a precomputed table of the speed dependent emission terms in CalcSegments, for speeds between 
+	// minSpeed and maxSpeed (km/h, rounded to multiples of 10 km/h) and an interpolation error of at most 
+	// tolerance dB. A tolerance of 0 removes the table, CalcSegments then calculates all terms exactly.
+	// Returns the number of speeds in the table.
+	CNOSSOS_DLL_API int SetEmissionTable(const double minSpeed, const double maxSpeed, const double tolerance);
+
+	// Upper limit of the interpolation error of the current emission table, in dB
+	CNOSSOS_DLL_API double GetEmissionTableError(void);
+
+	// Lookup functions for the indices used in RoadSegmentArrays, return -1 if the id is unknown
+	CNOSSOS_DLL_API int GetNumCategories(void);
+	CNOSSOS_DLL_API int GetCategoryIndex(const string id);
+	CNOSSOS_DLL_API int GetNumSurfaces(void);
+	CNOSSOS_DLL_API int GetSurfaceIndex(const string id);
+	CNOSSOS_DLL_API const char* GetSurfaceID(const int index);
 }
\ No newline at end of file
@@ -0,0 +1,386 @@
+#pragma once
+
+// ----------------------------------------------------------------------------------------------------- 
+//
+// project : CNOSSOS_ROADNOISE.dll
+// author  : Martijn Kirsten
+// company : DGMR
+//
+// Calculation road traffic noise source emission
+//
+// Disclaimer + header text
+//
+// Version : 
+// Release : 
+//
+// ----------------------------------------------------------------------------------------------------- 
+
+#include "stdafx.h"
+#include "CNOSSOS_ROADNOISE_DLL_CONST.h"
+#include "CNOSSOS_ROADNOISE_DLL_BATCH.h"
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+
+namespace CNOSSOS_ROADNOISE
+{
+	// ln(10) / 10, converts a level in dB to an energy with a single exp()
+	static const double DB_TO_NEPER = 0.23025850929940458;
+
+	inline double energyFromLevel(const double Lw)
+	{
+		return exp(DB_TO_NEPER * Lw);
+	}
+
+#pragma region RoadEmissionTable_methods
+	RoadEmissionTable::RoadEmissionTable(RoadNoiseCatalog *catalog, const double minSpeed, const double maxSpeed, const double tolerance)
+	{
+		this->catalog = catalog;
+		for (list<RoadSurface>::const_iterator rsi = catalog->surfaces.begin(); rsi != catalog->surfaces.end(); ++rsi)
+			surfaces.push_back(&*rsi);
+		numSurfaces = (int)surfaces.size();
+		numCategories = catalog->numCategories;
+
+		// the grid range is rounded to multiples of 10 km/h, so that 50 and 90 km/h are always grid points
+		this->minSpeed = max(10.0, floor(minSpeed / 10) * 10);
+		this->maxSpeed = max(this->minSpeed + 10, ceil(maxSpeed / 10) * 10);
+		this->tolerance = tolerance;
+		this->step = 10;
+		this->numNodes = 0;
+		this->maxError = 0;
+
+		Build();
+		maxError = CheckError();
+		while (maxError > tolerance / 2 && step > 0.01)
+		{
+			step = step / 2;
+			Build();
+			maxError = CheckError();
+		}
+	}
+
+	// Formula III-5 and III-19
+	double RoadEmissionTable::CalcRolling(const RoadSurface *rs, const int m, const int i, const double v) const
+	{
+		VehicleCategory *cat = catalog->getCategory(m);
+		return cat->coefficientA[ngROLLING][i] + rs->coefficientA[m][i]
+			 + (cat->coefficientB[ngROLLING][i] + rs->coefficientB[m]) * log10(v / catalog->refSpeed);
+	}
+
+	// Formula III-11 and III-20
+	double RoadEmissionTable::CalcPropulsion(const RoadSurface *rs, const int m, const int i, const double v) const
+	{
+		VehicleCategory *cat = catalog->getCategory(m);
+		return cat->coefficientA[ngPROPULSION][i] + min(rs->coefficientA[m][i], 0.0)
+			 + cat->coefficientB[ngPROPULSION][i] * (v - catalog->refSpeed) / catalog->refSpeed;
+	}
+
+	// Formula III-7
+	double RoadEmissionTable::CalcStudded(const int m, const int i, const double v) const
+	{
+		VehicleCategory *cat = catalog->getCategory(m);
+		if (!cat->calcStudded)
+			return 0.0;
+		return cat->studdedProps->studded[cfAlpha][i] 
+			 + cat->studdedProps->studded[cfBeta][i] * log10(min(max(v, 50.0), 90.0) / catalog->refSpeed);
+	}
+
+	// Fill the tables for the current grid step
+	void RoadEmissionTable::Build(void)
+	{
+		numNodes = (int)floor((maxSpeed - minSpeed) / step + 0.5) + 1;
+		rolling.assign(numSurfaces * numCategories * numNodes * MAX_FREQ_BAND_CENTRE, 0.0);
+		propulsion.assign(numSurfaces * numCategories * numNodes * MAX_FREQ_BAND_CENTRE, 0.0);
+		studded.assign(numCategories * numNodes * MAX_FREQ_BAND_CENTRE, 0.0);
+
+		for (int m = 0; m < numCategories; m++)
+		{
+			for (int k = 0; k < numNodes; k++)
+			{
+				double v = minSpeed + k * step;
+				for (int i = 0; i < MAX_FREQ_BAND_CENTRE; i++)
+					studded[(m * numNodes + k) * MAX_FREQ_BAND_CENTRE + i] = energyFromLevel(CalcStudded(m, i, v)) - 1;
+
+				for (int r = 0; r < numSurfaces; r++)
+				{
+					int index = ((r * numCategories + m) * numNodes + k) * MAX_FREQ_BAND_CENTRE;
+					for (int i = 0; i < MAX_FREQ_BAND_CENTRE; i++)
+					{
+						rolling[index + i] = energyFromLevel(CalcRolling(surfaces[r], m, i, v));
+						propulsion[index + i] = energyFromLevel(CalcPropulsion(surfaces[r], m, i, v));
+					}
+				}
+			}
+		}
+	}
+
+	// Largest interpolation error in dB, at the middle of each interval
+	double RoadEmissionTable::CheckError(void) const
+	{
+		double result = 0.0;
+		for (int m = 0; m < numCategories; m++)
+		{
+			for (int k = 0; k < numNodes - 1; k++)
+			{
+				double v = minSpeed + (k + 0.5) * step;
+				for (int i = 0; i < MAX_FREQ_BAND_CENTRE; i++)
+				{
+					// the studded tyre factor (1 - ps) + ps * 10^(delta / 10) has its largest relative error for ps = 1
+					int index = (m * numNodes + k) * MAX_FREQ_BAND_CENTRE + i;
+					double interpolated = 1 + (studded[index] + studded[index + MAX_FREQ_BAND_CENTRE]) / 2;
+					double exact = energyFromLevel(CalcStudded(m, i, v));
+					result = max(result, fabs(10 * log10(interpolated / exact)));
+				}
+				for (int r = 0; r < numSurfaces; r++)
+				{
+					int index = ((r * numCategories + m) * numNodes + k) * MAX_FREQ_BAND_CENTRE;
+					for (int i = 0; i < MAX_FREQ_BAND_CENTRE; i++)
+					{
+						double interpolated = (rolling[index + i] + rolling[index + i + MAX_FREQ_BAND_CENTRE]) / 2;
+						double exact = energyFromLevel(CalcRolling(surfaces[r], m, i, v));
+						result = max(result, fabs(10 * log10(interpolated / exact)));
+
+						interpolated = (propulsion[index + i] + propulsion[index + i + MAX_FREQ_BAND_CENTRE]) / 2;
+						exact = energyFromLevel(CalcPropulsion(surfaces[r], m, i, v));
+						result = max(result, fabs(10 * log10(interpolated / exact)));
+					}
+				}
+			}
+		}
+		return result;
+	}
+#pragma endregion RoadEmissionTable_methods
+
+	// --------------------------------------------------------------------------------------------------------
+	/// <summary>
+	/// Calculates the source power for each road segment of a struct-of-arrays set of segments
+	/// Formula III-1 .. III-20, rearranged per segment :
+	///
+	///   10^(Lw,eq,line,i,m / 10) = Q / (1000 v) * (10^(LWR / 10) * stud + 10^(LWP / 10))
+	///
+	/// where stud = (1 - ps) + ps * 10^(delta_stud / 10) is the studded tyre factor of formula III-9. 
+	/// </summary>
+	/// <param name='catalog'>The catalog with the vehicle categories and road surfaces</param>
+	/// <param name='segments'>The input and output arrays</param>
+	/// <param name='table'>Optional table with the speed dependent terms, NULL for the exact calculation</param>
+	/// <returns>0 if all is OK, 1 if the input contains an invalid surface index, an invalid junction type or junction types without distances</returns>
+	// --------------------------------------------------------------------------------------------------------
+	int CalcSegmentArrays(RoadNoiseCatalog *catalog, RoadSegmentArrays *segments, const RoadEmissionTable *table)
+	{
+		const int n = segments->count;
+		const double refSpeed = catalog->refSpeed;
+
+		// Formula III-17 and III-18 need the distance to the junction
+		if (segments->junctionType != NULL && segments->accDistance == NULL)
+			return 1;
+
+		// Random access to the road surfaces
+		vector<const RoadSurface*> surfaceList;
+		for (list<RoadSurface>::const_iterator rsi = catalog->surfaces.begin(); rsi != catalog->surfaces.end(); ++rsi)
+			surfaceList.push_back(&*rsi);
+
+		vector<const RoadSurface*> surface(n);
+		for (int s = 0; s < n; s++)
+		{
+			int index = segments->surface[s];
+			if (index < 0 || index >= (int)surfaceList.size())
+				return 1;
+			surface[s] = surfaceList[index];
+
+			// Formula III-17 and III-18 look up the coefficients of the junction type
+			if (segments->junctionType != NULL && (segments->junctionType[s] < 0 || segments->junctionType[s] >= MAX_SPEED_VARIATION_TYPES))
+				return 1;
+		}
+
+		// Energetic summation per band, stored band by band
+		double *total = segments->TotalSpec;
+		for (int k = 0; k < n * MAX_FREQ_BAND_CENTRE; k++)
+			total[k] = 0.0;
+
+		// Per segment terms, evaluated once per category instead of once per band
+		vector<double> lineFactor(n), logSpeed(n), relSpeed(n), tempDelta(n, 0.0);
+		vector<double> accRolling(n, 0.0), corrPropulsion(n, 0.0), studFraction(n, 0.0), logStudSpeed(n, 0.0);
+		vector<double> rolling(n), propulsion(n);
+
+		// Segments that are calculated exactly, for the current category
+		vector<int> exact(n);
+
+		if (segments->temperature != NULL)
+		{
+			for (int s = 0; s < n; s++)
+				tempDelta[s] = catalog->refTemp - segments->temperature[s];
+		}
+
+		for (int m = 0; m < catalog->numCategories; m++)
+		{
+			VehicleCategory *cat = catalog->getCategory(m);
+			const bool calcRolling = cat->calcNoise[ngROLLING];
+			const bool calcPropulsion = cat->calcNoise[ngPROPULSION];
+			const double *v = segments->v + m * n;
+			const double *Q = segments->Q + m * n;
+
+			// with a uniform temperature coefficient, the rolling noise corrections are a single factor per segment
+			bool uniformK = true;
+			for (int i = 1; i < MAX_FREQ_BAND_CENTRE; i++)
+				uniformK = uniformK && (cat->Ksurface[i] == cat->Ksurface[0]);
+
+			int numExact = 0;
+			for (int s = 0; s < n; s++)
+			{
+				// Formula III-1, as a linear factor; segments without traffic do not contribute
+				if (!(Q[s] > 0.0 && v[s] > 0.0))
+					continue;
+				lineFactor[s] = Q[s] / (1000 * v[s]);
+
+				// Formula III-17 and III-18
+				double accPropulsion = 0.0;
+				accRolling[s] = 0.0;
+				if (segments->junctionType != NULL && segments->junctionType[s] != 0)
+				{
+					double factor = max(1 - (abs(segments->accDistance[s]) / 100), 0.0);
+					accRolling[s] = cat->speedVariationCoefficient[segments->junctionType[s]][ngROLLING] * factor;
+					accPropulsion = cat->speedVariationCoefficient[segments->junctionType[s]][ngPROPULSION] * factor;
+				}
+
+				// Formula III-13 .. III-16
+				double grad = 0.0;
+				if (segments->gradient != NULL && cat->gradientCorrection != NULL)
+					grad = cat->gradientCorrection->CalcValue(segments->gradient[s], v[s]);
+				corrPropulsion[s] = accPropulsion + grad;
+
+				// Formula III-8
+				studFraction[s] = 0.0;
+				if (cat->calcStudded && segments->studdedMonths != NULL && segments->studdedMonths[s] > 0)
+				{
+					double Fstud = (segments->Fstud != NULL) ? segments->Fstud[m * n + s] : 0.0;
+					studFraction[s] = Fstud * ((double)segments->studdedMonths[s] / 12);
+				}
+
+				int k;
+				double w;
+				if (table != NULL && table->Locate(v[s], k, w))
+				{
+					// Interpolate the speed dependent terms in the table
+					const int node = (segments->surface[s] * table->numCategories + m) * table->numNodes + k;
+					const double *R = &table->rolling[node * MAX_FREQ_BAND_CENTRE];
+					const double *P = &table->propulsion[node * MAX_FREQ_BAND_CENTRE];
+					const double *S = &table->studded[(m * table->numNodes + k) * MAX_FREQ_BAND_CENTRE];
+					const double ps = studFraction[s];
+
+					double factorR = 1.0;
+					if (uniformK && (accRolling[s] != 0.0 || tempDelta[s] != 0.0))
+						factorR = energyFromLevel(accRolling[s] + cat->Ksurface[0] * tempDelta[s]);
+					double factorP = 1.0;
+					if (corrPropulsion[s] != 0.0)
+						factorP = energyFromLevel(corrPropulsion[s]);
+
+					for (int i = 0; i < MAX_FREQ_BAND_CENTRE; i++)
+					{
+						const int j = i + MAX_FREQ_BAND_CENTRE;
+						double e = 0.0;
+						if (calcRolling)
+						{
+							double er = R[i] + w * (R[j] - R[i]);
+							if (uniformK)
+								er *= factorR;
+							else
+								er *= energyFromLevel(accRolling[s] + cat->Ksurface[i] * tempDelta[s]);
+							if (ps > 0.0)
+								er *= 1 + ps * (S[i] + w * (S[j] - S[i]));
+							e += er;
+						}
+						if (calcPropulsion)
+							e += (P[i] + w * (P[j] - P[i])) * factorP;
+						else if (!calcRolling)
+							e = 1.0;
+						total[i * n + s] += lineFactor[s] * e;
+					}
+				}
+				else
+				{
+					// Formula III-5 and III-7, speed dependent terms of the exact calculation
+					logSpeed[s] = log10(v[s] / refSpeed);
+					relSpeed[s] = (v[s] - refSpeed) / refSpeed;
+					if (studFraction[s] > 0.0)
+						logStudSpeed[s] = log10(min(max(v[s], 50.0), 90.0) / refSpeed);
+					exact[numExact++] = s;
+				}
+			}
+
+			for (int i = 0; i < MAX_FREQ_BAND_CENTRE && numExact > 0; i++)
+			{
+				double *E = total + i * n;
+
+				if (calcRolling)
+				{
+					// Formula III-5, III-6, III-10 and III-19
+					const double A = cat->coefficientA[ngROLLING][i];
+					const double B = cat->coefficientB[ngROLLING][i];
+					const double K = cat->Ksurface[i];
+					for (int j = 0; j < numExact; j++)
+					{
+						const int s = exact[j];
+						const RoadSurface *rs = surface[s];
+						double LWR = A + rs->coefficientA[m][i] + (B + rs->coefficientB[m]) * logSpeed[s]
+								   + accRolling[s] + K * tempDelta[s];
+						rolling[s] = energyFromLevel(LWR);
+					}
+
+					// Formula III-9
+					if (cat->calcStudded)
+					{
+						const double As = cat->studdedProps->studded[cfAlpha][i];
+						const double Bs = cat->studdedProps->studded[cfBeta][i];
+						for (int j = 0; j < numExact; j++)
+						{
+							const int s = exact[j];
+							if (studFraction[s] > 0.0)
+							{
+								double ps = studFraction[s];
+								rolling[s] *= (1 - ps) + ps * energyFromLevel(As + Bs * logStudSpeed[s]);
+							}
+						}
+					}
+				}
+				else
+				{
+					for (int j = 0; j < numExact; j++)
+						rolling[exact[j]] = 0.0;
+				}
+
+				if (calcPropulsion)
+				{
+					// Formula III-11, III-12 and III-20
+					const double A = cat->coefficientA[ngPROPULSION][i];
+					const double B = cat->coefficientB[ngPROPULSION][i];
+					for (int j = 0; j < numExact; j++)
+					{
+						const int s = exact[j];
+						double LWP = A + min(surface[s]->coefficientA[m][i], 0.0) + B * relSpeed[s] + corrPropulsion[s];
+						propulsion[s] = energyFromLevel(LWP);
+					}
+				}
+				else
+				{
+					for (int j = 0; j < numExact; j++)
+						propulsion[exact[j]] = (calcRolling ? 0.0 : 1.0);
+				}
+
+				// Formula III-3 and III-1, energetic summation over the categories
+				for (int j = 0; j < numExact; j++)
+				{
+					const int s = exact[j];
+					E[s] += lineFactor[s] * (rolling[s] + propulsion[s]);
+				}
+			}
+		}
+
+		// Finalize the energetic summation of each band
+		for (int k = 0; k < n * MAX_FREQ_BAND_CENTRE; k++)
+			total[k] = 10 * log10(total[k]);
+
+		return 0;
+	}
+}
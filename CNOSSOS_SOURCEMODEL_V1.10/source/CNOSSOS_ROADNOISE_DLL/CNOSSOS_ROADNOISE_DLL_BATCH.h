@@ -0,0 +1,98 @@
+#pragma once
+
+// ----------------------------------------------------------------------------------------------------- 
+//
+// project : CNOSSOS_ROADNOISE.dll
+// author  : Martijn Kirsten
+// company : DGMR
+//
+// Calculation road traffic noise source emission
+//
+// Disclaimer + header text
+//
+// Version : 
+// Release : 
+//
+// ----------------------------------------------------------------------------------------------------- 
+
+#include "stdafx.h"
+#include "CNOSSOS_ROADNOISE_DLL.h"
+#include "CNOSSOS_ROADNOISE_DLL_DATA.h"
+
+#include <vector>
+
+using namespace std;
+
+namespace CNOSSOS_ROADNOISE
+{
+	// -------------------------------------------------------------------------------------------------------------
+	// Precomputed speed dependent emission, for each road surface, vehicle category and frequency band. 
+	//
+	// The table holds, as energies on a regular speed grid :
+	//  - the rolling noise including the road surface correction (formula III-5, III-19)
+	//  - the propulsion noise including the road surface correction (formula III-11, III-20)
+	//  - the studded tyre excess 10^(delta_stud / 10) - 1 (formula III-7, III-9)
+	// The remaining corrections do not depend on the frequency band, or only through Ksurface, and are 
+	// applied as factors per segment.
+	//
+	// The grid step is halved until the linear interpolation error, checked at the middle of every 
+	// interval, is below half the tolerance for each of the tabulated terms. Grid points fall on 
+	// 50 and 90 km/h, the limits of formula III-7, so that all tabulated functions are smooth and 
+	// convex within each interval and the middle of the interval is where the error peaks.
+	// -------------------------------------------------------------------------------------------------------------
+	class RoadEmissionTable
+	{
+		private:
+			RoadNoiseCatalog *catalog;
+			vector<const RoadSurface*> surfaces;
+
+			// exact values of the tabulated terms
+			double CalcRolling(const RoadSurface *rs, const int m, const int i, const double v) const;
+			double CalcPropulsion(const RoadSurface *rs, const int m, const int i, const double v) const;
+			double CalcStudded(const int m, const int i, const double v) const;
+
+			void Build(void);
+			double CheckError(void) const;
+
+		public:
+			double	minSpeed, maxSpeed, step;
+			double	tolerance;			// requested accuracy in dB
+			double	maxError;			// largest interpolation error found in the table, in dB
+			int		numNodes, numCategories, numSurfaces;
+
+			// energies, stored as [surface][category][node][band]
+			vector<double> rolling, propulsion;
+			// studded tyre excess, stored as [category][node][band]
+			vector<double> studded;
+
+			RoadEmissionTable(RoadNoiseCatalog *catalog, const double minSpeed, const double maxSpeed, const double tolerance);
+
+			// find the grid interval and the interpolation weight for speed v, false if v is outside the grid
+			inline bool Locate(const double v, int &k, double &w) const
+			{
+				if (!(v >= minSpeed && v <= maxSpeed))
+					return false;
+				double x = (v - minSpeed) / step;
+				k = (int)x;
+				if (k >= numNodes - 1)
+					k = numNodes - 2;
+				w = x - k;
+				return true;
+			}
+	};
+
+	// -------------------------------------------------------------------------------------------------------------
+	// Calculates the source power of many road segments in one call. 
+	//
+	// Gives the same results as RoadSegment::CalcSegment for each segment, but loops over the segments 
+	// in the innermost loops, works in energies instead of levels and only evaluates the speed dependent 
+	// logarithms once per segment and category instead of once per band.
+	//
+	// When a table is given, the speed dependent terms of all segments with a speed inside the table 
+	// are interpolated in the table instead, the others are calculated exactly.
+	//
+	// Returns 0 if all is OK, 1 if the input contains an invalid surface index, an invalid junction type
+	// (outside 0 .. MAX_SPEED_VARIATION_TYPES - 1) or junction types without distances.
+	// -------------------------------------------------------------------------------------------------------------
+	int CalcSegmentArrays(RoadNoiseCatalog *catalog, RoadSegmentArrays *segments, const RoadEmissionTable *table = NULL);
+}
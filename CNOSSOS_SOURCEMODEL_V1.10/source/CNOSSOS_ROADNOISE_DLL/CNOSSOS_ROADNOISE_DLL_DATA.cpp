@@ -113,6 +113,40 @@ namespace CNOSSOS_ROADNOISE
 		return NULL;
 	}
 
+	// Sets the average air temperature for the temperature correction
+	void RoadSegment::setTemperature(const double temperature)
+	{
+		if (TempProp == NULL)
+			TempProp = new TempProperties(temperature);
+		else
+			TempProp->t = temperature;
+	}
+
+	// Sets the gradient (in %) for the gradient correction
+	void RoadSegment::setGradient(const double gradient)
+	{
+		if (GradProp == NULL)
+			GradProp = new GradientProperties(gradient);
+		else
+			GradProp->s = gradient;
+	}
+
+	// Sets the distance to and the type of the nearest junction for the acceleration correction, 
+	// junction type 0 (no junction) switches the correction off but keeps the properties for later updates
+	void RoadSegment::setAcceleration(const double distance, const int junctionType)
+	{
+		if (AccProp == NULL)
+		{
+			if (junctionType != 0)
+				AccProp = new AccelerationProperties(distance, junctionType);
+		}
+		else
+		{
+			AccProp->distance = distance;
+			AccProp->K = junctionType;
+		}
+	}
+
 #pragma endregion Meta_Debug_functions
 
 #pragma region RollingNoise_Calculation_functions
@@ -166,7 +200,7 @@ namespace CNOSSOS_ROADNOISE
 	{
 		// if correction
 		VehicleCategory *cat = catalog->getCategory(m);
-		if (this->AccProp != NULL)
+		if (this->AccProp != NULL && this->AccProp->K != 0)
 		{
 			// Formula III-17
 			double Cfactor = cat->speedVariationCoefficient[this->AccProp->K][ngROLLING];
@@ -252,7 +286,7 @@ namespace CNOSSOS_ROADNOISE
 	{
 		
 		VehicleCategory *cat = catalog->getCategory(m);
-		if (this->AccProp != NULL)
+		if (this->AccProp != NULL && this->AccProp->K != 0)
 		{
 			// Formula III-18
 			double Cfactor = cat->speedVariationCoefficient[this->AccProp->K][ngPROPULSION];
@@ -509,25 +543,15 @@ namespace CNOSSOS_ROADNOISE
 				this->doDebug = (test != "0") && (test != "false");
 			}
 
-			TempProp = new TempProperties(floatFromElement(segment, "Taverage"));
-			GradProp = new GradientProperties(floatFromElement(segment, "Slope"));
+			setTemperature(floatFromElement(segment, "Taverage"));
+			setGradient(floatFromElement(segment, "Slope"));
 			// TODO: SetStuddedMonths(int)?
 			studdedMonths = intFromElement(segment, "Tstudded", 0);
 				
 			e = segment->FirstChildElement("SpeedVariations");
 			if (e != NULL)
 			{
-				if (intFromElement(e, "Type") != 0)
-				{
-					AccProp = new AccelerationProperties(floatFromElement(e, "Distance"),
-															intFromElement(e, "Type"));
-				}
-				else
-				{
-					if (AccProp != NULL)
-						delete AccProp;
-					AccProp = NULL;
-				}
+				setAcceleration(floatFromElement(e, "Distance"), intFromElement(e, "Type"));
 			}
 			else
 				ReportError("No SpeedVariations found", fn, segment);
@@ -679,7 +703,7 @@ namespace CNOSSOS_ROADNOISE
 		else
 			myfile << "Use temperature: " << this->TempProp->t << "°C" << endl;
 
-		if (this->AccProp == NULL)
+		if (this->AccProp == NULL || this->AccProp->K == 0)
 			myfile << "No acceleration properties found" << endl;
 		else
 		{
@@ -102,6 +102,12 @@ namespace CNOSSOS_ROADNOISE
 
 			// property setter for road surface
 			RoadSurface* setSurfaceID(const string id);
+
+			// property setters for the optional corrections; the property objects are created on first 
+			// use and updated in place afterwards, so re-parameterizing a segment does not allocate memory
+			void setTemperature(const double temperature);
+			void setGradient(const double gradient);
+			void setAcceleration(const double distance, const int junctionType);
 			
 			// aux function for printing the roadsegment object to screen
 			void PrintSegment();